@@ -1,6 +1,16 @@
 #include "Administrator.h"
+#include "ChangeExport.h"
+#include "ColumnarExport.h"
+#include "Compression.h"
 #include "Gradebook.h"
+#include "Merge.h"
 #include "utilities.h"
+#include "Query.h"
+#include "Ranking.h"
+#include "ReportArchive.h"
+#include "ReportBatch.h"
+#include "ReportSink.h"
+#include "Statistics.h"
 #include "Student.h"
 #include "Teacher.h"
 #include <fstream>
@@ -98,7 +108,7 @@ namespace gradebook {
                 "Great! Let's continue.",
                 "That's okay. Let's try again."));
 
-            gradebook.getTeachers().push_back(newTeacher);
+            gradebook.addTeacher(newTeacher);
 
             std::cout << "Teacher " << newTeacher.getFirstName() << " " << newTeacher.getLastName()
                 << " has been added successfully!" << std::endl;
@@ -135,6 +145,10 @@ namespace gradebook {
                 newStudent.setAge(numericValidator<unsigned>("Please enter the student's age: ", 4, 19));
                 newStudent.setGradeLevel(numericValidator<unsigned>("Please enter the student's grade: ", 1, 12));
                 newStudent.setID(numericValidator<unsigned>("Please enter the student's ID number: ", 1, 999999));
+                while (gradebook.findStudentByID(newStudent.getID())) {
+                    std::cout << "A student with that ID already exists." << std::endl;
+                    newStudent.setID(numericValidator<unsigned>("Please enter the student's ID number: ", 1, 999999));
+                }
                 newStudent.setSeat(stringValidator("Please enter the student's seat location: "));
                 newStudent.setNotes(stringValidator("Enter any additional notes for this student: "));
                 newStudent.printStudent();
@@ -144,10 +158,7 @@ namespace gradebook {
                 "That's okay. Let's try again."
             ));
 
-            std::vector<Teacher*> eligible;
-            for (auto& t : teachers)
-                if (t.getGradeLevel() == newStudent.getGradeLevel())
-                    eligible.push_back(&t);
+            std::vector<Teacher*> eligible = gradebook.getTeachersForGrade(newStudent.getGradeLevel());
 
             if (eligible.empty()) {
                 std::cout << "No teacher for grade " << newStudent.getGradeLevel()
@@ -155,32 +166,30 @@ namespace gradebook {
             }
             else {
                 std::cout << "Assign student to which teacher?\n";
-                for (size_t i = 0; i < eligible.size(); ++i) {
-                    std::cout << "  " << (i + 1) << ". "
-                        << eligible[i]->getFirstName() << " "
-                        << eligible[i]->getLastName() << std::endl;
+                std::vector<std::string> labels;
+                labels.reserve(eligible.size());
+                for (const Teacher* t : eligible) {
+                    labels.push_back(t->getFirstName() + " " + t->getLastName());
                 }
-                unsigned choice = numericValidator<unsigned>(
-                    "Enter the number of the teacher: ", 1, eligible.size()
-                );
-                Teacher* chosen = eligible[choice - 1];
-
-                auto studentPtr = std::make_unique<Student>(std::move(newStudent));
-                Student* stored = studentPtr.get();
-                gradebook.getStudents().push_back(std::move(studentPtr));
-
-                chosen->addStudentToClassroom(stored);
-
-                std::cout << "Student "
-                    << stored->getFirstName() << " "
-                    << stored->getLastName()
-                    << " assigned to "
-                    << chosen->getFirstName() << " "
-                    << chosen->getLastName() << "!" << std::endl;
-            }
+                size_t choice = pickFromList(labels);
+                if (choice == labels.size()) {
+                    std::cout << "No teacher selected. Student will NOT be added." << std::endl;
+                }
+                else {
+                    Teacher* chosen = eligible[choice];
 
-            if (gradebook.isAutosaveEnabled()) {
-                gradebook.serializeAndSave();
+                    Student* stored = gradebook.addStudent(std::make_unique<Student>(std::move(newStudent)));
+                    gradebook.enrollStudent(*chosen, stored);
+
+                    std::cout << "Student "
+                        << stored->getFirstName() << " "
+                        << stored->getLastName()
+                        << " assigned to "
+                        << chosen->getFirstName() << " "
+                        << chosen->getLastName() << "!" << std::endl;
+
+                    gradebook.autosave();
+                }
             }
 
             addMore = userCheck(
@@ -193,103 +202,579 @@ namespace gradebook {
         menu(gradebook);
     }
 
+    namespace {
+        /**
+         * @brief Lets the user pick a teacher by name.
+         * @param teachers Teachers to choose from.
+         * @return Pointer to the chosen teacher, or nullptr if the user cancelled.
+         */
+        Teacher* pickTeacher(std::vector<Teacher>& teachers) {
+            std::vector<std::string> labels;
+            labels.reserve(teachers.size());
+            for (const auto& t : teachers) {
+                labels.push_back(t.getTitle() + " " + t.getLastName() + " (Grade "
+                    + std::to_string(t.getGradeLevel()) + ", "
+                    + std::to_string(t.getClassroomStudents().size()) + " students)");
+            }
+            size_t choice = pickFromList(labels);
+            return choice == labels.size() ? nullptr : &teachers[choice];
+        }
+    }
+
     /**
-     * @brief Prints a detailed school-wide report of all teachers and their students.
+     * @brief Deletes a student after confirming, found by ID or from a classroom roster.
      * @param gradebook Reference to the Gradebook instance.
      */
-    void Administrator::printSchoolReport(Gradebook& gradebook) const {
-        const auto& teachers = gradebook.getTeachers();
+    void Administrator::removeStudent(Gradebook& gradebook) {
+        if (gradebook.getStudents().empty()) {
+            std::cout << "There are no students currently in the system." << std::endl;
+            return;
+        }
 
-        if (teachers.empty()) {
-            std::cout << "There are no teachers currently in the system." << std::endl;
+        Student* selected = nullptr;
+        unsigned how = numericValidator<unsigned>(
+            "1. Find the student by ID\n2. Pick the student from a classroom\nChoose an option [1-2]: ", 1, 2);
+        if (how == 1) {
+            selected = gradebook.findStudentByID(numericValidator<unsigned>("Enter the student's ID: ", 1, 999999));
+            if (!selected) {
+                std::cout << "No student has that ID." << std::endl;
+                return;
+            }
+        }
+        else {
+            std::cout << "Select the student's teacher:" << std::endl;
+            Teacher* teacher = pickTeacher(gradebook.getTeachers());
+            if (!teacher || teacher->getClassroomStudents().empty()) {
+                std::cout << "No student selected." << std::endl;
+                return;
+            }
+            selected = pickStudent(teacher->getRosterIndex());
+            if (!selected) {
+                std::cout << "No student selected." << std::endl;
+                return;
+            }
+        }
+
+        std::string name = selected->getFirstName() + " " + selected->getLastName();
+        if (!userCheck("Delete " + name + " and all of their grades? [Y/N] ",
+            "Deleting student.",
+            "Keeping student.")) {
             return;
         }
 
-        std::cout << "===== School-Wide Student Report =====" << std::endl << std::endl;
+        gradebook.removeStudent(selected);
+        std::cout << "Student " << name << " has been removed." << std::endl;
+        gradebook.autosave();
+    }
 
-        for (const auto& teacher : teachers) {
-            std::cout << teacher.getTitle() << " " << teacher.getFirstName()
-                << " " << teacher.getLastName()
-                << " (Grade " << teacher.getGradeLevel() << ")" << std::endl;
+    /**
+     * @brief Moves one student, or a whole class, from one teacher to another.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * Whole-class moves go through one batched transfer, which is the
+     * end-of-year path; the students' grade level can be moved along with them.
+     */
+    void Administrator::transferStudents(Gradebook& gradebook) {
+        auto& teachers = gradebook.getTeachers();
+        if (teachers.size() < 2) {
+            std::cout << "At least two teachers are needed to transfer students." << std::endl;
+            return;
+        }
 
-            const auto& students = teacher.getClassroomStudents();
+        std::cout << "Transfer from which teacher?" << std::endl;
+        Teacher* from = pickTeacher(teachers);
+        if (!from || from->getClassroomStudents().empty()) {
+            std::cout << "No students to transfer." << std::endl;
+            return;
+        }
+        std::cout << "Transfer to which teacher?" << std::endl;
+        Teacher* to = pickTeacher(teachers);
+        if (!to || to == from) {
+            std::cout << "Transfer cancelled." << std::endl;
+            return;
+        }
 
-            if (students.empty()) {
-                std::cout << "  No students assigned to this teacher." << std::endl << std::endl;
-                continue;
+        std::vector<Student*> moving;
+        unsigned scope = numericValidator<unsigned>(
+            "1. Transfer one student\n2. Transfer the whole class\nChoose an option [1-2]: ", 1, 2);
+        if (scope == 1) {
+            Student* selected = pickStudent(from->getRosterIndex());
+            if (!selected) {
+                std::cout << "No student selected." << std::endl;
+                return;
             }
+            moving.push_back(selected);
+        }
+        else {
+            moving = from->getClassroomStudents();
+        }
 
-            std::cout << std::left
-                << std::setw(16) << "First Name:"
-                << std::setw(16) << "Last Name:"
-                << std::setw(9) << "Age:"
-                << std::setw(11) << "ID:"
-                << std::setw(16) << "Percent Grade:"
-                << std::setw(13) << "Letter Grade:"
-                << std::endl;
-
-            std::cout << std::string(81, '-') << std::endl;
-
-            for (const Student* student : students) {
-                if (!student) continue;
-
-                std::cout << std::left
-                    << std::setw(16) << student->getFirstName()
-                    << std::setw(16) << student->getLastName()
-                    << std::setw(9) << student->getAge()
-                    << std::setw(11) << student->getID()
-                    << std::setw(16) << std::fixed << std::setprecision(2) << student->getGradePercent()
-                    << std::setw(13) << student->getOverallGrade()
-                    << std::endl;
+        bool regrade = from->getGradeLevel() != to->getGradeLevel()
+            && userCheck("Change the students' grade level to " + std::to_string(to->getGradeLevel()) + "? [Y/N] ",
+                "Grade level will be updated.",
+                "Grade level left unchanged.");
+
+        size_t moved = gradebook.transferStudents(moving, *from, *to, regrade);
+
+        std::cout << moved << " student(s) transferred from " << from->getLastName()
+            << " to " << to->getLastName() << "." << std::endl;
+        gradebook.autosave();
+    }
+
+    /**
+     * @brief Enrolls an existing student in one more classroom, keeping their other classes.
+     * @param gradebook Reference to the Gradebook instance.
+     */
+    void Administrator::enrollInAnotherClass(Gradebook& gradebook) {
+        if (gradebook.getStudents().empty() || gradebook.getTeachers().empty()) {
+            std::cout << "Students and teachers must be added first." << std::endl;
+            return;
+        }
+
+        Student* selected = gradebook.findStudentByID(numericValidator<unsigned>("Enter the student's ID: ", 1, 999999));
+        if (!selected) {
+            std::cout << "No student has that ID." << std::endl;
+            return;
+        }
+
+        std::vector<Teacher*> available;
+        std::vector<std::string> labels;
+        for (auto& t : gradebook.getTeachers()) {
+            if (!selected->isEnrolledIn(t.getClassroomID())) {
+                available.push_back(&t);
+                labels.push_back(t.getTitle() + " " + t.getLastName() + " (Grade " + std::to_string(t.getGradeLevel()) + ")");
             }
-            std::cout << std::endl;
         }
+        if (available.empty()) {
+            std::cout << selected->getFirstName() << " is already in every class." << std::endl;
+            return;
+        }
+
+        std::cout << "Enroll " << selected->getFirstName() << " " << selected->getLastName() << " in which class?" << std::endl;
+        size_t choice = pickFromList(labels);
+        if (choice == labels.size()) {
+            std::cout << "Enrollment cancelled." << std::endl;
+            return;
+        }
+
+        gradebook.enrollStudent(*available[choice], selected);
+        std::cout << selected->getFirstName() << " is now enrolled in "
+            << gradebook.getTeachersOf(selected).size() << " class(es)." << std::endl;
+        gradebook.autosave();
+    }
+
+    /**
+     * @brief Prints a detailed school-wide report of all teachers and their students.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * Rows come from the gradebook's report cache, so only classrooms that
+     * changed since the last report or export are formatted again.
+     */
+    void Administrator::printSchoolReport(Gradebook& gradebook) const {
+        if (gradebook.getTeachers().empty()) {
+            std::cout << "There are no teachers currently in the system." << std::endl;
+            return;
+        }
+
+        std::cout << "===== School-Wide Student Report =====" << std::endl << std::endl;
+
+        for (const auto& rows : gradebook.getSchoolReportRows()) {
+            std::cout << rows.printed;
+        }
+        std::cout.flush();
     }
 
     /**
      * @brief Exports the school report to a CSV file named "SchoolReport.csv".
      * @param gradebook Reference to the Gradebook instance.
      *
-     * Writes all teachers and their students' information in CSV format.
+     * Writes all teachers and their students' information in CSV format,
+     * reusing the cached rows of every classroom that has not changed.
+     * A change export instead writes SchoolReport_Changes_<version>.csv
+     * with only the rows added, changed or removed since the last one.
      */
     void Administrator::saveSchoolReportToCSV(Gradebook& gradebook) {
-        std::ofstream file("SchoolReport.csv");
+        unsigned choice = numericValidator<unsigned>(
+            "1. Full report\n2. Only rows changed since the last change export\nChoose an option [1-2]: ", 1, 2);
+
+        if (choice == 2) {
+            ChangeExportResult result;
+            if (!exportSchoolReportChanges(gradebook, result)) {
+                return;
+            }
+            if (result.filename.empty()) {
+                std::cout << "Nothing has changed since the last change export." << std::endl;
+                return;
+            }
+            gradebook.autosave();
+            std::cout << result.upserts << " changed row(s) and " << result.deletes << " deleted row(s) exported to "
+                << result.filename << "." << std::endl;
+            return;
+        }
+
+        const std::string filename = exportFileName("SchoolReport.csv");
+        ExportFile file(filename);
 
         if (!file.is_open()) {
-            std::cerr << "Failed to create SchoolReport.csv" << std::endl;
+            std::cerr << "Failed to create " << filename << std::endl;
             return;
         }
 
         file << "Teacher,Student First Name,Student Last Name,Pronouns,Age,Grade Level,ID,Seat,Notes,Grade %,Letter Grade" << std::endl;
 
-        const auto& teachers = gradebook.getTeachers();
-
-        for (const auto& teacher : teachers) {
-            std::string teacherName = teacher.getFirstName() + " " + teacher.getLastName();
-            const auto& students = teacher.getClassroomStudents();
-
-            for (const auto* studentPtr : students) {  // students are now pointers
-                if (!studentPtr) continue;  // just in case
-
-                const Student& student = *studentPtr;  // dereference pointer
-
-                file << std::quoted(teacherName) << ","
-                    << std::quoted(student.getFirstName()) << ","
-                    << std::quoted(student.getLastName()) << ","
-                    << std::quoted(student.getPronouns()) << ","
-                    << student.getAge() << ","
-                    << student.getGradeLevel() << ","
-                    << student.getID() << ","
-                    << std::quoted(student.getSeat()) << ","
-                    << std::quoted(student.getNotes()) << ","
-                    << std::fixed << std::setprecision(2) << student.getGradePercent() << ","
-                    << student.getOverallGrade()
-                    << std::endl;
-            }
+        for (const auto& rows : gradebook.getSchoolReportRows()) {
+            file << rows.csv;
         }
 
         file.close();
-        std::cout << "School data exported successfully to SchoolReport.csv." << std::endl;
+        std::cout << "School data exported successfully to " << filename << "." << std::endl;
+    }
+
+    /**
+     * @brief Writes every classroom, assignment score and student report CSV to reports/ and summarizes the run.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * Teachers no longer have to log in and export one classroom at a
+     * time; reports/manifest.csv lists every file written.
+     */
+    void Administrator::saveAllReports(Gradebook& gradebook) const {
+        if (gradebook.getTeachers().empty() && gradebook.getStudents().empty()) {
+            std::cout << "There is nothing to report yet." << std::endl;
+            return;
+        }
+
+        ReportBatchResult result = generateAllReports(gradebook, "reports");
+        if (result.outputs.empty()) {
+            return;
+        }
+
+        std::cout << result.written << " report(s) written to reports/ in "
+            << std::fixed << std::setprecision(2) << result.seconds << " s using "
+            << result.workers << " thread(s)." << std::endl;
+        if (result.failed > 0) {
+            std::cerr << result.failed << " report(s) could not be written; see the manifest." << std::endl;
+        }
+    }
+
+    /**
+     * @brief Exports all report cards into one indexed archive, or prints a single card from it.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * The archive replaces one CSV per student, so students who share a
+     * name no longer overwrite each other's files. Viewing a card reads
+     * only the index and that card.
+     */
+    void Administrator::reportCardArchive(Gradebook& gradebook) const {
+        const std::string archiveFile = "ReportCards.gbra";
+
+        unsigned choice = numericValidator<unsigned>(
+            "1. Export every student's report card\n2. View one student's card from " + archiveFile
+            + "\nChoose an option [1-2]: ", 1, 2);
+
+        if (choice == 1) {
+            if (gradebook.getStudents().empty()) {
+                std::cout << "There are no students currently in the system." << std::endl;
+                return;
+            }
+
+            size_t cards = 0;
+            if (writeReportCardArchive(gradebook, archiveFile, cards)) {
+                std::cout << cards << " report card(s) exported to " << archiveFile << "." << std::endl;
+            }
+            return;
+        }
+
+        ReportCardArchive archive;
+        if (!archive.open(archiveFile)) {
+            std::cout << "Export the report cards first." << std::endl;
+            return;
+        }
+
+        unsigned id = numericValidator<unsigned>("Enter the student's ID: ", 1, 999999);
+        if (auto card = archive.readCard(id)) {
+            std::cout << *card << std::endl;
+        }
+        else {
+            std::cout << "The archive has no card for that ID." << std::endl;
+        }
+    }
+
+    /**
+     * @brief Exports students, classrooms, assignments, enrollments and scores to SchoolData.gbc for analytics tools.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * The file is columnar and binary, so tools read typed columns
+     * directly instead of parsing CSV text.
+     */
+    void Administrator::exportAnalyticsData(Gradebook& gradebook) const {
+        const std::string dataFile = "SchoolData.gbc";
+
+        std::vector<ColumnarTable> tables;
+        if (!writeColumnarExport(gradebook, dataFile, tables)) {
+            return;
+        }
+
+        std::cout << "Analytics data exported to " << dataFile << ":" << std::endl;
+        for (const auto& table : tables) {
+            std::cout << "  " << std::left << std::setw(12) << table.name << std::right
+                << table.rows << " row(s) in " << table.rowGroups.size() << " row group(s)" << std::endl;
+        }
+    }
+
+    /**
+     * @brief Prints school-wide score distributions and offers a CSV export.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * Assignment, classroom and grade-level distributions are all gathered in
+     * one pass over the classrooms.
+     */
+    void Administrator::printSchoolStatistics(Gradebook& gradebook) const {
+        if (gradebook.getTeachers().empty()) {
+            std::cout << "There are no teachers currently in the system." << std::endl;
+            return;
+        }
+
+        StatisticsReport report = computeSchoolStatistics(gradebook);
+        std::cout << "===== School-Wide Statistics =====" << std::endl;
+        printStatistics(report);
+
+        if (userCheck("Would you like to export these statistics to CSV? [Y/N] ",
+            "Exporting statistics to CSV...",
+            "Skipping export.")) {
+            exportStatisticsToCSV(report, exportFileName("SchoolStatistics.csv"));
+        }
+    }
+
+    /**
+     * @brief Prompts for a ranking query, prints the result and offers a CSV export.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * Top-k queries use a bounded heap and full rankings a parallel sort, so
+     * both stay interactive on very large schools.
+     */
+    void Administrator::rankStudents(Gradebook& gradebook) const {
+        if (gradebook.getTeachers().empty()) {
+            std::cout << "There are no teachers currently in the system." << std::endl;
+            return;
+        }
+
+        std::cout << "1. Top or bottom students school-wide." << std::endl;
+        std::cout << "2. Top or bottom students in each grade level." << std::endl;
+        std::cout << "3. Full school ranking." << std::endl;
+        unsigned mode = numericValidator<unsigned>("Choose an option [1-3]: ", 1, 3);
+
+        RankingQuery query;
+        if (userCheck("Rank by a single assignment instead of overall grade? [Y/N] ",
+            "Ranking by assignment score.",
+            "Ranking by overall grade.")) {
+            query.assignmentName = stringValidator("Enter the assignment name: ");
+        }
+        query.highestFirst = numericValidator<unsigned>(
+            "1. Highest first\n2. Lowest first\nChoose an option [1-2]: ", 1, 2) == 1;
+
+        if (mode != 2) {
+            query.gradeLevel = numericValidator<unsigned>(
+                "Enter a grade level to restrict to [1-12], or 0 for all grades: ", 0, 12);
+        }
+
+        size_t k = 0;
+        if (mode != 3) {
+            k = numericValidator<unsigned>("How many students would you like to see? ", 1, 1000000);
+        }
+
+        std::vector<RankedEntry> results;
+        if (mode == 2) {
+            for (auto& [grade, entries] : topStudentsPerGradeLevel(gradebook, query, k)) {
+                std::cout << "=== Grade " << grade << " ===" << std::endl;
+                printRanking(entries);
+                results.insert(results.end(), entries.begin(), entries.end());
+            }
+        }
+        else {
+            results = (mode == 1) ? topStudents(gradebook, query, k) : rankAllStudents(gradebook, query);
+            printRanking(results);
+        }
+
+        if (!results.empty() && userCheck("Would you like to export this ranking to CSV? [Y/N] ",
+            "Exporting ranking to CSV...",
+            "Skipping export.")) {
+            exportRankingToCSV(results, exportFileName("SchoolRanking.csv"));
+        }
+    }
+
+    /**
+     * @brief Prompts for a grade level, letter grade and age band and lists the matching students.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * Answered from the gradebook's secondary index, so narrow questions such
+     * as "grade 7 students with an F" never scan the whole school.
+     */
+    void Administrator::findStudents(Gradebook& gradebook) const {
+        StudentFilter filter;
+        filter.gradeLevel = numericValidator<unsigned>(
+            "Enter a grade level to restrict to [1-12], or 0 for all grades: ", 0, 12);
+
+        std::cout << "1. Any letter grade\n2. A\n3. B\n4. C\n5. D\n6. F\n7. Not graded yet" << std::endl;
+        unsigned letter = numericValidator<unsigned>("Choose an option [1-7]: ", 1, 7);
+        if (letter > 1) {
+            filter.letterGrade = "ABCDF"[letter - 2];
+        }
+
+        filter.minAge = numericValidator<unsigned>("Youngest age to include [0-19]: ", 0, 19);
+        filter.maxAge = numericValidator<unsigned>("Oldest age to include [" + std::to_string(filter.minAge) + "-19]: ", filter.minAge, 19);
+
+        std::vector<Student*> matches = gradebook.findStudents(filter);
+        if (matches.empty()) {
+            std::cout << "No matching students found." << std::endl;
+            return;
+        }
+
+        std::cout << std::left
+            << std::setw(30) << "Student"
+            << std::setw(10) << "ID"
+            << std::setw(7) << "Grade"
+            << std::setw(6) << "Age"
+            << std::setw(10) << "Grade %"
+            << "Letter"
+            << "\n" << std::string(69, '-') << "\n";
+        for (const Student* s : matches) {
+            char letterGrade = s->getOverallGrade();
+            std::cout << std::left
+                << std::setw(30) << (s->getFirstName() + " " + s->getLastName())
+                << std::setw(10) << s->getID()
+                << std::setw(7) << s->getGradeLevel()
+                << std::setw(6) << s->getAge()
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << s->getGradePercent()
+                << (letterGrade == '\0' ? '-' : letterGrade)
+                << "\n";
+        }
+        std::cout << matches.size() << " student(s) found." << std::endl;
+    }
+
+    /**
+     * @brief Prompts for a query, prints its plan and results, and offers a CSV export.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * The same queries can be run without the menus with --query.
+     */
+    void Administrator::queryStudents(Gradebook& gradebook) const {
+        std::cout << "Fields: id, grade, age, percent, letter, assignment.points, assignment.score, assignment.percent" << std::endl;
+        std::cout << "Example: grade = 5 and assignment.percent < 70 and assignment.points > 50" << std::endl;
+
+        std::string error;
+        std::optional<StudentQuery> query = parseQuery(stringValidator("Enter a query: "), error);
+        if (!query) {
+            std::cout << "Invalid query: " << error << std::endl;
+            return;
+        }
+
+        QueryPlan plan = planQuery(*query);
+        std::cout << explainPlan(plan);
+
+        ConsoleSink console;
+        if (runQuery(gradebook, plan, console) > 0 && userCheck("Would you like to export these results to CSV? [Y/N] ",
+            "Exporting results to CSV...",
+            "Skipping export.")) {
+            CsvSink csv(exportFileName("QueryResults.csv"));
+            if (csv.isOpen()) {
+                runQuery(gradebook, plan, csv);
+            }
+        }
+    }
+
+    /**
+     * @brief Prompts for search words and prints the best-matching notes and descriptions.
+     * @param gradebook Reference to the Gradebook instance.
+     */
+    void Administrator::searchText(Gradebook& gradebook) const {
+        std::cout << "Words must all appear; use \"quotes\" for a phrase and a trailing * for a prefix." << std::endl;
+        std::string text = stringValidator("Search for: ");
+
+        ConsoleSink console;
+        if (runTextSearch(gradebook, text, 25, console) > 0 && userCheck("Would you like to export these results to CSV? [Y/N] ",
+            "Exporting results to CSV...",
+            "Skipping export.")) {
+            CsvSink csv(exportFileName("SearchResults.csv"));
+            if (csv.isOpen()) {
+                runTextSearch(gradebook, text, 25, csv);
+            }
+        }
+    }
+
+    /**
+     * @brief Prompts for an autosave durability mode and, for Grouped, its batching policy.
+     * @param gradebook Reference to the Gradebook instance.
+     *
+     * Fast never waits for the disk, Grouped waits at most one window per
+     * batch of changes on a background thread, and Strict waits for every
+     * change. All three replace gradebook.dat atomically.
+     */
+    void Administrator::configureDurability(Gradebook& gradebook) const {
+        std::cout << "Current save durability: " << durabilityModeName(gradebook.getDurabilityMode());
+        if (gradebook.getDurabilityMode() == DurabilityMode::Grouped) {
+            std::cout << " (window " << gradebook.getGroupCommitWindowMs() << " ms, up to "
+                << gradebook.getGroupCommitMaxChanges() << " changes per commit)";
+        }
+        std::cout << std::endl;
+
+        std::cout << "1. Fast - never wait for the disk; a power loss may lose recent changes." << std::endl;
+        std::cout << "2. Grouped - changes within a short window share one disk sync." << std::endl;
+        std::cout << "3. Strict - wait for the disk after every change." << std::endl;
+        unsigned mode = numericValidator<unsigned>("Choose an option [1-3]: ", 1, 3);
+
+        if (mode == 2) {
+            unsigned windowMs = numericValidator<unsigned>(
+                "Longest a change may wait to be synced, in milliseconds [10-10000]: ", 10, 10000);
+            unsigned maxChanges = numericValidator<unsigned>(
+                "Number of changes that triggers a sync early [1-1000]: ", 1, 1000);
+            gradebook.setGroupCommitPolicy(windowMs, maxChanges);
+        }
+
+        DurabilityMode chosen = mode == 1 ? DurabilityMode::Fast
+            : mode == 2 ? DurabilityMode::Grouped
+            : DurabilityMode::Strict;
+        gradebook.setDurabilityMode(chosen);
+        std::cout << "Save durability set to " << durabilityModeName(chosen) << "." << std::endl;
+    }
+
+    /**
+     * @brief Turns gzip compression of exports on or off.
+     *
+     * While on, every CSV export is written as "<name>.gz". Report card
+     * archives and analytics files are never compressed, since readers seek
+     * inside them.
+     */
+    void Administrator::toggleExportCompression() const {
+        setExportCompression(!isExportCompressionEnabled());
+        std::cout << "Export compression " << (isExportCompressionEnabled() ? "enabled." : "disabled.") << std::endl;
+    }
+
+    /**
+     * @brief Merges another copy of the school's data file, such as a teacher's laptop copy, into this one.
+     * @param gradebook Reference to the gradebook instance.
+     *
+     * Changes made only in the other copy are applied here; records both
+     * copies changed differently are listed and left as they are here. The
+     * merged school is saved if anything changed.
+     */
+    void Administrator::mergeSchoolCopy(Gradebook& gradebook) const {
+        std::string theirsFile = stringValidator("Enter the data file of the other copy: ");
+        std::string baseFile;
+        if (userCheck("Do you have the data file both copies were made from? [Y/N] ",
+            "It lets edits and removals merge, not just additions.",
+            "Only additions will merge automatically.")) {
+            baseFile = stringValidator("Enter the data file both copies were made from: ");
+        }
+
+        MergeResult result;
+        if (!mergeGradebookFiles(gradebook, theirsFile, baseFile, result)) {
+            return;
+        }
+        printMergeResult(result);
+        if (result.changesApplied > 0) {
+            gradebook.serializeAndSave();
+        }
     }
 
     /**
@@ -300,17 +785,33 @@ namespace gradebook {
      */
     void Administrator::menu(Gradebook& gradebook) {
         while (true) {
+            gradebook.reloadExternalChanges();
+
             std::cout << "=== Administrator Menu ===" << std::endl;
             std::cout << "1. Add Teacher." << std::endl;
             std::cout << "2. Add Student." << std::endl;
-            std::cout << "3. Overwrite Administrator Profile." << std::endl;
-            std::cout << "4. Print School Report" << std::endl;
-            std::cout << "5. Save School Report to CSV" << std::endl;
-            std::cout << "6. Save All Work." << std::endl;
-            std::cout << "7. Toggle Autosave." << std::endl;
-            std::cout << "8. Log Out." << std::endl;
-
-            unsigned choice = numericValidator<unsigned>("Choose an option [1-8]: ", 1, 8);
+            std::cout << "3. Remove Student." << std::endl;
+            std::cout << "4. Transfer Students." << std::endl;
+            std::cout << "5. Enroll Student in Another Class." << std::endl;
+            std::cout << "6. Overwrite Administrator Profile." << std::endl;
+            std::cout << "7. Print School Report" << std::endl;
+            std::cout << "8. Save School Report to CSV" << std::endl;
+            std::cout << "9. Save All Teacher and Student Reports to CSV" << std::endl;
+            std::cout << "10. Export or View Report Card Archive" << std::endl;
+            std::cout << "11. Export Analytics Data" << std::endl;
+            std::cout << "12. Merge Another Copy of the School Data" << std::endl;
+            std::cout << "13. Print School Statistics" << std::endl;
+            std::cout << "14. Rank Students" << std::endl;
+            std::cout << "15. Find Students by Grade, Letter Grade or Age." << std::endl;
+            std::cout << "16. Run a Query." << std::endl;
+            std::cout << "17. Search Notes and Descriptions." << std::endl;
+            std::cout << "18. Save All Work." << std::endl;
+            std::cout << "19. Toggle Autosave." << std::endl;
+            std::cout << "20. Configure Save Durability." << std::endl;
+            std::cout << "21. Toggle Export Compression." << std::endl;
+            std::cout << "22. Log Out." << std::endl;
+
+            unsigned choice = numericValidator<unsigned>("Choose an option [1-22]: ", 1, 22);
 
             switch (choice) {
             case 1:
@@ -320,23 +821,64 @@ namespace gradebook {
                 addStudent(gradebook);
                 break;
             case 3:
-                gradebook.createSchool();
+                removeStudent(gradebook);
                 break;
             case 4:
-                printSchoolReport(gradebook);
+                transferStudents(gradebook);
                 break;
             case 5:
-                saveSchoolReportToCSV(gradebook);
+                enrollInAnotherClass(gradebook);
                 break;
             case 6:
-                gradebook.serializeAndSave();
+                gradebook.createSchool();
                 break;
             case 7:
-                gradebook.autosaveToggle();
+                printSchoolReport(gradebook);
                 break;
             case 8:
-                welcomeMenu(gradebook);
+                saveSchoolReportToCSV(gradebook);
+                break;
+            case 9:
+                saveAllReports(gradebook);
                 break;
+            case 10:
+                reportCardArchive(gradebook);
+                break;
+            case 11:
+                exportAnalyticsData(gradebook);
+                break;
+            case 12:
+                mergeSchoolCopy(gradebook);
+                break;
+            case 13:
+                printSchoolStatistics(gradebook);
+                break;
+            case 14:
+                rankStudents(gradebook);
+                break;
+            case 15:
+                findStudents(gradebook);
+                break;
+            case 16:
+                queryStudents(gradebook);
+                break;
+            case 17:
+                searchText(gradebook);
+                break;
+            case 18:
+                gradebook.serializeAndSave();
+                break;
+            case 19:
+                gradebook.autosaveToggle();
+                break;
+            case 20:
+                configureDurability(gradebook);
+                break;
+            case 21:
+                toggleExportCompression();
+                break;
+            case 22:
+                return;
             default:
                 std::cout << "Invalid selection. Please try again." << std::endl;
                 return;
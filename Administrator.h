@@ -38,6 +38,18 @@ namespace gradebook {
          */
         std::string getSchoolName() const;
 
+        /**
+         * @brief Views the administrator's title without copying it.
+         * @return View of the stored title.
+         */
+        std::string_view getAdminTitleView() const { return adminTitle; }
+
+        /**
+         * @brief Views the name of the school without copying it.
+         * @return View of the stored school name.
+         */
+        std::string_view getSchoolNameView() const { return schoolName; }
+
         // === Overrides for User base class pure virtual functions ===
 
         /**
@@ -96,6 +108,24 @@ namespace gradebook {
          */
         void addStudent(Gradebook& gradebook);
 
+        /**
+         * @brief Deletes a student from the school and from every roster that lists them.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void removeStudent(Gradebook& gradebook);
+
+        /**
+         * @brief Moves one student, or a whole class, from one teacher to another.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void transferStudents(Gradebook& gradebook);
+
+        /**
+         * @brief Enrolls an existing student in one more classroom, keeping their other classes.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void enrollInAnotherClass(Gradebook& gradebook);
+
         /**
          * @brief Prints a school-wide report of students.
          * @param gradebook Reference to the gradebook instance.
@@ -103,9 +133,74 @@ namespace gradebook {
         void printSchoolReport(Gradebook& gradebook) const;
 
         /**
-         * @brief Saves the school report to a CSV file.
+         * @brief Saves the full school report, or only the rows changed since the last change export, to a CSV file.
          * @param gradebook Reference to the gradebook instance.
          */
         void saveSchoolReportToCSV(Gradebook& gradebook);
+
+        /**
+         * @brief Writes every teacher's and student's report CSVs into the reports folder in one run.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void saveAllReports(Gradebook& gradebook) const;
+
+        /**
+         * @brief Exports every student's report card into ReportCards.gbra, or shows one card from it.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void reportCardArchive(Gradebook& gradebook) const;
+
+        /**
+         * @brief Exports the school's data to SchoolData.gbc, a columnar file for analytics tools.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void exportAnalyticsData(Gradebook& gradebook) const;
+
+        /**
+         * @brief Prints score distributions per assignment, classroom and grade level.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void printSchoolStatistics(Gradebook& gradebook) const;
+
+        /**
+         * @brief Runs top-k, per-grade or full ranking queries over every classroom.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void rankStudents(Gradebook& gradebook) const;
+
+        /**
+         * @brief Lists the students matching a grade level, letter grade and age band.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void findStudents(Gradebook& gradebook) const;
+
+        /**
+         * @brief Runs an ad-hoc query over student fields, grades and assignment scores.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void queryStudents(Gradebook& gradebook) const;
+
+        /**
+         * @brief Searches student notes and assignment descriptions.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void searchText(Gradebook& gradebook) const;
+
+        /**
+         * @brief Chooses how autosave trades durability against latency.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void configureDurability(Gradebook& gradebook) const;
+
+        /**
+         * @brief Turns gzip compression of exports on or off.
+         */
+        void toggleExportCompression() const;
+
+        /**
+         * @brief Merges another copy of the school's data file, such as a teacher's laptop copy, into this one.
+         * @param gradebook Reference to the gradebook instance.
+         */
+        void mergeSchoolCopy(Gradebook& gradebook) const;
     };
 }
@@ -4,6 +4,14 @@
 namespace gradebook {
     // === Mutators ===
 
+    /**
+     * @brief Sets the assignment's stable ID.
+     * @param entry ID issued by the gradebook; scores refer to the assignment by it.
+     */
+    void Assignment::setAssignmentID(unsigned entry) {
+        assignmentID = entry;
+    }
+
     /**
      * @brief Sets the assignment's name.
      * @param entry New assignment name to assign.
@@ -30,6 +38,14 @@ namespace gradebook {
 
     // === Accessors ===
 
+    /**
+     * @brief Retrieves the assignment's stable ID.
+     * @return The ID, or 0 if none has been issued yet.
+     */
+    unsigned Assignment::getAssignmentID() const {
+        return assignmentID;
+    }
+
     /**
      * @brief Retrieves the assignment's name.
      * @return Current assignment name.
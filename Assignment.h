@@ -1,9 +1,12 @@
 #pragma once
 #include <iostream>
+#include <string>
+#include <string_view>
 
 namespace gradebook {
     class Assignment {
     private:
+        unsigned assignmentID = 0;
         std::string assignmentName;
         std::string assignmentDescription;
         float pointsPossible;
@@ -11,6 +14,12 @@ namespace gradebook {
     public:
         // === Mutators ===
 
+        /**
+         * @brief Sets the assignment's stable ID.
+         * @param entry ID issued by the gradebook; scores refer to the assignment by it.
+         */
+        void setAssignmentID(unsigned entry);
+
         /**
          * @brief Sets the assignment's name.
          * @param entry New assignment name to assign.
@@ -31,6 +40,12 @@ namespace gradebook {
 
         // === Accessors ===
 
+        /**
+         * @brief Retrieves the assignment's stable ID.
+         * @return The ID, or 0 if none has been issued yet.
+         */
+        unsigned getAssignmentID() const;
+
         /**
          * @brief Retrieves the assignment's name.
          * @return Current assignment name.
@@ -48,5 +63,19 @@ namespace gradebook {
          * @return Points possible as a float.
          */
         float getPointsPossible() const;
+
+        // === Zero-Copy Accessors ===
+
+        /**
+         * @brief Views the assignment's name without copying it.
+         * @return View of the stored name.
+         */
+        std::string_view getAssignmentNameView() const { return assignmentName; }
+
+        /**
+         * @brief Views the assignment's description without copying it.
+         * @return View of the stored description.
+         */
+        std::string_view getAssignmentDescriptionView() const { return assignmentDescription; }
     };
 }
@@ -0,0 +1,202 @@
+#include "ChangeExport.h"
+#include "Compression.h"
+#include "Gradebook.h"
+#include "utilities.h"
+#include <fstream>
+#include <iostream>
+
+namespace gradebook {
+
+    namespace {
+        /** Watermark name of the school report delta. */
+        const std::string schoolReportStream = "SchoolReport";
+
+        /**
+         * @brief Builds a delta file name from the full export's name.
+         * @param fullName Name the full export uses; ends in ".csv".
+         * @param through Version the delta covers up to.
+         * @return The delta's file name.
+         */
+        std::string deltaFileName(const std::string& fullName, ChangeVersion through) {
+            return fullName.substr(0, fullName.size() - 4) + "_Changes_" + std::to_string(through) + ".csv";
+        }
+
+        /**
+         * @brief Writes a delta file and moves its watermark once the file is complete.
+         * @tparam Write Callable taking (std::ostream&, ChangeVersion since, ChangeExportResult&) that writes the rows.
+         * @param log Change log holding the watermark.
+         * @param stream Watermark name.
+         * @param fullName Name the full export uses.
+         * @param header Column names after the Change column.
+         * @param result Receives what was written.
+         * @param write Writes the delete and upsert rows.
+         * @return False if the file could not be written.
+         */
+        template <typename Write>
+        bool writeDelta(ChangeLog& log, const std::string& stream, const std::string& fullName,
+            const char* header, ChangeExportResult& result, Write write)
+        {
+            result = ChangeExportResult();
+            result.since = log.getWatermark(stream);
+            result.through = log.getCurrentVersion();
+            if (result.through <= result.since) {
+                result.through = result.since;
+                return true;
+            }
+
+            result.filename = exportFileName(deltaFileName(fullName, result.through));
+            ExportFile file(result.filename);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open file " << result.filename << " for writing." << std::endl;
+                result.filename.clear();
+                return false;
+            }
+
+            file << "Changes After Version," << result.since << ",Through Version," << result.through << '\n';
+            file << "Change," << header << '\n';
+            write(file, result.since, result);
+
+            file.close();
+            if (file.fail()) {
+                std::cerr << "Failed to write " << result.filename << "." << std::endl;
+                return false;
+            }
+
+            log.setWatermark(stream, result.through);
+            return true;
+        }
+    }
+
+    /**
+     * @brief Writes the school report rows changed since the last school delta export.
+     * @param gradebook School to export; its change log is updated.
+     * @param result Receives what was written.
+     * @return False if the file could not be written; a message has been printed.
+     */
+    bool exportSchoolReportChanges(Gradebook& gradebook, ChangeExportResult& result) {
+        ChangeLog& log = gradebook.getChangeLog();
+        return writeDelta(log, schoolReportStream, "SchoolReport.csv",
+            "Teacher,Student First Name,Student Last Name,Pronouns,Age,Grade Level,ID,Seat,Notes,Grade %,Letter Grade,Classroom ID",
+            result, [&](std::ostream& out, ChangeVersion since, ChangeExportResult& counts) {
+                // A first export is a full snapshot, so there is nothing to delete.
+                if (since > 0) {
+                    for (const Tombstone& removal : log.tombstonesSince(since)) {
+                        if (removal.kind == TombstoneKind::ScoreErased) continue;
+
+                        out << "Delete,";
+                        if (removal.kind == TombstoneKind::Withdrawn) {
+                            if (const Teacher* teacher = gradebook.findClassroom(removal.classroomID)) {
+                                std::string teacherName;
+                                teacherName.append(teacher->getFirstNameView()).append(" ").append(teacher->getLastNameView());
+                                writeQuoted(out, teacherName);
+                            }
+                        }
+                        out << ",,,,,," << removal.studentID << ",,,,,";
+                        if (removal.kind == TombstoneKind::Withdrawn) {
+                            out << removal.classroomID;
+                        }
+                        out << '\n';
+                        ++counts.deletes;
+                    }
+                }
+
+                for (const Student* student : log.studentsChangedSince(since)) {
+                    for (const Enrollment& enrollment : student->getEnrollments()) {
+                        const Teacher* teacher = gradebook.findClassroom(enrollment.classroomID);
+                        if (!teacher) continue;
+
+                        std::string teacherName;
+                        teacherName.append(teacher->getFirstNameView()).append(" ").append(teacher->getLastNameView());
+                        out << "Upsert,";
+                        Gradebook::writeSchoolReportRow(out, teacherName, *student, enrollment.classroomID);
+                        out << ',' << enrollment.classroomID << '\n';
+                        ++counts.upserts;
+                    }
+                }
+            });
+    }
+
+    /**
+     * @brief Writes one classroom's report rows changed since its last delta export.
+     * @param gradebook School the classroom belongs to; its change log is updated.
+     * @param teacher Classroom to export.
+     * @param result Receives what was written.
+     * @return False if the file could not be written; a message has been printed.
+     */
+    bool exportClassroomReportChanges(Gradebook& gradebook, const Teacher& teacher, ChangeExportResult& result) {
+        ChangeLog& log = gradebook.getChangeLog();
+        unsigned classroomID = teacher.getClassroomID();
+        return writeDelta(log, "Classroom " + std::to_string(classroomID), teacher.classroomReportFileName(),
+            "First Name,Last Name,Pronouns,Age,ID,Seat,Notes,Grade %,Letter Grade",
+            result, [&](std::ostream& out, ChangeVersion since, ChangeExportResult& counts) {
+                if (since > 0) {
+                    for (const Tombstone& removal : log.tombstonesSince(since)) {
+                        if (removal.kind != TombstoneKind::Withdrawn || removal.classroomID != classroomID) continue;
+
+                        out << "Delete,,,,," << removal.studentID << ",,,,\n";
+                        ++counts.deletes;
+                    }
+                }
+
+                for (const Student* student : log.studentsChangedSince(since)) {
+                    if (!student->isEnrolledIn(classroomID)) continue;
+
+                    out << "Upsert,";
+                    teacher.writeClassroomReportRow(out, *student);
+                    out << '\n';
+                    ++counts.upserts;
+                }
+            });
+    }
+
+    /**
+     * @brief Writes one classroom's assignment scores changed since its last delta export.
+     * @param gradebook School the classroom belongs to; its change log is updated.
+     * @param teacher Classroom to export.
+     * @param result Receives what was written.
+     * @return False if the file could not be written; a message has been printed.
+     */
+    bool exportAssignmentScoreChanges(Gradebook& gradebook, const Teacher& teacher, ChangeExportResult& result) {
+        ChangeLog& log = gradebook.getChangeLog();
+        unsigned classroomID = teacher.getClassroomID();
+        return writeDelta(log, "AssignmentScores " + std::to_string(classroomID), teacher.assignmentScoresFileName(),
+            "Assignment ID,Assignment,Points Possible,Student ID,Student Name,Score",
+            result, [&](std::ostream& out, ChangeVersion since, ChangeExportResult& counts) {
+                if (since > 0) {
+                    for (const Tombstone& removal : log.tombstonesSince(since)) {
+                        if (removal.classroomID != classroomID) continue;
+
+                        if (removal.kind == TombstoneKind::ScoreErased) {
+                            out << "Delete," << removal.assignmentID << ",,," << removal.studentID << ",,\n";
+                        }
+                        else {
+                            out << "Delete,,,," << removal.studentID << ",,\n";
+                        }
+                        ++counts.deletes;
+                    }
+                }
+
+                // A changed student may have changed nothing here; each score's own version decides.
+                for (const Student* student : log.studentsChangedSince(since)) {
+                    const Enrollment* enrollment = student->findEnrollment(classroomID);
+                    if (!enrollment) continue;
+
+                    std::string studentName;
+                    studentName.append(student->getFirstNameView()).append(" ").append(student->getLastNameView());
+                    for (const AssignmentScore& score : enrollment->scores) {
+                        if (since > 0 && score.version <= since) continue;
+
+                        const Assignment* assignment = teacher.findAssignment(score.assignmentID);
+                        if (!assignment) continue;
+
+                        out << "Upsert," << score.assignmentID << ',';
+                        writeQuoted(out, assignment->getAssignmentNameView());
+                        out << ',' << assignment->getPointsPossible() << ',' << student->getID() << ',';
+                        writeQuoted(out, studentName);
+                        out << ',' << std::fixed << std::setprecision(2) << score.score << '\n';
+                        ++counts.upserts;
+                    }
+                }
+            });
+    }
+}
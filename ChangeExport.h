@@ -0,0 +1,61 @@
+#pragma once
+#include "ChangeLog.h"
+#include <string>
+
+namespace gradebook {
+
+    class Gradebook;
+    class Teacher;
+
+    /**
+     * @brief What one delta export wrote.
+     */
+    struct ChangeExportResult {
+        std::string filename;          /**< File written; empty if nothing had changed */
+        ChangeVersion since = 0;       /**< Watermark the export started after; 0 for a first, full export */
+        ChangeVersion through = 0;     /**< Version the export covers up to; the new watermark */
+        size_t upserts = 0;            /**< Rows to insert or replace */
+        size_t deletes = 0;            /**< Rows to delete */
+    };
+
+    /**
+     * @brief Writes the school report rows changed since the last school delta export.
+     *
+     * The first line gives the version range covered. Each row after the
+     * header starts with "Delete" or "Upsert"; rows are keyed by student ID
+     * and classroom ID, and a delete with no classroom removes every row
+     * of that student. Deletes come first. An export that has never run
+     * writes every row. The watermark only moves once the file is written.
+     *
+     * @param gradebook School to export; its change log is updated.
+     * @param result Receives what was written.
+     * @return False if the file could not be written; a message has been printed.
+     */
+    bool exportSchoolReportChanges(Gradebook& gradebook, ChangeExportResult& result);
+
+    /**
+     * @brief Writes one classroom's report rows changed since its last delta export.
+     *
+     * Rows are keyed by student ID, in the layout of the classroom report
+     * with a leading "Delete" or "Upsert" column.
+     *
+     * @param gradebook School the classroom belongs to; its change log is updated.
+     * @param teacher Classroom to export.
+     * @param result Receives what was written.
+     * @return False if the file could not be written; a message has been printed.
+     */
+    bool exportClassroomReportChanges(Gradebook& gradebook, const Teacher& teacher, ChangeExportResult& result);
+
+    /**
+     * @brief Writes one classroom's assignment scores changed since its last delta export.
+     *
+     * One row per score, keyed by assignment ID and student ID. A delete
+     * with no assignment removes every score of that student in the class.
+     *
+     * @param gradebook School the classroom belongs to; its change log is updated.
+     * @param teacher Classroom to export.
+     * @param result Receives what was written.
+     * @return False if the file could not be written; a message has been printed.
+     */
+    bool exportAssignmentScoreChanges(Gradebook& gradebook, const Teacher& teacher, ChangeExportResult& result);
+}
@@ -0,0 +1,173 @@
+#include "ChangeLog.h"
+#include "Student.h"
+#include <algorithm>
+
+namespace gradebook {
+
+    /**
+     * @brief Gets the latest version issued.
+     * @return The version; 0 if nothing has changed yet.
+     */
+    ChangeVersion ChangeLog::getCurrentVersion() const {
+        return current;
+    }
+
+    /**
+     * @brief Moves a student to the next version.
+     * @param student Student that changed.
+     * @param previous Version the student held until now; 0 if none.
+     * @return The student's new version.
+     */
+    ChangeVersion ChangeLog::recordStudentChange(Student* student, ChangeVersion previous) {
+        forgetStudent(student, previous);
+        ++current;
+        changedStudents.emplace_hint(changedStudents.end(), current, student);
+        return current;
+    }
+
+    /**
+     * @brief Stops tracking a student under a version.
+     * @param student Student to stop tracking.
+     * @param version Version the student held; nothing happens if another student is tracked under it.
+     */
+    void ChangeLog::forgetStudent(const Student* student, ChangeVersion version) {
+        auto found = changedStudents.find(version);
+        if (found != changedStudents.end() && found->second == student) {
+            changedStudents.erase(found);
+        }
+    }
+
+    /**
+     * @brief Records a removal under the next version.
+     * @param kind What was removed.
+     * @param studentID Student affected.
+     * @param classroomID Classroom affected, if any.
+     * @param assignmentID Assignment affected, if any.
+     */
+    void ChangeLog::addTombstone(TombstoneKind kind, unsigned studentID, unsigned classroomID, unsigned assignmentID) {
+        ++current;
+        // Until some export has a watermark, no one could ever be sent the removal.
+        if (!watermarks.empty()) {
+            tombstones.push_back({ current, kind, studentID, classroomID, assignmentID });
+        }
+    }
+
+    /**
+     * @brief Lists the students changed after a version, oldest change first.
+     * @param since Watermark; 0 lists every tracked student.
+     * @return The students.
+     */
+    std::vector<const Student*> ChangeLog::studentsChangedSince(ChangeVersion since) const {
+        std::vector<const Student*> result;
+        for (auto it = changedStudents.upper_bound(since); it != changedStudents.end(); ++it) {
+            result.push_back(it->second);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Lists the removals after a version, oldest first.
+     * @param since Watermark.
+     * @return The tombstones.
+     */
+    std::vector<Tombstone> ChangeLog::tombstonesSince(ChangeVersion since) const {
+        auto first = std::upper_bound(tombstones.begin(), tombstones.end(), since,
+            [](ChangeVersion version, const Tombstone& t) { return version < t.version; });
+        return std::vector<Tombstone>(first, tombstones.end());
+    }
+
+    /**
+     * @brief Gets how far an export has got.
+     * @param exportName Name of the export stream.
+     * @return The version it has exported through; 0 if it never has.
+     */
+    ChangeVersion ChangeLog::getWatermark(const std::string& exportName) const {
+        auto found = watermarks.find(exportName);
+        return found == watermarks.end() ? 0 : found->second;
+    }
+
+    /**
+     * @brief Records how far an export has got and drops tombstones no export still needs.
+     * @param exportName Name of the export stream.
+     * @param version Version it has now exported through.
+     */
+    void ChangeLog::setWatermark(const std::string& exportName, ChangeVersion version) {
+        watermarks[exportName] = version;
+        pruneTombstones();
+    }
+
+    /**
+     * @brief Gets every export's watermark.
+     * @return Export names and versions.
+     */
+    const std::map<std::string, ChangeVersion>& ChangeLog::getWatermarks() const {
+        return watermarks;
+    }
+
+    /**
+     * @brief Gets the tombstones still kept.
+     * @return Tombstones in version order.
+     */
+    const std::vector<Tombstone>& ChangeLog::getTombstones() const {
+        return tombstones;
+    }
+
+    /**
+     * @brief Drops tombstones that every export with a watermark has already passed.
+     *
+     * An export that has never run starts from a full snapshot and needs
+     * no tombstones, so only exports with a watermark hold them back.
+     */
+    void ChangeLog::pruneTombstones() {
+        ChangeVersion oldest = current;
+        for (const auto& [name, version] : watermarks) {
+            oldest = std::min(oldest, version);
+        }
+
+        auto keep = std::upper_bound(tombstones.begin(), tombstones.end(), oldest,
+            [](ChangeVersion version, const Tombstone& t) { return version < t.version; });
+        tombstones.erase(tombstones.begin(), keep);
+    }
+
+    /**
+     * @brief Replaces the log with one read from a file and re-tracks the loaded students.
+     * @param version Latest version issued when the file was saved.
+     * @param loadedTombstones Tombstones in version order.
+     * @param loadedWatermarks Export watermarks.
+     * @param students Loaded students, already pointing at this log.
+     */
+    void ChangeLog::restore(ChangeVersion version, std::vector<Tombstone> loadedTombstones,
+        std::map<std::string, ChangeVersion> loadedWatermarks,
+        const std::vector<std::unique_ptr<Student>>& students)
+    {
+        changedStudents.clear();
+        current = version;
+        tombstones = std::move(loadedTombstones);
+        watermarks = std::move(loadedWatermarks);
+
+        std::vector<Student*> unversioned;
+        for (const auto& student : students) {
+            ChangeVersion held = student->getChangeVersion();
+            current = std::max(current, held);
+            if (held == 0 || !changedStudents.emplace(held, student.get()).second) {
+                unversioned.push_back(student.get());
+            }
+        }
+        for (Student* student : unversioned) {
+            student->markChanged();
+        }
+    }
+
+    /**
+     * @brief Forgets everything, detaching every tracked student.
+     */
+    void ChangeLog::clear() {
+        for (auto& [version, student] : changedStudents) {
+            student->setChangeLog(nullptr);
+        }
+        changedStudents.clear();
+        tombstones.clear();
+        watermarks.clear();
+        current = 0;
+    }
+}
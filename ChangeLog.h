@@ -0,0 +1,150 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    class Student;
+
+    /**
+     * @brief Position in a gradebook's history of changes; every change takes the next one.
+     */
+    using ChangeVersion = unsigned long long;
+
+    /**
+     * @brief What a tombstone records the removal of.
+     */
+    enum class TombstoneKind : unsigned char {
+        StudentRemoved = 1,     /**< A student was deleted; every row about them is gone */
+        Withdrawn = 2,          /**< A student left a classroom, taking its scores */
+        ScoreErased = 3         /**< One score was erased */
+    };
+
+    /**
+     * @brief Marker left behind by a removal, so delta exports can tell consumers to delete rows.
+     */
+    struct Tombstone {
+        ChangeVersion version = 0;                          /**< Version the removal took */
+        TombstoneKind kind = TombstoneKind::StudentRemoved; /**< What was removed */
+        unsigned studentID = 0;                             /**< Student affected */
+        unsigned classroomID = 0;                           /**< Classroom affected; 0 for StudentRemoved */
+        unsigned assignmentID = 0;                          /**< Assignment affected; 0 unless ScoreErased */
+    };
+
+    /**
+     * @class ChangeLog
+     * @brief Issues change versions and remembers what changed after any version.
+     *
+     * Each student carries the version of their latest change and each
+     * score the version it was last set at. The log keeps students ordered
+     * by that version and removals as tombstones, so everything changed
+     * after a watermark is found without looking at anything older.
+     * Watermarks record how far each delta export has got; tombstones every
+     * export has passed are dropped.
+     */
+    class ChangeLog {
+    private:
+        ChangeVersion current = 0;                           /**< Latest version issued */
+        std::map<ChangeVersion, Student*> changedStudents;   /**< Each student under their latest version */
+        std::vector<Tombstone> tombstones;                   /**< Removals in version order */
+        std::map<std::string, ChangeVersion> watermarks;     /**< Export name to the version it has exported through */
+
+        /**
+         * @brief Drops tombstones that every export with a watermark has already passed.
+         */
+        void pruneTombstones();
+
+    public:
+        /**
+         * @brief Gets the latest version issued.
+         * @return The version; 0 if nothing has changed yet.
+         */
+        ChangeVersion getCurrentVersion() const;
+
+        /**
+         * @brief Records that a student changed and gives them the next version.
+         * @param student Student that changed.
+         * @param previous Version the student held until now; 0 if none.
+         * @return The student's new version.
+         */
+        ChangeVersion recordStudentChange(Student* student, ChangeVersion previous);
+
+        /**
+         * @brief Stops tracking a student, as when they are deleted.
+         * @param student Student to stop tracking.
+         * @param version Version the student held.
+         */
+        void forgetStudent(const Student* student, ChangeVersion version);
+
+        /**
+         * @brief Records a removal under the next version.
+         * @param kind What was removed.
+         * @param studentID Student affected.
+         * @param classroomID Classroom affected, if any.
+         * @param assignmentID Assignment affected, if any.
+         */
+        void addTombstone(TombstoneKind kind, unsigned studentID, unsigned classroomID = 0, unsigned assignmentID = 0);
+
+        /**
+         * @brief Lists the students changed after a version, oldest change first.
+         * @param since Watermark; 0 lists every tracked student.
+         * @return The students.
+         */
+        std::vector<const Student*> studentsChangedSince(ChangeVersion since) const;
+
+        /**
+         * @brief Lists the removals after a version, oldest first.
+         * @param since Watermark.
+         * @return The tombstones.
+         */
+        std::vector<Tombstone> tombstonesSince(ChangeVersion since) const;
+
+        /**
+         * @brief Gets how far an export has got.
+         * @param exportName Name of the export stream.
+         * @return The version it has exported through; 0 if it never has.
+         */
+        ChangeVersion getWatermark(const std::string& exportName) const;
+
+        /**
+         * @brief Records how far an export has got and drops tombstones no export still needs.
+         * @param exportName Name of the export stream.
+         * @param version Version it has now exported through.
+         */
+        void setWatermark(const std::string& exportName, ChangeVersion version);
+
+        /**
+         * @brief Gets every export's watermark.
+         * @return Export names and versions.
+         */
+        const std::map<std::string, ChangeVersion>& getWatermarks() const;
+
+        /**
+         * @brief Gets the tombstones still kept.
+         * @return Tombstones in version order.
+         */
+        const std::vector<Tombstone>& getTombstones() const;
+
+        /**
+         * @brief Replaces the log with one read from a file and re-tracks the loaded students.
+         *
+         * Students with no version yet (from files older than change
+         * tracking) are given one, so the first delta export includes them.
+         *
+         * @param version Latest version issued when the file was saved.
+         * @param loadedTombstones Tombstones in version order.
+         * @param loadedWatermarks Export watermarks.
+         * @param students Loaded students, already pointing at this log.
+         */
+        void restore(ChangeVersion version, std::vector<Tombstone> loadedTombstones,
+            std::map<std::string, ChangeVersion> loadedWatermarks,
+            const std::vector<std::unique_ptr<Student>>& students);
+
+        /**
+         * @brief Forgets everything, detaching every tracked student.
+         */
+        void clear();
+    };
+}
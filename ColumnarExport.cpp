@@ -0,0 +1,681 @@
+#include "ColumnarExport.h"
+#include "Gradebook.h"
+#include "Serialization.h"
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+
+namespace gradebook {
+
+    namespace {
+        /**
+         * @brief First four bytes of a columnar export ("GBCF"), repeated as the last four.
+         */
+        constexpr unsigned columnarMagic = 0x46434247;
+
+        /**
+         * @brief Columnar format version written by writeColumnarExport.
+         */
+        constexpr unsigned columnarVersion = 1;
+
+        /** Bytes before the first chunk: magic and version. */
+        constexpr size_t headerSize = 2 * sizeof(unsigned);
+
+        /** Bytes after the footer: footer offset, footer length, version and magic. */
+        constexpr size_t trailerSize = 2 * sizeof(unsigned long long) + 2 * sizeof(unsigned);
+
+        /** Rows per row group; each column of a group is encoded and written as one chunk. */
+        constexpr size_t rowsPerGroup = 65536;
+
+        /**
+         * @brief One row of the assignments table.
+         */
+        struct AssignmentRow {
+            const Teacher* teacher = nullptr;       /**< Classroom the assignment belongs to */
+            const Assignment* assignment = nullptr; /**< The assignment */
+        };
+
+        /**
+         * @brief One row of the enrollments table.
+         */
+        struct EnrollmentRow {
+            const Student* student = nullptr;       /**< Enrolled student */
+            const Enrollment* enrollment = nullptr; /**< The enrollment */
+        };
+
+        /**
+         * @brief One row of the scores table.
+         */
+        struct ScoreRow {
+            const Student* student = nullptr;       /**< Student who earned the score */
+            const Enrollment* enrollment = nullptr; /**< Classroom the score was earned in */
+            const AssignmentScore* score = nullptr; /**< The score */
+        };
+
+        /**
+         * @brief A column's name, type and how to read its value from a row.
+         * @tparam Row Row type of the table.
+         */
+        template <typename Row>
+        struct ColumnSpec {
+            ColumnInfo info;                                /**< Name and type */
+            std::function<unsigned(const Row&)> integer;    /**< Reads UInt32 and Char values */
+            std::function<float(const Row&)> real;          /**< Reads Float32 values */
+            std::function<std::string_view(const Row&)> text; /**< Reads String values; views must outlive the export */
+        };
+
+        template <typename Row>
+        ColumnSpec<Row> integerColumn(std::string name, std::function<unsigned(const Row&)> value) {
+            return { { std::move(name), ColumnType::UInt32 }, std::move(value), {}, {} };
+        }
+
+        template <typename Row>
+        ColumnSpec<Row> charColumn(std::string name, std::function<unsigned(const Row&)> value) {
+            return { { std::move(name), ColumnType::Char }, std::move(value), {}, {} };
+        }
+
+        template <typename Row>
+        ColumnSpec<Row> floatColumn(std::string name, std::function<float(const Row&)> value) {
+            return { { std::move(name), ColumnType::Float32 }, {}, std::move(value), {} };
+        }
+
+        template <typename Row>
+        ColumnSpec<Row> stringColumn(std::string name, std::function<std::string_view(const Row&)> value) {
+            return { { std::move(name), ColumnType::String }, {}, {}, std::move(value) };
+        }
+
+        /**
+         * @brief Appends a trivially copyable value to a byte string in native byte order.
+         * @tparam T Type of the value.
+         * @param bytes Destination.
+         * @param value The value to append.
+         */
+        template <typename T>
+        void appendRaw(std::string& bytes, const T& value) {
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        /**
+         * @brief Widens a chunk's min/max to include a value.
+         * @param info Chunk statistics.
+         * @param value The value.
+         */
+        void track(ColumnChunkInfo& info, double value) {
+            if (!info.hasStats) {
+                info.hasStats = true;
+                info.min = info.max = value;
+            }
+            else {
+                info.min = std::min(info.min, value);
+                info.max = std::max(info.max, value);
+            }
+        }
+
+        /**
+         * @brief Encodes one column of a row group.
+         *
+         * Strings are dictionary encoded per chunk: the distinct strings in
+         * first-seen order, each as a 4-byte length and its bytes, then one
+         * 4-byte dictionary index per row.
+         *
+         * @tparam Row Row type of the table.
+         * @param column Column to encode.
+         * @param rows Rows of the group.
+         * @param bytes Receives the chunk.
+         * @param info Receives the chunk's statistics.
+         */
+        template <typename Row>
+        void encodeChunk(const ColumnSpec<Row>& column, const std::vector<Row>& rows, std::string& bytes, ColumnChunkInfo& info) {
+            bytes.clear();
+            info = ColumnChunkInfo();
+
+            switch (column.info.type) {
+            case ColumnType::UInt32:
+                bytes.reserve(rows.size() * sizeof(unsigned));
+                for (const Row& row : rows) {
+                    unsigned value = column.integer(row);
+                    appendRaw(bytes, value);
+                    track(info, value);
+                }
+                break;
+            case ColumnType::Char:
+                bytes.reserve(rows.size());
+                for (const Row& row : rows) {
+                    unsigned char value = static_cast<unsigned char>(column.integer(row));
+                    bytes.push_back(static_cast<char>(value));
+                    track(info, value);
+                }
+                break;
+            case ColumnType::Float32:
+                bytes.reserve(rows.size() * sizeof(float));
+                for (const Row& row : rows) {
+                    float value = column.real(row);
+                    appendRaw(bytes, value);
+                    track(info, value);
+                }
+                break;
+            case ColumnType::String: {
+                std::unordered_map<std::string_view, unsigned> ids;
+                std::vector<std::string_view> dictionary;
+                std::vector<unsigned> indices;
+                indices.reserve(rows.size());
+                for (const Row& row : rows) {
+                    auto [entry, added] = ids.try_emplace(column.text(row), static_cast<unsigned>(dictionary.size()));
+                    if (added) {
+                        dictionary.push_back(entry->first);
+                    }
+                    indices.push_back(entry->second);
+                }
+
+                appendRaw(bytes, static_cast<unsigned>(dictionary.size()));
+                for (std::string_view text : dictionary) {
+                    appendRaw(bytes, static_cast<unsigned>(text.size()));
+                    bytes.append(text);
+                }
+                bytes.append(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(unsigned));
+                break;
+            }
+            }
+        }
+
+        /**
+         * @brief Streams tables into an open file a row group at a time.
+         */
+        class ColumnarWriter {
+        private:
+            std::ostream& out;                      /**< Destination */
+            unsigned long long offset = headerSize; /**< Offset of the next chunk */
+            std::string chunk;                      /**< Reused chunk buffer */
+
+        public:
+            std::vector<ColumnarTable> tables;      /**< Tables written so far */
+
+            explicit ColumnarWriter(std::ostream& destination)
+                : out(destination) {
+            }
+
+            /**
+             * @brief Gets the offset just past the last chunk.
+             * @return Byte offset.
+             */
+            unsigned long long position() const {
+                return offset;
+            }
+
+            /**
+             * @brief Writes one table.
+             * @tparam Row Row type of the table.
+             * @tparam Fill Callable taking (std::vector<Row>& group, size_t most) that appends the next rows, none once the table is done.
+             * @param name Table name.
+             * @param columns Columns in order.
+             * @param fill Produces the rows a group at a time.
+             */
+            template <typename Row, typename Fill>
+            void writeTable(std::string name, const std::vector<ColumnSpec<Row>>& columns, Fill fill) {
+                ColumnarTable table;
+                table.name = std::move(name);
+                for (const auto& column : columns) {
+                    table.columns.push_back(column.info);
+                }
+
+                std::vector<Row> group;
+                group.reserve(rowsPerGroup);
+                while (true) {
+                    group.clear();
+                    fill(group, rowsPerGroup);
+                    if (group.empty()) {
+                        break;
+                    }
+
+                    RowGroupInfo rowGroup;
+                    rowGroup.rows = group.size();
+                    rowGroup.chunks.resize(columns.size());
+                    for (size_t c = 0; c < columns.size(); ++c) {
+                        encodeChunk(columns[c], group, chunk, rowGroup.chunks[c]);
+                        rowGroup.chunks[c].offset = offset;
+                        rowGroup.chunks[c].length = chunk.size();
+                        out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                        offset += chunk.size();
+                    }
+
+                    table.rows += group.size();
+                    table.rowGroups.push_back(std::move(rowGroup));
+                }
+                tables.push_back(std::move(table));
+            }
+        };
+
+        /**
+         * @brief Encodes the footer: every table's schema, row groups and chunk statistics.
+         * @tparam Writer ByteSizer or ByteWriter.
+         * @param out Destination.
+         * @param tables Tables written.
+         */
+        template <typename Writer>
+        void encodeFooter(Writer& out, const std::vector<ColumnarTable>& tables) {
+            out.write(static_cast<unsigned>(tables.size()));
+            for (const auto& table : tables) {
+                out.writeString(table.name);
+                out.write(table.rows);
+                out.write(static_cast<unsigned>(table.columns.size()));
+                for (const auto& column : table.columns) {
+                    out.writeString(column.name);
+                    out.write(static_cast<unsigned char>(column.type));
+                }
+                out.write(static_cast<unsigned>(table.rowGroups.size()));
+                for (const auto& rowGroup : table.rowGroups) {
+                    out.write(rowGroup.rows);
+                    for (const auto& chunk : rowGroup.chunks) {
+                        out.write(chunk.offset);
+                        out.write(chunk.length);
+                        out.write(static_cast<unsigned char>(chunk.hasStats));
+                        out.write(chunk.min);
+                        out.write(chunk.max);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Writes every table of the school.
+         * @param gradebook School to export.
+         * @param writer Destination.
+         */
+        void writeTables(const Gradebook& gradebook, ColumnarWriter& writer) {
+            const auto& students = gradebook.getStudents();
+            const auto& teachers = gradebook.getTeachers();
+
+            using StudentRow = const Student*;
+            std::vector<ColumnSpec<StudentRow>> studentColumns = {
+                integerColumn<StudentRow>("id", [](const StudentRow& s) { return s->getID(); }),
+                stringColumn<StudentRow>("first_name", [](const StudentRow& s) { return s->getFirstNameView(); }),
+                stringColumn<StudentRow>("last_name", [](const StudentRow& s) { return s->getLastNameView(); }),
+                stringColumn<StudentRow>("pronouns", [](const StudentRow& s) { return s->getPronounsView(); }),
+                integerColumn<StudentRow>("age", [](const StudentRow& s) { return s->getAge(); }),
+                integerColumn<StudentRow>("grade_level", [](const StudentRow& s) { return s->getGradeLevel(); }),
+                stringColumn<StudentRow>("seat", [](const StudentRow& s) { return s->getSeatView(); }),
+                stringColumn<StudentRow>("notes", [](const StudentRow& s) { return s->getNotesView(); }),
+                floatColumn<StudentRow>("grade_percent", [](const StudentRow& s) { return s->getGradePercent(); }),
+                charColumn<StudentRow>("letter_grade", [](const StudentRow& s) { return static_cast<unsigned char>(s->getOverallGrade()); })
+            };
+            size_t nextStudent = 0;
+            writer.writeTable("students", studentColumns, [&](std::vector<StudentRow>& group, size_t most) {
+                for (; nextStudent < students.size() && group.size() < most; ++nextStudent) {
+                    group.push_back(students[nextStudent].get());
+                }
+                });
+
+            using ClassroomRow = const Teacher*;
+            std::vector<ColumnSpec<ClassroomRow>> classroomColumns = {
+                integerColumn<ClassroomRow>("classroom_id", [](const ClassroomRow& t) { return t->getClassroomID(); }),
+                stringColumn<ClassroomRow>("title", [](const ClassroomRow& t) { return t->getTitleView(); }),
+                stringColumn<ClassroomRow>("first_name", [](const ClassroomRow& t) { return t->getFirstNameView(); }),
+                stringColumn<ClassroomRow>("last_name", [](const ClassroomRow& t) { return t->getLastNameView(); }),
+                integerColumn<ClassroomRow>("grade_level", [](const ClassroomRow& t) { return t->getGradeLevel(); })
+            };
+            size_t nextTeacher = 0;
+            writer.writeTable("classrooms", classroomColumns, [&](std::vector<ClassroomRow>& group, size_t most) {
+                for (; nextTeacher < teachers.size() && group.size() < most; ++nextTeacher) {
+                    group.push_back(&teachers[nextTeacher]);
+                }
+                });
+
+            std::vector<ColumnSpec<AssignmentRow>> assignmentColumns = {
+                integerColumn<AssignmentRow>("classroom_id", [](const AssignmentRow& a) { return a.teacher->getClassroomID(); }),
+                integerColumn<AssignmentRow>("assignment_id", [](const AssignmentRow& a) { return a.assignment->getAssignmentID(); }),
+                stringColumn<AssignmentRow>("name", [](const AssignmentRow& a) { return a.assignment->getAssignmentNameView(); }),
+                stringColumn<AssignmentRow>("description", [](const AssignmentRow& a) { return a.assignment->getAssignmentDescriptionView(); }),
+                floatColumn<AssignmentRow>("points_possible", [](const AssignmentRow& a) { return a.assignment->getPointsPossible(); })
+            };
+            size_t teacherCursor = 0;
+            size_t assignmentCursor = 0;
+            writer.writeTable("assignments", assignmentColumns, [&](std::vector<AssignmentRow>& group, size_t most) {
+                while (teacherCursor < teachers.size() && group.size() < most) {
+                    const auto& assignments = teachers[teacherCursor].getAssignments();
+                    if (assignmentCursor < assignments.size()) {
+                        group.push_back({ &teachers[teacherCursor], &assignments[assignmentCursor++] });
+                    }
+                    else {
+                        ++teacherCursor;
+                        assignmentCursor = 0;
+                    }
+                }
+                });
+
+            std::vector<ColumnSpec<EnrollmentRow>> enrollmentColumns = {
+                integerColumn<EnrollmentRow>("student_id", [](const EnrollmentRow& e) { return e.student->getID(); }),
+                integerColumn<EnrollmentRow>("classroom_id", [](const EnrollmentRow& e) { return e.enrollment->classroomID; }),
+                floatColumn<EnrollmentRow>("grade_percent", [](const EnrollmentRow& e) { return e.enrollment->gradePercent; }),
+                charColumn<EnrollmentRow>("letter_grade", [](const EnrollmentRow& e) { return static_cast<unsigned char>(e.enrollment->letterGrade); })
+            };
+            size_t studentCursor = 0;
+            size_t enrollmentCursor = 0;
+            writer.writeTable("enrollments", enrollmentColumns, [&](std::vector<EnrollmentRow>& group, size_t most) {
+                while (studentCursor < students.size() && group.size() < most) {
+                    const auto& enrollments = students[studentCursor]->getEnrollments();
+                    if (enrollmentCursor < enrollments.size()) {
+                        group.push_back({ students[studentCursor].get(), &enrollments[enrollmentCursor++] });
+                    }
+                    else {
+                        ++studentCursor;
+                        enrollmentCursor = 0;
+                    }
+                }
+                });
+
+            std::vector<ColumnSpec<ScoreRow>> scoreColumns = {
+                integerColumn<ScoreRow>("student_id", [](const ScoreRow& s) { return s.student->getID(); }),
+                integerColumn<ScoreRow>("classroom_id", [](const ScoreRow& s) { return s.enrollment->classroomID; }),
+                integerColumn<ScoreRow>("assignment_id", [](const ScoreRow& s) { return s.score->assignmentID; }),
+                floatColumn<ScoreRow>("score", [](const ScoreRow& s) { return s.score->score; })
+            };
+            studentCursor = 0;
+            enrollmentCursor = 0;
+            size_t scoreCursor = 0;
+            writer.writeTable("scores", scoreColumns, [&](std::vector<ScoreRow>& group, size_t most) {
+                while (studentCursor < students.size() && group.size() < most) {
+                    const auto& enrollments = students[studentCursor]->getEnrollments();
+                    if (enrollmentCursor >= enrollments.size()) {
+                        ++studentCursor;
+                        enrollmentCursor = 0;
+                        scoreCursor = 0;
+                        continue;
+                    }
+                    const Enrollment& enrollment = enrollments[enrollmentCursor];
+                    if (scoreCursor >= enrollment.scores.size()) {
+                        ++enrollmentCursor;
+                        scoreCursor = 0;
+                        continue;
+                    }
+                    group.push_back({ students[studentCursor].get(), &enrollment, &enrollment.scores[scoreCursor++] });
+                }
+                });
+        }
+    }
+
+    /**
+     * @brief Writes students, classrooms, assignments, enrollments and scores into one columnar file.
+     * @param gradebook School to export.
+     * @param filename File to create or replace.
+     * @param tables Receives the tables written.
+     * @return True if the file is in place.
+     */
+    bool writeColumnarExport(const Gradebook& gradebook, const std::string& filename, std::vector<ColumnarTable>& tables) {
+        tables.clear();
+
+        std::string temporary = filename + ".tmp";
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Failed to open file " << temporary << " for writing." << std::endl;
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&columnarMagic), sizeof(columnarMagic));
+        out.write(reinterpret_cast<const char*>(&columnarVersion), sizeof(columnarVersion));
+
+        ColumnarWriter writer(out);
+        writeTables(gradebook, writer);
+
+        ByteSizer sizer;
+        encodeFooter(sizer, writer.tables);
+        std::vector<char> footer(sizer.size());
+        ByteWriter footerWriter(footer.data(), footer.size());
+        encodeFooter(footerWriter, writer.tables);
+
+        unsigned long long footerOffset = writer.position();
+        unsigned long long footerLength = footer.size();
+        out.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+        out.write(reinterpret_cast<const char*>(&footerOffset), sizeof(footerOffset));
+        out.write(reinterpret_cast<const char*>(&footerLength), sizeof(footerLength));
+        out.write(reinterpret_cast<const char*>(&columnarVersion), sizeof(columnarVersion));
+        out.write(reinterpret_cast<const char*>(&columnarMagic), sizeof(columnarMagic));
+
+        out.close();
+        if (out.fail()) {
+            std::cerr << "Failed to write " << temporary << "." << std::endl;
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, filename, error);
+        if (error) {
+            std::cerr << "Failed to replace " << filename << ": " << error.message() << std::endl;
+            return false;
+        }
+
+        tables = std::move(writer.tables);
+        return true;
+    }
+
+    /**
+     * @brief Opens a file and reads its trailer and footer.
+     * @param path Path of the file.
+     * @return False if the file is missing or is not a complete columnar export; a message has been printed.
+     */
+    bool ColumnarFile::open(const std::string& path) {
+        filename = path;
+        tables.clear();
+        if (file.is_open()) {
+            file.close();
+        }
+
+        file.open(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << filename << " was not found." << std::endl;
+            return false;
+        }
+
+        try {
+            file.seekg(0, std::ios::end);
+            unsigned long long fileSize = static_cast<unsigned long long>(file.tellg());
+            if (!file || fileSize < headerSize + trailerSize) {
+                throw std::runtime_error("too short to be a columnar export");
+            }
+
+            char header[headerSize];
+            file.seekg(0);
+            file.read(header, headerSize);
+            char trailer[trailerSize];
+            file.seekg(static_cast<std::streamoff>(fileSize - trailerSize));
+            file.read(trailer, trailerSize);
+            if (!file) {
+                throw std::runtime_error("could not be read");
+            }
+
+            ByteReader head(header, headerSize);
+            ByteReader tail(trailer, trailerSize);
+            unsigned long long footerOffset = tail.read<unsigned long long>();
+            unsigned long long footerLength = tail.read<unsigned long long>();
+            unsigned version = tail.read<unsigned>();
+            if (head.read<unsigned>() != columnarMagic || tail.read<unsigned>() != columnarMagic) {
+                throw std::runtime_error("not a columnar export");
+            }
+            if (head.read<unsigned>() != version || version > columnarVersion) {
+                throw std::runtime_error("written by a newer version (format " + std::to_string(version) + ")");
+            }
+            if (footerOffset < headerSize || footerLength > fileSize - trailerSize - footerOffset
+                || footerOffset + footerLength + trailerSize != fileSize) {
+                throw std::runtime_error("footer does not match the file size");
+            }
+
+            std::vector<char> footer(static_cast<size_t>(footerLength));
+            file.seekg(static_cast<std::streamoff>(footerOffset));
+            file.read(footer.data(), static_cast<std::streamsize>(footer.size()));
+            if (!file) {
+                throw std::runtime_error("footer could not be read");
+            }
+
+            ByteReader reader(footer.data(), footer.size());
+            unsigned tableCount = reader.read<unsigned>();
+            for (unsigned t = 0; t < tableCount; ++t) {
+                ColumnarTable table;
+                table.name = reader.readString();
+                table.rows = reader.read<unsigned long long>();
+
+                unsigned columnCount = reader.read<unsigned>();
+                for (unsigned c = 0; c < columnCount; ++c) {
+                    ColumnInfo column;
+                    column.name = reader.readString();
+                    unsigned char type = reader.read<unsigned char>();
+                    if (type < static_cast<unsigned char>(ColumnType::UInt32) || type > static_cast<unsigned char>(ColumnType::String)) {
+                        throw std::runtime_error("column " + table.name + "." + column.name + " has an unknown type");
+                    }
+                    column.type = static_cast<ColumnType>(type);
+                    table.columns.push_back(std::move(column));
+                }
+
+                unsigned long long rows = 0;
+                unsigned groupCount = reader.read<unsigned>();
+                for (unsigned g = 0; g < groupCount; ++g) {
+                    RowGroupInfo rowGroup;
+                    rowGroup.rows = reader.read<unsigned long long>();
+                    rows += rowGroup.rows;
+                    rowGroup.chunks.resize(columnCount);
+                    for (auto& chunk : rowGroup.chunks) {
+                        chunk.offset = reader.read<unsigned long long>();
+                        chunk.length = reader.read<unsigned long long>();
+                        chunk.hasStats = reader.read<unsigned char>() != 0;
+                        chunk.min = reader.read<double>();
+                        chunk.max = reader.read<double>();
+                        if (chunk.offset < headerSize || chunk.length > footerOffset - chunk.offset) {
+                            throw std::runtime_error("a chunk of " + table.name + " lies outside the file");
+                        }
+                    }
+                    table.rowGroups.push_back(std::move(rowGroup));
+                }
+                if (rows != table.rows) {
+                    throw std::runtime_error("row groups of " + table.name + " do not add up to its row count");
+                }
+                tables.push_back(std::move(table));
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << filename << " is damaged and was not opened: " << e.what() << "\n";
+            tables.clear();
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Gets the tables in the file.
+     * @return Schemas and row groups.
+     */
+    const std::vector<ColumnarTable>& ColumnarFile::getTables() const {
+        return tables;
+    }
+
+    /**
+     * @brief Finds a table by name.
+     * @param name Table name.
+     * @return The table, or nullptr if the file has none by that name.
+     */
+    const ColumnarTable* ColumnarFile::findTable(const std::string& name) const {
+        auto found = std::find_if(tables.begin(), tables.end(),
+            [&name](const ColumnarTable& table) { return table.name == name; });
+        return found == tables.end() ? nullptr : &*found;
+    }
+
+    /**
+     * @brief Reads every value of one column, a chunk at a time.
+     * @param table Table name.
+     * @param column Column name.
+     * @param values Receives the values in row order.
+     * @return False if there is no such column or it could not be read; a message has been printed.
+     */
+    bool ColumnarFile::readColumn(const std::string& table, const std::string& column, ColumnValues& values) const {
+        values = ColumnValues();
+
+        const ColumnarTable* found = findTable(table);
+        if (!found) {
+            std::cerr << filename << " has no table named " << table << ".\n";
+            return false;
+        }
+        auto columnInfo = std::find_if(found->columns.begin(), found->columns.end(),
+            [&column](const ColumnInfo& info) { return info.name == column; });
+        if (columnInfo == found->columns.end()) {
+            std::cerr << table << " has no column named " << column << ".\n";
+            return false;
+        }
+
+        size_t index = static_cast<size_t>(columnInfo - found->columns.begin());
+        for (const auto& rowGroup : found->rowGroups) {
+            if (!readChunk(columnInfo->type, rowGroup.chunks[index], rowGroup.rows, values)) {
+                std::cerr << "Failed to read " << table << "." << column << " from " << filename << ".\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Decodes one chunk and appends its values.
+     * @param type Column type.
+     * @param info Chunk position.
+     * @param rows Rows in the chunk.
+     * @param values Receives the values.
+     * @return False if the chunk could not be read or is malformed.
+     */
+    bool ColumnarFile::readChunk(ColumnType type, const ColumnChunkInfo& info, unsigned long long rows, ColumnValues& values) const {
+        std::vector<char> bytes(static_cast<size_t>(info.length));
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(info.offset));
+        file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            return false;
+        }
+
+        try {
+            ByteReader reader(bytes.data(), bytes.size());
+            switch (type) {
+            case ColumnType::UInt32:
+                for (unsigned long long r = 0; r < rows; ++r) {
+                    values.integers.push_back(reader.read<unsigned>());
+                }
+                break;
+            case ColumnType::Char:
+                for (unsigned long long r = 0; r < rows; ++r) {
+                    values.integers.push_back(reader.read<unsigned char>());
+                }
+                break;
+            case ColumnType::Float32:
+                for (unsigned long long r = 0; r < rows; ++r) {
+                    values.floats.push_back(reader.read<float>());
+                }
+                break;
+            case ColumnType::String: {
+                unsigned entries = reader.read<unsigned>();
+                if (entries > reader.remaining() / sizeof(unsigned)) {
+                    return false;
+                }
+                std::vector<std::string> dictionary(entries);
+                for (auto& text : dictionary) {
+                    unsigned length = reader.read<unsigned>();
+                    if (length > reader.remaining()) {
+                        return false;
+                    }
+                    text.assign(bytes.data() + reader.position(), length);
+                    reader.skip(length);
+                }
+                for (unsigned long long r = 0; r < rows; ++r) {
+                    unsigned id = reader.read<unsigned>();
+                    if (id >= dictionary.size()) {
+                        return false;
+                    }
+                    values.strings.push_back(dictionary[id]);
+                }
+                break;
+            }
+            }
+            return reader.remaining() == 0;
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
+}
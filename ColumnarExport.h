@@ -0,0 +1,140 @@
+#pragma once
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    class Gradebook;
+
+    /**
+     * @brief How a column's values are stored.
+     */
+    enum class ColumnType : unsigned char {
+        UInt32 = 1,     /**< 4-byte unsigned integers */
+        Float32 = 2,    /**< 4-byte floats */
+        Char = 3,       /**< 1-byte characters, such as letter grades; 0 when unset */
+        String = 4      /**< Dictionary-encoded text: each chunk holds its distinct strings, then a 4-byte index per row */
+    };
+
+    /**
+     * @brief Where one column's values for one row group sit, and their range.
+     */
+    struct ColumnChunkInfo {
+        unsigned long long offset = 0;  /**< Byte offset of the chunk from the start of the file */
+        unsigned long long length = 0;  /**< Chunk length in bytes */
+        bool hasStats = false;          /**< True for non-empty numeric and character chunks */
+        double min = 0.0;               /**< Smallest value in the chunk */
+        double max = 0.0;               /**< Largest value in the chunk */
+    };
+
+    /**
+     * @brief A run of consecutive rows stored together, one chunk per column.
+     */
+    struct RowGroupInfo {
+        unsigned long long rows = 0;            /**< Rows in the group */
+        std::vector<ColumnChunkInfo> chunks;    /**< One chunk per column, in column order */
+    };
+
+    /**
+     * @brief Name and type of one column.
+     */
+    struct ColumnInfo {
+        std::string name;                       /**< Column name */
+        ColumnType type = ColumnType::UInt32;   /**< How values are stored */
+    };
+
+    /**
+     * @brief Schema and row groups of one table.
+     */
+    struct ColumnarTable {
+        std::string name;                       /**< Table name */
+        unsigned long long rows = 0;            /**< Rows across every group */
+        std::vector<ColumnInfo> columns;        /**< Columns in order */
+        std::vector<RowGroupInfo> rowGroups;    /**< Row groups in row order */
+    };
+
+    /**
+     * @brief Values of one column read back from a columnar file.
+     *
+     * Only the vector matching the column's type is filled: UInt32 and Char
+     * columns fill integers, Float32 fills floats and String fills strings.
+     */
+    struct ColumnValues {
+        std::vector<unsigned> integers;     /**< UInt32 and Char values */
+        std::vector<float> floats;          /**< Float32 values */
+        std::vector<std::string> strings;   /**< String values */
+    };
+
+    /**
+     * @brief Writes students, classrooms, assignments, enrollments and scores into one columnar file.
+     *
+     * Each table is written a row group at a time: the group's rows are
+     * gathered as pointers into the school, then each column is encoded
+     * straight from them into one chunk. The schema, every chunk's position
+     * and each numeric chunk's min/max follow the data in a footer, so
+     * readers can skip groups and columns they do not need. The file is
+     * written beside the target and renamed over it once complete.
+     *
+     * @param gradebook School to export.
+     * @param filename File to create or replace.
+     * @param tables Receives the tables written.
+     * @return True if the file is in place.
+     */
+    bool writeColumnarExport(const Gradebook& gradebook, const std::string& filename, std::vector<ColumnarTable>& tables);
+
+    /**
+     * @class ColumnarFile
+     * @brief Reads the schema of a columnar export and any of its columns.
+     *
+     * Opening reads only the trailer and the footer; each column chunk is
+     * then one seek and one read. A ColumnarFile must not be shared between
+     * threads.
+     */
+    class ColumnarFile {
+    private:
+        std::string filename;               /**< File being read */
+        mutable std::ifstream file;         /**< Open file; moved by every read */
+        std::vector<ColumnarTable> tables;  /**< Footer contents */
+
+        /**
+         * @brief Decodes one chunk and appends its values.
+         * @param type Column type.
+         * @param info Chunk position.
+         * @param rows Rows in the chunk.
+         * @param values Receives the values.
+         * @return False if the chunk could not be read or is malformed.
+         */
+        bool readChunk(ColumnType type, const ColumnChunkInfo& info, unsigned long long rows, ColumnValues& values) const;
+
+    public:
+        /**
+         * @brief Opens a file and reads its footer.
+         * @param path Path of the file.
+         * @return False if the file is missing or is not a complete columnar export; a message has been printed.
+         */
+        bool open(const std::string& path);
+
+        /**
+         * @brief Gets the tables in the file.
+         * @return Schemas and row groups.
+         */
+        const std::vector<ColumnarTable>& getTables() const;
+
+        /**
+         * @brief Finds a table by name.
+         * @param name Table name.
+         * @return The table, or nullptr if the file has none by that name.
+         */
+        const ColumnarTable* findTable(const std::string& name) const;
+
+        /**
+         * @brief Reads every value of one column.
+         * @param table Table name.
+         * @param column Column name.
+         * @param values Receives the values in row order.
+         * @return False if there is no such column or it could not be read; a message has been printed.
+         */
+        bool readColumn(const std::string& table, const std::string& column, ColumnValues& values) const;
+    };
+}
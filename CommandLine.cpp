@@ -0,0 +1,260 @@
+#include "CommandLine.h"
+#include "ChangeExport.h"
+#include "ColumnarExport.h"
+#include "Gradebook.h"
+#include "Integrity.h"
+#include "Merge.h"
+#include "Query.h"
+#include "ReportArchive.h"
+#include "ReportSink.h"
+#include "utilities.h"
+#include <iostream>
+#include <memory>
+
+namespace gradebook {
+
+    namespace {
+        /**
+         * @brief Prints the accepted arguments.
+         */
+        void printUsage() {
+            std::cerr << "Usage:\n"
+                << "  gradebook [--file school.dat]                  open the school's menus\n"
+                << "  gradebook --district                           open the district menu\n"
+                << "  gradebook [--file school.dat] --query \"...\" [--csv out.csv] [--explain]\n"
+                << "                                                 run a query and exit\n"
+                << "  gradebook [--file school.dat] --search \"...\" [--limit N] [--csv out.csv]\n"
+                << "                                                 search notes and descriptions and exit\n"
+                << "  gradebook [--file school.dat] --export-cards cards.gbra\n"
+                << "                                                 write every report card into one archive and exit\n"
+                << "  gradebook [--file school.dat] --export-columnar school.gbc\n"
+                << "                                                 write the school's data as typed columns for analytics and exit\n"
+                << "  gradebook [--file school.dat] --export-changes\n"
+                << "                                                 write the school report rows changed since the last run and exit\n"
+                << "  gradebook [--file school.dat] --merge other.dat [--base original.dat]\n"
+                << "                                                 merge another copy into this one and exit; exits 3 if conflicts were kept\n"
+                << "  gradebook [--file school.dat] --verify         check the file's checksums and list damaged records; exits 4 if any\n"
+                << "  gradebook [--file school.dat] --repair         rebuild the file from its intact records, keeping the original as .bak\n"
+                << "Add --compress to gzip CSV exports; a --csv or --file name ending in .gz is always compressed.\n"
+                << "Query example: grade = 5 and assignment.percent < 70 and assignment.points > 50\n";
+        }
+    }
+
+    /**
+     * @brief Reads the command line into options.
+     * @param argc Number of command-line arguments.
+     * @param argv Command-line arguments.
+     * @param options Receives the options.
+     * @return False if an argument was not understood; a usage message has been printed.
+     */
+    bool parseCommandLine(int argc, char* argv[], CommandLineOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--district") {
+                options.district = true;
+            }
+            else if (arg == "--explain") {
+                options.explain = true;
+            }
+            else if (arg == "--compress") {
+                options.compress = true;
+            }
+            else if (arg == "--file" && hasValue) {
+                options.dataFile = argv[++i];
+            }
+            else if (arg == "--query" && hasValue) {
+                options.query = argv[++i];
+            }
+            else if (arg == "--search" && hasValue) {
+                options.search = argv[++i];
+            }
+            else if (arg == "--limit" && hasValue) {
+                try {
+                    options.limit = static_cast<unsigned>(std::stoul(argv[++i]));
+                }
+                catch (const std::exception&) {
+                    std::cerr << "--limit needs a number.\n";
+                    return false;
+                }
+            }
+            else if (arg == "--export-cards" && hasValue) {
+                options.exportCards = argv[++i];
+            }
+            else if (arg == "--export-columnar" && hasValue) {
+                options.exportColumnar = argv[++i];
+            }
+            else if (arg == "--export-changes") {
+                options.exportChanges = true;
+            }
+            else if (arg == "--verify") {
+                options.verify = true;
+            }
+            else if (arg == "--repair") {
+                options.repair = true;
+            }
+            else if (arg == "--merge" && hasValue) {
+                options.merge = argv[++i];
+            }
+            else if (arg == "--base" && hasValue) {
+                options.base = argv[++i];
+            }
+            else if (arg == "--csv" && hasValue) {
+                options.csvFile = argv[++i];
+            }
+            else {
+                std::cerr << "Unrecognized argument: " << arg << "\n";
+                printUsage();
+                return false;
+            }
+        }
+
+        int headlessTasks = !options.query.empty() + !options.search.empty() + !options.exportCards.empty()
+            + !options.exportColumnar.empty() + options.exportChanges + !options.merge.empty() + options.verify + options.repair;
+        if (headlessTasks > 1) {
+            std::cerr << "Only one of --query, --search, --export-cards, --export-columnar, --export-changes, --merge, --verify and --repair can be given.\n";
+            printUsage();
+            return false;
+        }
+        if (!options.base.empty() && options.merge.empty()) {
+            std::cerr << "--base needs a --merge to go with.\n";
+            printUsage();
+            return false;
+        }
+        if (!options.csvFile.empty() && options.query.empty() && options.search.empty()) {
+            std::cerr << "--csv needs a --query or --search to export.\n";
+            printUsage();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the options ask for a headless run with no menus.
+     * @param options Parsed options.
+     * @return True if runHeadless should handle this run.
+     */
+    bool isHeadless(const CommandLineOptions& options) {
+        return !options.query.empty() || !options.search.empty() || !options.exportCards.empty()
+            || !options.exportColumnar.empty() || options.exportChanges || !options.merge.empty()
+            || options.verify || options.repair;
+    }
+
+    /**
+     * @brief Loads the school and performs the requested headless work.
+     *
+     * Errors go to std::cerr and produce a non-zero exit code, so scripts
+     * can tell a failed run from one that simply matched nothing.
+     *
+     * @param options Parsed options.
+     * @return Process exit code: 0 on success.
+     */
+    int runHeadless(const CommandLineOptions& options) {
+        std::optional<StudentQuery> query;
+        if (!options.query.empty()) {
+            std::string error;
+            query = parseQuery(options.query, error);
+            if (!query) {
+                std::cerr << "Invalid query: " << error << "\n";
+                return 2;
+            }
+        }
+
+        if (!fileExists(options.dataFile)) {
+            std::cerr << options.dataFile << " was not found.\n";
+            return 1;
+        }
+
+        // A damaged file would not load, so these work on the file itself.
+        if (options.verify || options.repair) {
+            IntegrityReport report;
+            bool done = options.repair ? repairDataFile(options.dataFile, report) : verifyDataFile(options.dataFile, report);
+            printIntegrityReport(report);
+            if (!done) {
+                return 1;
+            }
+            return options.verify && !report.problems.empty() ? 4 : 0;
+        }
+
+        Gradebook gradebook;
+        gradebook.setDataFile(options.dataFile);
+        gradebook.shareDataFile(false);
+        if (!gradebook.deserializeAndLoad()) {
+            return 1;
+        }
+
+        if (!options.exportCards.empty()) {
+            size_t cards = 0;
+            if (!writeReportCardArchive(gradebook, options.exportCards, cards)) {
+                return 1;
+            }
+            std::cout << cards << " report card(s) exported to " << options.exportCards << "." << std::endl;
+            return 0;
+        }
+
+        if (!options.exportColumnar.empty()) {
+            std::vector<ColumnarTable> tables;
+            if (!writeColumnarExport(gradebook, options.exportColumnar, tables)) {
+                return 1;
+            }
+            for (const auto& table : tables) {
+                std::cout << table.name << ": " << table.rows << " row(s)\n";
+            }
+            std::cout << "Exported to " << options.exportColumnar << "." << std::endl;
+            return 0;
+        }
+
+        if (options.exportChanges) {
+            ChangeExportResult result;
+            if (!exportSchoolReportChanges(gradebook, result)) {
+                return 1;
+            }
+            if (result.filename.empty()) {
+                std::cout << "Nothing has changed since version " << result.since << "." << std::endl;
+                return 0;
+            }
+            // The moved watermark is part of the school's data.
+            gradebook.serializeAndSave();
+            std::cout << result.upserts << " upsert(s) and " << result.deletes << " delete(s) through version "
+                << result.through << " exported to " << result.filename << "." << std::endl;
+            return 0;
+        }
+
+        if (!options.merge.empty()) {
+            MergeResult result;
+            if (!mergeGradebookFiles(gradebook, options.merge, options.base, result)) {
+                return 1;
+            }
+            printMergeResult(result);
+            if (result.changesApplied > 0) {
+                gradebook.serializeAndSave();
+            }
+            return result.conflicts.empty() ? 0 : 3;
+        }
+
+        std::unique_ptr<ReportSink> sink;
+        if (options.csvFile.empty()) {
+            sink = std::make_unique<ConsoleSink>();
+        }
+        else {
+            auto csv = std::make_unique<CsvSink>(options.csvFile);
+            if (!csv->isOpen()) {
+                return 1;
+            }
+            sink = std::move(csv);
+        }
+
+        if (!query) {
+            runTextSearch(gradebook, options.search, options.limit, *sink);
+            return 0;
+        }
+
+        QueryPlan plan = planQuery(*query);
+        if (options.explain) {
+            std::cout << explainPlan(plan);
+        }
+        runQuery(gradebook, plan, *sink);
+        return 0;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+
+namespace gradebook {
+
+    /**
+     * @brief Options given on the command line.
+     */
+    struct CommandLineOptions {
+        bool district = false;                  /**< --district: run the district menu */
+        std::string dataFile = "gradebook.dat"; /**< --file: school data file to open */
+        std::string query;                      /**< --query: run this query headless and exit */
+        std::string search;                     /**< --search: search notes and descriptions headless and exit */
+        unsigned limit = 50;                    /**< --limit: most search results to show */
+        std::string csvFile;                    /**< --csv: write headless results here instead of the console */
+        bool explain = false;                   /**< --explain: print the query plan first */
+        std::string exportCards;                /**< --export-cards: write every report card into this archive and exit */
+        std::string exportColumnar;             /**< --export-columnar: write the school's data into this columnar file and exit */
+        bool exportChanges = false;             /**< --export-changes: write the school report rows changed since the last such export and exit */
+        std::string merge;                      /**< --merge: merge this copy of the school into --file and exit */
+        std::string base;                       /**< --base: copy both --merge inputs were made from */
+        bool compress = false;                  /**< --compress: gzip every CSV export written under a fixed name */
+        bool verify = false;                    /**< --verify: check every checksum in --file, list the damaged records and exit */
+        bool repair = false;                    /**< --repair: rebuild --file from its intact records and exit */
+    };
+
+    /**
+     * @brief Reads the command line into options.
+     * @param argc Number of command-line arguments.
+     * @param argv Command-line arguments.
+     * @param options Receives the options.
+     * @return False if an argument was not understood; a usage message has been printed.
+     */
+    bool parseCommandLine(int argc, char* argv[], CommandLineOptions& options);
+
+    /**
+     * @brief Checks whether the options ask for a headless run with no menus.
+     * @param options Parsed options.
+     * @return True if runHeadless should handle this run.
+     */
+    bool isHeadless(const CommandLineOptions& options);
+
+    /**
+     * @brief Loads the school and performs the requested headless work.
+     * @param options Parsed options.
+     * @return Process exit code: 0 on success.
+     */
+    int runHeadless(const CommandLineOptions& options);
+}
@@ -0,0 +1,1237 @@
+#include "Compression.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+
+namespace gradebook {
+
+    namespace {
+        /** Most bytes a deflate match may reach back. */
+        constexpr size_t windowSize = 32768;
+
+        /** Bytes per slice deflated on its own; also the export pipeline's buffer size. */
+        constexpr size_t sliceSize = size_t{ 1 } << 20;
+
+        /** Tokens per deflate block; each block gets its own Huffman codes. */
+        constexpr size_t tokensPerBlock = 16384;
+
+        /** Candidates checked per position when looking for a match. */
+        constexpr unsigned maxChainLength = 48;
+
+        /** A match this long is taken without looking for a longer one. */
+        constexpr unsigned niceLength = 128;
+
+        constexpr unsigned minMatch = 3;
+        constexpr unsigned maxMatch = 258;
+        constexpr unsigned hashBits = 15;
+
+        /** Bytes of the fixed gzip header written: magic, method, flags, time, extra flags, OS. */
+        constexpr unsigned char gzipHeader[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 255 };
+
+        constexpr unsigned short lengthBase[29] = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        constexpr unsigned char lengthExtra[29] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        constexpr unsigned short distanceBase[30] = {
+            1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        constexpr unsigned char distanceExtra[30] = {
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        /** Order code-length code lengths are stored in a dynamic block header. */
+        constexpr unsigned char codeLengthOrder[19] = {
+            16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+        /**
+         * @brief Lookup tables shared by every encoder and decoder.
+         */
+        struct DeflateTables {
+            std::array<std::array<unsigned, 256>, 8> crc{}; /**< CRC-32 of each byte value, then of it followed by 1-7 zero bytes */
+            std::array<unsigned char, maxMatch + 1> lengthCode{};   /**< Length to its code index 0-28 */
+            std::array<unsigned char, 512> distanceCode{};  /**< Distance to its code index; see distanceCodeOf */
+            std::array<unsigned char, 288> fixedLiteralLengths{};   /**< Code lengths of the fixed literal/length code */
+            std::array<unsigned char, 30> fixedDistanceLengths{};   /**< Code lengths of the fixed distance code */
+
+            DeflateTables() {
+                for (unsigned n = 0; n < 256; ++n) {
+                    unsigned c = n;
+                    for (int k = 0; k < 8; ++k) {
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    }
+                    crc[0][n] = c;
+                }
+                for (unsigned n = 0; n < 256; ++n) {
+                    for (size_t k = 1; k < crc.size(); ++k) {
+                        crc[k][n] = (crc[k - 1][n] >> 8) ^ crc[0][crc[k - 1][n] & 0xFF];
+                    }
+                }
+                for (unsigned code = 0; code < 29; ++code) {
+                    unsigned last = code == 28 ? maxMatch : lengthBase[code] + (1u << lengthExtra[code]) - 1;
+                    for (unsigned length = lengthBase[code]; length <= last && length <= maxMatch; ++length) {
+                        lengthCode[length] = static_cast<unsigned char>(code);
+                    }
+                }
+                // Distances up to 256 index directly; longer ones by (distance - 1) >> 7, offset by 256.
+                for (unsigned code = 0; code < 30; ++code) {
+                    unsigned first = distanceBase[code];
+                    unsigned last = first + (1u << distanceExtra[code]) - 1;
+                    for (unsigned d = first; d <= last; ++d) {
+                        if (d <= 256) distanceCode[d - 1] = static_cast<unsigned char>(code);
+                        else distanceCode[256 + ((d - 1) >> 7)] = static_cast<unsigned char>(code);
+                    }
+                }
+                for (unsigned s = 0; s < 288; ++s) {
+                    fixedLiteralLengths[s] = static_cast<unsigned char>(s < 144 ? 8 : s < 256 ? 9 : s < 280 ? 7 : 8);
+                }
+                fixedDistanceLengths.fill(5);
+            }
+
+            unsigned distanceCodeOf(unsigned distance) const {
+                return distance <= 256 ? distanceCode[distance - 1] : distanceCode[256 + ((distance - 1) >> 7)];
+            }
+        };
+
+        const DeflateTables& tables() {
+            static const DeflateTables instance;
+            return instance;
+        }
+
+        /**
+         * @brief Reverses the low bits of a Huffman code, since deflate packs codes starting from their top bit.
+         * @param code The code.
+         * @param length Its length in bits.
+         * @return The code with its bits in the order they are written.
+         */
+        unsigned reverseBits(unsigned code, unsigned length) {
+            unsigned reversed = 0;
+            for (unsigned i = 0; i < length; ++i) {
+                reversed = (reversed << 1) | (code & 1);
+                code >>= 1;
+            }
+            return reversed;
+        }
+
+        /**
+         * @brief Assigns canonical codes to code lengths.
+         * @param lengths Length of each symbol's code; 0 if unused.
+         * @param count Number of symbols.
+         * @param codes Receives each code, bit-reversed ready for writing.
+         */
+        void canonicalCodes(const unsigned char* lengths, size_t count, unsigned* codes) {
+            unsigned lengthCount[16] = {};
+            for (size_t s = 0; s < count; ++s) {
+                ++lengthCount[lengths[s]];
+            }
+            lengthCount[0] = 0;
+
+            unsigned next[16] = {};
+            unsigned code = 0;
+            for (unsigned bits = 1; bits < 16; ++bits) {
+                code = (code + lengthCount[bits - 1]) << 1;
+                next[bits] = code;
+            }
+            for (size_t s = 0; s < count; ++s) {
+                codes[s] = lengths[s] ? reverseBits(next[lengths[s]]++, lengths[s]) : 0;
+            }
+        }
+
+        /**
+         * @brief Builds Huffman code lengths no longer than a limit from symbol frequencies.
+         *
+         * If the optimal tree is too deep, frequencies are halved (keeping
+         * every used symbol at least 1) until it fits. At least two symbols
+         * always get codes so the code is complete.
+         *
+         * @param frequencies Occurrences of each symbol.
+         * @param count Number of symbols.
+         * @param maxBits Longest code allowed.
+         * @param lengths Receives each symbol's code length.
+         */
+        void buildCodeLengths(const unsigned* frequencies, size_t count, unsigned maxBits, unsigned char* lengths) {
+            std::vector<unsigned> weights(frequencies, frequencies + count);
+            size_t used = static_cast<size_t>(std::count_if(weights.begin(), weights.end(), [](unsigned w) { return w > 0; }));
+            for (size_t s = 0; used < 2 && s < count; ++s) {
+                if (weights[s] == 0) {
+                    weights[s] = 1;
+                    ++used;
+                }
+            }
+
+            while (true) {
+                // Leaves are 0..count-1; internal nodes follow. parent[] links each node upwards.
+                using Node = std::pair<unsigned long long, size_t>;
+                std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+                std::vector<size_t> parent(count * 2, 0);
+                for (size_t s = 0; s < count; ++s) {
+                    if (weights[s] > 0) queue.push({ weights[s], s });
+                }
+                size_t nextNode = count;
+                while (queue.size() > 1) {
+                    Node a = queue.top(); queue.pop();
+                    Node b = queue.top(); queue.pop();
+                    parent[a.second] = nextNode;
+                    parent[b.second] = nextNode;
+                    queue.push({ a.first + b.first, nextNode++ });
+                }
+                size_t root = nextNode - 1;
+
+                std::vector<unsigned> depth(nextNode, 0);
+                for (size_t node = root; node-- > count;) {
+                    depth[node] = depth[parent[node]] + 1;
+                }
+                unsigned deepest = 0;
+                for (size_t s = 0; s < count; ++s) {
+                    lengths[s] = 0;
+                    if (weights[s] > 0) {
+                        unsigned d = depth[parent[s]] + 1;
+                        lengths[s] = static_cast<unsigned char>(std::min(d, 255u));
+                        deepest = std::max(deepest, d);
+                    }
+                }
+                if (deepest <= maxBits) {
+                    return;
+                }
+                for (auto& w : weights) {
+                    if (w > 0) w = std::max(1u, w / 2);
+                }
+            }
+        }
+
+        /**
+         * @brief Packs bits into bytes, least significant bit first, as deflate does.
+         */
+        class BitWriter {
+        private:
+            std::string& out;                   /**< Destination */
+            unsigned long long bits = 0;        /**< Bits not yet written */
+            unsigned count = 0;                 /**< Number of pending bits */
+
+        public:
+            explicit BitWriter(std::string& destination)
+                : out(destination) {
+            }
+
+            void put(unsigned value, unsigned length) {
+                bits |= static_cast<unsigned long long>(value) << count;
+                count += length;
+                while (count >= 8) {
+                    out.push_back(static_cast<char>(bits & 0xFF));
+                    bits >>= 8;
+                    count -= 8;
+                }
+            }
+
+            void alignToByte() {
+                if (count > 0) {
+                    put(0, 8 - count);
+                }
+            }
+        };
+
+        /**
+         * @brief A literal byte (distance 0) or a match of length 3-258 at distance 1-32768.
+         */
+        struct Token {
+            unsigned short lengthOrLiteral = 0;
+            unsigned short distance = 0;
+        };
+
+        /**
+         * @brief Writes one block of tokens in whichever of the stored, fixed and dynamic forms is smallest.
+         * @param writer Destination.
+         * @param tokens The block's tokens.
+         * @param raw The bytes the tokens encode, for a stored block.
+         * @param rawLength Number of those bytes.
+         * @param final True for the last block of the stream.
+         */
+        void writeBlock(BitWriter& writer, const std::vector<Token>& tokens, const char* raw, size_t rawLength, bool final) {
+            const DeflateTables& t = tables();
+
+            unsigned literalFrequency[286] = {};
+            unsigned distanceFrequency[30] = {};
+            unsigned long long extraBits = 0;
+            for (const Token& token : tokens) {
+                if (token.distance == 0) {
+                    ++literalFrequency[token.lengthOrLiteral];
+                }
+                else {
+                    unsigned lengthCode = t.lengthCode[token.lengthOrLiteral];
+                    unsigned distanceCode = t.distanceCodeOf(token.distance);
+                    ++literalFrequency[257 + lengthCode];
+                    ++distanceFrequency[distanceCode];
+                    extraBits += lengthExtra[lengthCode] + distanceExtra[distanceCode];
+                }
+            }
+            literalFrequency[256] = 1;
+
+            unsigned char literalLengths[286];
+            unsigned char distanceLengths[30];
+            buildCodeLengths(literalFrequency, 286, 15, literalLengths);
+            buildCodeLengths(distanceFrequency, 30, 15, distanceLengths);
+
+            unsigned literalCount = 286;
+            while (literalCount > 257 && literalLengths[literalCount - 1] == 0) --literalCount;
+            unsigned distanceCount = 30;
+            while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0) --distanceCount;
+
+            // Run-length encode both code length lists as one sequence, with codes 16-18 for runs.
+            std::vector<unsigned char> sequence(literalLengths, literalLengths + literalCount);
+            sequence.insert(sequence.end(), distanceLengths, distanceLengths + distanceCount);
+            std::vector<std::pair<unsigned char, unsigned char>> runs;
+            for (size_t i = 0; i < sequence.size();) {
+                unsigned char length = sequence[i];
+                size_t run = 1;
+                while (i + run < sequence.size() && sequence[i + run] == length) ++run;
+
+                size_t left = run;
+                if (length == 0) {
+                    while (left >= 11) {
+                        size_t n = std::min<size_t>(left, 138);
+                        runs.push_back({ 18, static_cast<unsigned char>(n - 11) });
+                        left -= n;
+                    }
+                    if (left >= 3) {
+                        runs.push_back({ 17, static_cast<unsigned char>(left - 3) });
+                        left = 0;
+                    }
+                }
+                else {
+                    runs.push_back({ length, 0 });
+                    --left;
+                    while (left >= 3) {
+                        size_t n = std::min<size_t>(left, 6);
+                        runs.push_back({ 16, static_cast<unsigned char>(n - 3) });
+                        left -= n;
+                    }
+                }
+                for (; left > 0; --left) runs.push_back({ length, 0 });
+                i += run;
+            }
+
+            unsigned codeLengthFrequency[19] = {};
+            for (const auto& run : runs) ++codeLengthFrequency[run.first];
+            unsigned char codeLengthLengths[19];
+            buildCodeLengths(codeLengthFrequency, 19, 7, codeLengthLengths);
+            unsigned codeLengthCount = 19;
+            while (codeLengthCount > 4 && codeLengthLengths[codeLengthOrder[codeLengthCount - 1]] == 0) --codeLengthCount;
+
+            unsigned long long dynamicBits = 3 + 14 + 3ull * codeLengthCount + extraBits;
+            for (const auto& run : runs) {
+                dynamicBits += codeLengthLengths[run.first] + (run.first == 16 ? 2 : run.first == 17 ? 3 : run.first == 18 ? 7 : 0);
+            }
+            unsigned long long fixedBits = 3 + extraBits;
+            for (unsigned s = 0; s < 286; ++s) {
+                dynamicBits += static_cast<unsigned long long>(literalFrequency[s]) * literalLengths[s];
+                fixedBits += static_cast<unsigned long long>(literalFrequency[s]) * t.fixedLiteralLengths[s];
+            }
+            for (unsigned s = 0; s < 30; ++s) {
+                dynamicBits += static_cast<unsigned long long>(distanceFrequency[s]) * distanceLengths[s];
+                fixedBits += static_cast<unsigned long long>(distanceFrequency[s]) * 5;
+            }
+            unsigned long long storedBits = (rawLength / 65535 + 1) * (3 + 7 + 32) + 8ull * rawLength;
+
+            if (storedBits < dynamicBits && storedBits < fixedBits) {
+                size_t offset = 0;
+                do {
+                    size_t length = std::min<size_t>(rawLength - offset, 65535);
+                    bool last = offset + length == rawLength;
+                    writer.put(final && last ? 1 : 0, 1);
+                    writer.put(0, 2);
+                    writer.alignToByte();
+                    writer.put(static_cast<unsigned>(length), 16);
+                    writer.put(static_cast<unsigned>(~length & 0xFFFF), 16);
+                    for (size_t i = 0; i < length; ++i) {
+                        writer.put(static_cast<unsigned char>(raw[offset + i]), 8);
+                    }
+                    offset += length;
+                } while (offset < rawLength);
+                return;
+            }
+
+            unsigned literalCodes[288];
+            unsigned distanceCodes[30];
+            const unsigned char* useLiteralLengths = literalLengths;
+            const unsigned char* useDistanceLengths = distanceLengths;
+
+            writer.put(final ? 1 : 0, 1);
+            if (fixedBits <= dynamicBits) {
+                writer.put(1, 2);
+                useLiteralLengths = t.fixedLiteralLengths.data();
+                useDistanceLengths = t.fixedDistanceLengths.data();
+                canonicalCodes(useLiteralLengths, 288, literalCodes);
+                canonicalCodes(useDistanceLengths, 30, distanceCodes);
+            }
+            else {
+                writer.put(2, 2);
+                writer.put(literalCount - 257, 5);
+                writer.put(distanceCount - 1, 5);
+                writer.put(codeLengthCount - 4, 4);
+                for (unsigned i = 0; i < codeLengthCount; ++i) {
+                    writer.put(codeLengthLengths[codeLengthOrder[i]], 3);
+                }
+                unsigned codeLengthCodes[19];
+                canonicalCodes(codeLengthLengths, 19, codeLengthCodes);
+                for (const auto& run : runs) {
+                    writer.put(codeLengthCodes[run.first], codeLengthLengths[run.first]);
+                    if (run.first == 16) writer.put(run.second, 2);
+                    else if (run.first == 17) writer.put(run.second, 3);
+                    else if (run.first == 18) writer.put(run.second, 7);
+                }
+                canonicalCodes(literalLengths, 286, literalCodes);
+                canonicalCodes(distanceLengths, 30, distanceCodes);
+            }
+
+            for (const Token& token : tokens) {
+                if (token.distance == 0) {
+                    writer.put(literalCodes[token.lengthOrLiteral], useLiteralLengths[token.lengthOrLiteral]);
+                    continue;
+                }
+                unsigned lengthCode = t.lengthCode[token.lengthOrLiteral];
+                writer.put(literalCodes[257 + lengthCode], useLiteralLengths[257 + lengthCode]);
+                writer.put(token.lengthOrLiteral - lengthBase[lengthCode], lengthExtra[lengthCode]);
+                unsigned distanceCode = t.distanceCodeOf(token.distance);
+                writer.put(distanceCodes[distanceCode], useDistanceLengths[distanceCode]);
+                writer.put(token.distance - distanceBase[distanceCode], distanceExtra[distanceCode]);
+            }
+            writer.put(literalCodes[256], useLiteralLengths[256]);
+        }
+
+        /**
+         * @brief Deflates one slice of input, matching against the bytes before it.
+         *
+         * A slice that is not the last ends with an empty stored block, which
+         * leaves the stream on a byte boundary so the next slice's output can
+         * simply be appended.
+         *
+         * @param history Up to 32 KB immediately before the slice; may be empty.
+         * @param historyLength Number of history bytes.
+         * @param data The slice.
+         * @param length Number of bytes in the slice.
+         * @param final True if this is the end of the stream.
+         * @param out Receives the compressed bytes.
+         */
+        void deflateSlice(const char* history, size_t historyLength, const char* data, size_t length, bool final, std::string& out) {
+            historyLength = std::min(historyLength, windowSize);
+            std::vector<unsigned char> buffer(historyLength + length);
+            if (historyLength > 0) std::memcpy(buffer.data(), history, historyLength);
+            if (length > 0) std::memcpy(buffer.data() + historyLength, data, length);
+            const unsigned char* bytes = buffer.data();
+            size_t end = buffer.size();
+
+            std::vector<int> head(size_t{ 1 } << hashBits, -1);
+            std::vector<int> previous(end, -1);
+            auto hashAt = [bytes](size_t p) {
+                unsigned v = bytes[p] | (bytes[p + 1] << 8) | (bytes[p + 2] << 16);
+                return (v * 2654435761u) >> (32 - hashBits);
+            };
+            auto insert = [&](size_t p) {
+                if (p + minMatch <= end) {
+                    unsigned h = hashAt(p);
+                    previous[p] = head[h];
+                    head[h] = static_cast<int>(p);
+                }
+            };
+            for (size_t p = 0; p < historyLength; ++p) {
+                insert(p);
+            }
+
+            BitWriter writer(out);
+            std::vector<Token> tokens;
+            tokens.reserve(tokensPerBlock);
+            size_t blockStart = historyLength;
+            size_t p = historyLength;
+
+            while (p < end) {
+                unsigned bestLength = 0;
+                unsigned bestDistance = 0;
+                if (p + minMatch <= end) {
+                    unsigned limit = static_cast<unsigned>(std::min<size_t>(maxMatch, end - p));
+                    int candidate = head[hashAt(p)];
+                    for (unsigned chain = 0; candidate >= 0 && chain < maxChainLength; ++chain) {
+                        size_t distance = p - static_cast<size_t>(candidate);
+                        if (distance > windowSize) break;
+                        const unsigned char* a = bytes + candidate;
+                        const unsigned char* b = bytes + p;
+                        if (a[bestLength] == b[bestLength]) {
+                            unsigned n = 0;
+                            while (n < limit && a[n] == b[n]) ++n;
+                            if (n > bestLength) {
+                                bestLength = n;
+                                bestDistance = static_cast<unsigned>(distance);
+                                if (n >= niceLength || n == limit) break;
+                            }
+                        }
+                        candidate = previous[candidate];
+                    }
+                }
+
+                if (bestLength >= minMatch) {
+                    tokens.push_back({ static_cast<unsigned short>(bestLength), static_cast<unsigned short>(bestDistance) });
+                    for (size_t i = 0; i < bestLength; ++i) insert(p + i);
+                    p += bestLength;
+                }
+                else {
+                    tokens.push_back({ bytes[p], 0 });
+                    insert(p);
+                    ++p;
+                }
+
+                if (tokens.size() == tokensPerBlock && p < end) {
+                    writeBlock(writer, tokens, reinterpret_cast<const char*>(bytes + blockStart), p - blockStart, false);
+                    tokens.clear();
+                    blockStart = p;
+                }
+            }
+
+            writeBlock(writer, tokens, reinterpret_cast<const char*>(bytes + blockStart), end - blockStart, final);
+            if (!final) {
+                // Empty stored block: realigns to a byte so the next slice can follow.
+                writer.put(0, 3);
+                writer.alignToByte();
+                writer.put(0, 16);
+                writer.put(0xFFFF, 16);
+            }
+            writer.alignToByte();
+        }
+
+        /**
+         * @brief Appends a 4-byte little-endian value, as gzip stores its trailer.
+         * @param out Destination.
+         * @param value The value.
+         */
+        void appendLittleEndian(std::string& out, unsigned value) {
+            for (int i = 0; i < 4; ++i) {
+                out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+            }
+        }
+
+        /**
+         * @brief Reads deflate's least-significant-bit-first bit stream.
+         *
+         * Reading past the end yields zero bits; finish() reports whether
+         * the stream really held everything that was read.
+         */
+        class BitReader {
+        private:
+            const unsigned char* data;          /**< Compressed bytes */
+            size_t size;                        /**< Number of compressed bytes */
+            size_t pos;                         /**< Next byte to load, counting bytes past the end */
+            unsigned long long bits = 0;        /**< Loaded bits */
+            unsigned count = 0;                 /**< Number of loaded bits */
+
+        public:
+            BitReader(const char* bytes, size_t length, size_t offset)
+                : data(reinterpret_cast<const unsigned char*>(bytes)), size(length), pos(offset) {
+            }
+
+            void refill() {
+                while (count <= 56) {
+                    if (pos < size) bits |= static_cast<unsigned long long>(data[pos]) << count;
+                    else if (pos > size + 8) throw std::runtime_error("compressed data ends too soon");
+                    ++pos;
+                    count += 8;
+                }
+            }
+
+            unsigned peek(unsigned length) const {
+                return static_cast<unsigned>(bits & ((1ull << length) - 1));
+            }
+
+            void consume(unsigned length) {
+                bits >>= length;
+                count -= length;
+            }
+
+            unsigned get(unsigned length) {
+                if (length == 0) return 0;
+                if (count < length) refill();
+                unsigned value = peek(length);
+                consume(length);
+                return value;
+            }
+
+            /** @brief Drops bits up to the next byte boundary and returns the offset of that byte. */
+            size_t alignToByte() {
+                consume(count % 8);
+                size_t offset = pos - count / 8;
+                bits = 0;
+                count = 0;
+                pos = offset;
+                if (offset > size) throw std::runtime_error("compressed data ends too soon");
+                return offset;
+            }
+
+            void skipTo(size_t offset) {
+                bits = 0;
+                count = 0;
+                pos = offset;
+            }
+        };
+
+        /**
+         * @brief Table-driven decoder for one canonical Huffman code.
+         */
+        class HuffmanDecoder {
+        private:
+            std::vector<unsigned short> table;  /**< Indexed by the next maxLength bits: symbol << 4 | code length */
+            unsigned maxLength = 0;             /**< Longest code */
+
+        public:
+            void build(const unsigned char* lengths, size_t count) {
+                unsigned lengthCount[16] = {};
+                maxLength = 0;
+                for (size_t s = 0; s < count; ++s) {
+                    ++lengthCount[lengths[s]];
+                    maxLength = std::max<unsigned>(maxLength, lengths[s]);
+                }
+                lengthCount[0] = 0;
+
+                int left = 1;
+                for (unsigned bits = 1; bits < 16; ++bits) {
+                    left = (left << 1) - static_cast<int>(lengthCount[bits]);
+                    if (left < 0) throw std::runtime_error("invalid Huffman code");
+                }
+
+                table.assign(size_t{ 1 } << maxLength, 0);
+                std::vector<unsigned> codes(count);
+                canonicalCodes(lengths, count, codes.data());
+                for (size_t s = 0; s < count; ++s) {
+                    unsigned length = lengths[s];
+                    if (length == 0) continue;
+                    unsigned short entry = static_cast<unsigned short>((s << 4) | length);
+                    for (size_t i = codes[s]; i < table.size(); i += size_t{ 1 } << length) {
+                        table[i] = entry;
+                    }
+                }
+            }
+
+            unsigned decode(BitReader& reader) const {
+                if (maxLength == 0) throw std::runtime_error("code with no symbols used");
+                unsigned short entry = table[reader.peek(maxLength)];
+                unsigned length = entry & 15;
+                if (length == 0) throw std::runtime_error("invalid Huffman code");
+                reader.consume(length);
+                return entry >> 4;
+            }
+        };
+
+        /**
+         * @brief Inflates one deflate stream onto the end of a buffer.
+         * @param data Compressed bytes.
+         * @param length Number of compressed bytes.
+         * @param offset Where the stream starts.
+         * @param out Receives the bytes; matches may only reach back to memberStart.
+         * @param memberStart Size of out when this stream began.
+         * @return Offset of the first byte after the stream.
+         */
+        size_t inflateStream(const char* data, size_t length, size_t offset, std::vector<char>& out, size_t memberStart) {
+            const DeflateTables& t = tables();
+            BitReader reader(data, length, offset);
+            HuffmanDecoder literals;
+            HuffmanDecoder distances;
+
+            bool final = false;
+            while (!final) {
+                reader.refill();
+                final = reader.get(1) == 1;
+                unsigned type = reader.get(2);
+
+                if (type == 0) {
+                    size_t at = reader.alignToByte();
+                    if (length - at < 4) throw std::runtime_error("compressed data ends too soon");
+                    const unsigned char* b = reinterpret_cast<const unsigned char*>(data + at);
+                    unsigned storedLength = b[0] | (b[1] << 8);
+                    unsigned check = b[2] | (b[3] << 8);
+                    if ((storedLength ^ 0xFFFF) != check) throw std::runtime_error("stored block length is corrupt");
+                    at += 4;
+                    if (length - at < storedLength) throw std::runtime_error("compressed data ends too soon");
+                    out.insert(out.end(), data + at, data + at + storedLength);
+                    reader.skipTo(at + storedLength);
+                    continue;
+                }
+
+                if (type == 1) {
+                    literals.build(t.fixedLiteralLengths.data(), 288);
+                    distances.build(t.fixedDistanceLengths.data(), 30);
+                }
+                else if (type == 2) {
+                    unsigned literalCount = reader.get(5) + 257;
+                    unsigned distanceCount = reader.get(5) + 1;
+                    unsigned codeLengthCount = reader.get(4) + 4;
+                    if (literalCount > 286 || distanceCount > 30) throw std::runtime_error("too many codes in a block");
+
+                    unsigned char codeLengthLengths[19] = {};
+                    for (unsigned i = 0; i < codeLengthCount; ++i) {
+                        codeLengthLengths[codeLengthOrder[i]] = static_cast<unsigned char>(reader.get(3));
+                    }
+                    HuffmanDecoder codeLengths;
+                    codeLengths.build(codeLengthLengths, 19);
+
+                    unsigned char lengths[286 + 30] = {};
+                    unsigned total = literalCount + distanceCount;
+                    for (unsigned i = 0; i < total;) {
+                        reader.refill();
+                        unsigned symbol = codeLengths.decode(reader);
+                        if (symbol < 16) {
+                            lengths[i++] = static_cast<unsigned char>(symbol);
+                            continue;
+                        }
+                        unsigned char repeat = 0;
+                        unsigned times = 0;
+                        if (symbol == 16) {
+                            if (i == 0) throw std::runtime_error("repeat with no previous length");
+                            repeat = lengths[i - 1];
+                            times = 3 + reader.get(2);
+                        }
+                        else if (symbol == 17) {
+                            times = 3 + reader.get(3);
+                        }
+                        else {
+                            times = 11 + reader.get(7);
+                        }
+                        if (i + times > total) throw std::runtime_error("code lengths overflow the block");
+                        while (times-- > 0) lengths[i++] = repeat;
+                    }
+                    if (lengths[256] == 0) throw std::runtime_error("block has no end code");
+                    literals.build(lengths, literalCount);
+                    distances.build(lengths + literalCount, distanceCount);
+                }
+                else {
+                    throw std::runtime_error("invalid block type");
+                }
+
+                while (true) {
+                    reader.refill();
+                    unsigned symbol = literals.decode(reader);
+                    if (symbol < 256) {
+                        out.push_back(static_cast<char>(symbol));
+                        continue;
+                    }
+                    if (symbol == 256) break;
+
+                    symbol -= 257;
+                    if (symbol >= 29) throw std::runtime_error("invalid length code");
+                    unsigned matchLength = lengthBase[symbol] + reader.get(lengthExtra[symbol]);
+                    unsigned distanceCode = distances.decode(reader);
+                    if (distanceCode >= 30) throw std::runtime_error("invalid distance code");
+                    size_t distance = distanceBase[distanceCode] + reader.get(distanceExtra[distanceCode]);
+                    if (distance > out.size() - memberStart) throw std::runtime_error("match reaches before the start of the data");
+
+                    size_t from = out.size() - distance;
+                    for (unsigned i = 0; i < matchLength; ++i) {
+                        out.push_back(out[from + i]);
+                    }
+                }
+            }
+            return reader.alignToByte();
+        }
+
+        std::atomic<bool> exportCompression{ false };
+    }
+
+    /**
+     * @brief Computes the CRC-32 that gzip stores, continuing from an earlier value.
+     * @param data Bytes to checksum.
+     * @param length Number of bytes.
+     * @param crc CRC of the bytes before these; 0 to start.
+     * @return CRC of everything so far.
+     */
+    unsigned crc32(const char* data, size_t length, unsigned crc) {
+        const auto& table = tables().crc;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+        crc = ~crc;
+        // Eight bytes per step, one table lookup each (slicing-by-8); the tail goes a byte at a time.
+        for (; length >= 8; bytes += 8, length -= 8) {
+            unsigned low = crc ^ (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<unsigned>(bytes[3]) << 24);
+            crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24]
+                ^ table[3][bytes[4]] ^ table[2][bytes[5]] ^ table[1][bytes[6]] ^ table[0][bytes[7]];
+        }
+        for (; length > 0; ++bytes, --length) {
+            crc = table[0][(crc ^ *bytes) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    namespace {
+        /**
+         * @brief Multiplies a 32-bit vector by a 32x32 matrix over GF(2).
+         * @param matrix Matrix as 32 columns.
+         * @param vector Vector to multiply.
+         * @return The product.
+         */
+        unsigned gf2Times(const unsigned* matrix, unsigned vector) {
+            unsigned sum = 0;
+            for (; vector; vector >>= 1, ++matrix) {
+                if (vector & 1) sum ^= *matrix;
+            }
+            return sum;
+        }
+
+        /**
+         * @brief Squares a 32x32 matrix over GF(2).
+         * @param square Receives the result.
+         * @param matrix Matrix to square.
+         */
+        void gf2Square(unsigned* square, const unsigned* matrix) {
+            for (int n = 0; n < 32; ++n) {
+                square[n] = gf2Times(matrix, matrix[n]);
+            }
+        }
+
+        /** Bytes of one span checksummed by a single thread in crc32Spans. */
+        constexpr size_t crcChunkBytes = size_t{ 1 } << 20;
+    }
+
+    /**
+     * @brief Combines the CRC-32s of two adjacent blocks into the CRC-32 of both.
+     *
+     * Appending length2 zero bytes to the first block is a linear operation
+     * on its CRC, applied here by repeated squaring of the one-zero-bit
+     * operator, as zlib's crc32_combine does.
+     *
+     * @param crc1 CRC of the first block.
+     * @param crc2 CRC of the second block.
+     * @param length2 Length of the second block.
+     * @return CRC of the first block followed by the second.
+     */
+    unsigned crc32Combine(unsigned crc1, unsigned crc2, size_t length2) {
+        if (length2 == 0) return crc1;
+
+        unsigned even[32];
+        unsigned odd[32];
+        odd[0] = 0xEDB88320u;
+        for (int n = 1; n < 32; ++n) {
+            odd[n] = 1u << (n - 1);
+        }
+        gf2Square(even, odd);   // two zero bits
+        gf2Square(odd, even);   // four zero bits
+
+        // Each pass squares once more, so the first applies one zero byte.
+        do {
+            gf2Square(even, odd);
+            if (length2 & 1) crc1 = gf2Times(even, crc1);
+            length2 >>= 1;
+            if (length2 == 0) break;
+
+            gf2Square(odd, even);
+            if (length2 & 1) crc1 = gf2Times(odd, crc1);
+            length2 >>= 1;
+        } while (length2 != 0);
+
+        return crc1 ^ crc2;
+    }
+
+    /**
+     * @brief Computes the CRC-32 of several spans, splitting them into chunks checksummed in parallel.
+     *
+     * Spans are cut into 1 MB chunks and every chunk of every span is
+     * shared out across threads, so one large span is checksummed as fast as
+     * many small ones; the chunk CRCs are then combined per span.
+     *
+     * @param spans Bytes to checksum.
+     * @return CRC of each span, in the same order.
+     */
+    std::vector<unsigned> crc32Spans(const std::vector<std::string_view>& spans) {
+        struct Chunk {
+            size_t span;
+            const char* data;
+            size_t length;
+            unsigned crc;
+        };
+        std::vector<Chunk> chunks;
+        for (size_t i = 0; i < spans.size(); ++i) {
+            for (size_t offset = 0; offset < spans[i].size(); offset += crcChunkBytes) {
+                chunks.push_back({ i, spans[i].data() + offset, std::min(crcChunkBytes, spans[i].size() - offset), 0 });
+            }
+        }
+
+        parallelForRanges(chunks.size(), workerCountFor(chunks.size(), 1), [&](unsigned, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                chunks[i].crc = crc32(chunks[i].data, chunks[i].length);
+            }
+            });
+
+        std::vector<unsigned> crcs(spans.size(), 0);
+        for (const Chunk& chunk : chunks) {
+            crcs[chunk.span] = crc32Combine(crcs[chunk.span], chunk.crc, chunk.length);
+        }
+        return crcs;
+    }
+
+    /**
+     * @brief Checks whether a file name asks for gzip compression.
+     * @param filename File name.
+     * @return True if it ends in ".gz", in any case.
+     */
+    bool hasGzipExtension(std::string_view filename) {
+        return filename.size() > 3 && filename[filename.size() - 3] == '.'
+            && std::tolower(static_cast<unsigned char>(filename[filename.size() - 2])) == 'g'
+            && std::tolower(static_cast<unsigned char>(filename[filename.size() - 1])) == 'z';
+    }
+
+    /**
+     * @brief Checks whether bytes start like a gzip file.
+     * @param data Start of the bytes.
+     * @param length Number of bytes.
+     * @return True if the gzip magic and the deflate method are present.
+     */
+    bool isGzipData(const char* data, size_t length) {
+        return length >= 3 && static_cast<unsigned char>(data[0]) == 0x1f
+            && static_cast<unsigned char>(data[1]) == 0x8b && data[2] == 8;
+    }
+
+    /**
+     * @brief Compresses a whole buffer into gzip format, deflating slices of it in parallel.
+     * @param data Bytes to compress.
+     * @param length Number of bytes.
+     * @return The gzip file's contents.
+     */
+    ByteBuffer gzipCompress(const char* data, size_t length) {
+        size_t sliceCount = std::max<size_t>(1, (length + sliceSize - 1) / sliceSize);
+        std::vector<std::string> slices(sliceCount);
+        unsigned crc = 0;
+
+        parallelForRanges(sliceCount + 1, workerCountFor(sliceCount + 1, 1),
+            [&](unsigned, size_t first, size_t last) {
+                for (size_t s = first; s < last; ++s) {
+                    // The extra index checksums the whole buffer alongside the slices.
+                    if (s == sliceCount) {
+                        crc = crc32(data, length);
+                        continue;
+                    }
+                    size_t start = s * sliceSize;
+                    size_t history = std::min(start, windowSize);
+                    deflateSlice(data + start - history, history, data + start,
+                        std::min(sliceSize, length - start), s + 1 == sliceCount, slices[s]);
+                }
+            });
+
+        std::string trailer;
+        appendLittleEndian(trailer, crc);
+        appendLittleEndian(trailer, static_cast<unsigned>(length & 0xFFFFFFFFu));
+
+        ByteBuffer result;
+        result.size = sizeof(gzipHeader) + trailer.size();
+        for (const auto& slice : slices) result.size += slice.size();
+        result.data = std::make_unique<char[]>(result.size);
+
+        char* cursor = result.data.get();
+        std::memcpy(cursor, gzipHeader, sizeof(gzipHeader));
+        cursor += sizeof(gzipHeader);
+        for (const auto& slice : slices) {
+            std::memcpy(cursor, slice.data(), slice.size());
+            cursor += slice.size();
+        }
+        std::memcpy(cursor, trailer.data(), trailer.size());
+        return result;
+    }
+
+    /**
+     * @brief Decompresses gzip data, checking every member's CRC and length.
+     *
+     * Concatenated members, as written by appending gzip files, are
+     * decompressed one after another.
+     *
+     * @param data gzip file contents.
+     * @param length Number of bytes.
+     * @param contents Receives the decompressed bytes.
+     * @param error Receives what was wrong if decompression fails.
+     * @return True if every member decompressed and checked out.
+     */
+    bool gzipDecompress(const char* data, size_t length, std::vector<char>& contents, std::string& error) {
+        contents.clear();
+        try {
+            size_t offset = 0;
+            do {
+                if (!isGzipData(data + offset, length - offset) || length - offset < 18) {
+                    throw std::runtime_error("not gzip data");
+                }
+                const unsigned char* header = reinterpret_cast<const unsigned char*>(data + offset);
+                unsigned flags = header[3];
+                if (flags & 0xE0) throw std::runtime_error("unknown header flags");
+                offset += 10;
+
+                auto need = [&](size_t count) {
+                    if (length - offset < count) throw std::runtime_error("header ends too soon");
+                };
+                if (flags & 4) {
+                    need(2);
+                    size_t extra = static_cast<unsigned char>(data[offset]) | (static_cast<unsigned char>(data[offset + 1]) << 8);
+                    offset += 2;
+                    need(extra);
+                    offset += extra;
+                }
+                for (unsigned textFlag : { 8u, 16u }) {
+                    if (flags & textFlag) {
+                        const void* nul = std::memchr(data + offset, 0, length - offset);
+                        if (!nul) throw std::runtime_error("header ends too soon");
+                        offset = static_cast<size_t>(static_cast<const char*>(nul) - data) + 1;
+                    }
+                }
+                if (flags & 2) {
+                    need(2);
+                    offset += 2;
+                }
+
+                size_t memberStart = contents.size();
+                if (length - offset >= 8) {
+                    // The trailer's size (mod 4 GB) is only a hint for reserving.
+                    const unsigned char* end = reinterpret_cast<const unsigned char*>(data + length - 4);
+                    size_t hint = end[0] | (end[1] << 8) | (end[2] << 16) | (static_cast<size_t>(end[3]) << 24);
+                    contents.reserve(memberStart + std::min<size_t>(hint, length * 1032));
+                }
+                offset = inflateStream(data, length, offset, contents, memberStart);
+
+                if (length - offset < 8) throw std::runtime_error("trailer is missing");
+                const unsigned char* trailer = reinterpret_cast<const unsigned char*>(data + offset);
+                unsigned storedCrc = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast<unsigned>(trailer[3]) << 24);
+                unsigned storedSize = trailer[4] | (trailer[5] << 8) | (trailer[6] << 16) | (static_cast<unsigned>(trailer[7]) << 24);
+                offset += 8;
+
+                size_t memberSize = contents.size() - memberStart;
+                if (crc32(contents.data() + memberStart, memberSize) != storedCrc) {
+                    throw std::runtime_error("CRC mismatch");
+                }
+                if (static_cast<unsigned>(memberSize & 0xFFFFFFFFu) != storedSize) {
+                    throw std::runtime_error("length mismatch");
+                }
+            } while (offset < length);
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+            contents.clear();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Turns gzip compression of exports with fixed names on or off for the whole program.
+     * @param enabled True to write "<name>.gz" instead of "<name>".
+     */
+    void setExportCompression(bool enabled) {
+        exportCompression = enabled;
+    }
+
+    /**
+     * @brief Checks whether exports with fixed names are being compressed.
+     * @return True if setExportCompression(true) is in effect.
+     */
+    bool isExportCompressionEnabled() {
+        return exportCompression;
+    }
+
+    /**
+     * @brief Gets the name an export should be written under.
+     * @param filename Name the export would use uncompressed.
+     * @return The name with ".gz" appended while export compression is on, otherwise unchanged.
+     */
+    std::string exportFileName(const std::string& filename) {
+        return exportCompression && !hasGzipExtension(filename) ? filename + ".gz" : filename;
+    }
+
+    /**
+     * @class GzipStreamBuffer
+     * @brief Stream buffer that gzips into a file on a pipeline thread.
+     *
+     * The exporter fills one slice while the pipeline thread deflates and
+     * writes the one before, keeping the last 32 KB of input as the next
+     * slice's dictionary.
+     */
+    class GzipStreamBuffer : public std::streambuf {
+    private:
+        std::ofstream file;                 /**< Compressed output */
+        std::vector<char> filling;          /**< Slice the exporter writes into */
+        std::vector<char> pending;          /**< Slice handed to the pipeline thread */
+        std::string history;                /**< Last 32 KB of input before the pending slice */
+        unsigned crc = 0;                   /**< CRC of all input so far */
+        unsigned long long total = 0;       /**< Bytes of input so far */
+
+        std::thread worker;                 /**< Pipeline thread */
+        std::mutex mutex;                   /**< Guards the fields below */
+        std::condition_variable changed;    /**< Signalled when a slice is handed over or finished */
+        bool hasPending = false;            /**< True while pending holds a slice to compress */
+        bool pendingFinal = false;          /**< True if the pending slice ends the stream */
+        bool stopping = false;              /**< Set once the final slice has been handed over */
+        bool failed = false;                /**< Set if a write to the file failed */
+        bool finished = false;              /**< Set by finish() */
+
+        /**
+         * @brief Pipeline thread: compresses and writes each slice handed over.
+         */
+        void run() {
+            std::string compressed;
+            while (true) {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this] { return hasPending || stopping; });
+                if (!hasPending) {
+                    return;
+                }
+                bool final = pendingFinal;
+                lock.unlock();
+
+                compressed.clear();
+                deflateSlice(history.data(), history.size(), pending.data(), pending.size(), final, compressed);
+                crc = crc32(pending.data(), pending.size(), crc);
+                total += pending.size();
+                if (final) {
+                    appendLittleEndian(compressed, crc);
+                    appendLittleEndian(compressed, static_cast<unsigned>(total & 0xFFFFFFFFu));
+                }
+                file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+
+                if (pending.size() >= windowSize) {
+                    history.assign(pending.end() - windowSize, pending.end());
+                }
+                else {
+                    history.append(pending.data(), pending.size());
+                    if (history.size() > windowSize) history.erase(0, history.size() - windowSize);
+                }
+
+                lock.lock();
+                failed = failed || !file;
+                hasPending = false;
+                changed.notify_all();
+                if (final) {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief Hands the filled slice to the pipeline thread once it has finished the previous one.
+         * @param final True if this slice ends the stream.
+         */
+        void handOver(bool final) {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return !hasPending; });
+            filling.resize(static_cast<size_t>(pptr() - pbase()));
+            std::swap(filling, pending);
+            hasPending = true;
+            pendingFinal = final;
+            changed.notify_all();
+            lock.unlock();
+
+            filling.resize(sliceSize);
+            setp(filling.data(), filling.data() + filling.size());
+        }
+
+    protected:
+        int_type overflow(int_type ch) override {
+            if (finished) {
+                return traits_type::eof();
+            }
+            handOver(false);
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        // Flushes such as std::endl keep filling the slice; only finish() ends it.
+        int sync() override {
+            return 0;
+        }
+
+    public:
+        explicit GzipStreamBuffer(const std::string& filename)
+            : file(filename, std::ios::binary | std::ios::trunc), filling(sliceSize) {
+            setp(filling.data(), filling.data() + filling.size());
+            if (file.is_open()) {
+                file.write(reinterpret_cast<const char*>(gzipHeader), sizeof(gzipHeader));
+                worker = std::thread(&GzipStreamBuffer::run, this);
+            }
+        }
+
+        ~GzipStreamBuffer() override {
+            finish();
+        }
+
+        bool isOpen() const {
+            return file.is_open();
+        }
+
+        /**
+         * @brief Compresses the last slice, writes the trailer and closes the file.
+         * @return True if every byte reached the file.
+         */
+        bool finish() {
+            if (finished) {
+                return !failed;
+            }
+            finished = true;
+            if (!file.is_open()) {
+                return false;
+            }
+
+            handOver(true);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+                changed.notify_all();
+            }
+            worker.join();
+            setp(nullptr, nullptr);
+
+            file.close();
+            failed = failed || file.fail();
+            return !failed;
+        }
+    };
+
+    /**
+     * @brief Creates or truncates a file for writing.
+     * @param filename File to write; compressed if it ends in ".gz".
+     */
+    ExportFile::ExportFile(const std::string& filename)
+        : std::ostream(nullptr) {
+        if (hasGzipExtension(filename)) {
+            gzip = std::make_unique<GzipStreamBuffer>(filename);
+            rdbuf(gzip.get());
+            if (!gzip->isOpen()) setstate(std::ios::failbit);
+        }
+        else {
+            rdbuf(&plain);
+            if (!plain.open(filename, std::ios::out | std::ios::trunc)) setstate(std::ios::failbit);
+        }
+    }
+
+    /**
+     * @brief Finishes the file if close() was not called.
+     */
+    ExportFile::~ExportFile() {
+        close();
+    }
+
+    /**
+     * @brief Checks whether the file could be created.
+     * @return True if writes reach the file.
+     */
+    bool ExportFile::is_open() const {
+        return gzip ? gzip->isOpen() : plain.is_open();
+    }
+
+    /**
+     * @brief Writes everything still buffered, finishes the gzip stream and closes the file.
+     */
+    void ExportFile::close() {
+        if (gzip) {
+            if (!gzip->finish()) setstate(std::ios::failbit);
+        }
+        else if (plain.is_open() && !plain.close()) {
+            setstate(std::ios::failbit);
+        }
+    }
+}
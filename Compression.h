@@ -0,0 +1,137 @@
+#pragma once
+#include "Serialization.h"
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gradebook {
+
+    /**
+     * @brief Computes the CRC-32 that gzip stores, continuing from an earlier value.
+     * @param data Bytes to checksum.
+     * @param length Number of bytes.
+     * @param crc CRC of the bytes before these; 0 to start.
+     * @return CRC of everything so far.
+     */
+    unsigned crc32(const char* data, size_t length, unsigned crc = 0);
+
+    /**
+     * @brief Combines the CRC-32s of two adjacent blocks into the CRC-32 of both.
+     * @param crc1 CRC of the first block.
+     * @param crc2 CRC of the second block.
+     * @param length2 Length of the second block.
+     * @return CRC of the first block followed by the second.
+     */
+    unsigned crc32Combine(unsigned crc1, unsigned crc2, size_t length2);
+
+    /**
+     * @brief Computes the CRC-32 of several spans, splitting them into chunks checksummed in parallel.
+     * @param spans Bytes to checksum.
+     * @return CRC of each span, in the same order.
+     */
+    std::vector<unsigned> crc32Spans(const std::vector<std::string_view>& spans);
+
+    /**
+     * @brief Checks whether a file name asks for gzip compression.
+     * @param filename File name.
+     * @return True if it ends in ".gz", in any case.
+     */
+    bool hasGzipExtension(std::string_view filename);
+
+    /**
+     * @brief Checks whether bytes start like a gzip file.
+     * @param data Start of the bytes.
+     * @param length Number of bytes.
+     * @return True if the gzip magic and the deflate method are present.
+     */
+    bool isGzipData(const char* data, size_t length);
+
+    /**
+     * @brief Compresses a whole buffer into gzip format, deflating slices of it in parallel.
+     *
+     * Each slice is deflated on its own thread with the 32 KB before it as
+     * its dictionary and ends on a byte boundary, so the slices join into
+     * one standard deflate stream that any gzip tool reads.
+     *
+     * @param data Bytes to compress.
+     * @param length Number of bytes.
+     * @return The gzip file's contents.
+     */
+    ByteBuffer gzipCompress(const char* data, size_t length);
+
+    /**
+     * @brief Decompresses gzip data, checking every member's CRC and length.
+     * @param data gzip file contents.
+     * @param length Number of bytes.
+     * @param contents Receives the decompressed bytes.
+     * @param error Receives what was wrong if decompression fails.
+     * @return True if every member decompressed and checked out.
+     */
+    bool gzipDecompress(const char* data, size_t length, std::vector<char>& contents, std::string& error);
+
+    /**
+     * @brief Turns gzip compression of exports with fixed names on or off for the whole program.
+     * @param enabled True to write "<name>.gz" instead of "<name>".
+     */
+    void setExportCompression(bool enabled);
+
+    /**
+     * @brief Checks whether exports with fixed names are being compressed.
+     * @return True if setExportCompression(true) is in effect.
+     */
+    bool isExportCompressionEnabled();
+
+    /**
+     * @brief Gets the name an export should be written under.
+     * @param filename Name the export would use uncompressed.
+     * @return The name with ".gz" appended while export compression is on, otherwise unchanged.
+     */
+    std::string exportFileName(const std::string& filename);
+
+    class GzipStreamBuffer;
+
+    /**
+     * @class ExportFile
+     * @brief An output file stream that gzips its contents when the file name ends in ".gz".
+     *
+     * Used in place of std::ofstream by every text export. Compressed
+     * output is gathered into large slices; each full slice is deflated and
+     * written by a pipeline thread while the exporter fills the next one.
+     * close() finishes the gzip stream and sets failbit if anything could
+     * not be written.
+     */
+    class ExportFile : public std::ostream {
+    private:
+        std::filebuf plain;                         /**< Buffer for uncompressed files */
+        std::unique_ptr<GzipStreamBuffer> gzip;     /**< Buffer for compressed files */
+
+    public:
+        /**
+         * @brief Creates or truncates a file for writing.
+         * @param filename File to write; compressed if it ends in ".gz".
+         */
+        explicit ExportFile(const std::string& filename);
+
+        /**
+         * @brief Finishes the file if close() was not called.
+         */
+        ~ExportFile() override;
+
+        ExportFile(const ExportFile&) = delete;
+        ExportFile& operator=(const ExportFile&) = delete;
+
+        /**
+         * @brief Checks whether the file could be created.
+         * @return True if writes reach the file.
+         */
+        bool is_open() const;
+
+        /**
+         * @brief Writes everything still buffered, finishes the gzip stream and closes the file.
+         */
+        void close();
+    };
+}
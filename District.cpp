@@ -0,0 +1,390 @@
+#include "District.h"
+#include "Compression.h"
+#include "Serialization.h"
+#include "utilities.h"
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace gradebook {
+
+    namespace {
+        /**
+         * @brief First four bytes of district.dat ("GBDS").
+         */
+        constexpr unsigned districtFileMagic = 0x53444247;
+
+        /**
+         * @brief Manifest format version written by saveManifest.
+         */
+        constexpr unsigned districtFormatVersion = 1;
+
+        /**
+         * @brief Encodes the manifest.
+         * @tparam Sink ByteSizer to measure the manifest or ByteWriter to write it.
+         * @param out Destination.
+         * @param schools Schools to list.
+         */
+        template <typename Sink>
+        void encodeManifest(Sink& out, const std::vector<SchoolShard>& schools) {
+            out.write(districtFileMagic);
+            out.write(districtFormatVersion);
+            out.write(static_cast<unsigned>(schools.size()));
+            for (const auto& shard : schools) {
+                out.writeString(shard.name);
+                out.writeString(shard.dataFile);
+            }
+        }
+    }
+
+    /**
+     * @brief Creates a district backed by a manifest file.
+     * @param manifest Path of the manifest file.
+     */
+    District::District(std::string manifest)
+        : manifestFile(std::move(manifest)) {
+    }
+
+    /**
+     * @brief Reads the list of schools from the manifest.
+     *
+     * Schools are only listed here; their data files are read when each
+     * school is first opened.
+     *
+     * @return True if the manifest was read; false if it is missing or damaged.
+     */
+    bool District::loadManifest() {
+        std::vector<char> buffer;
+        if (!readWholeFile(manifestFile, buffer)) {
+            return false;
+        }
+
+        std::vector<SchoolShard> loaded;
+        try {
+            ByteReader reader(buffer.data(), buffer.size());
+            if (reader.read<unsigned>() != districtFileMagic) {
+                throw std::runtime_error("not a district manifest");
+            }
+            unsigned version = reader.read<unsigned>();
+            if (version > districtFormatVersion) {
+                throw std::runtime_error("written by a newer version (format " + std::to_string(version) + ")");
+            }
+
+            unsigned count = reader.read<unsigned>();
+            for (unsigned i = 0; i < count; ++i) {
+                SchoolShard shard;
+                shard.name = reader.readString();
+                shard.dataFile = reader.readString();
+                loaded.push_back(std::move(shard));
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << manifestFile << " is damaged and was not loaded: " << e.what() << "\n";
+            return false;
+        }
+
+        schools = std::move(loaded);
+        return true;
+    }
+
+    /**
+     * @brief Writes the list of schools to the manifest, replacing it atomically.
+     * @return True on success.
+     */
+    bool District::saveManifest() const {
+        ByteSizer sizer;
+        encodeManifest(sizer, schools);
+
+        auto bytes = std::make_unique_for_overwrite<char[]>(sizer.size());
+        ByteWriter writer(bytes.get(), sizer.size());
+        encodeManifest(writer, schools);
+
+        if (!writeFileAtomically(manifestFile, bytes.get(), sizer.size(), true)) {
+            std::cerr << "Failed to write " << manifestFile << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Gets the number of schools in the district.
+     * @return School count.
+     */
+    size_t District::getSchoolCount() const {
+        return schools.size();
+    }
+
+    /**
+     * @brief Gets one school's shard.
+     * @param index Position of the school in the manifest.
+     * @return Const reference to the shard.
+     */
+    const SchoolShard& District::getSchool(size_t index) const {
+        return schools.at(index);
+    }
+
+    /**
+     * @brief Gets a school's gradebook, loading it from its data file on first use.
+     * @param index Position of the school in the manifest.
+     * @return Reference to the school's gradebook.
+     */
+    Gradebook& District::openSchool(size_t index) {
+        SchoolShard& shard = schools.at(index);
+        if (!shard.gradebook) {
+            auto gradebook = std::make_unique<Gradebook>();
+            gradebook->setDataFile(shard.dataFile);
+            if (fileExists(shard.dataFile)) {
+                gradebook->deserializeAndLoad();
+            }
+            shard.gradebook = std::move(gradebook);
+        }
+        return *shard.gradebook;
+    }
+
+    /**
+     * @brief Loads every school that has not been opened yet, each on its own thread.
+     *
+     * Each task builds and fills a gradebook no other thread can see, so the
+     * loads share nothing but the disk.
+     */
+    void District::loadAllSchools() {
+        std::vector<std::pair<size_t, std::future<std::unique_ptr<Gradebook>>>> pending;
+        for (size_t i = 0; i < schools.size(); ++i) {
+            if (schools[i].gradebook) continue;
+
+            pending.emplace_back(i, std::async(std::launch::async, [dataFile = schools[i].dataFile] {
+                auto gradebook = std::make_unique<Gradebook>();
+                gradebook->setDataFile(dataFile);
+                if (fileExists(dataFile)) {
+                    gradebook->deserializeAndLoad();
+                }
+                return gradebook;
+                }));
+        }
+
+        for (auto& [index, future] : pending) {
+            schools[index].gradebook = future.get();
+        }
+    }
+
+    /**
+     * @brief Picks a data file name no school in the district uses yet.
+     * @return The file name, e.g. "school3.dat".
+     */
+    std::string District::nextDataFileName() const {
+        for (size_t n = schools.size() + 1;; ++n) {
+            std::string candidate = "school" + std::to_string(n) + ".dat";
+            bool taken = fileExists(candidate);
+            for (const auto& shard : schools) {
+                taken = taken || shard.dataFile == candidate;
+            }
+            if (!taken) {
+                return candidate;
+            }
+        }
+    }
+
+    /**
+     * @brief Runs one school's logins until the user returns to the district menu.
+     *
+     * The school is loaded only the first time it is opened; later visits
+     * pick up the shard as it was left. Leaving offers to save the school,
+     * and its data stays open either way for district reports.
+     *
+     * @param index Position of the school in the manifest.
+     */
+    void District::schoolMenu(size_t index) {
+        Gradebook& gradebook = openSchool(index);
+        const SchoolShard& shard = schools[index];
+
+        if (gradebook.getSchool().empty()) {
+            std::cout << shard.dataFile << " has no administrator yet. Let's set up the school." << std::endl;
+            gradebook.createSchool();
+            gradebook.serializeAndSave();
+        }
+
+        std::cout << std::endl << "Welcome to " << shard.name << "!" << std::endl;
+        loginMenu(gradebook, "Return to District Menu");
+
+        if (userCheck("Would you like to save " + shard.name + " before returning? [Y/N] ",
+            "Saving school.",
+            "Returning without saving.")) {
+            gradebook.serializeAndSave();
+        }
+        else {
+            // Changes already autosaved stay saved, even if their group commit is still pending.
+            gradebook.flushPendingSaves();
+        }
+    }
+
+    /**
+     * @brief Adds a school to the district and records it in the manifest.
+     *
+     * The school is listed under the school name its administrator entered.
+     *
+     * @param gradebook The school's gradebook, already pointed at its data file.
+     * @return Position of the new school.
+     */
+    size_t District::addSchool(std::unique_ptr<Gradebook> gradebook) {
+        SchoolShard shard;
+        shard.name = gradebook->getSchool().empty()
+            ? "School " + std::to_string(schools.size() + 1)
+            : gradebook->getSchool().front().getSchoolName();
+        shard.dataFile = gradebook->getDataFile();
+        shard.gradebook = std::move(gradebook);
+        schools.push_back(std::move(shard));
+
+        if (saveManifest()) {
+            std::cout << "School " << schools.back().name << " added to the district." << std::endl;
+        }
+        return schools.size() - 1;
+    }
+
+    /**
+     * @brief Computes district-wide statistics, measuring every school in parallel.
+     * @return The finalized report.
+     */
+    StatisticsReport District::computeStatistics() {
+        loadAllSchools();
+
+        std::vector<std::pair<std::string, const Gradebook*>> measured;
+        measured.reserve(schools.size());
+        for (const auto& shard : schools) {
+            measured.emplace_back(shard.name, shard.gradebook.get());
+        }
+        return computeDistrictStatistics(measured);
+    }
+
+    /**
+     * @brief Exports every school's school report to one CSV file with a School column.
+     * @param filename Name of the CSV file to write.
+     */
+    void District::exportReportToCSV(const std::string& filename) {
+        loadAllSchools();
+
+        // Each task reads and refreshes the report cache of its own school only.
+        std::vector<std::future<std::string>> pending;
+        pending.reserve(schools.size());
+        for (auto& shard : schools) {
+            pending.push_back(std::async(std::launch::async, [&shard] {
+                std::ostringstream prefix;
+                writeQuoted(prefix, shard.name);
+                prefix << ",";
+                std::string schoolColumn = prefix.str();
+
+                std::string out;
+                for (const auto& rows : shard.gradebook->getSchoolReportRows()) {
+                    std::string_view csv = rows.csv;
+                    size_t lineStart = 0;
+                    while (lineStart < csv.size()) {
+                        size_t lineEnd = csv.find('\n', lineStart);
+                        lineEnd = (lineEnd == std::string_view::npos) ? csv.size() : lineEnd + 1;
+                        out += schoolColumn;
+                        out.append(csv.substr(lineStart, lineEnd - lineStart));
+                        lineStart = lineEnd;
+                    }
+                }
+                return out;
+                }));
+        }
+
+        ExportFile file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to create " << filename << std::endl;
+            for (auto& future : pending) {
+                future.wait();
+            }
+            return;
+        }
+
+        file << "School,Teacher,Student First Name,Student Last Name,Pronouns,Age,Grade Level,ID,Seat,Notes,Grade %,Letter Grade" << std::endl;
+        for (auto& future : pending) {
+            file << future.get();
+        }
+
+        file.close();
+        std::cout << "District data exported successfully to " << filename << "." << std::endl;
+    }
+
+    /**
+     * @brief Interactive district menu: open or add schools, and run district-wide reports.
+     *
+     * Opening a school runs that school's logins; leaving them comes back
+     * here, so any number of schools can be visited in one run.
+     */
+    void District::menu() {
+        if (schools.empty() && fileExists("gradebook.dat")) {
+            if (userCheck("Add the school saved in gradebook.dat to this district? [Y/N] ",
+                "Adding existing school.",
+                "Starting with an empty district.")) {
+                auto existing = std::make_unique<Gradebook>();
+                existing->deserializeAndLoad();
+                addSchool(std::move(existing));
+            }
+        }
+
+        while (true) {
+            std::cout << std::endl << "=== District Menu ===" << std::endl;
+            std::cout << "1. Open a School." << std::endl;
+            std::cout << "2. Add a School." << std::endl;
+            std::cout << "3. Print District Statistics." << std::endl;
+            std::cout << "4. Export District Report to CSV." << std::endl;
+            std::cout << "5. Exit." << std::endl;
+
+            unsigned choice = numericValidator<unsigned>("Choose an option [1-5]: ", 1, 5);
+
+            switch (choice) {
+            case 1: {
+                if (schools.empty()) {
+                    std::cout << "There are no schools in this district yet." << std::endl;
+                    break;
+                }
+                std::vector<std::string> labels;
+                labels.reserve(schools.size());
+                for (const auto& shard : schools) {
+                    labels.push_back(shard.name + " (" + shard.dataFile + ")");
+                }
+                size_t picked = pickFromList(labels);
+                if (picked < labels.size()) {
+                    schoolMenu(picked);
+                }
+                break;
+            }
+            case 2: {
+                auto gradebook = std::make_unique<Gradebook>();
+                gradebook->setDataFile(nextDataFileName());
+                gradebook->createSchool();
+                gradebook->serializeAndSave();
+                addSchool(std::move(gradebook));
+                break;
+            }
+            case 3: {
+                if (schools.empty()) {
+                    std::cout << "There are no schools in this district yet." << std::endl;
+                    break;
+                }
+                StatisticsReport report = computeStatistics();
+                std::cout << "===== District-Wide Statistics =====" << std::endl;
+                printStatistics(report);
+
+                if (userCheck("Would you like to export these statistics to CSV? [Y/N] ",
+                    "Exporting statistics to CSV...",
+                    "Skipping export.")) {
+                    exportStatisticsToCSV(report, exportFileName("DistrictStatistics.csv"));
+                }
+                break;
+            }
+            case 4:
+                exportReportToCSV(exportFileName("DistrictReport.csv"));
+                break;
+            case 5:
+                return;
+            default:
+                std::cout << "Invalid selection. Please try again." << std::endl;
+                break;
+            }
+        }
+    }
+}
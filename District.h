@@ -0,0 +1,120 @@
+#pragma once
+#include "Gradebook.h"
+#include "Statistics.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    /**
+     * @brief One school in a district: its own gradebook, rosters, indexes and data file.
+     */
+    struct SchoolShard {
+        std::string name;                       /**< Display name of the school */
+        std::string dataFile;                   /**< File the school's gradebook loads from and saves to */
+        std::unique_ptr<Gradebook> gradebook;   /**< The school's data; null until first opened */
+    };
+
+    /**
+     * @class District
+     * @brief Serves many schools from one process, each as an independent shard.
+     *
+     * Schools share nothing: each has its own Gradebook and its own data
+     * file, and is only loaded when it is first opened. School-scoped work
+     * touches only that school's shard. District-wide reports load any
+     * schools still on disk and measure every school on its own thread.
+     *
+     * The list of schools lives in a small manifest file next to the
+     * schools' data files.
+     */
+    class District {
+    private:
+        std::string manifestFile;               /**< File listing the district's schools */
+        std::vector<SchoolShard> schools;       /**< Every school, in manifest order */
+
+        /**
+         * @brief Loads every school that has not been opened yet, each on its own thread.
+         */
+        void loadAllSchools();
+
+        /**
+         * @brief Picks a data file name no school in the district uses yet.
+         * @return The file name.
+         */
+        std::string nextDataFileName() const;
+
+        /**
+         * @brief Runs one school's logins until the user returns to the district menu.
+         * @param index Position of the school in the manifest.
+         */
+        void schoolMenu(size_t index);
+
+    public:
+        /**
+         * @brief Creates a district backed by a manifest file.
+         * @param manifest Path of the manifest file.
+         */
+        explicit District(std::string manifest = "district.dat");
+
+        /**
+         * @brief Reads the list of schools from the manifest.
+         * @return True if the manifest was read; false if it is missing or damaged.
+         */
+        bool loadManifest();
+
+        /**
+         * @brief Writes the list of schools to the manifest, replacing it atomically.
+         * @return True on success.
+         */
+        bool saveManifest() const;
+
+        /**
+         * @brief Gets the number of schools in the district.
+         * @return School count.
+         */
+        size_t getSchoolCount() const;
+
+        /**
+         * @brief Gets one school's shard.
+         * @param index Position of the school in the manifest.
+         * @return Const reference to the shard.
+         */
+        const SchoolShard& getSchool(size_t index) const;
+
+        /**
+         * @brief Gets a school's gradebook, loading it from its data file on first use.
+         * @param index Position of the school in the manifest.
+         * @return Reference to the school's gradebook.
+         */
+        Gradebook& openSchool(size_t index);
+
+        /**
+         * @brief Adds a school to the district and records it in the manifest.
+         * @param gradebook The school's gradebook, already pointed at its data file.
+         * @return Position of the new school.
+         */
+        size_t addSchool(std::unique_ptr<Gradebook> gradebook);
+
+        /**
+         * @brief Computes district-wide statistics, measuring every school in parallel.
+         * @return The finalized report.
+         */
+        StatisticsReport computeStatistics();
+
+        /**
+         * @brief Exports every school's school report to one CSV file with a School column.
+         *
+         * Each school renders its own rows on its own thread; the rows are
+         * then written in manifest order.
+         *
+         * @param filename Name of the CSV file to write.
+         */
+        void exportReportToCSV(const std::string& filename);
+
+        /**
+         * @brief Interactive district menu: open or add schools, and run district-wide reports.
+         */
+        void menu();
+    };
+}
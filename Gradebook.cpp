@@ -1,13 +1,21 @@
 #include "Gradebook.h"
 #include "Administrator.h"
+#include "Compression.h"
+#include "Merge.h"
 #include "Student.h"
+#include "Serialization.h"
 #include "Teacher.h"
 #include "utilities.h"
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <sstream>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace gradebook {
 
@@ -21,6 +29,14 @@ namespace gradebook {
         return school;
     }
 
+    /**
+     * @brief Gets a const reference to the vector of administrators.
+     * @return Const reference to vector of Administrator objects.
+     */
+    const std::vector<Administrator>& Gradebook::getSchool() const {
+        return school;
+    }
+
     /**
      * @brief Gets a modifiable reference to the vector of teachers.
      * @return Reference to vector of Teacher objects.
@@ -53,6 +69,14 @@ namespace gradebook {
         return students;
     }
 
+    /**
+     * @brief Gets the hot records of every student, in the same order as getStudents().
+     * @return Const reference to the records.
+     */
+    const std::vector<StudentRecord>& Gradebook::getStudentRecords() const {
+        return studentRecords;
+    }
+
     /**
      * @brief Returns whether autosave is currently enabled.
      * @return True if autosave is enabled; false otherwise.
@@ -61,6 +85,182 @@ namespace gradebook {
         return autosaveEnabled;
     }
 
+    /**
+     * @brief Gets the file this gradebook loads from and saves to.
+     * @return The data file path.
+     */
+    const std::string& Gradebook::getDataFile() const {
+        return dataFile;
+    }
+
+    /**
+     * @brief Points the gradebook at another data file, committing pending saves to the old one first.
+     * @param filename The new data file path.
+     */
+    void Gradebook::setDataFile(const std::string& filename) {
+        // The committer is bound to the old file; a new one is started on the next autosave.
+        committer.reset();
+        dataFile = filename;
+        if (sharedFile) {
+            sharedFile = std::make_unique<SharedDataFile>(dataFile, sharedFile->isWatching());
+        }
+    }
+
+    /**
+     * @brief Lets other sessions use the data file at the same time as this one.
+     * @param watch True to watch the file for other sessions' commits.
+     */
+    void Gradebook::shareDataFile(bool watch) {
+        // A committer already running would write around the shared file.
+        committer.reset();
+        sharedFile = std::make_unique<SharedDataFile>(dataFile, watch);
+    }
+
+    /**
+     * @brief Issues a new, globally unique revision number.
+     * @return A revision number greater than any previously issued.
+     */
+    unsigned long long Gradebook::nextRevision() {
+        static std::atomic<unsigned long long> revisionClock{ 0 };
+        return ++revisionClock;
+    }
+
+    // === Report Cache ===
+
+    /**
+     * @brief Gets the per-classroom school report rows.
+     *
+     * Each cache entry remembers the teacher revision and the latest student
+     * change version it was rendered from, so only classrooms whose roster,
+     * scores or students' profiles changed since the last build are rendered
+     * again. Everything else is served straight from the cache.
+     *
+     * @return Const reference to cached rows, one entry per teacher.
+     */
+    const std::vector<ClassroomReportRows>& Gradebook::getSchoolReportRows() {
+        reportCache.resize(teachers.size());
+
+        for (size_t i = 0; i < teachers.size(); ++i) {
+            ClassroomReportRows& rows = reportCache[i];
+            if (!rows.valid || rows.revision != teachers[i].getRevision()
+                || rows.studentsVersion != latestRosterChange(teachers[i])) {
+                renderClassroomRows(teachers[i], rows);
+            }
+        }
+
+        return reportCache;
+    }
+
+    /**
+     * @brief Drops every cached report row.
+     */
+    void Gradebook::invalidateReportCache() {
+        reportCache.clear();
+    }
+
+    /**
+     * @brief Gets the latest change version among a classroom's students.
+     *
+     * Every edit to a tracked student, including age, grade level, pronouns,
+     * seat and notes, moves it to a newer version than any before it.
+     *
+     * @param teacher Teacher whose roster is checked.
+     * @return The highest student change version; 0 if none is tracked.
+     */
+    ChangeVersion Gradebook::latestRosterChange(const Teacher& teacher) {
+        ChangeVersion latest = 0;
+        for (const Student* student : teacher.getClassroomStudents()) {
+            if (student) {
+                latest = std::max(latest, student->getChangeVersion());
+            }
+        }
+        return latest;
+    }
+
+    /**
+     * @brief Renders the console and CSV school report rows for one classroom.
+     * @param teacher Teacher whose classroom is rendered.
+     * @param rows Cache entry to overwrite.
+     */
+    void Gradebook::renderClassroomRows(const Teacher& teacher, ClassroomReportRows& rows) {
+        std::ostringstream printed;
+        std::ostringstream csv;
+
+        printed << teacher.getTitleView() << " " << teacher.getFirstNameView()
+            << " " << teacher.getLastNameView()
+            << " (Grade " << teacher.getGradeLevel() << ")" << '\n';
+
+        const auto& classroom = teacher.getClassroomStudents();
+
+        if (classroom.empty()) {
+            printed << "  No students assigned to this teacher." << '\n' << '\n';
+        }
+        else {
+            printed << std::left
+                << std::setw(16) << "First Name:"
+                << std::setw(16) << "Last Name:"
+                << std::setw(9) << "Age:"
+                << std::setw(11) << "ID:"
+                << std::setw(16) << "Percent Grade:"
+                << std::setw(13) << "Letter Grade:"
+                << '\n';
+
+            printed << std::string(81, '-') << '\n';
+
+            std::string teacherName;
+            teacherName.append(teacher.getFirstNameView()).append(" ").append(teacher.getLastNameView());
+
+            for (const Student* student : classroom) {
+                if (!student) continue;
+
+                printed << std::left
+                    << std::setw(16) << student->getFirstNameView()
+                    << std::setw(16) << student->getLastNameView()
+                    << std::setw(9) << student->getAge()
+                    << std::setw(11) << student->getID()
+                    << std::setw(16) << std::fixed << std::setprecision(2) << student->getClassroomGradePercent(teacher.getClassroomID())
+                    << std::setw(13) << student->getClassroomGrade(teacher.getClassroomID())
+                    << '\n';
+
+                writeSchoolReportRow(csv, teacherName, *student, teacher.getClassroomID());
+                csv << '\n';
+            }
+            printed << '\n';
+        }
+
+        rows.printed = printed.str();
+        rows.csv = csv.str();
+        rows.revision = teacher.getRevision();
+        rows.studentsVersion = latestRosterChange(teacher);
+        rows.valid = true;
+    }
+
+    /**
+     * @brief Writes the cells of one school report CSV row, without the line end.
+     * @param out Destination.
+     * @param teacherName Teacher's first and last name.
+     * @param student Student the row is about.
+     * @param classroomID Classroom whose grade the row shows.
+     */
+    void Gradebook::writeSchoolReportRow(std::ostream& out, std::string_view teacherName, const Student& student, unsigned classroomID) {
+        writeQuoted(out, teacherName);
+        out << ",";
+        writeQuoted(out, student.getFirstNameView());
+        out << ",";
+        writeQuoted(out, student.getLastNameView());
+        out << ",";
+        writeQuoted(out, student.getPronounsView());
+        out << "," << student.getAge()
+            << "," << student.getGradeLevel()
+            << "," << student.getID() << ",";
+        writeQuoted(out, student.getSeatView());
+        out << ",";
+        writeQuoted(out, student.getNotesView());
+        out << ","
+            << std::fixed << std::setprecision(2) << student.getClassroomGradePercent(classroomID) << ","
+            << student.getClassroomGrade(classroomID);
+    }
+
     // === Admin Function ===
 
     /**
@@ -118,225 +318,1662 @@ namespace gradebook {
         std::cout << "Autosave " << (autosaveEnabled ? "enabled." : "disabled.") << std::endl;
     }
 
-    // === Serialization (Save) ===
+    // === Assignment Directory ===
 
     /**
-     * @brief Serializes and saves the gradebook data to a binary file ("gradebook.dat").
-     * Saves administrators, students (with assignment scores), and teachers (with classroom assignments and assignments).
+     * @brief Issues a new stable assignment ID owned by a teacher.
+     * @param owner Teacher the assignment belongs to; must be stored in this gradebook.
+     * @return The new ID.
      */
-    void Gradebook::serializeAndSave() {
-        std::ofstream outFile("gradebook.dat", std::ios::binary);
-        if (!outFile) {
-            std::cerr << "Failed to open file for saving.\n";
-            return;
+    unsigned Gradebook::registerAssignment(const Teacher& owner) {
+        unsigned assignmentID = nextAssignmentID++;
+        assignmentOwners[assignmentID] = owner.getClassroomID();
+        return assignmentID;
+    }
+
+    /**
+     * @brief Forgets a deleted assignment's ID. The ID is never issued again.
+     * @param assignmentID ID of the deleted assignment.
+     */
+    void Gradebook::unregisterAssignment(unsigned assignmentID) {
+        assignmentOwners.erase(assignmentID);
+        textIndex->removeAssignment(assignmentID);
+    }
+
+    /**
+     * @brief Finds an assignment anywhere in the school by its stable ID.
+     * @param assignmentID ID to look up.
+     * @return Pointer to the assignment, or nullptr if no such assignment exists.
+     */
+    const Assignment* Gradebook::findAssignment(unsigned assignmentID) const {
+        const Teacher* owner = findAssignmentOwner(assignmentID);
+        return owner ? owner->findAssignment(assignmentID) : nullptr;
+    }
+
+    /**
+     * @brief Finds the teacher who owns an assignment.
+     * @param assignmentID ID to look up.
+     * @return Pointer to the teacher, or nullptr if no such assignment exists.
+     */
+    const Teacher* Gradebook::findAssignmentOwner(unsigned assignmentID) const {
+        auto owner = assignmentOwners.find(assignmentID);
+        return owner == assignmentOwners.end() ? nullptr : findClassroom(owner->second);
+    }
+
+    /**
+     * @brief Adds a newly stored assignment's description to the full-text index.
+     * @param assignment Assignment already registered and stored with its teacher.
+     */
+    void Gradebook::indexAssignmentDescription(const Assignment& assignment) {
+        textIndex->setAssignmentDescription(assignment.getAssignmentID(), assignment.getAssignmentDescriptionView());
+    }
+
+    /**
+     * @brief Rebuilds the assignment ID directory from every teacher's assignments.
+     */
+    void Gradebook::rebuildAssignmentDirectory() {
+        assignmentOwners.clear();
+        for (const auto& t : teachers) {
+            for (const auto& a : t.getAssignments()) {
+                assignmentOwners[a.getAssignmentID()] = t.getClassroomID();
+                nextAssignmentID = std::max(nextAssignmentID, a.getAssignmentID() + 1);
+            }
         }
+    }
 
-        // Helper lambdas to write various types
-        auto writeString = [&](const std::string& str) {
-            size_t len = str.size();
-            outFile.write(reinterpret_cast<char*>(&len), sizeof(len));
-            outFile.write(str.c_str(), len);
-            };
-        auto writeUnsigned = [&](unsigned val) {
-            outFile.write(reinterpret_cast<char*>(&val), sizeof(val));
-            };
-        auto writeFloat = [&](float val) {
-            outFile.write(reinterpret_cast<char*>(&val), sizeof(val));
-            };
-        auto writeChar = [&](char c) {
-            outFile.write(reinterpret_cast<char*>(&c), sizeof(c));
-            };
+    // === Classroom Directory ===
+
+    /**
+     * @brief Stores a new teacher and issues their classroom a stable ID.
+     * @param teacher The teacher to store.
+     * @return Reference to the stored teacher.
+     */
+    Teacher& Gradebook::addTeacher(Teacher teacher) {
+        teacher.setClassroomID(nextClassroomID++);
+        classroomsByID[teacher.getClassroomID()] = teachers.size();
+        teachersByGradeLevel[teacher.getGradeLevel()].push_back(teachers.size());
+        teachers.push_back(std::move(teacher));
+        return teachers.back();
+    }
+
+    /**
+     * @brief Finds a classroom by its stable ID.
+     * @param classroomID ID to look up.
+     * @return Pointer to the classroom's teacher, or nullptr if no such classroom exists.
+     */
+    Teacher* Gradebook::findClassroom(unsigned classroomID) {
+        auto found = classroomsByID.find(classroomID);
+        return found == classroomsByID.end() ? nullptr : &teachers[found->second];
+    }
+
+    /**
+     * @brief Finds a classroom by its stable ID without modifying it.
+     * @param classroomID ID to look up.
+     * @return Pointer to the classroom's teacher, or nullptr if no such classroom exists.
+     */
+    const Teacher* Gradebook::findClassroom(unsigned classroomID) const {
+        auto found = classroomsByID.find(classroomID);
+        return found == classroomsByID.end() ? nullptr : &teachers[found->second];
+    }
+
+    /**
+     * @brief Lists the teachers of one grade level.
+     * @param gradeLevel Grade level to look up.
+     * @return Pointers to those teachers, in the order they were added.
+     */
+    std::vector<Teacher*> Gradebook::getTeachersForGrade(unsigned gradeLevel) {
+        std::vector<Teacher*> result;
+        auto found = teachersByGradeLevel.find(gradeLevel);
+        if (found != teachersByGradeLevel.end()) {
+            result.reserve(found->second.size());
+            for (size_t position : found->second) {
+                result.push_back(&teachers[position]);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Moves a classroom to another grade level, keeping the grade level directory current.
+     * @param teacher Teacher stored in this gradebook.
+     * @param gradeLevel The new grade level.
+     */
+    void Gradebook::setClassroomGradeLevel(Teacher& teacher, unsigned gradeLevel) {
+        if (teacher.getGradeLevel() == gradeLevel) return;
+
+        size_t position = teacherPosition(teacher);
+        auto& before = teachersByGradeLevel[teacher.getGradeLevel()];
+        before.erase(std::remove(before.begin(), before.end(), position), before.end());
+        if (before.empty()) {
+            teachersByGradeLevel.erase(teacher.getGradeLevel());
+        }
+        // Each level lists its teachers in the order they were added.
+        auto& after = teachersByGradeLevel[gradeLevel];
+        after.insert(std::upper_bound(after.begin(), after.end(), position), position);
+        teacher.setGradeLevel(gradeLevel);
+    }
+
+    /**
+     * @brief Rebuilds the classroom ID and grade level directories from every teacher.
+     */
+    void Gradebook::rebuildClassroomDirectory() {
+        classroomsByID.clear();
+        teachersByGradeLevel.clear();
+        classroomsByID.reserve(teachers.size());
+        for (size_t t = 0; t < teachers.size(); ++t) {
+            classroomsByID[teachers[t].getClassroomID()] = t;
+            teachersByGradeLevel[teachers[t].getGradeLevel()].push_back(t);
+            nextClassroomID = std::max(nextClassroomID, teachers[t].getClassroomID() + 1);
+        }
+    }
+
+    // === Student Directory ===
 
-        // --- Save administrators ---
-        size_t adminCount = school.size();
-        writeUnsigned((unsigned)adminCount);
-        for (const auto& admin : school) {
-            writeString(admin.getAdminTitle());
-            writeString(admin.getFirstName());
-            writeString(admin.getLastName());
-            writeString(admin.getSchoolName());
-            writeString(admin.getPassword());
-        }
-
-        // --- Save students ---
-        size_t studentCount = students.size();
-        writeUnsigned((unsigned)studentCount);
-        for (const auto& studentPtr : students) {
-            const Student& student = *studentPtr;
-
-            writeString(student.getFirstName());
-            writeString(student.getLastName());
-            writeString(student.getPronouns());
-            writeUnsigned(student.getAge());
-            writeUnsigned(student.getGradeLevel());
-            writeUnsigned(student.getID());
-            writeString(student.getSeat());
-            writeString(student.getNotes());
-            writeChar(student.getOverallGrade());
-            writeFloat(student.getGradePercent());
-
-            // Assignment scores
-            const auto& scores = student.getAssignmentScores();
-            writeUnsigned((unsigned)scores.size());
-            for (const auto& [name, score] : scores) {
-                writeString(name);
-                writeFloat(score);
-            }
-        }
-
-        // --- Save teachers ---
-        size_t teacherCount = teachers.size();
-        writeUnsigned((unsigned)teacherCount);
-        for (const auto& teacher : teachers) {
-            writeString(teacher.getTitle());
-            writeString(teacher.getFirstName());
-            writeString(teacher.getLastName());
-            writeUnsigned(teacher.getGradeLevel());
-            writeString(teacher.getPassword());
-
-            // Classroom students to write IDs
-            const auto& cls = teacher.getClassroomStudents();
-            writeUnsigned((unsigned)cls.size());
-            for (const auto* sPtr : cls) {
-                writeUnsigned(sPtr->getID());
+    /**
+     * @brief Gets a teacher's position in the teachers vector.
+     * @param teacher Teacher stored in this gradebook.
+     * @return The position.
+     */
+    size_t Gradebook::teacherPosition(const Teacher& teacher) const {
+        return static_cast<size_t>(&teacher - teachers.data());
+    }
+
+    /**
+     * @brief Takes ownership of a new student and records its slot.
+     * @param student The student to store.
+     * @return Pointer to the stored student.
+     */
+    Student* Gradebook::addStudent(std::unique_ptr<Student> student) {
+        Student* stored = student.get();
+        const StudentRecord* before = studentRecords.data();
+        studentRecords.push_back(stored->getRecord());
+        if (studentRecords.data() == before) {
+            stored->attachRecord(&studentRecords.back());
+        }
+        studentSlots[stored] = students.size();
+        studentsByID[stored->getID()] = stored;
+        studentIndex->insert(stored);
+        textIndex->setStudentNotes(stored, stored->getNotesView());
+        stored->setChangeLog(changeLog.get());
+        stored->markChanged();
+        students.push_back(std::move(student));
+        if (studentRecords.data() != before) {
+            attachStudentRecords();
+        }
+        return stored;
+    }
+
+    /**
+     * @brief Puts a stored student on a teacher's roster.
+     * @param teacher Teacher stored in this gradebook.
+     * @param student Student stored in this gradebook.
+     */
+    void Gradebook::enrollStudent(Teacher& teacher, Student* student) {
+        if (!teacher.hasStudent(student)) {
+            teacher.addStudentToClassroom(student);
+        }
+    }
+
+    /**
+     * @brief Finds a student by ID.
+     * @param id Student ID.
+     * @return Pointer to the student, or nullptr if no student has that ID.
+     */
+    Student* Gradebook::findStudentByID(unsigned id) const {
+        auto found = studentsByID.find(id);
+        return found == studentsByID.end() ? nullptr : found->second;
+    }
+
+    /**
+     * @brief Renames a student, keeping every roster they are on in name order.
+     * @param student Student stored in this gradebook.
+     * @param firstName The new first name.
+     * @param lastName The new last name.
+     */
+    void Gradebook::renameStudent(Student* student, const std::string& firstName, const std::string& lastName) {
+        student->setFirstName(firstName);
+        student->setLastName(lastName);
+        student->markChanged();
+        for (const auto& enrollment : student->getEnrollments()) {
+            if (Teacher* teacher = findClassroom(enrollment.classroomID)) {
+                teacher->reindexStudentName(student);
+            }
+        }
+    }
+
+    /**
+     * @brief Lists the teachers of every class a student is enrolled in.
+     * @param student Student to look up.
+     * @return Pointers to those teachers, in classroom ID order.
+     */
+    std::vector<const Teacher*> Gradebook::getTeachersOf(const Student* student) const {
+        std::vector<const Teacher*> result;
+        result.reserve(student->getEnrollments().size());
+        for (const auto& enrollment : student->getEnrollments()) {
+            if (const Teacher* teacher = findClassroom(enrollment.classroomID)) {
+                result.push_back(teacher);
             }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Deletes a student, taking them off the roster of every class they are enrolled in.
+     * @param student Student to delete; the pointer is invalid afterwards.
+     * @return True if the student was stored in this gradebook.
+     */
+    bool Gradebook::removeStudent(Student* student) {
+        auto entry = studentSlots.find(student);
+        if (entry == studentSlots.end()) {
+            return false;
+        }
+
+        // Leaving a roster withdraws the enrollment, so walk a copy of the IDs.
+        std::vector<unsigned> classroomIDs;
+        classroomIDs.reserve(student->getEnrollments().size());
+        for (const auto& enrollment : student->getEnrollments()) {
+            classroomIDs.push_back(enrollment.classroomID);
+        }
+        for (unsigned classroomID : classroomIDs) {
+            if (Teacher* teacher = findClassroom(classroomID)) {
+                teacher->removeStudentFromClassroom(student);
+            }
+        }
+
+        auto byID = studentsByID.find(student->getID());
+        if (byID != studentsByID.end() && byID->second == student) {
+            studentsByID.erase(byID);
+        }
+        studentIndex->erase(student);
+        textIndex->removeStudent(student);
+        changeLog->forgetStudent(student, student->getChangeVersion());
+        changeLog->addTombstone(TombstoneKind::StudentRemoved, student->getID());
+        student->setChangeLog(nullptr);
+        student->detachRecord();
+
+        // Swap the last student and record into the freed slot, then drop the tail.
+        size_t slot = entry->second;
+        studentSlots.erase(entry);
+        if (slot + 1 != students.size()) {
+            std::swap(students[slot], students.back());
+            studentRecords[slot] = studentRecords.back();
+            studentSlots[students[slot].get()] = slot;
+            students[slot]->attachRecord(&studentRecords[slot]);
+        }
+        students.pop_back();
+        studentRecords.pop_back();
+        return true;
+    }
+
+    /**
+     * @brief Moves students from one classroom to another in one batch.
+     * @param batch Students to move; ones not on the source roster are skipped.
+     * @param from Teacher the students leave.
+     * @param to Teacher the students join.
+     * @param regrade If true, moved students take the destination's grade level.
+     * @return Number of students moved.
+     */
+    size_t Gradebook::transferStudents(const std::vector<Student*>& batch, Teacher& from, Teacher& to, bool regrade) {
+        if (&from == &to) {
+            return 0;
+        }
+
+        std::unordered_set<const Student*> leaving;
+        std::vector<Student*> joining;
+        leaving.reserve(batch.size());
+        joining.reserve(batch.size());
+        for (Student* s : batch) {
+            if (from.hasStudent(s) && leaving.insert(s).second) {
+                if (!to.hasStudent(s)) {
+                    joining.push_back(s);
+                }
+            }
+        }
+
+        // Grade levels change before the rosters are touched, so cached report rows pick them up.
+        if (regrade) {
+            for (Student* s : batch) {
+                if (leaving.count(s)) {
+                    s->setGradeLevel(to.getGradeLevel());
+                }
+            }
+        }
+
+        from.removeStudentsFromClassroom(leaving);
+        to.addStudentsToClassroom(joining);
+
+        for (Student* s : joining) {
+            s->calculateGrade(to.getClassroomID(), to.getAssignments());
+        }
+        return leaving.size();
+    }
+
+    /**
+     * @brief Finds the students matching a grade level, letter grade and age band.
+     * @param filter What to match.
+     * @return Matching students, grouped by grade level, then letter grade, then age.
+     */
+    std::vector<Student*> Gradebook::findStudents(const StudentFilter& filter) const {
+        return studentIndex->find(filter);
+    }
+
+    /**
+     * @brief Counts the students matching a grade level, letter grade and age band.
+     * @param filter What to match.
+     * @return Number of matching students.
+     */
+    size_t Gradebook::countStudents(const StudentFilter& filter) const {
+        return studentIndex->count(filter);
+    }
+
+    /**
+     * @brief Searches student notes and assignment descriptions.
+     * @param query Search text.
+     * @param limit Most results to return.
+     * @return Hits, most relevant first.
+     */
+    std::vector<TextHit> Gradebook::searchText(const std::string& query, size_t limit) const {
+        return textIndex->search(query, limit);
+    }
+
+    /**
+     * @brief Gets the log of change versions, removals and export watermarks.
+     * @return Reference to the log.
+     */
+    ChangeLog& Gradebook::getChangeLog() {
+        return *changeLog;
+    }
+
+    /**
+     * @brief Gets the log of change versions, removals and export watermarks without modifying it.
+     * @return Const reference to the log.
+     */
+    const ChangeLog& Gradebook::getChangeLog() const {
+        return *changeLog;
+    }
+
+    /**
+     * @brief Rebuilds the full-text index from every student's notes and assignment's description.
+     */
+    void Gradebook::rebuildTextIndex() {
+        std::vector<Student*> all;
+        all.reserve(students.size());
+        for (const auto& s : students) {
+            all.push_back(s.get());
+        }
+
+        std::vector<std::pair<unsigned, std::string_view>> descriptions;
+        for (const auto& t : teachers) {
+            for (const auto& a : t.getAssignments()) {
+                descriptions.emplace_back(a.getAssignmentID(), a.getAssignmentDescriptionView());
+            }
+        }
+        textIndex->rebuild(all, descriptions);
+    }
+
+    /**
+     * @brief Points every student at its slot in studentRecords, after the array moved.
+     */
+    void Gradebook::attachStudentRecords() {
+        for (size_t i = 0; i < students.size(); ++i) {
+            students[i]->attachRecord(&studentRecords[i]);
+        }
+    }
+
+    /**
+     * @brief Rebuilds the student slot and ID maps, the record array and the secondary index from the student list.
+     */
+    void Gradebook::rebuildStudentDirectory() {
+        studentSlots.clear();
+        studentsByID.clear();
+        studentSlots.reserve(students.size());
+        studentsByID.reserve(students.size());
+
+        std::vector<StudentRecord> records;
+        records.reserve(students.size());
+        for (const auto& s : students) {
+            records.push_back(s->getRecord());
+        }
+        studentRecords = std::move(records);
+        attachStudentRecords();
+
+        for (size_t i = 0; i < students.size(); ++i) {
+            studentSlots[students[i].get()] = i;
+            // Later records win on duplicate IDs.
+            studentsByID[students[i]->getID()] = students[i].get();
+        }
+        studentIndex->rebuild(students);
+    }
+
+    // === Serialization (Save) ===
+
+    namespace {
+        /**
+         * @brief Fewest student records worth encoding or decoding on a separate thread.
+         */
+        constexpr size_t minimumStudentsPerWorker = 4096;
+
+        /**
+         * @brief Fewest teacher records worth encoding or decoding on a separate thread.
+         */
+        constexpr size_t minimumTeachersPerWorker = 64;
+
+        /**
+         * @brief Encodes one administrator record.
+         * @tparam Sink ByteSizer to measure the record or ByteWriter to write it.
+         * @param out Destination.
+         * @param admin Administrator to encode.
+         */
+        template <typename Sink>
+        void encodeAdministratorRecord(Sink& out, const Administrator& admin) {
+            out.writeString(admin.getAdminTitleView());
+            out.writeString(admin.getFirstNameView());
+            out.writeString(admin.getLastNameView());
+            out.writeString(admin.getSchoolNameView());
+            out.writeString(admin.getPasswordView());
+        }
+
+        /**
+         * @brief Encodes one student record, including assignment scores.
+         * @tparam Sink ByteSizer to measure the record or ByteWriter to write it.
+         * @param out Destination.
+         * @param student Student to encode.
+         */
+        template <typename Sink>
+        void encodeStudentRecord(Sink& out, const Student& student) {
+            out.writeString(student.getFirstNameView());
+            out.writeString(student.getLastNameView());
+            out.writeString(student.getPronounsView());
+            out.write(student.getAge());
+            out.write(student.getGradeLevel());
+            out.write(student.getID());
+            out.writeString(student.getSeatView());
+            out.writeString(student.getNotesView());
+            out.write(student.getOverallGrade());
+            out.write(student.getGradePercent());
+            out.write(student.getChangeVersion());
+
+            // Enrollments, each with its scores keyed by assignment ID
+            const auto& enrollments = student.getEnrollments();
+            out.write(static_cast<unsigned>(enrollments.size()));
+            for (const auto& enrollment : enrollments) {
+                out.write(enrollment.classroomID);
+                out.write(enrollment.letterGrade);
+                out.write(enrollment.gradePercent);
+                out.write(static_cast<unsigned>(enrollment.scores.size()));
+                for (const auto& entry : enrollment.scores) {
+                    out.write(entry.assignmentID);
+                    out.write(entry.score);
+                    out.write(entry.version);
+                }
+            }
+        }
+
+        /**
+         * @brief Encodes one teacher record, including assignments.
+         *
+         * The roster is not written; it is rebuilt from the students' enrollments.
+         *
+         * @tparam Sink ByteSizer to measure the record or ByteWriter to write it.
+         * @param out Destination.
+         * @param teacher Teacher to encode.
+         */
+        template <typename Sink>
+        void encodeTeacherRecord(Sink& out, const Teacher& teacher) {
+            out.write(teacher.getClassroomID());
+            out.writeString(teacher.getTitleView());
+            out.writeString(teacher.getFirstNameView());
+            out.writeString(teacher.getLastNameView());
+            out.write(teacher.getGradeLevel());
+            out.writeString(teacher.getPasswordView());
 
             // Assignments
             const auto& assigns = teacher.getAssignments();
-            writeUnsigned((unsigned)assigns.size());
+            out.write(static_cast<unsigned>(assigns.size()));
             for (const auto& a : assigns) {
-                writeString(a.getAssignmentName());
-                writeFloat(a.getPointsPossible());
+                out.write(a.getAssignmentID());
+                out.writeString(a.getAssignmentNameView());
+                out.writeString(a.getAssignmentDescriptionView());
+                out.write(a.getPointsPossible());
+            }
+        }
+
+        /**
+         * @brief Encodes the change log: latest version, tombstones and export watermarks.
+         * @tparam Sink ByteSizer to measure the section or ByteWriter to write it.
+         * @param out Destination.
+         * @param log Log to encode.
+         */
+        template <typename Sink>
+        void encodeChangeSection(Sink& out, const ChangeLog& log) {
+            out.write(log.getCurrentVersion());
+
+            const auto& tombstones = log.getTombstones();
+            out.write(static_cast<unsigned>(tombstones.size()));
+            for (const auto& t : tombstones) {
+                out.write(t.version);
+                out.write(static_cast<unsigned char>(t.kind));
+                out.write(t.studentID);
+                out.write(t.classroomID);
+                out.write(t.assignmentID);
+            }
+
+            const auto& watermarks = log.getWatermarks();
+            out.write(static_cast<unsigned>(watermarks.size()));
+            for (const auto& [name, version] : watermarks) {
+                out.writeString(name);
+                out.write(version);
+            }
+        }
+
+        /**
+         * @brief Measures one record behind its frame.
+         * @param out Sizer.
+         * @param encode Callable taking (sink) that encodes the record.
+         */
+        template <typename EncodeFn>
+        void encodeFramedRecord(ByteSizer& out, EncodeFn encode) {
+            out.write(0u);
+            out.write(0u);
+            encode(out);
+        }
+
+        /**
+         * @brief Writes one record behind its frame, filling in the record's length and CRC-32 once it is written.
+         * @param out Writer.
+         * @param encode Callable taking (sink) that encodes the record.
+         */
+        template <typename EncodeFn>
+        void encodeFramedRecord(ByteWriter& out, EncodeFn encode) {
+            char* frame = out.cursor();
+            out.write(0u);
+            out.write(0u);
+            size_t start = out.position();
+            encode(out);
+
+            unsigned length = static_cast<unsigned>(out.position() - start);
+            unsigned crc = crc32(frame + recordFrameBytes, length);
+            std::memcpy(frame, &length, sizeof(length));
+            std::memcpy(frame + sizeof(length), &crc, sizeof(crc));
+        }
+
+        /**
+         * @brief A run of records split into per-worker ranges, each with its exact encoded size.
+         */
+        struct SectionLayout {
+            unsigned workers = 1;               ///< Number of ranges
+            std::vector<size_t> rangeBytes;     ///< Encoded size of each range
+            size_t totalBytes = 0;              ///< Sum of rangeBytes
+        };
+
+        /**
+         * @brief First pass: measures each worker's range of records in parallel.
+         * @param count Number of records.
+         * @param minimumPerWorker Smallest range worth a thread.
+         * @param encode Callable taking (sink, record index).
+         * @return The measured layout.
+         */
+        template <typename EncodeFn>
+        SectionLayout measureSection(size_t count, size_t minimumPerWorker, EncodeFn encode) {
+            SectionLayout layout;
+            layout.workers = workerCountFor(count, minimumPerWorker);
+            layout.rangeBytes.assign(layout.workers, 0);
+
+            parallelForRanges(count, layout.workers, [&](unsigned w, size_t first, size_t last) {
+                ByteSizer sizer;
+                for (size_t i = first; i < last; ++i) {
+                    encode(sizer, i);
+                }
+                layout.rangeBytes[w] = sizer.size();
+                });
+
+            for (size_t bytes : layout.rangeBytes) {
+                layout.totalBytes += bytes;
             }
+            return layout;
         }
 
-        outFile.close();
-        std::cout << "Gradebook data saved to gradebook.dat.\n";
+        /**
+         * @brief Second pass: writes each worker's range into its own slice of the buffer in parallel.
+         * @param out Start of the section in the save buffer.
+         * @param count Number of records.
+         * @param layout Layout returned by measureSection for the same records.
+         * @param encode Callable taking (sink, record index).
+         */
+        template <typename EncodeFn>
+        void writeSection(char* out, size_t count, const SectionLayout& layout, EncodeFn encode) {
+            std::vector<size_t> rangeOffsets(layout.workers, 0);
+            for (unsigned w = 1; w < layout.workers; ++w) {
+                rangeOffsets[w] = rangeOffsets[w - 1] + layout.rangeBytes[w - 1];
+            }
+
+            parallelForRanges(count, layout.workers, [&](unsigned w, size_t first, size_t last) {
+                ByteWriter writer(out + rangeOffsets[w], layout.rangeBytes[w]);
+                for (size_t i = first; i < last; ++i) {
+                    encode(writer, i);
+                }
+                if (writer.position() != layout.rangeBytes[w]) {
+                    throw std::logic_error("Record changed size between measuring and writing");
+                }
+                });
+        }
     }
 
-    // === Deserialization (Load) ===
+    /**
+     * @brief Encodes the whole gradebook into one exactly sized buffer.
+     *
+     * A first pass measures every section exactly, so the whole file is laid
+     * out in one preallocated buffer. Student and teacher ranges are then
+     * encoded into their own slices of that buffer in parallel, each record
+     * checksummed as it is written, and finally every section's body is
+     * checksummed in parallel for its header.
+     *
+     * @param snapshot Receives the encoded file contents.
+     * @return True on success, false if encoding failed.
+     */
+    bool Gradebook::encodeSnapshot(ByteBuffer& snapshot) const {
+        auto encodeAdmin = [&](auto& out, size_t i) {
+            encodeFramedRecord(out, [&](auto& record) { encodeAdministratorRecord(record, school[i]); });
+            };
+        auto encodeStudent = [&](auto& out, size_t i) {
+            encodeFramedRecord(out, [&](auto& record) { encodeStudentRecord(record, *students[i]); });
+            };
+        auto encodeTeacher = [&](auto& out, size_t i) {
+            encodeFramedRecord(out, [&](auto& record) { encodeTeacherRecord(record, teachers[i]); });
+            };
+
+        try {
+            // --- Measure ---
+            ByteSizer adminSizer;
+            for (size_t i = 0; i < school.size(); ++i) {
+                encodeAdmin(adminSizer, i);
+            }
+            SectionLayout studentLayout = measureSection(students.size(), minimumStudentsPerWorker, encodeStudent);
+            SectionLayout teacherLayout = measureSection(teachers.size(), minimumTeachersPerWorker, encodeTeacher);
+            ByteSizer changeSizer;
+            encodeChangeSection(changeSizer, *changeLog);
+
+            SectionHeader sections[] = {
+                { SectionTag::Administrators, static_cast<unsigned>(school.size()), adminSizer.size() },
+                { SectionTag::Students, static_cast<unsigned>(students.size()), studentLayout.totalBytes },
+                { SectionTag::Teachers, static_cast<unsigned>(teachers.size()), teacherLayout.totalBytes },
+                { SectionTag::ChangeLog, 0, changeSizer.size() } };
+            size_t bodyStarts[std::size(sections)];
+            size_t end = fileHeaderBytes;
+            for (size_t i = 0; i < std::size(sections); ++i) {
+                bodyStarts[i] = end + sectionHeaderBytes;
+                end = bodyStarts[i] + sections[i].bytes;
+            }
+            snapshot.size = end;
+            snapshot.data = std::make_unique_for_overwrite<char[]>(snapshot.size);
+            char* buffer = snapshot.data.get();
+
+            // --- Save header ---
+            ByteWriter header(buffer, fileHeaderBytes);
+            header.write(gradebookFileMagic);
+            header.write(gradebookFormatVersion);
+            header.write(nextAssignmentID);
+            header.write(nextClassroomID);
+            header.write(crc32(buffer, header.position()));
+
+            // --- Save administrators ---
+            ByteWriter adminWriter(buffer + bodyStarts[0], sections[0].bytes);
+            for (size_t i = 0; i < school.size(); ++i) {
+                encodeAdmin(adminWriter, i);
+            }
+
+            // --- Save students and teachers ---
+            writeSection(buffer + bodyStarts[1], students.size(), studentLayout, encodeStudent);
+            writeSection(buffer + bodyStarts[2], teachers.size(), teacherLayout, encodeTeacher);
+
+            // --- Save change log ---
+            ByteWriter changeWriter(buffer + bodyStarts[3], sections[3].bytes);
+            encodeChangeSection(changeWriter, *changeLog);
+
+            // --- Checksum sections ---
+            std::vector<std::string_view> bodies;
+            for (size_t i = 0; i < std::size(sections); ++i) {
+                bodies.emplace_back(buffer + bodyStarts[i], sections[i].bytes);
+            }
+            std::vector<unsigned> crcs = crc32Spans(bodies);
+            for (size_t i = 0; i < std::size(sections); ++i) {
+                sections[i].crc = crcs[i];
+                writeSectionHeader(buffer + bodyStarts[i] - sectionHeaderBytes, sections[i]);
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to prepare gradebook data for saving: " << e.what() << "\n";
+            return false;
+        }
+        return true;
+    }
 
     /**
-     * @brief Loads and deserializes gradebook data from the binary file ("gradebook.dat").
-     * Clears existing data and populates administrators, students, and teachers accordingly.
+     * @brief Writes a snapshot to the data file under its lock, merging in other sessions' commits if it is shared.
+     *
+     * Runs on the commit thread in Grouped mode.
+     *
+     * @param snapshot Encoded snapshot; may be replaced by a merged one.
+     * @param sync If true, make the new file durable before returning.
+     * @return False if the file could not be written; a message has been printed.
      */
-    void Gradebook::deserializeAndLoad() {
-        std::ifstream inFile("gradebook.dat", std::ios::binary);
-        if (!inFile) {
-            std::cerr << "Failed to load gradebook.dat.\n";
+    bool Gradebook::writeSnapshot(ByteBuffer& snapshot, bool sync) {
+        if (sharedFile) {
+            return sharedFile->commit(snapshot, sync,
+                [this](ByteBuffer& merged, const std::vector<char>& current, const std::vector<char>& base) {
+                    return mergeSnapshots(dataFile, merged, current, base);
+                });
+        }
+
+        FileLock lock(dataFile);
+        if (!lock.isLocked()) {
+            std::cerr << "Failed to lock " << dataFile << " for writing.\n";
+            return false;
+        }
+        if (!writeDataFile(dataFile, snapshot, sync)) {
+            std::cerr << "Failed to write " << dataFile << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Merges a file another session committed into a snapshot this session is about to write.
+     * @param filename Data file, for messages.
+     * @param snapshot Snapshot to write; replaced by the merged one.
+     * @param current The file's contents now.
+     * @param base The file's contents when the session last took it in.
+     * @return False if a copy could not be decoded or the merge could not be encoded.
+     */
+    bool Gradebook::mergeSnapshots(const std::string& filename, ByteBuffer& snapshot,
+        const std::vector<char>& current, const std::vector<char>& base)
+    {
+        Gradebook ours, theirs, ancestor;
+        for (Gradebook* copy : { &ours, &theirs, &ancestor }) {
+            copy->dataFile = filename;
+        }
+        if (!ours.loadSnapshot(snapshot.data.get(), snapshot.size)
+            || !theirs.loadSnapshot(current.data(), current.size())
+            || !ancestor.loadSnapshot(base.data(), base.size())) {
+            std::cerr << "Could not merge the changes another session saved to " << filename << "; nothing was saved.\n";
+            return false;
+        }
+
+        MergeResult result;
+        mergeGradebooks(ours, theirs, &ancestor, result);
+        if (!ours.encodeSnapshot(snapshot)) {
+            return false;
+        }
+
+        std::cout << "Merged " << result.changesApplied << " change(s) another session saved to " << filename << " first";
+        if (!result.conflicts.empty()) {
+            std::cout << "; " << result.conflicts.size() << " record(s) both sessions changed keep this session's version";
+        }
+        std::cout << ".\n";
+        return true;
+    }
+
+    /**
+     * @brief Serializes and saves the gradebook data to a binary file ("gradebook.dat").
+     *
+     * The file is replaced atomically and synced before returning. In
+     * Grouped mode the snapshot goes through the committer so it can never
+     * be overtaken by an older autosave still in flight.
+     */
+    void Gradebook::serializeAndSave() {
+        ByteBuffer snapshot;
+        if (!encodeSnapshot(snapshot)) {
             return;
         }
 
-        // Clear existing data before loading
-        school.clear();
-        students.clear();
-        teachers.clear();
+        if (committer) {
+            committer->submit(std::move(snapshot));
+            committer->flush();
+        }
+        else if (!writeSnapshot(snapshot, true)) {
+            return;
+        }
+        std::cout << "Gradebook data saved to " << dataFile << ".\n";
+    }
 
-        // Helper lambdas to read various types
-        auto readString = [&](std::ifstream& f) {
-            size_t len = 0;
-            f.read(reinterpret_cast<char*>(&len), sizeof(len));
-            std::string s(len, '\0');
-            f.read(&s[0], len);
-            return s;
-            };
-        auto readUnsigned = [&](std::ifstream& f) {
-            unsigned v = 0;
-            f.read(reinterpret_cast<char*>(&v), sizeof(v));
-            return v;
-            };
-        auto readFloat = [&](std::ifstream& f) {
-            float v = 0.0f;
-            f.read(reinterpret_cast<char*>(&v), sizeof(v));
-            return v;
-            };
-        auto readChar = [&](std::ifstream& f) {
-            char c = '\0';
-            f.read(reinterpret_cast<char*>(&c), sizeof(c));
-            return c;
-            };
+    /**
+     * @brief Saves after a change if autosave is on, using the current durability mode.
+     *
+     * Fast replaces the file atomically without syncing. Strict also syncs
+     * before returning. Grouped hands the snapshot to the background
+     * committer, which folds every change inside the window into one sync.
+     */
+    void Gradebook::autosave() {
+        if (!autosaveEnabled) {
+            return;
+        }
+
+        ByteBuffer snapshot;
+        if (!encodeSnapshot(snapshot)) {
+            return;
+        }
+
+        switch (durabilityMode) {
+        case DurabilityMode::Grouped:
+            if (!committer) {
+                committer = std::make_unique<GroupCommitter>(dataFile,
+                    [this](ByteBuffer& batch) { return writeSnapshot(batch, true); });
+                committer->setPolicy(std::chrono::milliseconds(groupCommitWindowMs), groupCommitMaxChanges);
+            }
+            committer->submit(std::move(snapshot));
+            std::cout << "Gradebook data queued for saving to " << dataFile << ".\n";
+            return;
+        case DurabilityMode::Fast:
+        case DurabilityMode::Strict:
+            if (!writeSnapshot(snapshot, durabilityMode == DurabilityMode::Strict)) {
+                return;
+            }
+            std::cout << "Gradebook data saved to " << dataFile << ".\n";
+            return;
+        }
+    }
+
+    /**
+     * @brief Blocks until every grouped autosave has been committed.
+     */
+    void Gradebook::flushPendingSaves() {
+        if (committer) {
+            committer->flush();
+        }
+    }
+
+    /**
+     * @brief Gets the autosave durability mode.
+     * @return The current mode.
+     */
+    DurabilityMode Gradebook::getDurabilityMode() const {
+        return durabilityMode;
+    }
+
+    /**
+     * @brief Switches the autosave durability mode, committing anything still pending first.
+     * @param mode The new mode.
+     */
+    void Gradebook::setDurabilityMode(DurabilityMode mode) {
+        if (mode != DurabilityMode::Grouped) {
+            // Destroying the committer commits its last batch and joins the thread.
+            committer.reset();
+        }
+        durabilityMode = mode;
+    }
+
+    /**
+     * @brief Sets when a group commit closes in Grouped mode.
+     * @param windowMs Longest a change may wait for its fsync, in milliseconds.
+     * @param maxChanges Number of changes that closes a batch early.
+     */
+    void Gradebook::setGroupCommitPolicy(unsigned windowMs, unsigned maxChanges) {
+        groupCommitWindowMs = windowMs;
+        groupCommitMaxChanges = std::max(1u, maxChanges);
+        if (committer) {
+            committer->setPolicy(std::chrono::milliseconds(groupCommitWindowMs), groupCommitMaxChanges);
+        }
+    }
+
+    /**
+     * @brief Gets the group commit window.
+     * @return Window in milliseconds.
+     */
+    unsigned Gradebook::getGroupCommitWindowMs() const {
+        return groupCommitWindowMs;
+    }
+
+    /**
+     * @brief Gets the number of changes that closes a group commit early.
+     * @return Change count.
+     */
+    unsigned Gradebook::getGroupCommitMaxChanges() const {
+        return groupCommitMaxChanges;
+    }
+
+    // === Deserialization (Load) ===
+
+    namespace {
+        /**
+         * @brief Scores read from a file older than version 2, not yet tied to a classroom.
+         */
+        struct UnlinkedScores {
+            std::vector<std::pair<std::string, float>> byName;  ///< Version 0: keyed by assignment name
+            std::vector<AssignmentScore> byID;                  ///< Version 1: keyed by assignment ID
+        };
 
-        // --- Load administrators ---
-        unsigned adminCount = readUnsigned(inFile);
-        for (unsigned i = 0; i < adminCount; ++i) {
-            Administrator admin;
-            admin.setAdminTitle(readString(inFile));
-            admin.setFirstName(readString(inFile));
-            admin.setLastName(readString(inFile));
-            admin.setSchoolName(readString(inFile));
-            admin.setPassword(readString(inFile));
-            school.push_back(std::move(admin));
-        }
-
-        // --- Load students ---
-        unsigned studentCount = readUnsigned(inFile);
-        students.reserve(studentCount);
-        std::unordered_map<unsigned, Student*> idToStudentPtr;
-
-        for (unsigned i = 0; i < studentCount; ++i) {
-            auto s = std::make_unique<Student>();
-            s->setFirstName(readString(inFile));
-            s->setLastName(readString(inFile));
-            s->setPronouns(readString(inFile));
-            s->setAge(readUnsigned(inFile));
-            s->setGradeLevel(readUnsigned(inFile));
-            s->setID(readUnsigned(inFile));
-            s->setSeat(readString(inFile));
-            s->setNotes(readString(inFile));
-            s->setOverallGrade(readChar(inFile));
-            s->setGradePercent(readFloat(inFile));
-
-            unsigned mapSize = readUnsigned(inFile);
+        /**
+         * @brief Steps over one student record, checking every length against the buffer.
+         * @param reader Reader positioned at the start of a student record.
+         * @param version Format version of the file.
+         */
+        void skipStudentRecord(ByteReader& reader, unsigned version) {
+            reader.skipString();                            // first name
+            reader.skipString();                            // last name
+            reader.skipString();                            // pronouns
+            reader.skip(3 * sizeof(unsigned));              // age, grade level, ID
+            reader.skipString();                            // seat
+            reader.skipString();                            // notes
+            reader.skip(sizeof(char) + sizeof(float));      // letter grade, percent
+            if (version >= 4) {
+                reader.skip(sizeof(ChangeVersion));         // change version
+            }
+
+            if (version >= 2) {
+                size_t scoreBytes = sizeof(unsigned) + sizeof(float) + (version >= 4 ? sizeof(ChangeVersion) : 0);
+                unsigned enrollmentCount = reader.read<unsigned>();
+                for (unsigned j = 0; j < enrollmentCount; ++j) {
+                    reader.skip(sizeof(unsigned) + sizeof(char) + sizeof(float));  // classroom ID, letter, percent
+                    unsigned scoreCount = reader.read<unsigned>();
+                    reader.skip(static_cast<size_t>(scoreCount) * scoreBytes);
+                }
+                return;
+            }
+
+            unsigned mapSize = reader.read<unsigned>();
+            if (version == 0) {
+                for (unsigned j = 0; j < mapSize; ++j) {
+                    reader.skipString();
+                    reader.skip(sizeof(float));
+                }
+            }
+            else {
+                reader.skip(static_cast<size_t>(mapSize) * (sizeof(unsigned) + sizeof(float)));
+            }
+        }
+
+        /**
+         * @brief Decodes one student record.
+         * @param reader Reader positioned at the start of a student record.
+         * @param s Student to fill in.
+         * @param version Format version of the file.
+         * @param unlinked Receives the scores of a file older than version 2.
+         */
+        void decodeStudentRecord(ByteReader& reader, Student& s, unsigned version, UnlinkedScores& unlinked) {
+            s.setFirstName(reader.readString());
+            s.setLastName(reader.readString());
+            s.setPronouns(reader.readString());
+            s.setAge(reader.read<unsigned>());
+            s.setGradeLevel(reader.read<unsigned>());
+            s.setID(reader.read<unsigned>());
+            s.setSeat(reader.readString());
+            s.setNotes(reader.readString());
+            s.setOverallGrade(reader.read<char>());
+            s.setGradePercent(reader.read<float>());
+            if (version >= 4) {
+                s.setChangeVersion(reader.read<ChangeVersion>());
+            }
+
+            if (version >= 2) {
+                unsigned enrollmentCount = reader.read<unsigned>();
+                for (unsigned j = 0; j < enrollmentCount; ++j) {
+                    unsigned classroomID = reader.read<unsigned>();
+                    s.enroll(classroomID);
+                    char letter = reader.read<char>();
+                    s.setClassroomGrade(classroomID, letter, reader.read<float>());
+                    unsigned scoreCount = reader.read<unsigned>();
+                    for (unsigned k = 0; k < scoreCount; ++k) {
+                        unsigned assignmentID = reader.read<unsigned>();
+                        float sc = reader.read<float>();
+                        ChangeVersion scoreVersion = version >= 4 ? reader.read<ChangeVersion>() : 0;
+                        s.setAssignmentScore(classroomID, assignmentID, sc, scoreVersion);
+                    }
+                }
+                return;
+            }
+
+            unsigned mapSize = reader.read<unsigned>();
             for (unsigned j = 0; j < mapSize; ++j) {
-                std::string nm = readString(inFile);
-                float sc = readFloat(inFile);
-                s->setAssignmentScore(nm, sc);
+                if (version == 0) {
+                    std::string nm = reader.readString();
+                    float sc = reader.read<float>();
+                    unlinked.byName.emplace_back(std::move(nm), sc);
+                }
+                else {
+                    unsigned assignmentID = reader.read<unsigned>();
+                    float sc = reader.read<float>();
+                    unlinked.byID.push_back(AssignmentScore{ assignmentID, sc });
+                }
+            }
+        }
+
+        /**
+         * @brief Steps over one teacher record, checking every length against the buffer.
+         * @param reader Reader positioned at the start of a teacher record.
+         * @param version Format version of the file.
+         */
+        void skipTeacherRecord(ByteReader& reader, unsigned version) {
+            if (version >= 2) {
+                reader.skip(sizeof(unsigned));              // classroom ID
+            }
+            reader.skipString();                            // title
+            reader.skipString();                            // first name
+            reader.skipString();                            // last name
+            reader.skip(sizeof(unsigned));                  // grade level
+            reader.skipString();                            // password
+
+            if (version < 2) {
+                unsigned clsSize = reader.read<unsigned>();
+                reader.skip(static_cast<size_t>(clsSize) * sizeof(unsigned));
             }
 
-            unsigned id = s->getID();
-            idToStudentPtr[id] = s.get();
-            students.push_back(std::move(s));
+            unsigned asz = reader.read<unsigned>();
+            for (unsigned j = 0; j < asz; ++j) {
+                if (version >= 1) {
+                    reader.skip(sizeof(unsigned));          // assignment ID
+                }
+                reader.skipString();                        // name
+                if (version >= 3) {
+                    reader.skipString();                    // description
+                }
+                reader.skip(sizeof(float));
+            }
         }
 
-        // --- Load teachers ---
-        unsigned teacherCount = readUnsigned(inFile);
-        for (unsigned i = 0; i < teacherCount; ++i) {
-            Teacher t;
-            t.setTitle(readString(inFile));
-            t.setFirstName(readString(inFile));
-            t.setLastName(readString(inFile));
-            t.setGradeLevel(readUnsigned(inFile));
-            t.setPassword(readString(inFile));
+        /**
+         * @brief Decodes one teacher record.
+         * @param reader Reader positioned at the start of a teacher record.
+         * @param t Teacher to fill in.
+         * @param version Format version of the file.
+         * @param studentIDs Receives the roster's student IDs from a file older than version 2.
+         */
+        void decodeTeacherRecord(ByteReader& reader, Teacher& t, unsigned version, std::vector<unsigned>& studentIDs) {
+            if (version >= 2) {
+                t.setClassroomID(reader.read<unsigned>());
+            }
+            t.setTitle(reader.readString());
+            t.setFirstName(reader.readString());
+            t.setLastName(reader.readString());
+            t.setGradeLevel(reader.read<unsigned>());
+            t.setPassword(reader.readString());
 
-            // Load student IDs assigned to teacher's classroom
-            unsigned clsSize = readUnsigned(inFile);
-            std::vector<unsigned> studentIDs(clsSize);
-            for (unsigned j = 0; j < clsSize; ++j) {
-                studentIDs[j] = readUnsigned(inFile);
+            studentIDs.clear();
+            if (version < 2) {
+                unsigned clsSize = reader.read<unsigned>();
+                studentIDs.resize(clsSize);
+                for (unsigned j = 0; j < clsSize; ++j) {
+                    studentIDs[j] = reader.read<unsigned>();
+                }
             }
 
-            // Load assignments for the teacher
-            unsigned asz = readUnsigned(inFile);
+            unsigned asz = reader.read<unsigned>();
+            t.getAssignments().reserve(asz);
             for (unsigned j = 0; j < asz; ++j) {
                 Assignment a;
-                a.setAssignmentName(readString(inFile));
-                a.setPointsPossible(readFloat(inFile));
-                t.getAssignments().push_back(a);
+                if (version >= 1) {
+                    a.setAssignmentID(reader.read<unsigned>());
+                }
+                a.setAssignmentName(reader.readString());
+                if (version >= 3) {
+                    a.setAssignmentDescription(reader.readString());
+                }
+                a.setPointsPossible(reader.read<float>());
+                t.getAssignments().push_back(std::move(a));
+            }
+        }
+
+        /**
+         * @brief Walks a section once to find where each worker's range of records starts.
+         * @param reader Reader positioned at the first record; left just past the last one.
+         * @param count Number of records in the section.
+         * @param workers Number of ranges the section will be split into.
+         * @param skipRecord Function that steps over one record.
+         * @return Byte offset of the first record of each of the workers ranges; ranges
+         *         left empty (fewer records than workers) start at the end of the section.
+         */
+        template <typename SkipFn>
+        std::vector<size_t> scanRangeOffsets(ByteReader& reader, size_t count, unsigned workers, SkipFn skipRecord) {
+            size_t stride = rangeStride(count, workers);
+            std::vector<size_t> offsets;
+            offsets.reserve(std::max(workers, 1u));
+            for (size_t i = 0; i < count; ++i) {
+                if (stride > 0 && i % stride == 0) {
+                    offsets.push_back(reader.position());
+                }
+                skipRecord(reader);
+            }
+            offsets.resize(std::max(workers, 1u), reader.position());
+            return offsets;
+        }
+
+        /**
+         * @brief Steps over the frame in front of a record of a checksummed file.
+         * @param reader Reader positioned at the record.
+         * @param version Format version of the file.
+         * @return Offset the record must end at, or 0 if the file has no frames.
+         */
+        size_t enterRecord(ByteReader& reader, unsigned version) {
+            if (version < firstChecksummedVersion) {
+                return 0;
             }
+            unsigned length = reader.read<unsigned>();
+            reader.skip(sizeof(unsigned));      // CRC, already checked with the whole section
+            return reader.position() + length;
+        }
+
+        /**
+         * @brief Checks that a record used exactly the length its frame gave.
+         * @param reader Reader just past the record.
+         * @param end Offset returned by enterRecord.
+         */
+        void leaveRecord(const ByteReader& reader, size_t end) {
+            if (end != 0 && reader.position() != end) {
+                throw std::runtime_error("a record does not fill its frame at offset " + std::to_string(reader.position()));
+            }
+        }
 
-            teachers.push_back(std::move(t));
-            Teacher& refTeacher = teachers.back();
+        /**
+         * @brief Steps over one framed record of a checksummed file by its length.
+         * @param reader Reader positioned at the record's frame.
+         */
+        void skipFramedRecord(ByteReader& reader) {
+            unsigned length = reader.read<unsigned>();
+            reader.skip(sizeof(unsigned) + size_t{ length });
+        }
+
+        /**
+         * @brief Checks every section header of a checksummed file, then every section body in parallel.
+         *
+         * This runs before anything is decoded, so a damaged file is turned
+         * away without trusting any length inside it.
+         *
+         * @param data Uncompressed file contents, header already checked.
+         * @param size Number of bytes.
+         */
+        void verifySections(const char* data, size_t size) {
+            std::vector<std::string_view> bodies;
+            std::vector<unsigned> expected;
+            size_t offset = fileHeaderBytes;
+            for (SectionTag tag : dataFileSections) {
+                SectionHeader header;
+                if (size - offset < sectionHeaderBytes || !readSectionHeader(data + offset, header) || header.tag != tag) {
+                    throw std::runtime_error(std::string("the ") + sectionName(tag) + " section header is damaged");
+                }
+                offset += sectionHeaderBytes;
+                if (header.bytes > size - offset) {
+                    throw std::runtime_error(std::string("the ") + sectionName(tag) + " section is cut short");
+                }
+                bodies.emplace_back(data + offset, static_cast<size_t>(header.bytes));
+                expected.push_back(header.crc);
+                offset += static_cast<size_t>(header.bytes);
+            }
+            if (offset != size) {
+                throw std::runtime_error("unexpected data after the change log");
+            }
 
-            // Link students to teacher's classroom by ID lookup
-            for (unsigned id : studentIDs) {
-                if (idToStudentPtr.count(id)) {
-                    refTeacher.addStudentToClassroom(idToStudentPtr[id]);
+            std::vector<unsigned> crcs = crc32Spans(bodies);
+            for (size_t i = 0; i < crcs.size(); ++i) {
+                if (crcs[i] != expected[i]) {
+                    throw std::runtime_error(std::string("the ") + sectionName(dataFileSections[i]) + " section fails its checksum");
                 }
             }
         }
 
-        inFile.close();
-        std::cout << "Gradebook data loaded from gradebook.dat.\n";
+        /**
+         * @brief Gives a version 0 file's assignments IDs and re-keys its scores by them.
+         *
+         * Each student's name-keyed scores are matched against the assignments
+         * of every classroom the student is on, exactly as the old name lookup
+         * would have matched them, and stored in that classroom's enrollment.
+         * Same-named assignments in one classroom used to share a single score,
+         * so each of them gets a copy. Scores with no matching assignment were
+         * never counted toward a grade and are dropped.
+         *
+         * @param teachers Loaded teachers, rosters already linked.
+         * @param students Loaded students, parallel to unlinked.
+         * @param unlinked Name-keyed scores per student.
+         * @return The next unused assignment ID.
+         */
+        unsigned upgradeLegacyScores(std::vector<Teacher>& teachers,
+            const std::vector<std::unique_ptr<Student>>& students,
+            const std::vector<UnlinkedScores>& unlinked)
+        {
+            unsigned nextID = 1;
+            std::unordered_map<const Student*, const UnlinkedScores*> scoresByStudent;
+            scoresByStudent.reserve(students.size());
+            for (size_t i = 0; i < students.size(); ++i) {
+                if (!unlinked[i].byName.empty()) {
+                    scoresByStudent[students[i].get()] = &unlinked[i];
+                }
+            }
+
+            std::unordered_map<std::string_view, std::vector<unsigned>> idsByName;
+            for (auto& teacher : teachers) {
+                idsByName.clear();
+                for (auto& a : teacher.getAssignments()) {
+                    a.setAssignmentID(nextID++);
+                    idsByName[a.getAssignmentNameView()].push_back(a.getAssignmentID());
+                }
+
+                for (Student* s : teacher.getClassroomStudents()) {
+                    auto found = scoresByStudent.find(s);
+                    if (found == scoresByStudent.end()) continue;
+
+                    for (const auto& [name, score] : found->second->byName) {
+                        auto ids = idsByName.find(name);
+                        if (ids == idsByName.end()) continue;
+                        for (unsigned id : ids->second) {
+                            s->setAssignmentScore(teacher.getClassroomID(), id, score);
+                        }
+                    }
+                }
+            }
+            return nextID;
+        }
+
+        /**
+         * @brief Files a version 1 file's ID-keyed scores under the classroom that owns each assignment.
+         *
+         * A score whose classroom the student is not on was never counted
+         * toward a grade and is dropped.
+         *
+         * @param teachers Loaded teachers, rosters already linked.
+         * @param students Loaded students, parallel to unlinked.
+         * @param unlinked ID-keyed scores per student.
+         */
+        void linkScoresToEnrollments(const std::vector<Teacher>& teachers,
+            const std::vector<std::unique_ptr<Student>>& students,
+            const std::vector<UnlinkedScores>& unlinked)
+        {
+            std::unordered_map<unsigned, unsigned> classroomOf;
+            for (const auto& teacher : teachers) {
+                for (const auto& a : teacher.getAssignments()) {
+                    classroomOf.emplace(a.getAssignmentID(), teacher.getClassroomID());
+                }
+            }
+
+            for (size_t i = 0; i < students.size(); ++i) {
+                for (const auto& entry : unlinked[i].byID) {
+                    auto owner = classroomOf.find(entry.assignmentID);
+                    if (owner != classroomOf.end()) {
+                        students[i]->setAssignmentScore(owner->second, entry.assignmentID, entry.score);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Fills in per-classroom grades for students loaded from a file older than version 2.
+         *
+         * Those files kept a single grade per student. A student in one class
+         * keeps it as that class's grade; a student in several has each class
+         * graded from its own assignments.
+         *
+         * @param teachers Loaded teachers, rosters and scores already linked.
+         * @param students Loaded students.
+         */
+        void upgradeClassroomGrades(const std::vector<Teacher>& teachers,
+            const std::vector<std::unique_ptr<Student>>& students)
+        {
+            std::unordered_map<unsigned, const Teacher*> byClassroom;
+            for (const auto& teacher : teachers) {
+                byClassroom[teacher.getClassroomID()] = &teacher;
+            }
+
+            for (const auto& s : students) {
+                const auto& enrollments = s->getEnrollments();
+                if (enrollments.size() == 1) {
+                    s->setClassroomGrade(enrollments.front().classroomID, s->getOverallGrade(), s->getGradePercent());
+                    continue;
+                }
+
+                for (const auto& enrollment : enrollments) {
+                    s->calculateGrade(enrollment.classroomID, byClassroom.at(enrollment.classroomID)->getAssignments());
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Loads the entire gradebook data from a binary file.
+     *
+     * A shared data file is read under its lock, and what was read becomes
+     * the base later saves merge other sessions' commits against.
+     *
+     * @return False if the file could not be read or is damaged; a message has been printed.
+     */
+    bool Gradebook::deserializeAndLoad() {
+        // A grouped autosave landing after the load would overwrite what was just read.
+        flushPendingSaves();
+
+        bool loaded;
+        if (sharedFile) {
+            loaded = sharedFile->take([&](const std::vector<char>& contents, const std::vector<char>&) {
+                return loadSnapshot(contents.data(), contents.size());
+                }, false);
+        }
+        else {
+            std::vector<char> buffer;
+            std::string error;
+            if (!readDataFile(dataFile, buffer, error)) {
+                std::cerr << "Failed to load " << dataFile << ": " << error << ".\n";
+                return false;
+            }
+            loaded = loadSnapshot(buffer.data(), buffer.size());
+        }
+        if (!loaded) {
+            return false;
+        }
+
+        std::cout << "Gradebook data loaded from " << dataFile << ".\n";
+        return true;
+    }
+
+    /**
+     * @brief Loads contents salvaged from a damaged data file, fixing what the lost records broke.
+     * @param data Uncompressed contents, rebuilt from the records that survived.
+     * @param size Number of bytes.
+     * @param repairs Receives a line for every fix made.
+     * @return False if the contents still cannot be loaded; a message has been printed.
+     */
+    bool Gradebook::loadSalvagedSnapshot(const char* data, size_t size, std::vector<std::string>& repairs) {
+        flushPendingSaves();
+        return loadSnapshot(data, size, &repairs);
+    }
+
+    /**
+     * @brief Loads the changes other sessions committed to a shared data file since this one last read it.
+     *
+     * The file is merged into the session three ways against the contents
+     * the session last took in, so only the classrooms and student buckets
+     * whose hashes differ are compared and updated, and anything changed
+     * here but not yet saved stays.
+     *
+     * @return True if anything was loaded.
+     */
+    bool Gradebook::reloadExternalChanges() {
+        if (!sharedFile || !sharedFile->hasNewerCommit()) {
+            return false;
+        }
+        // A grouped autosave still waiting goes first, so it is merged on disk rather than lost.
+        flushPendingSaves();
+
+        MergeResult result;
+        bool taken = sharedFile->take([&](const std::vector<char>& current, const std::vector<char>& base) {
+            Gradebook theirs, ancestor;
+            theirs.dataFile = ancestor.dataFile = dataFile;
+            if (!theirs.loadSnapshot(current.data(), current.size())) {
+                return false;
+            }
+            bool hasBase = !base.empty() && ancestor.loadSnapshot(base.data(), base.size());
+            mergeGradebooks(*this, theirs, hasBase ? &ancestor : nullptr, result);
+            return true;
+            }, true);
+        if (!taken || result.identical) {
+            return false;
+        }
+
+        if (result.conflicts.empty()) {
+            std::cout << "Loaded " << result.changesApplied << " change(s) another session saved to " << dataFile << ".\n";
+        }
+        else {
+            printMergeResult(result);
+        }
+        return result.changesApplied > 0;
+    }
+
+    /**
+     * @brief Decodes a whole data file's contents and replaces the school with them.
+     *
+     * A quick pre-scan of each section finds where every worker's range of
+     * records begins, then the ranges are decoded in parallel into
+     * pre-sized vectors. Rosters are rebuilt from the students' enrollments
+     * once every teacher exists. Files written before assignment IDs or
+     * enrollments existed are upgraded on the way in. Checksummed files are
+     * verified whole, in parallel, before any record is decoded. Nothing in
+     * memory is replaced unless the whole file decodes cleanly.
+     *
+     * @param data Uncompressed file contents.
+     * @param size Number of bytes.
+     * @param repairs If not null, contents salvaged from a damaged file: a later classroom reusing an ID is dropped and enrollments in missing classrooms are withdrawn, each noted here, instead of failing the load.
+     * @return False if the contents are damaged; a message has been printed.
+     */
+    bool Gradebook::loadSnapshot(const char* data, size_t size, std::vector<std::string>* repairs) {
+        std::vector<Administrator> loadedSchool;
+        std::vector<std::unique_ptr<Student>> loadedStudents;
+        std::vector<Teacher> loadedTeachers;
+        unsigned loadedNextAssignmentID = 1;
+        unsigned loadedNextClassroomID = 1;
+        ChangeVersion loadedChangeVersion = 0;
+        std::vector<Tombstone> loadedTombstones;
+        std::map<std::string, ChangeVersion> loadedWatermarks;
+
+        try {
+            ByteReader reader(data, size);
+
+            // --- Load header ---
+            unsigned version = 0;
+            if (reader.remaining() >= sizeof(unsigned) && ByteReader(reader).read<unsigned>() == gradebookFileMagic) {
+                reader.skip(sizeof(unsigned));
+                version = reader.read<unsigned>();
+                if (version > gradebookFormatVersion) {
+                    throw std::runtime_error("written by a newer version (format " + std::to_string(version) + ")");
+                }
+                loadedNextAssignmentID = reader.read<unsigned>();
+                if (version >= 2) {
+                    loadedNextClassroomID = reader.read<unsigned>();
+                }
+                if (version >= firstChecksummedVersion) {
+                    unsigned headerCrc = crc32(data, reader.position());
+                    if (reader.read<unsigned>() != headerCrc) {
+                        throw std::runtime_error("the file header fails its checksum");
+                    }
+                    verifySections(data, size);
+                }
+            }
+
+            // Checksummed files keep each section's record count in its header.
+            SectionHeader section;
+            auto beginSection = [&]() {
+                if (version < firstChecksummedVersion) {
+                    return reader.read<unsigned>();
+                }
+                readSectionHeader(data + reader.position(), section);
+                reader.skip(sectionHeaderBytes);
+                return section.count;
+                };
+            auto skipStudent = [version](ByteReader& r) {
+                if (version >= firstChecksummedVersion) skipFramedRecord(r);
+                else skipStudentRecord(r, version);
+                };
+            auto skipTeacher = [version](ByteReader& r) {
+                if (version >= firstChecksummedVersion) skipFramedRecord(r);
+                else skipTeacherRecord(r, version);
+                };
+
+            // --- Load administrators ---
+            unsigned adminCount = beginSection();
+            for (unsigned i = 0; i < adminCount; ++i) {
+                size_t end = enterRecord(reader, version);
+                Administrator admin;
+                admin.setAdminTitle(reader.readString());
+                admin.setFirstName(reader.readString());
+                admin.setLastName(reader.readString());
+                admin.setSchoolName(reader.readString());
+                admin.setPassword(reader.readString());
+                leaveRecord(reader, end);
+                loadedSchool.push_back(std::move(admin));
+            }
+
+            // --- Load students ---
+            unsigned studentCount = beginSection();
+            unsigned studentWorkers = workerCountFor(studentCount, minimumStudentsPerWorker);
+            std::vector<size_t> studentOffsets = scanRangeOffsets(reader, studentCount, studentWorkers, skipStudent);
+
+            loadedStudents.resize(studentCount);
+            std::vector<UnlinkedScores> unlinkedScores(version < 2 ? studentCount : 0);
+            parallelForRanges(studentCount, studentWorkers, [&](unsigned w, size_t first, size_t last) {
+                ByteReader rangeReader(data, size, studentOffsets[w]);
+                UnlinkedScores unused;
+                for (size_t i = first; i < last; ++i) {
+                    size_t end = enterRecord(rangeReader, version);
+                    auto s = std::make_unique<Student>();
+                    decodeStudentRecord(rangeReader, *s, version, version < 2 ? unlinkedScores[i] : unused);
+                    leaveRecord(rangeReader, end);
+                    loadedStudents[i] = std::move(s);
+                }
+                });
+
+            // --- Load teachers ---
+            unsigned teacherCount = beginSection();
+            unsigned teacherWorkers = workerCountFor(teacherCount, minimumTeachersPerWorker);
+            std::vector<size_t> teacherOffsets = scanRangeOffsets(reader, teacherCount, teacherWorkers, skipTeacher);
+
+            loadedTeachers.resize(teacherCount);
+            std::vector<std::vector<unsigned>> rosterIDs(version < 2 ? teacherCount : 0);
+            parallelForRanges(teacherCount, teacherWorkers, [&](unsigned w, size_t first, size_t last) {
+                ByteReader rangeReader(data, size, teacherOffsets[w]);
+                std::vector<unsigned> unused;
+                for (size_t i = first; i < last; ++i) {
+                    size_t end = enterRecord(rangeReader, version);
+                    decodeTeacherRecord(rangeReader, loadedTeachers[i], version, version < 2 ? rosterIDs[i] : unused);
+                    leaveRecord(rangeReader, end);
+                }
+                });
+
+            // --- Link rosters ---
+            if (version >= 2 && repairs) {
+                std::unordered_set<unsigned> classroomIDs;
+                std::erase_if(loadedTeachers, [&](const Teacher& t) {
+                    if (classroomIDs.insert(t.getClassroomID()).second) return false;
+                    repairs->push_back("Dropped a second classroom with ID " + std::to_string(t.getClassroomID())
+                        + " (" + std::string(t.getFirstNameView()) + " " + std::string(t.getLastNameView()) + ").");
+                    return true;
+                    });
+                teacherCount = static_cast<unsigned>(loadedTeachers.size());
+            }
+
+            std::vector<std::vector<Student*>> rosters(teacherCount);
+            if (version >= 2) {
+                std::unordered_map<unsigned, size_t> classroomPositions;
+                classroomPositions.reserve(teacherCount);
+                for (size_t t = 0; t < teacherCount; ++t) {
+                    if (!classroomPositions.emplace(loadedTeachers[t].getClassroomID(), t).second) {
+                        throw std::runtime_error("two classrooms share ID " + std::to_string(loadedTeachers[t].getClassroomID()));
+                    }
+                }
+                std::vector<unsigned> missing;
+                for (const auto& s : loadedStudents) {
+                    missing.clear();
+                    for (const auto& enrollment : s->getEnrollments()) {
+                        auto found = classroomPositions.find(enrollment.classroomID);
+                        if (found == classroomPositions.end()) {
+                            if (!repairs) {
+                                throw std::runtime_error("student " + std::to_string(s->getID())
+                                    + " is enrolled in missing classroom " + std::to_string(enrollment.classroomID));
+                            }
+                            missing.push_back(enrollment.classroomID);
+                            continue;
+                        }
+                        rosters[found->second].push_back(s.get());
+                    }
+                    for (unsigned classroomID : missing) {
+                        s->withdraw(classroomID);
+                        repairs->push_back("Withdrew student " + std::to_string(s->getID())
+                            + " from classroom " + std::to_string(classroomID) + ", which was lost.");
+                    }
+                }
+            }
+            else {
+                // Older files have no classroom IDs; number them in file order.
+                for (size_t t = 0; t < teacherCount; ++t) {
+                    loadedTeachers[t].setClassroomID(static_cast<unsigned>(t + 1));
+                }
+                loadedNextClassroomID = teacherCount + 1;
+
+                // Later records win on duplicate IDs, as they always have.
+                std::unordered_map<unsigned, Student*> idToStudentPtr;
+                idToStudentPtr.reserve(studentCount);
+                for (const auto& s : loadedStudents) {
+                    idToStudentPtr[s->getID()] = s.get();
+                }
+                for (size_t t = 0; t < teacherCount; ++t) {
+                    for (unsigned id : rosterIDs[t]) {
+                        auto found = idToStudentPtr.find(id);
+                        unsigned classroomID = loadedTeachers[t].getClassroomID();
+                        if (found != idToStudentPtr.end() && !found->second->isEnrolledIn(classroomID)) {
+                            found->second->enroll(classroomID);
+                            rosters[t].push_back(found->second);
+                        }
+                    }
+                }
+            }
+
+            // Every enrollment already exists, so classrooms only read their students here.
+            parallelForRanges(teacherCount, teacherWorkers, [&](unsigned, size_t first, size_t last) {
+                for (size_t t = first; t < last; ++t) {
+                    loadedTeachers[t].addStudentsToClassroom(rosters[t]);
+                }
+                });
+
+            if (version == 0) {
+                loadedNextAssignmentID = upgradeLegacyScores(loadedTeachers, loadedStudents, unlinkedScores);
+            }
+            else if (version == 1) {
+                linkScoresToEnrollments(loadedTeachers, loadedStudents, unlinkedScores);
+            }
+            if (version < 2) {
+                upgradeClassroomGrades(loadedTeachers, loadedStudents);
+            }
+
+            // --- Load change log ---
+            if (version >= firstChecksummedVersion) {
+                beginSection();
+            }
+            // A salvaged file may carry an empty change log section.
+            if (version >= 4 && (version < firstChecksummedVersion || section.bytes > 0)) {
+                loadedChangeVersion = reader.read<ChangeVersion>();
+                unsigned tombstoneCount = reader.read<unsigned>();
+                loadedTombstones.reserve(std::min<size_t>(tombstoneCount, reader.remaining()));
+                for (unsigned i = 0; i < tombstoneCount; ++i) {
+                    Tombstone t;
+                    t.version = reader.read<ChangeVersion>();
+                    unsigned char kind = reader.read<unsigned char>();
+                    if (kind < static_cast<unsigned char>(TombstoneKind::StudentRemoved)
+                        || kind > static_cast<unsigned char>(TombstoneKind::ScoreErased)) {
+                        throw std::runtime_error("unknown tombstone kind " + std::to_string(kind));
+                    }
+                    t.kind = static_cast<TombstoneKind>(kind);
+                    t.studentID = reader.read<unsigned>();
+                    t.classroomID = reader.read<unsigned>();
+                    t.assignmentID = reader.read<unsigned>();
+                    if (!loadedTombstones.empty() && t.version <= loadedTombstones.back().version) {
+                        throw std::runtime_error("tombstones are out of order");
+                    }
+                    loadedTombstones.push_back(t);
+                }
+                unsigned watermarkCount = reader.read<unsigned>();
+                for (unsigned i = 0; i < watermarkCount; ++i) {
+                    std::string name = reader.readString();
+                    loadedWatermarks[std::move(name)] = reader.read<ChangeVersion>();
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << dataFile << " is damaged and was not loaded: " << e.what()
+                << " (--verify lists the damaged records; --repair salvages the rest)\n";
+            return false;
+        }
+
+        // The indexes still point at the students about to be replaced.
+        studentIndex->clear();
+        textIndex->clear();
+        changeLog->clear();
+        school = std::move(loadedSchool);
+        students = std::move(loadedStudents);
+        teachers = std::move(loadedTeachers);
+        nextAssignmentID = loadedNextAssignmentID;
+        nextClassroomID = loadedNextClassroomID;
+        rebuildAssignmentDirectory();
+        rebuildClassroomDirectory();
+        rebuildStudentDirectory();
+        rebuildTextIndex();
+        for (const auto& s : students) {
+            s->setChangeLog(changeLog.get());
+        }
+        changeLog->restore(loadedChangeVersion, std::move(loadedTombstones), std::move(loadedWatermarks), students);
+        invalidateReportCache();
+        return true;
     }
 
     // === Clear Cached Data ===
@@ -345,9 +1982,19 @@ namespace gradebook {
      * @brief Clears all cached data in memory for teachers, students, and administrators.
      */
     void Gradebook::clearCachedData() {
+        studentIndex->clear();
+        textIndex->clear();
+        changeLog->clear();
         teachers.clear();
         students.clear();
+        studentRecords.clear();
         school.clear();
+        assignmentOwners.clear();
+        classroomsByID.clear();
+        teachersByGradeLevel.clear();
+        studentSlots.clear();
+        studentsByID.clear();
+        invalidateReportCache();
         std::cout << "All cached data cleared from memory.\n";
     }
 }
\ No newline at end of file
@@ -2,20 +2,157 @@
 #include "Teacher.h"
 #include "Student.h"
 #include "Administrator.h"
+#include "ChangeLog.h"
+#include "Serialization.h"
+#include "SharedDataFile.h"
+#include "StudentIndex.h"
+#include "TextIndex.h"
 #include "User.h"
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 namespace gradebook {
+
+    /**
+     * @brief Materialized school report rows for a single classroom.
+     *
+     * Rows are rendered once per teacher revision and reused by every later
+     * school report or CSV export until the classroom or one of its students
+     * changes.
+     */
+    struct ClassroomReportRows {
+        bool valid = false;                 /**< True once the rows have been rendered */
+        unsigned long long revision = 0;    /**< Teacher revision the rows were rendered from */
+        ChangeVersion studentsVersion = 0;  /**< Latest change version among the roster when rendered */
+        std::string printed;                /**< Console block printed by the school report */
+        std::string csv;                    /**< CSV rows written by the school report export */
+    };
+
     class Gradebook {
     private:
         std::vector<Teacher> teachers;                        /**< Vector storing Teacher objects */
         std::vector<std::unique_ptr<Student>> students;       /**< Vector storing unique pointers to Student objects */
+        std::vector<StudentRecord> studentRecords;            /**< Hot record of every student, parallel to students */
         std::vector<Administrator> school;                    /**< Vector storing Administrator objects */
+        std::string dataFile = "gradebook.dat";               /**< File the gradebook loads from and saves to */
         bool autosaveEnabled = true;                          /**< Flag to control autosave feature */
+        std::vector<ClassroomReportRows> reportCache;         /**< Cached report rows, parallel to teachers */
+        DurabilityMode durabilityMode = DurabilityMode::Grouped; /**< How autosave makes changes durable */
+        unsigned groupCommitWindowMs = 250;                   /**< Longest a grouped change waits for its fsync */
+        unsigned groupCommitMaxChanges = 8;                   /**< Changes that close a group commit early */
+        std::unique_ptr<GroupCommitter> committer;            /**< Background committer, alive only in Grouped mode */
+        std::unique_ptr<SharedDataFile> sharedFile;           /**< Coordinates saves with other sessions; null unless shareDataFile() was called */
+        unsigned nextAssignmentID = 1;                        /**< Next stable assignment ID to issue; never reused */
+        std::unordered_map<unsigned, unsigned> assignmentOwners; /**< Assignment ID to owning teacher's classroom ID */
+        unsigned nextClassroomID = 1;                         /**< Next stable classroom ID to issue; never reused */
+        std::unordered_map<unsigned, size_t> classroomsByID;  /**< Classroom ID to teacher's position */
+        std::map<unsigned, std::vector<size_t>> teachersByGradeLevel; /**< Grade level to the positions of its teachers */
+        std::unordered_map<const Student*, size_t> studentSlots; /**< Position of every student in students */
+        std::unordered_map<unsigned, Student*> studentsByID;  /**< Student ID to student */
+        std::unique_ptr<StudentIndex> studentIndex = std::make_unique<StudentIndex>(); /**< Students by grade level, letter grade and age; heap-held so students' back pointers survive moves */
+        std::unique_ptr<TextIndex> textIndex = std::make_unique<TextIndex>(); /**< Words in student notes and assignment descriptions */
+        std::unique_ptr<ChangeLog> changeLog = std::make_unique<ChangeLog>(); /**< Change versions, tombstones and export watermarks */
+
+        /**
+         * @brief Rebuilds the student slot and ID maps, the record array and the secondary index from the student list.
+         */
+        void rebuildStudentDirectory();
+
+        /**
+         * @brief Points every student at its slot in studentRecords, after the array moved.
+         */
+        void attachStudentRecords();
+
+        /**
+         * @brief Rebuilds the classroom ID and grade level directories from every teacher.
+         */
+        void rebuildClassroomDirectory();
+
+        /**
+         * @brief Gets a teacher's position in the teachers vector.
+         * @param teacher Teacher stored in this gradebook.
+         * @return The position.
+         */
+        size_t teacherPosition(const Teacher& teacher) const;
+
+        /**
+         * @brief Rebuilds the assignment ID directory from every teacher's assignments.
+         */
+        void rebuildAssignmentDirectory();
+
+        /**
+         * @brief Rebuilds the full-text index from every student's notes and assignment's description.
+         */
+        void rebuildTextIndex();
+
+        /**
+         * @brief Encodes the whole gradebook into one exactly sized buffer.
+         * @param snapshot Receives the encoded file contents.
+         * @return True on success, false if encoding failed.
+         */
+        bool encodeSnapshot(ByteBuffer& snapshot) const;
+
+        /**
+         * @brief Decodes a whole data file's contents and replaces the school with them.
+         * @param data Uncompressed file contents.
+         * @param size Number of bytes.
+         * @param repairs If not null, the contents were salvaged from a damaged file: records the lost ones left inconsistent are fixed and noted here instead of failing the load.
+         * @return False if the contents are damaged; nothing was replaced and a message has been printed.
+         */
+        bool loadSnapshot(const char* data, size_t size, std::vector<std::string>* repairs = nullptr);
+
+        /**
+         * @brief Writes a snapshot to the data file under its lock, merging in other sessions' commits if it is shared.
+         * @param snapshot Encoded snapshot; may be replaced by a merged one.
+         * @param sync If true, make the new file durable before returning.
+         * @return False if the file could not be written; a message has been printed.
+         */
+        bool writeSnapshot(ByteBuffer& snapshot, bool sync);
+
+        /**
+         * @brief Merges a file another session committed into a snapshot this session is about to write.
+         *
+         * Works only on encoded copies, so it can run on the commit thread
+         * while the session goes on changing. Conflicts keep the snapshot's
+         * version.
+         *
+         * @param filename Data file, for messages.
+         * @param snapshot Snapshot to write; replaced by the merged one.
+         * @param current The file's contents now.
+         * @param base The file's contents when the session last took it in.
+         * @return False if a copy could not be decoded or the merge could not be encoded.
+         */
+        static bool mergeSnapshots(const std::string& filename, ByteBuffer& snapshot,
+            const std::vector<char>& current, const std::vector<char>& base);
+
+        /**
+         * @brief Renders the report rows for one classroom into a cache entry.
+         * @param teacher Teacher whose classroom is rendered.
+         * @param rows Cache entry to overwrite.
+         */
+        static void renderClassroomRows(const Teacher& teacher, ClassroomReportRows& rows);
+
+        /**
+         * @brief Gets the latest change version among a classroom's students.
+         * @param teacher Teacher whose roster is checked.
+         * @return The highest student change version; 0 if none is tracked.
+         */
+        static ChangeVersion latestRosterChange(const Teacher& teacher);
 
     public:
+        /**
+         * @brief Writes the cells of one school report CSV row, without the line end.
+         * @param out Destination.
+         * @param teacherName Teacher's first and last name.
+         * @param student Student the row is about.
+         * @param classroomID Classroom whose grade the row shows.
+         */
+        static void writeSchoolReportRow(std::ostream& out, std::string_view teacherName, const Student& student, unsigned classroomID);
+
         // === Accessors ===
 
         /**
@@ -42,18 +179,271 @@ namespace gradebook {
          */
         const std::vector<std::unique_ptr<Student>>& getStudents() const;
 
+        /**
+         * @brief Gets the hot records of every student, in the same order as getStudents().
+         *
+         * The records sit side by side, so whole-school scans read them
+         * without touching any Student object.
+         *
+         * @return Const reference to the records.
+         */
+        const std::vector<StudentRecord>& getStudentRecords() const;
+
         /**
          * @brief Gets a modifiable reference to the list of administrators.
          * @return Reference to vector of Administrator objects.
          */
         std::vector<Administrator>& getSchool();
 
+        /**
+         * @brief Gets a const reference to the list of administrators.
+         * @return Const reference to vector of Administrator objects.
+         */
+        const std::vector<Administrator>& getSchool() const;
+
         /**
          * @brief Checks if autosave is currently enabled.
          * @return True if autosave is enabled, false otherwise.
          */
         bool isAutosaveEnabled() const;
 
+        /**
+         * @brief Gets the file this gradebook loads from and saves to.
+         * @return The data file path; "gradebook.dat" unless changed.
+         */
+        const std::string& getDataFile() const;
+
+        /**
+         * @brief Points the gradebook at another data file, committing pending saves to the old one first.
+         * @param filename The new data file path.
+         */
+        void setDataFile(const std::string& filename);
+
+        /**
+         * @brief Lets other sessions use the data file at the same time as this one.
+         *
+         * Every save then merges in whatever another session committed since
+         * this one last read the file, instead of overwriting it. Call before
+         * deserializeAndLoad() so the load becomes the base of those merges.
+         *
+         * @param watch True to watch the file for other sessions' commits, for reloadExternalChanges().
+         */
+        void shareDataFile(bool watch);
+
+        /**
+         * @brief Loads the changes other sessions committed to a shared data file since this one last read it.
+         *
+         * Only differing classrooms and student buckets are compared and
+         * updated; changes this session has not saved yet are kept. Teachers
+         * and administrators stay where they are, so a signed-in user's menu
+         * may call this between actions.
+         *
+         * @return True if anything was loaded.
+         */
+        bool reloadExternalChanges();
+
+        /**
+         * @brief Issues a new, globally unique revision number.
+         *
+         * Teachers stamp themselves with a fresh revision whenever their roster
+         * or scores change, which is how cached report rows detect staleness.
+         *
+         * @return A revision number greater than any previously issued.
+         */
+        static unsigned long long nextRevision();
+
+        // === Assignment Directory ===
+
+        /**
+         * @brief Issues a new stable assignment ID owned by a teacher.
+         * @param owner Teacher the assignment belongs to; must be stored in this gradebook.
+         * @return The new ID.
+         */
+        unsigned registerAssignment(const Teacher& owner);
+
+        /**
+         * @brief Forgets a deleted assignment's ID. The ID is never issued again.
+         * @param assignmentID ID of the deleted assignment.
+         */
+        void unregisterAssignment(unsigned assignmentID);
+
+        /**
+         * @brief Finds an assignment anywhere in the school by its stable ID.
+         * @param assignmentID ID to look up.
+         * @return Pointer to the assignment, or nullptr if no such assignment exists.
+         */
+        const Assignment* findAssignment(unsigned assignmentID) const;
+
+        /**
+         * @brief Finds the teacher who owns an assignment.
+         * @param assignmentID ID to look up.
+         * @return Pointer to the teacher, or nullptr if no such assignment exists.
+         */
+        const Teacher* findAssignmentOwner(unsigned assignmentID) const;
+
+        /**
+         * @brief Adds a newly stored assignment's description to the full-text index.
+         * @param assignment Assignment already registered and stored with its teacher.
+         */
+        void indexAssignmentDescription(const Assignment& assignment);
+
+        // === Classroom Directory ===
+
+        /**
+         * @brief Stores a new teacher and issues their classroom a stable ID.
+         * @param teacher The teacher to store.
+         * @return Reference to the stored teacher.
+         */
+        Teacher& addTeacher(Teacher teacher);
+
+        /**
+         * @brief Finds a classroom by its stable ID.
+         * @param classroomID ID to look up.
+         * @return Pointer to the classroom's teacher, or nullptr if no such classroom exists.
+         */
+        Teacher* findClassroom(unsigned classroomID);
+
+        /** @brief Finds a classroom by its stable ID without modifying it. */
+        const Teacher* findClassroom(unsigned classroomID) const;
+
+        /**
+         * @brief Lists the teachers of one grade level.
+         * @param gradeLevel Grade level to look up.
+         * @return Pointers to those teachers, in the order they were added.
+         */
+        std::vector<Teacher*> getTeachersForGrade(unsigned gradeLevel);
+
+        /**
+         * @brief Moves a classroom to another grade level, keeping the grade level directory current.
+         * @param teacher Teacher stored in this gradebook.
+         * @param gradeLevel The new grade level.
+         */
+        void setClassroomGradeLevel(Teacher& teacher, unsigned gradeLevel);
+
+        // === Student Directory ===
+
+        /**
+         * @brief Takes ownership of a new student and records its slot.
+         * @param student The student to store.
+         * @return Pointer to the stored student.
+         */
+        Student* addStudent(std::unique_ptr<Student> student);
+
+        /**
+         * @brief Puts a stored student on a teacher's roster.
+         * @param teacher Teacher stored in this gradebook.
+         * @param student Student stored in this gradebook.
+         */
+        void enrollStudent(Teacher& teacher, Student* student);
+
+        /**
+         * @brief Finds a student by ID.
+         * @param id Student ID.
+         * @return Pointer to the student, or nullptr if no student has that ID.
+         */
+        Student* findStudentByID(unsigned id) const;
+
+        /**
+         * @brief Renames a student, keeping every roster they are on in name order.
+         * @param student Student stored in this gradebook.
+         * @param firstName The new first name.
+         * @param lastName The new last name.
+         */
+        void renameStudent(Student* student, const std::string& firstName, const std::string& lastName);
+
+        /**
+         * @brief Lists the teachers of every class a student is enrolled in.
+         *
+         * Walks the student's own enrollments, so the cost grows with that
+         * student's classes, not with the number of teachers.
+         *
+         * @param student Student to look up.
+         * @return Pointers to those teachers, in classroom ID order.
+         */
+        std::vector<const Teacher*> getTeachersOf(const Student* student) const;
+
+        /**
+         * @brief Deletes a student, taking them off the roster of every class they are enrolled in.
+         *
+         * The last student is swapped into the freed slot, so removal costs
+         * the same no matter how many students the school has.
+         *
+         * @param student Student to delete; the pointer is invalid afterwards.
+         * @return True if the student was stored in this gradebook.
+         */
+        bool removeStudent(Student* student);
+
+        /**
+         * @brief Moves students from one classroom to another in one batch.
+         *
+         * The source roster is compacted once and the destination index sorted
+         * once, however many students move. Moved students are regraded
+         * against the destination's assignments.
+         *
+         * @param batch Students to move; ones not on the source roster are skipped.
+         * @param from Teacher the students leave.
+         * @param to Teacher the students join.
+         * @param regrade If true, moved students take the destination's grade level.
+         * @return Number of students moved.
+         */
+        size_t transferStudents(const std::vector<Student*>& batch, Teacher& from, Teacher& to, bool regrade = false);
+
+        /**
+         * @brief Finds the students matching a grade level, letter grade and age band.
+         *
+         * Answered from the secondary index, which every student keeps current
+         * as it is added, regraded or removed, so the cost follows the number
+         * of matches rather than the size of the school.
+         *
+         * @param filter What to match.
+         * @return Matching students, grouped by grade level, then letter grade, then age.
+         */
+        std::vector<Student*> findStudents(const StudentFilter& filter) const;
+
+        /**
+         * @brief Counts the students matching a grade level, letter grade and age band.
+         * @param filter What to match.
+         * @return Number of matching students.
+         */
+        size_t countStudents(const StudentFilter& filter) const;
+
+        /**
+         * @brief Searches student notes and assignment descriptions.
+         *
+         * Plain words must all appear, "quoted phrases" must appear word for
+         * word, and a word ending in * matches any word starting with it.
+         *
+         * @param query Search text.
+         * @param limit Most results to return.
+         * @return Hits, most relevant first.
+         */
+        std::vector<TextHit> searchText(const std::string& query, size_t limit) const;
+
+        /**
+         * @brief Gets the log of change versions, removals and export watermarks.
+         * @return Reference to the log.
+         */
+        ChangeLog& getChangeLog();
+
+        /**
+         * @brief Gets the log of change versions, removals and export watermarks without modifying it.
+         * @return Const reference to the log.
+         */
+        const ChangeLog& getChangeLog() const;
+
+        // === Report Cache ===
+
+        /**
+         * @brief Gets the per-classroom school report rows, re-rendering only dirty classrooms.
+         * @return Const reference to cached rows, one entry per teacher.
+         */
+        const std::vector<ClassroomReportRows>& getSchoolReportRows();
+
+        /**
+         * @brief Drops every cached report row so the next report rebuilds from scratch.
+         */
+        void invalidateReportCache();
+
         // === Admin Functions ===
 
         /**
@@ -65,13 +455,72 @@ namespace gradebook {
 
         /**
          * @brief Serializes current gradebook data and saves it to disk in binary format.
+         *
+         * Explicit saves are always durable: any grouped autosave still
+         * waiting is superseded, and the call returns once the data is synced.
          */
         void serializeAndSave();
 
+        /**
+         * @brief Saves after a change if autosave is on, using the current durability mode.
+         */
+        void autosave();
+
+        /**
+         * @brief Blocks until every grouped autosave has been committed.
+         */
+        void flushPendingSaves();
+
+        /**
+         * @brief Gets the autosave durability mode.
+         * @return The current mode.
+         */
+        DurabilityMode getDurabilityMode() const;
+
+        /**
+         * @brief Switches the autosave durability mode, committing anything still pending first.
+         * @param mode The new mode.
+         */
+        void setDurabilityMode(DurabilityMode mode);
+
+        /**
+         * @brief Sets when a group commit closes in Grouped mode.
+         * @param windowMs Longest a change may wait for its fsync, in milliseconds.
+         * @param maxChanges Number of changes that closes a batch early.
+         */
+        void setGroupCommitPolicy(unsigned windowMs, unsigned maxChanges);
+
+        /**
+         * @brief Gets the group commit window.
+         * @return Window in milliseconds.
+         */
+        unsigned getGroupCommitWindowMs() const;
+
+        /**
+         * @brief Gets the number of changes that closes a group commit early.
+         * @return Change count.
+         */
+        unsigned getGroupCommitMaxChanges() const;
+
         /**
          * @brief Loads gradebook data from a binary file and deserializes into current gradebook state.
+         * @return False if the file could not be read or is damaged; nothing was replaced and a message has been printed.
+         */
+        bool deserializeAndLoad();
+
+        /**
+         * @brief Loads contents salvaged from a damaged data file, fixing what the lost records broke.
+         *
+         * A classroom whose ID an earlier classroom already uses is dropped,
+         * and students enrolled in a classroom that was lost are withdrawn
+         * from it.
+         *
+         * @param data Uncompressed contents, rebuilt from the records that survived.
+         * @param size Number of bytes.
+         * @param repairs Receives a line for every fix made.
+         * @return False if the contents still cannot be loaded; a message has been printed.
          */
-        void deserializeAndLoad();
+        bool loadSalvagedSnapshot(const char* data, size_t size, std::vector<std::string>& repairs);
 
         /**
          * @brief Toggles the autosave feature on or off.
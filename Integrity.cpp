@@ -0,0 +1,590 @@
+#include "Integrity.h"
+#include "Compression.h"
+#include "Gradebook.h"
+#include "Serialization.h"
+#include "SharedDataFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string_view>
+
+namespace gradebook {
+
+    namespace {
+        /** Smallest batch of records worth checksumming on its own thread. */
+        constexpr size_t minimumFramesPerWorker = 4096;
+
+        /** Longest record the resync scan checksums before any intact record has shown how long records get. */
+        constexpr size_t resyncRecordFloor = 4096;
+
+        /** Farthest the resync scan looks for the next intact record before writing off the rest of the section. */
+        constexpr size_t maximumResyncBytes = size_t{ 16 } << 20;
+
+        /**
+         * @brief What scanning one section found, kept for salvaging.
+         */
+        struct SectionScan {
+            SectionTag tag = SectionTag::Administrators;    ///< Which section
+            bool headerIntact = false;                      ///< True if the section header was found and checked out
+            SectionHeader header;                           ///< Decoded header, if intact
+            size_t bodyStart = 0;                           ///< Offset of the body, or where it should have been
+            size_t bodyEnd = 0;                             ///< Offset just past the body
+            bool bodyIntact = false;                        ///< True if the body matched the header's checksum
+            bool cutShort = false;                          ///< True if the file ends inside the body
+            std::vector<std::string_view> records;          ///< Intact framed records of a damaged body
+        };
+
+        /**
+         * @brief A data file's contents and what scanning them found.
+         */
+        struct FileScan {
+            std::vector<char> contents;             ///< Uncompressed file contents
+            bool headerIntact = false;              ///< True if the file header checked out
+            unsigned nextAssignmentID = 1;          ///< From the header, if intact
+            unsigned nextClassroomID = 1;           ///< From the header, if intact
+            std::vector<SectionScan> sections;      ///< One per section, in file order
+        };
+
+        /**
+         * @brief Reads an unsigned value at an arbitrary offset.
+         * @param data Where the value starts.
+         * @return The value.
+         */
+        unsigned readUnsigned(const char* data) {
+            unsigned value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        /**
+         * @brief Checks for an intact section header at an offset.
+         * @param data File contents.
+         * @param size Number of bytes.
+         * @param offset Where the header would start.
+         * @param first Index in dataFileSections of the first section that may be there.
+         * @param header Receives the header if one is found.
+         * @return True if a header of that section or a later one checks out there and its body fits in the file.
+         */
+        bool isSectionHeader(const char* data, size_t size, size_t offset, size_t first, SectionHeader& header) {
+            if (size - offset < sectionHeaderBytes) return false;
+
+            unsigned tag = readUnsigned(data + offset);
+            bool expected = false;
+            for (size_t i = first; i < std::size(dataFileSections); ++i) {
+                expected = expected || tag == static_cast<unsigned>(dataFileSections[i]);
+            }
+            return expected && readSectionHeader(data + offset, header)
+                && header.bytes <= size - offset - sectionHeaderBytes;
+        }
+
+        /**
+         * @brief Checks for an intact record frame at an offset.
+         * @param data File contents.
+         * @param offset Where the frame would start.
+         * @param end End of the section body.
+         * @param maximumLength Longest record to consider; longer lengths are rejected without checksumming.
+         * @return True if a non-empty record fits there and matches its checksum.
+         */
+        bool isIntactFrame(const char* data, size_t offset, size_t end, size_t maximumLength = std::numeric_limits<size_t>::max()) {
+            if (end - offset < recordFrameBytes) return false;
+
+            unsigned length = readUnsigned(data + offset);
+            if (length == 0 || length > end - offset - recordFrameBytes || length > maximumLength) return false;
+            return crc32(data + offset + recordFrameBytes, length) == readUnsigned(data + offset + sizeof(unsigned));
+        }
+
+        /**
+         * @brief Names a damaged record from whatever of it can still be read.
+         * @param tag Section the record is in.
+         * @param body Record body, after its frame.
+         * @param length Length its frame gives.
+         * @return E.g. "student 1234 (Ana Ruiz)", or "the record" if too little can be read.
+         */
+        std::string describeRecord(SectionTag tag, const char* body, size_t length) {
+            try {
+                ByteReader reader(body, length);
+                if (tag == SectionTag::Administrators) {
+                    reader.skipString();                        // title
+                    std::string first = reader.readString();
+                    std::string last = reader.readString();
+                    return "administrator " + first + " " + last;
+                }
+                if (tag == SectionTag::Students) {
+                    std::string first = reader.readString();
+                    std::string last = reader.readString();
+                    reader.skipString();                        // pronouns
+                    reader.skip(2 * sizeof(unsigned));          // age, grade level
+                    unsigned id = reader.read<unsigned>();
+                    return "student " + std::to_string(id) + " (" + first + " " + last + ")";
+                }
+                if (tag == SectionTag::Teachers) {
+                    unsigned classroomID = reader.read<unsigned>();
+                    reader.skipString();                        // title
+                    std::string first = reader.readString();
+                    std::string last = reader.readString();
+                    return "classroom " + std::to_string(classroomID) + " (" + first + " " + last + ")";
+                }
+            }
+            catch (const std::exception&) {
+            }
+            return "the record";
+        }
+
+        /**
+         * @brief Walks a damaged section record by record, keeping the intact records and reporting the rest.
+         *
+         * Frames are followed by their lengths as far as they stay inside
+         * the body, and that run of records is checksummed in parallel. At
+         * the first record that fails, the walk either steps over it, if its
+         * length still leads to an intact record, or scans forward byte by
+         * byte for the next frame whose checksum matches. The scan only
+         * checksums candidates no longer than the longest intact record seen,
+         * and gives up after maximumResyncBytes, reporting the rest of the
+         * section as one damaged stretch, so garbage costs linear time.
+         *
+         * @param data File contents.
+         * @param section Section to walk; its records are filled in.
+         * @param report Receives a problem per damaged stretch.
+         */
+        void walkDamagedSection(const char* data, SectionScan& section, IntegrityReport& report) {
+            const std::string name = sectionName(section.tag);
+            size_t end = section.bodyEnd;
+            size_t position = section.bodyStart;
+            long long index = 0;
+            size_t longest = resyncRecordFloor;
+
+            while (position < end) {
+                std::vector<size_t> frames;
+                size_t cursor = position;
+                while (end - cursor >= recordFrameBytes) {
+                    unsigned length = readUnsigned(data + cursor);
+                    if (length == 0 || length > end - cursor - recordFrameBytes) break;
+                    frames.push_back(cursor);
+                    cursor += recordFrameBytes + length;
+                }
+
+                std::vector<char> intact(frames.size(), 0);
+                parallelForRanges(frames.size(), workerCountFor(frames.size(), minimumFramesPerWorker),
+                    [&](unsigned, size_t first, size_t last) {
+                        for (size_t i = first; i < last; ++i) {
+                            intact[i] = isIntactFrame(data, frames[i], end);
+                        }
+                    });
+
+                size_t resyncFrom = cursor;
+                bool stopped = false;
+                for (size_t i = 0; i < frames.size(); ++i, ++index) {
+                    unsigned length = readUnsigned(data + frames[i]);
+                    if (intact[i]) {
+                        section.records.emplace_back(data + frames[i], recordFrameBytes + length);
+                        longest = std::max<size_t>(longest, length);
+                        continue;
+                    }
+
+                    // A record whose length still leads to an intact one is the only one lost.
+                    bool nextIntact = i + 1 < frames.size() ? intact[i + 1] != 0 : cursor == end;
+                    if (nextIntact) {
+                        report.problems.push_back({ name, index, frames[i], recordFrameBytes + length,
+                            describeRecord(section.tag, data + frames[i] + recordFrameBytes, length) + " fails its checksum" });
+                        continue;
+                    }
+                    resyncFrom = frames[i];
+                    stopped = true;
+                    break;
+                }
+                if (!stopped && cursor == end) break;
+
+                size_t next = resyncFrom + 1;
+                size_t scanEnd = end - resyncFrom > maximumResyncBytes ? resyncFrom + maximumResyncBytes : end;
+                while (next < scanEnd && !isIntactFrame(data, next, end, longest)) {
+                    ++next;
+                }
+                bool gaveUp = next == scanEnd && scanEnd != end;
+                if (next == scanEnd) {
+                    next = end;
+                }
+                report.problems.push_back({ name, index++, resyncFrom, next - resyncFrom,
+                    "one or more records are damaged up to "
+                    + std::string(next != end ? "the next intact record"
+                        : gaveUp ? "the end of the section (no intact record within "
+                            + std::to_string(maximumResyncBytes >> 20) + " MiB of the damage)"
+                        : "the end of the section") });
+                position = next;
+            }
+        }
+
+        /**
+         * @brief Reads a data file and checks everything in it, keeping what is needed to salvage it.
+         * @param filename Data file to check.
+         * @param report Receives what was found.
+         * @param scan Receives the contents and the intact parts of a checksummed file.
+         * @return False if the file could not be read at all; a message has been printed.
+         */
+        bool scanDataFile(const std::string& filename, IntegrityReport& report, FileScan& scan) {
+            auto started = std::chrono::steady_clock::now();
+            report = IntegrityReport();
+            report.filename = filename;
+
+            std::string error;
+            if (!readDataFile(filename, scan.contents, error)) {
+                std::cerr << "Failed to read " << filename << ": " << error << ".\n";
+                return false;
+            }
+            report.readable = true;
+            const char* data = scan.contents.data();
+            size_t size = scan.contents.size();
+            report.bytes = size;
+
+            if (size >= 2 * sizeof(unsigned) && readUnsigned(data) == gradebookFileMagic) {
+                report.version = readUnsigned(data + sizeof(unsigned));
+            }
+            if (report.version > gradebookFormatVersion) {
+                report.problems.push_back({ "file header", -1, 0, 0,
+                    "written by a newer version (format " + std::to_string(report.version) + ")" });
+                return true;
+            }
+
+            if (report.version < firstChecksummedVersion) {
+                // Nothing to check but whether it loads.
+                Gradebook test;
+                test.setDataFile(filename);
+                if (!test.deserializeAndLoad()) {
+                    report.problems.push_back({ "file", -1, 0, size, "the file does not load and has no checksums to find the damage by" });
+                }
+                report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+                return true;
+            }
+            report.checksummed = true;
+
+            // --- Header ---
+            if (size >= fileHeaderBytes
+                && crc32(data, fileHeaderBytes - sizeof(unsigned)) == readUnsigned(data + fileHeaderBytes - sizeof(unsigned))) {
+                scan.headerIntact = true;
+                scan.nextAssignmentID = readUnsigned(data + 2 * sizeof(unsigned));
+                scan.nextClassroomID = readUnsigned(data + 3 * sizeof(unsigned));
+            }
+            else {
+                report.problems.push_back({ "file header", -1, 0, std::min(size, fileHeaderBytes), "the header fails its checksum" });
+            }
+
+            // --- Locate sections ---
+            size_t position = std::min(size, fileHeaderBytes);
+            for (size_t i = 0; i < std::size(dataFileSections); ++i) {
+                SectionScan section;
+                section.tag = dataFileSections[i];
+                SectionHeader found;
+
+                if (size - position >= sectionHeaderBytes && readSectionHeader(data + position, found)
+                    && found.tag == section.tag && found.bytes > size - position - sectionHeaderBytes) {
+                    report.problems.push_back({ sectionName(section.tag), -1, size, 0, "the file ends inside the section" });
+                    section.headerIntact = true;
+                    section.cutShort = true;
+                    section.header = found;
+                    section.bodyStart = position + sectionHeaderBytes;
+                    section.bodyEnd = size;
+                    position = size;
+                    scan.sections.push_back(std::move(section));
+                    continue;
+                }
+
+                bool here = isSectionHeader(data, size, position, i, found);
+                if (!here || found.tag != section.tag) {
+                    // Look for this section's header further on, or else the next section's.
+                    size_t next = position;
+                    if (!here) {
+                        for (++next; next < size && !isSectionHeader(data, size, next, i, found); ++next) {
+                        }
+                    }
+                    if (next < size && found.tag == section.tag) {
+                        report.problems.push_back({ sectionName(section.tag), -1, position, next - position,
+                            "unexpected bytes before the section header" });
+                        position = next;
+                    }
+                    else {
+                        next = std::min(next, size);
+                        report.problems.push_back({ sectionName(section.tag), -1, position, next - position,
+                            next == position ? "the section is missing" : "the section header is damaged" });
+                        section.bodyStart = std::min(next, position + sectionHeaderBytes);
+                        section.bodyEnd = next;
+                        position = section.bodyEnd;
+                        scan.sections.push_back(std::move(section));
+                        continue;
+                    }
+                }
+
+                section.headerIntact = true;
+                section.header = found;
+                section.bodyStart = position + sectionHeaderBytes;
+                section.bodyEnd = section.bodyStart + static_cast<size_t>(found.bytes);
+                position = section.bodyEnd;
+                scan.sections.push_back(std::move(section));
+            }
+            if (position < size) {
+                report.problems.push_back({ "file", -1, position, size - position, "unexpected bytes after the change log" });
+            }
+
+            // --- Check section bodies in parallel ---
+            std::vector<std::string_view> bodies;
+            for (const SectionScan& section : scan.sections) {
+                bool checkable = section.headerIntact && !section.cutShort;
+                bodies.emplace_back(data + section.bodyStart, checkable ? section.bodyEnd - section.bodyStart : 0);
+            }
+            std::vector<unsigned> crcs = crc32Spans(bodies);
+
+            for (size_t i = 0; i < scan.sections.size(); ++i) {
+                SectionScan& section = scan.sections[i];
+                SectionCheck check;
+                check.name = sectionName(section.tag);
+                check.countKnown = section.headerIntact;
+                check.records = section.header.count;
+                check.bytes = section.bodyEnd - section.bodyStart;
+                section.bodyIntact = section.headerIntact && !section.cutShort && crcs[i] == section.header.crc;
+
+                if (section.bodyIntact) {
+                    check.intact = true;
+                    check.intactRecords = check.records;
+                }
+                else if (section.tag == SectionTag::ChangeLog) {
+                    if (section.headerIntact) {
+                        report.problems.push_back({ check.name, -1, section.bodyStart, static_cast<size_t>(check.bytes),
+                            "the change log fails its checksum" });
+                    }
+                }
+                else {
+                    walkDamagedSection(data, section, report);
+                    check.intactRecords = section.records.size();
+                    if (section.headerIntact && check.intactRecords == check.records) {
+                        // Every record checks out, so the damage is in the header's own fields.
+                        report.problems.push_back({ check.name, -1, section.bodyStart - sectionHeaderBytes, sectionHeaderBytes,
+                            "the section checksum does not match its intact records" });
+                    }
+                }
+                report.sections.push_back(std::move(check));
+            }
+            std::stable_sort(report.problems.begin(), report.problems.end(),
+                [](const IntegrityProblem& a, const IntegrityProblem& b) { return a.offset < b.offset; });
+
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            return true;
+        }
+
+        /**
+         * @brief Appends a section with a freshly computed header to a salvaged file.
+         * @param out Salvaged file so far.
+         * @param tag Section.
+         * @param count Records in the body.
+         * @param records Pieces of the body, in order.
+         */
+        void appendSection(std::vector<char>& out, SectionTag tag, unsigned count, const std::vector<std::string_view>& records) {
+            SectionHeader header;
+            header.tag = tag;
+            header.count = count;
+            size_t headerAt = out.size();
+            out.resize(out.size() + sectionHeaderBytes);
+            for (std::string_view record : records) {
+                header.crc = crc32(record.data(), record.size(), header.crc);
+                header.bytes += record.size();
+                out.insert(out.end(), record.begin(), record.end());
+            }
+            writeSectionHeader(out.data() + headerAt, header);
+        }
+
+        /**
+         * @brief Builds a format 5 file from the intact parts of a scanned file.
+         * @param scan Scanned file.
+         * @param report Receives a line per section that lost records.
+         * @return The salvaged contents.
+         */
+        std::vector<char> salvage(const FileScan& scan, IntegrityReport& report) {
+            std::vector<char> out(fileHeaderBytes);
+            ByteWriter header(out.data(), out.size());
+            header.write(gradebookFileMagic);
+            header.write(gradebookFormatVersion);
+            header.write(scan.nextAssignmentID);
+            header.write(scan.nextClassroomID);
+            header.write(crc32(out.data(), header.position()));
+            if (!scan.headerIntact) {
+                report.repairs.push_back("Rebuilt the file header; the next assignment and classroom IDs were recomputed.");
+            }
+
+            for (const SectionScan& section : scan.sections) {
+                std::string_view body(scan.contents.data() + section.bodyStart, section.bodyEnd - section.bodyStart);
+                if (section.bodyIntact) {
+                    appendSection(out, section.tag, section.header.count, { body });
+                }
+                else if (section.tag == SectionTag::ChangeLog) {
+                    appendSection(out, section.tag, 0, {});
+                    report.repairs.push_back("Reset the damaged change log; the next delta exports will be full exports.");
+                }
+                else {
+                    appendSection(out, section.tag, static_cast<unsigned>(section.records.size()), section.records);
+                    std::string line = "Kept " + std::to_string(section.records.size());
+                    if (section.headerIntact) {
+                        line += " of " + std::to_string(section.header.count);
+                    }
+                    report.repairs.push_back(line + " record(s) of the " + sectionName(section.tag) + " section.");
+                }
+            }
+            return out;
+        }
+
+        /**
+         * @brief Keeps a copy of a data file before it is replaced.
+         * @param filename Data file.
+         * @param report Receives the copy's name.
+         * @return False if the copy could not be made; a message has been printed.
+         */
+        bool backUpDataFile(const std::string& filename, IntegrityReport& report) {
+            std::error_code error;
+            std::filesystem::copy_file(filename, filename + ".bak", std::filesystem::copy_options::overwrite_existing, error);
+            if (error) {
+                std::cerr << "Failed to copy " << filename << " to " << filename << ".bak: " << error.message() << ". Nothing was changed.\n";
+                return false;
+            }
+            report.backup = filename + ".bak";
+            return true;
+        }
+    }
+
+    /**
+     * @brief Checks every checksum in a data file and finds exactly which records are damaged.
+     * @param filename Data file to check; may be gzip-compressed.
+     * @param report Receives what was found.
+     * @return False if the file could not be read at all; a message has been printed.
+     */
+    bool verifyDataFile(const std::string& filename, IntegrityReport& report) {
+        FileScan scan;
+        return scanDataFile(filename, report, scan);
+    }
+
+    /**
+     * @brief Rebuilds a damaged data file from every record that is still intact.
+     * @param filename Data file to repair.
+     * @param report Receives what was found and what was changed.
+     * @return False if the file could not be read or nothing could be salvaged; a message has been printed.
+     */
+    bool repairDataFile(const std::string& filename, IntegrityReport& report) {
+        FileScan scan;
+        if (!scanDataFile(filename, report, scan)) {
+            return false;
+        }
+
+        Gradebook gradebook;
+        gradebook.setDataFile(filename);
+        if (!report.checksummed) {
+            if (!report.problems.empty()) {
+                std::cerr << filename << " has no checksums, so its damaged records cannot be told apart from the rest.\n";
+                return false;
+            }
+            // Loads cleanly; rewriting it adds the checksums.
+            if (!gradebook.deserializeAndLoad() || !backUpDataFile(filename, report)) {
+                return false;
+            }
+            gradebook.serializeAndSave();
+            report.repairs.push_back("Rewrote the file in format " + std::to_string(gradebookFormatVersion) + " with checksums.");
+            return true;
+        }
+        if (report.problems.empty()) {
+            return true;
+        }
+
+        std::vector<char> salvaged = salvage(scan, report);
+        if (!gradebook.loadSalvagedSnapshot(salvaged.data(), salvaged.size(), report.repairs)) {
+            std::cerr << "The records salvaged from " << filename << " could not be loaded; nothing was changed.\n";
+            return false;
+        }
+        if (gradebook.getSchool().empty()) {
+            report.repairs.push_back("No administrator record survived; one will have to be set up again.");
+        }
+        if (!backUpDataFile(filename, report)) {
+            return false;
+        }
+        gradebook.serializeAndSave();
+
+        // Make sure what landed on disk is whole.
+        IntegrityReport check;
+        FileScan rescan;
+        if (!scanDataFile(filename, check, rescan) || !check.problems.empty()) {
+            std::cerr << "The repaired " << filename << " did not verify; the damaged original is in " << report.backup << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Prints the sections, problems and repairs of a report.
+     * @param report Report to print.
+     */
+    void printIntegrityReport(const IntegrityReport& report) {
+        if (!report.readable) {
+            return;
+        }
+
+        double megabytes = report.bytes / (1024.0 * 1024.0);
+        std::cout << report.filename << ": format " << report.version << ", " << std::fixed;
+        if (megabytes < 1) {
+            std::cout << report.bytes << " byte(s)";
+        }
+        else {
+            std::cout << std::setprecision(1) << megabytes << " MB";
+        }
+        std::cout << " checked in " << std::setprecision(3) << report.seconds << " s";
+        if (megabytes >= 1 && report.seconds > 0) {
+            std::cout << " (" << std::setprecision(0) << megabytes / report.seconds << " MB/s)";
+        }
+        std::cout << ".\n" << std::defaultfloat;
+        if (!report.checksummed) {
+            std::cout << "This file predates checksums; it was only test-loaded.\n";
+        }
+
+        for (const SectionCheck& section : report.sections) {
+            std::cout << "  " << section.name << ": ";
+            if (section.intact) {
+                std::cout << "intact";
+                if (section.name != sectionName(SectionTag::ChangeLog)) {
+                    std::cout << ", " << section.records << " record(s)";
+                }
+            }
+            else if (section.name == sectionName(SectionTag::ChangeLog)) {
+                std::cout << "damaged";
+            }
+            else {
+                std::cout << section.intactRecords;
+                if (section.countKnown) {
+                    std::cout << " of " << section.records;
+                }
+                std::cout << " record(s) intact";
+            }
+            std::cout << "\n";
+        }
+
+        if (report.problems.empty()) {
+            std::cout << "No damage found.\n";
+        }
+        else {
+            std::cout << report.problems.size() << " problem(s):\n";
+            for (const IntegrityProblem& problem : report.problems) {
+                std::cout << "  " << problem.section;
+                if (problem.record >= 0) {
+                    std::cout << ", record " << problem.record;
+                }
+                std::cout << ", offset " << problem.offset << " (" << problem.length << " byte(s)): " << problem.what << "\n";
+            }
+        }
+
+        if (!report.repairs.empty()) {
+            std::cout << "Repairs:\n";
+            for (const std::string& line : report.repairs) {
+                std::cout << "  " << line << "\n";
+            }
+        }
+        if (!report.backup.empty()) {
+            std::cout << "The original file was kept as " << report.backup << ".\n";
+        }
+        std::cout << std::flush;
+    }
+}
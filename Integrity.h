@@ -0,0 +1,81 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    /**
+     * @brief One damaged stretch of a data file.
+     */
+    struct IntegrityProblem {
+        std::string section;        /**< Section the damage is in, or "file header" */
+        long long record = -1;      /**< Index of the first damaged record in its section, or -1 if the damage is not in a record */
+        size_t offset = 0;          /**< Byte offset of the damage in the uncompressed contents */
+        size_t length = 0;          /**< Bytes lost, up to the next intact record or section */
+        std::string what;           /**< What is wrong, naming the record where it can still be read */
+    };
+
+    /**
+     * @brief What verifying one section found.
+     */
+    struct SectionCheck {
+        std::string name;               /**< Section name */
+        bool intact = false;            /**< True if the header and body checksums both matched */
+        bool countKnown = false;        /**< False if the section header was damaged, so the record count is unknown */
+        size_t records = 0;             /**< Record count from the section header */
+        size_t intactRecords = 0;       /**< Records whose own checksum matched */
+        unsigned long long bytes = 0;   /**< Length of the body */
+    };
+
+    /**
+     * @brief What verifying, and possibly repairing, a data file found.
+     */
+    struct IntegrityReport {
+        std::string filename;                   /**< Data file checked */
+        bool readable = false;                  /**< False if the file could not be read or decompressed at all */
+        unsigned version = 0;                   /**< Format version in the header */
+        bool checksummed = false;               /**< False for files older than format 5, which could only be test-loaded */
+        size_t bytes = 0;                       /**< Uncompressed length */
+        double seconds = 0;                     /**< Time taken to read and check the file */
+        std::vector<SectionCheck> sections;     /**< One entry per section, in file order */
+        std::vector<IntegrityProblem> problems; /**< Every damaged stretch found */
+        std::vector<std::string> repairs;       /**< What repairing changed; empty unless repairDataFile ran */
+        std::string backup;                     /**< Copy of the damaged file kept by repairDataFile */
+    };
+
+    /**
+     * @brief Checks every checksum in a data file and finds exactly which records are damaged.
+     *
+     * The header and section checksums are verified first, every section
+     * in parallel. Only a section that fails is walked record by record,
+     * its records checksummed in parallel; past a damaged record the walk
+     * resynchronises on the next frame whose checksum matches. Files older
+     * than format 5 have no checksums and are only test-loaded.
+     *
+     * @param filename Data file to check; may be gzip-compressed.
+     * @param report Receives what was found.
+     * @return False if the file could not be read at all; a message has been printed.
+     */
+    bool verifyDataFile(const std::string& filename, IntegrityReport& report);
+
+    /**
+     * @brief Rebuilds a damaged data file from every record that is still intact.
+     *
+     * A copy of the damaged file is kept as "<file>.bak". Records that
+     * failed their checksum are dropped, enrollments in classrooms that were
+     * lost are withdrawn, and a damaged change log is reset, so the next
+     * delta export is a full one. An intact file is left alone; an intact
+     * file older than format 5 is rewritten with checksums.
+     *
+     * @param filename Data file to repair.
+     * @param report Receives what was found and what was changed.
+     * @return False if the file could not be read or nothing could be salvaged; a message has been printed.
+     */
+    bool repairDataFile(const std::string& filename, IntegrityReport& report);
+
+    /**
+     * @brief Prints the sections, problems and repairs of a report.
+     * @param report Report to print.
+     */
+    void printIntegrityReport(const IntegrityReport& report);
+}
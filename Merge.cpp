@@ -0,0 +1,1026 @@
+#include "Merge.h"
+#include "Gradebook.h"
+#include "Serialization.h"
+#include "utilities.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace gradebook {
+
+    namespace {
+        /** Branches under the student root. */
+        constexpr size_t treeBranches = 256;
+
+        /** Buckets under each branch. */
+        constexpr size_t bucketsPerBranch = 256;
+
+        /** Smallest batch of students worth hashing on its own thread. */
+        constexpr size_t minimumStudentsPerHashWorker = 4096;
+
+        /**
+         * @brief Builds a 64-bit content hash from a sequence of fields.
+         *
+         * Text is length-prefixed so neighbouring fields cannot run into each
+         * other. A finished hash is never 0, which stands for "no record".
+         */
+        class ContentHash {
+        private:
+            std::uint64_t state = 0xcbf29ce484222325ULL;   /**< FNV-1a state */
+
+            void addBytes(const void* data, size_t length) {
+                auto bytes = static_cast<const unsigned char*>(data);
+                for (size_t i = 0; i < length; ++i) {
+                    state = (state ^ bytes[i]) * 0x100000001b3ULL;
+                }
+            }
+
+        public:
+            void addUnsigned(unsigned value) { addBytes(&value, sizeof value); }
+
+            void addFloat(float value) { addBytes(&value, sizeof value); }
+
+            void addHash(std::uint64_t value) { addBytes(&value, sizeof value); }
+
+            void addText(std::string_view text) {
+                addUnsigned(static_cast<unsigned>(text.size()));
+                addBytes(text.data(), text.size());
+            }
+
+            std::uint64_t finish() const {
+                std::uint64_t h = state;
+                h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+                h ^= h >> 31;
+                return h ? h : 1;
+            }
+        };
+
+        std::uint64_t hashStudentProfile(const Student& s) {
+            ContentHash h;
+            h.addText(s.getFirstNameView());
+            h.addText(s.getLastNameView());
+            h.addText(s.getPronounsView());
+            h.addUnsigned(s.getAge());
+            h.addUnsigned(s.getGradeLevel());
+            h.addText(s.getSeatView());
+            h.addText(s.getNotesView());
+            return h.finish();
+        }
+
+        /** Grades are left out: they follow from the scores and are recomputed after a merge. */
+        std::uint64_t hashEnrollment(const Enrollment& enrollment) {
+            ContentHash h;
+            h.addUnsigned(enrollment.classroomID);
+            for (const AssignmentScore& score : enrollment.scores) {
+                h.addUnsigned(score.assignmentID);
+                h.addFloat(score.score);
+            }
+            return h.finish();
+        }
+
+        std::uint64_t hashStudent(const Student& s) {
+            ContentHash h;
+            h.addUnsigned(s.getID());
+            h.addHash(hashStudentProfile(s));
+            for (const Enrollment& enrollment : s.getEnrollments()) {
+                h.addHash(hashEnrollment(enrollment));
+            }
+            return h.finish();
+        }
+
+        std::uint64_t hashTeacherProfile(const Teacher& t) {
+            ContentHash h;
+            h.addText(t.getTitleView());
+            h.addText(t.getFirstNameView());
+            h.addText(t.getLastNameView());
+            h.addText(t.getPasswordView());
+            h.addUnsigned(t.getGradeLevel());
+            return h.finish();
+        }
+
+        std::uint64_t hashAssignment(const Assignment& a) {
+            ContentHash h;
+            h.addUnsigned(a.getAssignmentID());
+            h.addText(a.getAssignmentNameView());
+            h.addText(a.getAssignmentDescriptionView());
+            h.addFloat(a.getPointsPossible());
+            return h.finish();
+        }
+
+        /** Compares everything but the ID, to recognise an assignment that was copied under a new ID. */
+        bool sameAssignmentContent(const Assignment& a, const Assignment& b) {
+            return a.getAssignmentNameView() == b.getAssignmentNameView()
+                && a.getAssignmentDescriptionView() == b.getAssignmentDescriptionView()
+                && a.getPointsPossible() == b.getPointsPossible();
+        }
+
+        /** The roster is left out: it is the students' enrollments seen from the other side. */
+        std::uint64_t hashClassroom(const Teacher& t) {
+            std::vector<std::pair<unsigned, std::uint64_t>> assignments;
+            assignments.reserve(t.getAssignments().size());
+            for (const Assignment& a : t.getAssignments()) {
+                assignments.emplace_back(a.getAssignmentID(), hashAssignment(a));
+            }
+            std::sort(assignments.begin(), assignments.end());
+
+            ContentHash h;
+            h.addUnsigned(t.getClassroomID());
+            h.addHash(hashTeacherProfile(t));
+            for (const auto& [id, hash] : assignments) {
+                h.addHash(hash);
+            }
+            return h.finish();
+        }
+
+        std::uint64_t hashAdministrators(const std::vector<Administrator>& school) {
+            ContentHash h;
+            h.addUnsigned(static_cast<unsigned>(school.size()));
+            for (const Administrator& admin : school) {
+                h.addText(admin.getAdminTitleView());
+                h.addText(admin.getFirstNameView());
+                h.addText(admin.getLastNameView());
+                h.addText(admin.getSchoolNameView());
+                h.addText(admin.getPasswordView());
+            }
+            return h.finish();
+        }
+
+        /**
+         * @brief Picks a student's bucket from their ID.
+         * @param studentID Student ID.
+         * @return Bucket index; the high byte is the branch.
+         */
+        size_t studentBucket(unsigned studentID) {
+            return static_cast<unsigned>(studentID * 2654435761u) >> 16;
+        }
+
+        /**
+         * @brief One record's key and content hash.
+         */
+        struct RecordHash {
+            unsigned id = 0;            /**< Student or classroom ID */
+            std::uint64_t hash = 0;     /**< Content hash */
+        };
+
+        /**
+         * @brief Content hashes of one copy of a school, arranged as a tree.
+         *
+         * Students are laid out bucket by bucket in one vector, in ID order
+         * within each bucket, with bucketStarts marking where each begins.
+         */
+        struct RecordTree {
+            std::uint64_t root = 0;                 /**< Hash of everything below */
+            std::uint64_t administrators = 0;       /**< Hash of the administrator list */
+            std::uint64_t classroomsHash = 0;       /**< Hash over every classroom */
+            std::vector<RecordHash> classrooms;     /**< One entry per classroom, in ID order */
+            std::uint64_t studentsHash = 0;         /**< Hash over every branch */
+            std::vector<std::uint64_t> branches;    /**< Hash over each branch's buckets */
+            std::vector<std::uint64_t> buckets;     /**< Hash over each bucket's students; 0 if empty */
+            std::vector<size_t> bucketStarts;       /**< Where each bucket begins in students, plus the end */
+            std::vector<RecordHash> students;       /**< Student hashes grouped by bucket */
+        };
+
+        /**
+         * @brief Hashes a school into a record tree, hashing students and buckets in parallel.
+         * @param gradebook School to hash.
+         * @return The tree.
+         */
+        RecordTree buildRecordTree(const Gradebook& gradebook) {
+            RecordTree tree;
+            tree.administrators = hashAdministrators(gradebook.getSchool());
+
+            ContentHash classrooms;
+            for (const Teacher& t : gradebook.getTeachers()) {
+                tree.classrooms.push_back({ t.getClassroomID(), hashClassroom(t) });
+            }
+            std::sort(tree.classrooms.begin(), tree.classrooms.end(),
+                [](const RecordHash& a, const RecordHash& b) { return a.id < b.id; });
+            for (const RecordHash& entry : tree.classrooms) {
+                classrooms.addHash(entry.hash);
+            }
+            tree.classroomsHash = classrooms.finish();
+
+            const auto& students = gradebook.getStudents();
+            std::vector<RecordHash> leaves(students.size());
+            parallelForRanges(students.size(), workerCountFor(students.size(), minimumStudentsPerHashWorker),
+                [&](unsigned, size_t first, size_t last) {
+                    for (size_t i = first; i < last; ++i) {
+                        leaves[i] = { students[i]->getID(), hashStudent(*students[i]) };
+                    }
+                });
+
+            const size_t bucketCount = treeBranches * bucketsPerBranch;
+            tree.bucketStarts.assign(bucketCount + 1, 0);
+            for (const RecordHash& leaf : leaves) {
+                ++tree.bucketStarts[studentBucket(leaf.id) + 1];
+            }
+            for (size_t b = 0; b < bucketCount; ++b) {
+                tree.bucketStarts[b + 1] += tree.bucketStarts[b];
+            }
+            tree.students.resize(leaves.size());
+            std::vector<size_t> next(tree.bucketStarts.begin(), tree.bucketStarts.end() - 1);
+            for (const RecordHash& leaf : leaves) {
+                tree.students[next[studentBucket(leaf.id)]++] = leaf;
+            }
+
+            tree.buckets.assign(bucketCount, 0);
+            tree.branches.assign(treeBranches, 0);
+            parallelForRanges(treeBranches, workerCountFor(leaves.size(), minimumStudentsPerHashWorker),
+                [&](unsigned, size_t first, size_t last) {
+                    for (size_t branch = first; branch < last; ++branch) {
+                        ContentHash branchHash;
+                        for (size_t b = branch * bucketsPerBranch; b < (branch + 1) * bucketsPerBranch; ++b) {
+                            auto begin = tree.students.begin() + tree.bucketStarts[b];
+                            auto end = tree.students.begin() + tree.bucketStarts[b + 1];
+                            if (begin != end) {
+                                std::sort(begin, end, [](const RecordHash& x, const RecordHash& y) { return x.id < y.id; });
+                                ContentHash bucketHash;
+                                for (auto it = begin; it != end; ++it) {
+                                    bucketHash.addUnsigned(it->id);
+                                    bucketHash.addHash(it->hash);
+                                }
+                                tree.buckets[b] = bucketHash.finish();
+                            }
+                            branchHash.addHash(tree.buckets[b]);
+                        }
+                        tree.branches[branch] = branchHash.finish();
+                    }
+                });
+
+            ContentHash all;
+            for (std::uint64_t branch : tree.branches) {
+                all.addHash(branch);
+            }
+            tree.studentsHash = all.finish();
+
+            ContentHash root;
+            root.addHash(tree.administrators);
+            root.addHash(tree.classroomsHash);
+            root.addHash(tree.studentsHash);
+            tree.root = root.finish();
+            return tree;
+        }
+
+        /**
+         * @brief How one record is settled.
+         */
+        enum class Resolution {
+            KeepOurs,       /**< Nothing to do */
+            TakeTheirs,     /**< Copy the other side's version, which may be "removed" */
+            Conflict        /**< Both sides changed it differently */
+        };
+
+        /**
+         * @brief Settles one record from its versions on each side; an empty optional means the record is absent.
+         * @param ours This copy's version.
+         * @param theirs The other copy's version.
+         * @param base The ancestor's version.
+         * @param threeWay True if the ancestor is known.
+         * @param removedHere True if this copy's change log shows it removed the record.
+         * @return What to do.
+         */
+        template <typename T>
+        Resolution resolve(const std::optional<T>& ours, const std::optional<T>& theirs, const std::optional<T>& base,
+            bool threeWay, bool removedHere = false)
+        {
+            if (ours == theirs) return Resolution::KeepOurs;
+            if (threeWay) {
+                if (ours == base) return Resolution::TakeTheirs;
+                if (theirs == base) return Resolution::KeepOurs;
+                return Resolution::Conflict;
+            }
+            // Without an ancestor only additions can be told apart from edits.
+            if (!ours) return removedHere ? Resolution::KeepOurs : Resolution::TakeTheirs;
+            if (!theirs) return Resolution::KeepOurs;
+            return Resolution::Conflict;
+        }
+
+        /**
+         * @brief Translates classroom or assignment IDs between the two copies.
+         *
+         * IDs are the same on both sides unless the other copy's record was
+         * added here under a new ID, or was not taken at all.
+         */
+        struct IdMap {
+            std::unordered_map<unsigned, unsigned> toOurs;      /**< Other copy's ID to the ID it was given here */
+            std::unordered_map<unsigned, unsigned> toTheirs;    /**< Reverse of toOurs */
+            std::unordered_set<unsigned> dropped;               /**< Other copy's IDs with no record here */
+
+            void link(unsigned theirsID, unsigned oursID) {
+                toOurs[theirsID] = oursID;
+                toTheirs[oursID] = theirsID;
+            }
+
+            std::optional<unsigned> ours(unsigned theirsID) const {
+                if (dropped.count(theirsID)) return std::nullopt;
+                auto found = toOurs.find(theirsID);
+                return found == toOurs.end() ? theirsID : found->second;
+            }
+
+            std::optional<unsigned> theirs(unsigned oursID) const {
+                auto found = toTheirs.find(oursID);
+                if (found != toTheirs.end()) return found->second;
+                // The other copy's record with this ID means something else here.
+                if (toOurs.count(oursID) || dropped.count(oursID)) return std::nullopt;
+                return oursID;
+            }
+        };
+
+        std::string formatNumber(float value) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(2) << value;
+            return out.str();
+        }
+
+        std::string describeScore(const std::optional<float>& score) {
+            return score ? formatNumber(*score) : "no score";
+        }
+
+        std::string describeStudentProfile(const Student* s) {
+            if (!s) return "removed";
+            std::ostringstream out;
+            out << s->getFirstNameView() << " " << s->getLastNameView() << ", " << s->getPronounsView()
+                << ", age " << s->getAge() << ", grade " << s->getGradeLevel()
+                << ", seat " << s->getSeatView() << ", notes \"" << s->getNotesView() << "\"";
+            return out.str();
+        }
+
+        std::string describeEnrollment(const Enrollment* enrollment) {
+            if (!enrollment) return "not enrolled";
+            return "enrolled with " + std::to_string(enrollment->scores.size()) + " score(s)";
+        }
+
+        std::string describeTeacherProfile(const Teacher& t) {
+            std::ostringstream out;
+            out << t.getTitleView() << " " << t.getFirstNameView() << " " << t.getLastNameView()
+                << ", grade " << t.getGradeLevel();
+            return out.str();
+        }
+
+        std::string describeAssignment(const Assignment* a) {
+            if (!a) return "removed";
+            std::ostringstream out;
+            out << a->getAssignmentNameView() << " (" << formatNumber(a->getPointsPossible()) << " pts): "
+                << a->getAssignmentDescriptionView();
+            return out.str();
+        }
+
+        std::string describeAdministrators(const std::vector<Administrator>& school) {
+            if (school.empty()) return "none";
+            const Administrator& first = school.front();
+            std::ostringstream out;
+            out << first.getAdminTitleView() << " " << first.getFirstNameView() << " " << first.getLastNameView()
+                << " of " << first.getSchoolNameView();
+            if (school.size() > 1) {
+                out << " and " << school.size() - 1 << " more";
+            }
+            return out.str();
+        }
+
+        std::string studentLabel(unsigned id, const Student& s) {
+            std::ostringstream out;
+            out << "Student " << id << " (" << s.getFirstNameView() << " " << s.getLastNameView() << ")";
+            return out.str();
+        }
+
+        std::string classroomLabel(const Teacher& t) {
+            std::ostringstream out;
+            out << "Classroom " << t.getClassroomID() << " (" << t.getTitleView() << " " << t.getLastNameView() << ")";
+            return out.str();
+        }
+
+        /**
+         * @brief Merges one copy of a school into another.
+         *
+         * Classrooms are settled first so the other copy's classroom and
+         * assignment IDs can be translated before any student refers to them.
+         */
+        class Merger {
+        private:
+            Gradebook& ours;                    /**< School being merged into */
+            const Gradebook& theirs;            /**< Other copy */
+            const Gradebook* base;              /**< Common ancestor, or nullptr */
+            MergeResult& result;                /**< What the merge did */
+            IdMap classroomIDs;                 /**< Classroom IDs of the other copy */
+            IdMap assignmentIDs;                /**< Assignment IDs of the other copy */
+            std::unordered_set<unsigned> addedClassrooms;   /**< Classrooms created here by this merge */
+            std::unordered_set<unsigned> addedAssignments;  /**< Assignments created here by this merge */
+            std::unordered_set<unsigned> renumberedRosters; /**< Other copy's classrooms whose IDs moved; their students are compared whatever their hashes */
+            std::set<unsigned> regradeClassrooms;           /**< Classrooms here whose assignments changed */
+            std::vector<std::pair<Student*, unsigned>> regradeEnrollments; /**< Enrollments here whose scores changed */
+            std::unordered_set<unsigned> removedStudents;   /**< Students this copy's change log says were removed */
+            std::set<std::pair<unsigned, unsigned>> withdrawals;            /**< (student, classroom) withdrawals logged here */
+            std::set<std::tuple<unsigned, unsigned, unsigned>> erasedScores; /**< (student, classroom, assignment) erasures logged here */
+
+            bool threeWay() const { return base != nullptr; }
+
+            void conflict(std::string record, std::string oursValue, std::string theirsValue) {
+                result.conflicts.push_back({ std::move(record), std::move(oursValue), std::move(theirsValue) });
+            }
+
+            void rememberRemovals() {
+                for (const Tombstone& removal : ours.getChangeLog().tombstonesSince(0)) {
+                    switch (removal.kind) {
+                    case TombstoneKind::StudentRemoved:
+                        removedStudents.insert(removal.studentID);
+                        break;
+                    case TombstoneKind::Withdrawn:
+                        withdrawals.emplace(removal.studentID, removal.classroomID);
+                        break;
+                    case TombstoneKind::ScoreErased:
+                        erasedScores.emplace(removal.studentID, removal.classroomID, removal.assignmentID);
+                        break;
+                    }
+                }
+            }
+
+            // === Classrooms ===
+
+            void addAssignment(Teacher& into, const Assignment& source, unsigned theirsClassroomID) {
+                Assignment copy = source;
+                copy.setAssignmentID(ours.registerAssignment(into));
+                into.getAssignments().push_back(std::move(copy));
+                const Assignment& stored = into.getAssignments().back();
+                ours.indexAssignmentDescription(stored);
+
+                assignmentIDs.link(source.getAssignmentID(), stored.getAssignmentID());
+                addedAssignments.insert(stored.getAssignmentID());
+                if (stored.getAssignmentID() != source.getAssignmentID()) {
+                    renumberedRosters.insert(theirsClassroomID);
+                }
+                regradeClassrooms.insert(into.getClassroomID());
+                ++result.changesApplied;
+            }
+
+            /**
+             * @brief Links the other copy's assignment to an identical one here, such as one an earlier merge copied, or else adds it.
+             */
+            void adoptOrAddAssignment(Teacher& here, const Assignment& source, const Teacher& other) {
+                for (const Assignment& candidate : here.getAssignments()) {
+                    unsigned id = candidate.getAssignmentID();
+                    if (!sameAssignmentContent(candidate, source) || assignmentIDs.toTheirs.count(id)) continue;
+                    // Already the counterpart of the other copy's assignment with the same ID.
+                    if (id != source.getAssignmentID() && other.findAssignment(id)
+                        && sameAssignmentContent(*other.findAssignment(id), candidate)) continue;
+
+                    assignmentIDs.link(source.getAssignmentID(), id);
+                    if (id != source.getAssignmentID()) {
+                        renumberedRosters.insert(other.getClassroomID());
+                    }
+                    return;
+                }
+                addAssignment(here, source, other.getClassroomID());
+            }
+
+            /**
+             * @brief Finds a classroom here with the same teacher as one of the other copy's, such as one an earlier merge copied.
+             * @return Its ID, or nothing if there is none.
+             */
+            std::optional<unsigned> matchingClassroom(const Teacher& source) const {
+                std::uint64_t profile = hashTeacherProfile(source);
+                for (const Teacher& candidate : ours.getTeachers()) {
+                    unsigned id = candidate.getClassroomID();
+                    if (id == source.getClassroomID() || addedClassrooms.count(id) || classroomIDs.toTheirs.count(id)) continue;
+                    if (hashTeacherProfile(candidate) != profile) continue;
+                    // Already the counterpart of the other copy's classroom with the same ID.
+                    const Teacher* sameID = theirs.findClassroom(id);
+                    if (sameID && hashTeacherProfile(*sameID) == profile) continue;
+                    return id;
+                }
+                return std::nullopt;
+            }
+
+            void addClassroom(const Teacher& source) {
+                Teacher copy;
+                copy.setTitle(source.getTitle());
+                copy.setFirstName(source.getFirstName());
+                copy.setLastName(source.getLastName());
+                copy.setPassword(source.getPassword());
+                copy.setGradeLevel(source.getGradeLevel());
+                Teacher& added = ours.addTeacher(std::move(copy));
+
+                classroomIDs.link(source.getClassroomID(), added.getClassroomID());
+                addedClassrooms.insert(added.getClassroomID());
+                renumberedRosters.insert(source.getClassroomID());
+                ++result.changesApplied;
+                for (const Assignment& a : source.getAssignments()) {
+                    addAssignment(ours.getTeachers().back(), a, source.getClassroomID());
+                }
+            }
+
+            void takeAssignment(Teacher& into, const Assignment& source) {
+                unsigned id = source.getAssignmentID();
+                Assignment* target = into.findAssignment(id);
+                if (target->getAssignmentNameView() != source.getAssignmentNameView()) {
+                    into.renameAssignment(id, source.getAssignmentName());
+                }
+                if (target->getAssignmentDescriptionView() != source.getAssignmentDescriptionView()) {
+                    target->setAssignmentDescription(source.getAssignmentDescription());
+                    ours.indexAssignmentDescription(*target);
+                }
+                if (target->getPointsPossible() != source.getPointsPossible()) {
+                    into.setAssignmentPoints(id, source.getPointsPossible());
+                }
+                ++result.changesApplied;
+            }
+
+            void mergeAssignments(unsigned classroomID, const Teacher& other, const Teacher* ancestor) {
+                for (const Assignment& a : other.getAssignments()) {
+                    Teacher& here = *ours.findClassroom(classroomID);
+                    unsigned id = a.getAssignmentID();
+                    const Teacher* owner = addedAssignments.count(id) ? nullptr : ours.findAssignmentOwner(id);
+                    const Assignment* mine = owner ? owner->findAssignment(id) : nullptr;
+                    const Assignment* original = ancestor ? ancestor->findAssignment(id) : nullptr;
+
+                    // Created on both sides under the same ID: two different assignments.
+                    bool distinct = mine && (owner->getClassroomID() != classroomID
+                        || (threeWay() ? !original && hashAssignment(*mine) != hashAssignment(a)
+                            : mine->getAssignmentNameView() != a.getAssignmentNameView()));
+                    if (distinct) {
+                        adoptOrAddAssignment(here, a, other);
+                        continue;
+                    }
+
+                    auto version = [](const Assignment* x) { return x ? std::optional(hashAssignment(*x)) : std::nullopt; };
+                    switch (resolve(version(mine), version(&a), version(original), threeWay())) {
+                    case Resolution::KeepOurs:
+                        if (!mine) assignmentIDs.dropped.insert(id);
+                        break;
+                    case Resolution::TakeTheirs:
+                        if (mine) takeAssignment(here, a);
+                        else adoptOrAddAssignment(here, a, other);
+                        break;
+                    case Resolution::Conflict:
+                        // Scores for one side's version say nothing about the other's.
+                        assignmentIDs.dropped.insert(id);
+                        conflict(classroomLabel(here) + ", assignment " + std::to_string(id),
+                            describeAssignment(mine), describeAssignment(&a));
+                        break;
+                    }
+                }
+
+                if (!threeWay() || !ancestor) return;
+
+                // Assignments only this copy still has: the other copy removed them.
+                std::vector<unsigned> mineOnly;
+                for (const Assignment& a : ours.findClassroom(classroomID)->getAssignments()) {
+                    unsigned id = a.getAssignmentID();
+                    if (addedAssignments.count(id)) continue;
+                    std::optional<unsigned> counterpart = assignmentIDs.theirs(id);
+                    if (counterpart && other.findAssignment(*counterpart)) continue;
+                    if (ancestor->findAssignment(id)) mineOnly.push_back(id);
+                }
+                for (unsigned id : mineOnly) {
+                    Teacher& here = *ours.findClassroom(classroomID);
+                    const Assignment* mine = here.findAssignment(id);
+                    const Assignment* original = ancestor->findAssignment(id);
+                    if (hashAssignment(*mine) == hashAssignment(*original)) {
+                        here.deleteAssignment(id, ours);
+                        ++result.changesApplied;
+                    }
+                    else {
+                        conflict(classroomLabel(here) + ", assignment " + std::to_string(id),
+                            describeAssignment(mine), describeAssignment(nullptr));
+                    }
+                }
+            }
+
+            void mergeClassroom(unsigned classroomID, const Teacher& other, const Teacher* ancestor) {
+                Teacher& here = *ours.findClassroom(classroomID);
+                auto profile = [](const Teacher* t) { return t ? std::optional(hashTeacherProfile(*t)) : std::nullopt; };
+                switch (resolve(profile(&here), profile(&other), profile(ancestor), threeWay())) {
+                case Resolution::KeepOurs:
+                    break;
+                case Resolution::TakeTheirs:
+                    here.setTitle(other.getTitle());
+                    here.setFirstName(other.getFirstName());
+                    here.setLastName(other.getLastName());
+                    here.setPassword(other.getPassword());
+                    ours.setClassroomGradeLevel(here, other.getGradeLevel());
+                    ++result.changesApplied;
+                    break;
+                case Resolution::Conflict:
+                    conflict(classroomLabel(here), describeTeacherProfile(here), describeTeacherProfile(other));
+                    break;
+                }
+                mergeAssignments(classroomID, other, ancestor);
+            }
+
+            void adoptOrAddClassroom(const Teacher& source) {
+                if (std::optional<unsigned> match = matchingClassroom(source)) {
+                    classroomIDs.link(source.getClassroomID(), *match);
+                    renumberedRosters.insert(source.getClassroomID());
+                    mergeClassroom(*match, source, nullptr);
+                }
+                else {
+                    addClassroom(source);
+                }
+            }
+
+            void mergeClassrooms(const RecordTree& oursTree, const RecordTree& theirsTree) {
+                if (oursTree.classroomsHash == theirsTree.classroomsHash) return;
+
+                auto findHash = [](const RecordTree& tree, unsigned id) -> const RecordHash* {
+                    auto it = std::lower_bound(tree.classrooms.begin(), tree.classrooms.end(), id,
+                        [](const RecordHash& entry, unsigned key) { return entry.id < key; });
+                    return it != tree.classrooms.end() && it->id == id ? &*it : nullptr;
+                };
+
+                // Classrooms cannot be deleted, so only the other copy's list needs walking.
+                for (const RecordHash& entry : theirsTree.classrooms) {
+                    const RecordHash* mine = findHash(oursTree, entry.id);
+                    if (mine && mine->hash == entry.hash) continue;
+
+                    const Teacher& other = *theirs.findClassroom(entry.id);
+                    const Teacher* here = mine ? ours.findClassroom(entry.id) : nullptr;
+                    const Teacher* ancestor = base ? base->findClassroom(entry.id) : nullptr;
+                    if (!here) {
+                        adoptOrAddClassroom(other);
+                        continue;
+                    }
+
+                    // Both copies may have created a classroom under the same ID.
+                    bool same = threeWay()
+                        ? ancestor || hashTeacherProfile(*here) == hashTeacherProfile(other)
+                        : here->getFirstNameView() == other.getFirstNameView() && here->getLastNameView() == other.getLastNameView();
+                    if (same) {
+                        mergeClassroom(entry.id, other, ancestor);
+                    }
+                    else {
+                        adoptOrAddClassroom(other);
+                    }
+                }
+            }
+
+            // === Students ===
+
+            void copyScores(Student* into, unsigned classroomID, const Enrollment& source) {
+                for (const AssignmentScore& score : source.scores) {
+                    std::optional<unsigned> id = assignmentIDs.ours(score.assignmentID);
+                    const Teacher* owner = id ? ours.findAssignmentOwner(*id) : nullptr;
+                    if (owner && owner->getClassroomID() == classroomID) {
+                        into->setAssignmentScore(classroomID, *id, score.score);
+                    }
+                }
+            }
+
+            void addStudent(const Student& source) {
+                auto copy = std::make_unique<Student>();
+                copy->setFirstName(source.getFirstName());
+                copy->setLastName(source.getLastName());
+                copy->setPronouns(source.getPronouns());
+                copy->setAge(source.getAge());
+                copy->setGradeLevel(source.getGradeLevel());
+                copy->setID(source.getID());
+                copy->setSeat(source.getSeat());
+                copy->setNotes(source.getNotes());
+                Student* stored = ours.addStudent(std::move(copy));
+
+                for (const Enrollment& enrollment : source.getEnrollments()) {
+                    std::optional<unsigned> classroomID = classroomIDs.ours(enrollment.classroomID);
+                    Teacher* teacher = classroomID ? ours.findClassroom(*classroomID) : nullptr;
+                    if (!teacher) continue;
+                    ours.enrollStudent(*teacher, stored);
+                    copyScores(stored, *classroomID, enrollment);
+                    regradeEnrollments.emplace_back(stored, *classroomID);
+                }
+                ++result.changesApplied;
+            }
+
+            void takeProfile(Student* here, const Student& other) {
+                if (here->getFirstNameView() != other.getFirstNameView() || here->getLastNameView() != other.getLastNameView()) {
+                    ours.renameStudent(here, other.getFirstName(), other.getLastName());
+                }
+                if (here->getPronounsView() != other.getPronounsView()) here->setPronouns(other.getPronouns());
+                if (here->getAge() != other.getAge()) here->setAge(other.getAge());
+                if (here->getGradeLevel() != other.getGradeLevel()) here->setGradeLevel(other.getGradeLevel());
+                if (here->getSeatView() != other.getSeatView()) here->setSeat(other.getSeat());
+                if (here->getNotesView() != other.getNotesView()) here->setNotes(other.getNotes());
+                ++result.changesApplied;
+            }
+
+            void mergeScores(Student* here, const Student& other, const Student* ancestor,
+                unsigned classroomID, unsigned theirsClassroomID)
+            {
+                const Enrollment& mine = *std::as_const(*here).findEnrollment(classroomID);
+                const Enrollment& theirsEnrollment = *other.findEnrollment(theirsClassroomID);
+                std::set<unsigned> ids;
+                for (const AssignmentScore& score : mine.scores) {
+                    ids.insert(score.assignmentID);
+                }
+                for (const AssignmentScore& score : theirsEnrollment.scores) {
+                    if (std::optional<unsigned> id = assignmentIDs.ours(score.assignmentID)) ids.insert(*id);
+                }
+
+                bool changed = false;
+                for (unsigned id : ids) {
+                    const Teacher* owner = ours.findAssignmentOwner(id);
+                    if (!owner || owner->getClassroomID() != classroomID) continue;
+
+                    std::optional<unsigned> theirsID = assignmentIDs.theirs(id);
+                    std::optional<float> mineScore = here->getAssignmentScore(classroomID, id);
+                    std::optional<float> theirsScore;
+                    if (theirsID) theirsScore = other.getAssignmentScore(theirsClassroomID, *theirsID);
+                    std::optional<float> originalScore;
+                    if (ancestor) originalScore = ancestor->getAssignmentScore(theirsClassroomID, theirsID.value_or(id));
+                    bool erasedHere = erasedScores.count({ here->getID(), classroomID, id }) != 0;
+
+                    switch (resolve(mineScore, theirsScore, originalScore, threeWay(), erasedHere)) {
+                    case Resolution::KeepOurs:
+                        break;
+                    case Resolution::TakeTheirs:
+                        if (theirsScore) here->setAssignmentScore(classroomID, id, *theirsScore);
+                        else here->eraseAssignmentScore(classroomID, id);
+                        changed = true;
+                        ++result.changesApplied;
+                        break;
+                    case Resolution::Conflict:
+                        conflict(studentLabel(here->getID(), *here) + ", classroom " + std::to_string(classroomID)
+                            + ", assignment " + std::to_string(id) + " (" + std::string(owner->findAssignment(id)->getAssignmentNameView()) + ")",
+                            describeScore(mineScore), describeScore(theirsScore));
+                        break;
+                    }
+                }
+                if (changed) {
+                    regradeEnrollments.emplace_back(here, classroomID);
+                }
+            }
+
+            void mergeEnrollment(Student* here, const Student& other, const Student* ancestor, unsigned classroomID) {
+                Teacher* teacher = ours.findClassroom(classroomID);
+                if (!teacher) return;
+
+                std::optional<unsigned> theirsClassroomID = classroomIDs.theirs(classroomID);
+                const Enrollment* mine = std::as_const(*here).findEnrollment(classroomID);
+                const Enrollment* theirsEnrollment = theirsClassroomID ? other.findEnrollment(*theirsClassroomID) : nullptr;
+                const Enrollment* original = ancestor ? ancestor->findEnrollment(theirsClassroomID.value_or(classroomID)) : nullptr;
+
+                if (mine && theirsEnrollment) {
+                    mergeScores(here, other, ancestor, classroomID, *theirsClassroomID);
+                    return;
+                }
+
+                auto version = [](const Enrollment* e) { return e ? std::optional(hashEnrollment(*e)) : std::nullopt; };
+                bool withdrawnHere = withdrawals.count({ here->getID(), classroomID }) != 0;
+                switch (resolve(version(mine), version(theirsEnrollment), version(original), threeWay(), withdrawnHere)) {
+                case Resolution::KeepOurs:
+                    break;
+                case Resolution::TakeTheirs:
+                    if (theirsEnrollment) {
+                        ours.enrollStudent(*teacher, here);
+                        copyScores(here, classroomID, *theirsEnrollment);
+                        regradeEnrollments.emplace_back(here, classroomID);
+                    }
+                    else {
+                        teacher->removeStudentFromClassroom(here);
+                    }
+                    ++result.changesApplied;
+                    break;
+                case Resolution::Conflict:
+                    conflict(studentLabel(here->getID(), *here) + " in " + classroomLabel(*teacher),
+                        describeEnrollment(mine), describeEnrollment(theirsEnrollment));
+                    break;
+                }
+            }
+
+            void mergeStudent(unsigned id) {
+                Student* here = ours.findStudentByID(id);
+                const Student* other = theirs.findStudentByID(id);
+                const Student* ancestor = base ? base->findStudentByID(id) : nullptr;
+
+                if (!here || !other) {
+                    auto version = [](const Student* s) { return s ? std::optional(hashStudent(*s)) : std::nullopt; };
+                    switch (resolve(version(here), version(other), version(ancestor), threeWay(), removedStudents.count(id) != 0)) {
+                    case Resolution::KeepOurs:
+                        break;
+                    case Resolution::TakeTheirs:
+                        if (other) {
+                            addStudent(*other);
+                        }
+                        else {
+                            ours.removeStudent(here);
+                            ++result.changesApplied;
+                        }
+                        break;
+                    case Resolution::Conflict:
+                        conflict(studentLabel(id, here ? *here : *other), describeStudentProfile(here), describeStudentProfile(other));
+                        break;
+                    }
+                    return;
+                }
+
+                auto profile = [](const Student* s) { return s ? std::optional(hashStudentProfile(*s)) : std::nullopt; };
+                switch (resolve(profile(here), profile(other), profile(ancestor), threeWay())) {
+                case Resolution::KeepOurs:
+                    break;
+                case Resolution::TakeTheirs:
+                    takeProfile(here, *other);
+                    break;
+                case Resolution::Conflict:
+                    conflict(studentLabel(id, *here), describeStudentProfile(here), describeStudentProfile(other));
+                    break;
+                }
+
+                std::set<unsigned> classroomIDsToMerge;
+                for (const Enrollment& enrollment : here->getEnrollments()) {
+                    classroomIDsToMerge.insert(enrollment.classroomID);
+                }
+                for (const Enrollment& enrollment : other->getEnrollments()) {
+                    if (std::optional<unsigned> classroomID = classroomIDs.ours(enrollment.classroomID)) {
+                        classroomIDsToMerge.insert(*classroomID);
+                    }
+                }
+                for (unsigned classroomID : classroomIDsToMerge) {
+                    mergeEnrollment(here, *other, ancestor, classroomID);
+                }
+            }
+
+            /**
+             * @brief Lists the students whose hashes differ, descending only into differing branches and buckets.
+             */
+            std::vector<unsigned> differingStudents(const RecordTree& oursTree, const RecordTree& theirsTree) {
+                std::vector<unsigned> ids;
+                if (oursTree.studentsHash == theirsTree.studentsHash) return ids;
+
+                for (size_t branch = 0; branch < treeBranches; ++branch) {
+                    if (oursTree.branches[branch] == theirsTree.branches[branch]) continue;
+
+                    for (size_t b = branch * bucketsPerBranch; b < (branch + 1) * bucketsPerBranch; ++b) {
+                        if (oursTree.buckets[b] == theirsTree.buckets[b]) continue;
+                        ++result.bucketsCompared;
+
+                        size_t i = oursTree.bucketStarts[b], iEnd = oursTree.bucketStarts[b + 1];
+                        size_t j = theirsTree.bucketStarts[b], jEnd = theirsTree.bucketStarts[b + 1];
+                        while (i < iEnd || j < jEnd) {
+                            if (j == jEnd || (i < iEnd && oursTree.students[i].id < theirsTree.students[j].id)) {
+                                ids.push_back(oursTree.students[i++].id);
+                            }
+                            else if (i == iEnd || theirsTree.students[j].id < oursTree.students[i].id) {
+                                ids.push_back(theirsTree.students[j++].id);
+                            }
+                            else {
+                                if (oursTree.students[i].hash != theirsTree.students[j].hash) {
+                                    ids.push_back(oursTree.students[i].id);
+                                }
+                                ++i;
+                                ++j;
+                            }
+                        }
+                    }
+                }
+                return ids;
+            }
+
+        public:
+            Merger(Gradebook& ours, const Gradebook& theirs, const Gradebook* base, MergeResult& result)
+                : ours(ours), theirs(theirs), base(base), result(result) {}
+
+            void run() {
+                result = MergeResult();
+                result.threeWay = threeWay();
+                result.studentsTotal = ours.getStudents().size();
+
+                auto theirsTree = std::async(std::launch::async, [this] { return buildRecordTree(theirs); });
+                RecordTree oursTree = buildRecordTree(ours);
+                RecordTree other = theirsTree.get();
+                if (oursTree.root == other.root) {
+                    result.identical = true;
+                    return;
+                }
+                rememberRemovals();
+
+                if (oursTree.administrators != other.administrators) {
+                    std::optional<std::uint64_t> original;
+                    if (base) original = hashAdministrators(base->getSchool());
+                    switch (resolve(std::optional(oursTree.administrators), std::optional(other.administrators), original, threeWay())) {
+                    case Resolution::KeepOurs:
+                        break;
+                    case Resolution::TakeTheirs:
+                        // Assigned in place, so a signed-in administrator's menu keeps its object.
+                        ours.getSchool().reserve(theirs.getSchool().size());
+                        ours.getSchool().assign(theirs.getSchool().begin(), theirs.getSchool().end());
+                        ++result.changesApplied;
+                        break;
+                    case Resolution::Conflict:
+                        conflict("Administrators", describeAdministrators(ours.getSchool()), describeAdministrators(theirs.getSchool()));
+                        break;
+                    }
+                }
+
+                // Added classrooms never move the existing ones, which a signed-in teacher's menu runs on.
+                ours.getTeachers().reserve(ours.getTeachers().size() + theirs.getTeachers().size());
+                mergeClassrooms(oursTree, other);
+
+                std::vector<unsigned> ids = differingStudents(oursTree, other);
+                for (unsigned classroomID : renumberedRosters) {
+                    for (const Student* s : theirs.findClassroom(classroomID)->getClassroomStudents()) {
+                        ids.push_back(s->getID());
+                    }
+                }
+                std::sort(ids.begin(), ids.end());
+                ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+                result.studentsCompared = ids.size();
+                for (unsigned id : ids) {
+                    mergeStudent(id);
+                }
+
+                for (unsigned classroomID : regradeClassrooms) {
+                    Teacher* teacher = ours.findClassroom(classroomID);
+                    teacher->scoreAllStudents(teacher->getAssignments());
+                }
+                for (auto [student, classroomID] : regradeEnrollments) {
+                    if (regradeClassrooms.count(classroomID) || !student->isEnrolledIn(classroomID)) continue;
+                    student->calculateGrade(classroomID, ours.findClassroom(classroomID)->getAssignments());
+                }
+                ours.invalidateReportCache();
+            }
+        };
+    }
+
+    /**
+     * @brief Merges another copy of a school into this one.
+     * @param ours School to merge into; changed in place.
+     * @param theirs Other copy.
+     * @param base Copy both were made from, or nullptr if unknown.
+     * @param result Receives what was merged and every conflict.
+     */
+    void mergeGradebooks(Gradebook& ours, const Gradebook& theirs, const Gradebook* base, MergeResult& result) {
+        Merger(ours, theirs, base, result).run();
+    }
+
+    /**
+     * @brief Loads another copy, and optionally the common ancestor, in parallel and merges them into a school.
+     * @param ours School to merge into; changed in place but not saved.
+     * @param theirsFile Data file of the other copy.
+     * @param baseFile Data file both copies were made from; empty if unknown.
+     * @param result Receives what was merged and every conflict.
+     * @return False if a file could not be loaded; a message has been printed and nothing was changed.
+     */
+    bool mergeGradebookFiles(Gradebook& ours, const std::string& theirsFile, const std::string& baseFile, MergeResult& result) {
+        for (const std::string* file : { &theirsFile, &baseFile }) {
+            if (!file->empty() && !fileExists(*file)) {
+                std::cerr << *file << " was not found.\n";
+                return false;
+            }
+        }
+
+        auto load = [](const std::string& file) {
+            auto gradebook = std::make_unique<Gradebook>();
+            gradebook->setDataFile(file);
+            if (!gradebook->deserializeAndLoad()) {
+                gradebook.reset();
+            }
+            return gradebook;
+        };
+        auto theirsLoad = std::async(std::launch::async, load, theirsFile);
+        std::unique_ptr<Gradebook> base = baseFile.empty() ? nullptr : load(baseFile);
+        std::unique_ptr<Gradebook> theirs = theirsLoad.get();
+        if (!theirs || (!baseFile.empty() && !base)) {
+            return false;
+        }
+
+        mergeGradebooks(ours, *theirs, base.get(), result);
+        return true;
+    }
+
+    /**
+     * @brief Prints a summary of a merge and lists its conflicts.
+     * @param result What the merge did.
+     */
+    void printMergeResult(const MergeResult& result) {
+        if (result.identical) {
+            std::cout << "Both copies already hold the same school; nothing to merge." << std::endl;
+            return;
+        }
+
+        std::cout << result.changesApplied << " change(s) merged. Compared " << result.studentsCompared
+            << " of " << result.studentsTotal << " student record(s) in " << result.bucketsCompared
+            << " differing bucket(s)." << std::endl;
+        if (!result.threeWay) {
+            std::cout << "Without the copy both were made from, only additions merge automatically." << std::endl;
+        }
+        if (result.conflicts.empty()) {
+            std::cout << "No conflicts." << std::endl;
+            return;
+        }
+
+        std::cout << result.conflicts.size() << " conflict(s); this copy's version was kept:" << std::endl;
+        for (const MergeConflict& c : result.conflicts) {
+            std::cout << "  " << c.record << "\n"
+                << "    here:  " << c.ours << "\n"
+                << "    other: " << c.theirs << "\n";
+        }
+        std::cout << std::flush;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    class Gradebook;
+
+    /**
+     * @brief A record both copies changed in different ways; this copy's version was kept.
+     */
+    struct MergeConflict {
+        std::string record;     /**< What the record is, e.g. "Student 1234 (Ana Ruiz), classroom 2, assignment 7 (Essay)" */
+        std::string ours;       /**< Value kept in this copy */
+        std::string theirs;     /**< Value in the other copy, not taken */
+    };
+
+    /**
+     * @brief What a merge did.
+     */
+    struct MergeResult {
+        bool identical = false;                 /**< True if both copies already held the same school */
+        bool threeWay = false;                  /**< True if a common ancestor was used */
+        size_t changesApplied = 0;              /**< Records added, changed or removed in this copy */
+        size_t studentsCompared = 0;            /**< Student records examined after matching subtrees were skipped */
+        size_t studentsTotal = 0;               /**< Students in this copy before the merge */
+        size_t bucketsCompared = 0;             /**< Student buckets whose hashes differed */
+        std::vector<MergeConflict> conflicts;   /**< Records left as they were in this copy */
+    };
+
+    /**
+     * @brief Merges another copy of a school into this one.
+     *
+     * Both copies, and the common ancestor if there is one, are hashed into
+     * trees: a root over the administrators, one hash per classroom, and the
+     * students spread over 256 branches of 256 buckets by ID. The trees are
+     * compared top-down, so matching branches and buckets are skipped and
+     * only students in differing buckets are examined; their profiles,
+     * enrollments and individual scores are then merged one by one.
+     *
+     * With an ancestor, a record changed on one side only takes that side's
+     * version, including additions and removals, and a record changed
+     * differently on both sides is a conflict. Without one, records the other
+     * copy added are taken unless this copy's change log shows it removed
+     * them, and any other difference is a conflict. Conflicts keep this
+     * copy's version. Classrooms and assignments both copies created under
+     * the same ID are kept apart by giving the other copy's a new ID.
+     *
+     * @param ours School to merge into; changed in place.
+     * @param theirs Other copy.
+     * @param base Copy both were made from, or nullptr if unknown.
+     * @param result Receives what was merged and every conflict.
+     */
+    void mergeGradebooks(Gradebook& ours, const Gradebook& theirs, const Gradebook* base, MergeResult& result);
+
+    /**
+     * @brief Loads another copy, and optionally the common ancestor, in parallel and merges them into a school.
+     * @param ours School to merge into; changed in place but not saved.
+     * @param theirsFile Data file of the other copy.
+     * @param baseFile Data file both copies were made from; empty if unknown.
+     * @param result Receives what was merged and every conflict.
+     * @return False if a file could not be loaded; a message has been printed and nothing was changed.
+     */
+    bool mergeGradebookFiles(Gradebook& ours, const std::string& theirsFile, const std::string& baseFile, MergeResult& result);
+
+    /**
+     * @brief Prints a summary of a merge and lists its conflicts.
+     * @param result What the merge did.
+     */
+    void printMergeResult(const MergeResult& result);
+}
@@ -0,0 +1,629 @@
+#include "Query.h"
+#include "Assignment.h"
+#include "Gradebook.h"
+#include "ReportSink.h"
+#include "Student.h"
+#include "Teacher.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace gradebook {
+
+    namespace {
+        /**
+         * @brief Students gathered into columns at a time; bounds memory while rows stream out.
+         */
+        constexpr size_t queryBatchSize = 4096;
+
+        /**
+         * @brief Spelling of each field in query text, in QueryField order.
+         */
+        constexpr const char* fieldNames[] = {
+            "id", "grade", "age", "percent", "letter",
+            "assignment.points", "assignment.score", "assignment.percent"
+        };
+
+        /**
+         * @brief Spelling of each operator in query text, in CompareOp order.
+         */
+        constexpr const char* opNames[] = { "=", "!=", "<", "<=", ">", ">=" };
+
+        /**
+         * @brief Checks whether a field holds one value per score rather than per student.
+         */
+        bool isScoreField(QueryField field) {
+            return field == QueryField::AssignmentPoints
+                || field == QueryField::AssignmentScore
+                || field == QueryField::AssignmentPercent;
+        }
+
+        /**
+         * @brief Largest constant an ID, grade level or age may be compared with.
+         *
+         * The largest float that converts back to an unsigned, so every
+         * accepted constant can be used as an index key without overflow.
+         */
+        constexpr unsigned maximumIntegralValue = 4294967040u;
+
+        /**
+         * @brief Checks whether a field holds whole numbers stored as unsigned.
+         */
+        bool isIntegralField(QueryField field) {
+            return field == QueryField::ID
+                || field == QueryField::GradeLevel
+                || field == QueryField::Age;
+        }
+
+        /**
+         * @brief Lower-cases a word for case-insensitive keyword matching.
+         */
+        std::string lowered(std::string word) {
+            for (char& ch : word) {
+                ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+            }
+            return word;
+        }
+
+        /**
+         * @brief Splits query text into words, numbers and operators.
+         * @param text The query text.
+         * @return The tokens in order.
+         */
+        std::vector<std::string> tokenize(const std::string& text) {
+            std::vector<std::string> tokens;
+            size_t i = 0;
+            while (i < text.size()) {
+                unsigned char ch = static_cast<unsigned char>(text[i]);
+                if (std::isspace(ch)) {
+                    ++i;
+                }
+                else if (ch == '<' || ch == '>' || ch == '=' || ch == '!') {
+                    size_t length = (i + 1 < text.size() && text[i + 1] == '=') ? 2 : 1;
+                    tokens.push_back(text.substr(i, length));
+                    i += length;
+                }
+                else {
+                    size_t start = i;
+                    while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))
+                        && std::string("<>=!").find(text[i]) == std::string::npos) {
+                        ++i;
+                    }
+                    tokens.push_back(text.substr(start, i - start));
+                }
+            }
+            return tokens;
+        }
+
+        /**
+         * @brief Ranks predicates so the likely most selective run first.
+         */
+        int selectivityRank(CompareOp op) {
+            switch (op) {
+            case CompareOp::Equal: return 0;
+            case CompareOp::NotEqual: return 2;
+            default: return 1;
+            }
+        }
+
+        /**
+         * @brief Narrows a band of ages to a superset of the ages a predicate accepts.
+         * @param predicate An age predicate.
+         * @param filter Index seek whose band is narrowed.
+         */
+        void narrowAgeBand(const QueryPredicate& predicate, StudentFilter& filter) {
+            double v = predicate.value;
+            double low = 0.0;
+            double high = static_cast<double>(std::numeric_limits<unsigned>::max());
+            switch (predicate.op) {
+            case CompareOp::Equal: low = std::ceil(v); high = std::floor(v); break;
+            case CompareOp::Less: high = std::ceil(v) - 1.0; break;
+            case CompareOp::LessEqual: high = std::floor(v); break;
+            case CompareOp::Greater: low = std::floor(v) + 1.0; break;
+            case CompareOp::GreaterEqual: low = std::ceil(v); break;
+            case CompareOp::NotEqual: return;
+            }
+
+            if (high < 0.0 || low > high || low > static_cast<double>(filter.maxAge)) {
+                // Nothing can match; an inverted band finds no cells.
+                filter.minAge = 1;
+                filter.maxAge = 0;
+                return;
+            }
+            filter.minAge = std::max(filter.minAge, static_cast<unsigned>(std::max(low, 0.0)));
+            filter.maxAge = std::min(filter.maxAge, static_cast<unsigned>(std::min(high, static_cast<double>(filter.maxAge))));
+        }
+
+        /**
+         * @brief Keeps only the selected rows whose value passes a comparison.
+         *
+         * Each row is written back unconditionally and the output position
+         * advances by the comparison result, so the loop has no data-dependent
+         * branch and the compiler can vectorize the comparison.
+         *
+         * @param column Values, one per row.
+         * @param value Constant compared against.
+         * @param selection Row numbers still selected; compacted in place.
+         * @param pass Comparison of a row value with the constant.
+         */
+        template <typename Compare>
+        void refine(const std::vector<float>& column, float value, std::vector<unsigned>& selection, Compare pass) {
+            size_t kept = 0;
+            for (size_t i = 0; i < selection.size(); ++i) {
+                unsigned row = selection[i];
+                selection[kept] = row;
+                kept += pass(column[row], value) ? 1 : 0;
+            }
+            selection.resize(kept);
+        }
+
+        /**
+         * @brief Applies one predicate to a selection vector.
+         */
+        void refine(const std::vector<float>& column, const QueryPredicate& predicate, std::vector<unsigned>& selection) {
+            switch (predicate.op) {
+            case CompareOp::Equal: refine(column, predicate.value, selection, std::equal_to<float>()); break;
+            case CompareOp::NotEqual: refine(column, predicate.value, selection, std::not_equal_to<float>()); break;
+            case CompareOp::Less: refine(column, predicate.value, selection, std::less<float>()); break;
+            case CompareOp::LessEqual: refine(column, predicate.value, selection, std::less_equal<float>()); break;
+            case CompareOp::Greater: refine(column, predicate.value, selection, std::greater<float>()); break;
+            case CompareOp::GreaterEqual: refine(column, predicate.value, selection, std::greater_equal<float>()); break;
+            }
+        }
+
+        /**
+         * @brief A batch of students laid out one column per field.
+         */
+        struct StudentColumns {
+            std::vector<const Student*> students;
+            std::vector<float> id, gradeLevel, age, gradePercent, letterGrade;
+
+            /**
+             * @brief Loads one batch of candidates.
+             * @param candidates Students to query.
+             * @param records Hot records parallel to candidates when they are every student in
+             *        slot order, so the columns are read straight from the record array; otherwise null.
+             * @param first First candidate of the batch.
+             * @param last One past the last candidate of the batch.
+             */
+            void fill(const std::vector<Student*>& candidates, const StudentRecord* records, size_t first, size_t last) {
+                size_t n = last - first;
+                for (auto* column : { &id, &gradeLevel, &age, &gradePercent, &letterGrade }) {
+                    column->resize(n);
+                }
+                students.assign(candidates.begin() + first, candidates.begin() + last);
+                for (size_t r = 0; r < n; ++r) {
+                    const StudentRecord& record = records ? records[first + r] : students[r]->getRecord();
+                    id[r] = static_cast<float>(record.id);
+                    gradeLevel[r] = static_cast<float>(record.gradeLevel);
+                    age[r] = static_cast<float>(record.age);
+                    gradePercent[r] = record.gradePercent;
+                    letterGrade[r] = static_cast<float>(static_cast<unsigned char>(record.overallGrade));
+                }
+            }
+
+            const std::vector<float>& column(QueryField field) const {
+                switch (field) {
+                case QueryField::ID: return id;
+                case QueryField::GradeLevel: return gradeLevel;
+                case QueryField::Age: return age;
+                case QueryField::GradePercent: return gradePercent;
+                default: return letterGrade;
+                }
+            }
+        };
+
+        /**
+         * @brief Every graded score of the selected students, one column per field.
+         */
+        struct ScoreColumns {
+            std::vector<unsigned> studentRow, classroomID, assignmentID;
+            std::vector<float> points, score, percent;
+
+            void fill(const Gradebook& gradebook, const StudentColumns& batch, const std::vector<unsigned>& selection) {
+                for (auto* column : { &studentRow, &classroomID, &assignmentID }) column->clear();
+                for (auto* column : { &points, &score, &percent }) column->clear();
+
+                for (unsigned row : selection) {
+                    for (const auto& enrollment : batch.students[row]->getEnrollments()) {
+                        for (const auto& s : enrollment.scores) {
+                            const Assignment* assignment = gradebook.findAssignment(s.assignmentID);
+                            if (!assignment) continue;
+
+                            float possible = assignment->getPointsPossible();
+                            studentRow.push_back(row);
+                            classroomID.push_back(enrollment.classroomID);
+                            assignmentID.push_back(s.assignmentID);
+                            points.push_back(possible);
+                            score.push_back(s.score);
+                            percent.push_back(possible > 0.0f ? s.score / possible * 100.0f : 0.0f);
+                        }
+                    }
+                }
+            }
+
+            const std::vector<float>& column(QueryField field) const {
+                switch (field) {
+                case QueryField::AssignmentPoints: return points;
+                case QueryField::AssignmentScore: return score;
+                default: return percent;
+                }
+            }
+        };
+
+        /**
+         * @brief Formats a number with two decimals.
+         */
+        std::string fixed2(float value) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(2) << value;
+            return out.str();
+        }
+
+        /**
+         * @brief Formats the student cells shared by every row.
+         */
+        std::vector<std::string> studentCells(const Student& s) {
+            char letter = s.getOverallGrade();
+            return {
+                s.getFirstName(),
+                s.getLastName(),
+                std::to_string(s.getID()),
+                std::to_string(s.getGradeLevel()),
+                std::to_string(s.getAge()),
+                fixed2(s.getGradePercent()),
+                letter == '\0' ? std::string() : std::string(1, letter)
+            };
+        }
+    }
+
+    /**
+     * @brief Parses a query such as "grade = 5 and assignment.percent < 70 and assignment.points > 50".
+     * @param text The query text.
+     * @param error Receives a description of the problem if parsing fails.
+     * @return The query, or nothing if the text is not a valid query.
+     */
+    std::optional<StudentQuery> parseQuery(const std::string& text, std::string& error) {
+        std::vector<std::string> tokens = tokenize(text);
+        StudentQuery query;
+
+        size_t i = 0;
+        while (i < tokens.size()) {
+            if (i + 3 > tokens.size()) {
+                error = "incomplete condition at the end of the query";
+                return std::nullopt;
+            }
+
+            QueryPredicate predicate;
+            std::string name = lowered(tokens[i]);
+            auto field = std::find(std::begin(fieldNames), std::end(fieldNames), name);
+            if (field == std::end(fieldNames)) {
+                error = "unknown field '" + tokens[i] + "'";
+                return std::nullopt;
+            }
+            predicate.field = static_cast<QueryField>(field - std::begin(fieldNames));
+
+            std::string op = tokens[i + 1] == "==" ? "=" : tokens[i + 1];
+            auto found = std::find(std::begin(opNames), std::end(opNames), op);
+            if (found == std::end(opNames)) {
+                error = "expected a comparison after '" + tokens[i] + "', found '" + tokens[i + 1] + "'";
+                return std::nullopt;
+            }
+            predicate.op = static_cast<CompareOp>(found - std::begin(opNames));
+
+            const std::string& value = tokens[i + 2];
+            if (predicate.field == QueryField::LetterGrade) {
+                std::string letter = lowered(value);
+                if (predicate.op != CompareOp::Equal && predicate.op != CompareOp::NotEqual) {
+                    error = "letter grades can only be compared with = or !=";
+                    return std::nullopt;
+                }
+                if (letter == "none") {
+                    predicate.value = 0.0f;
+                }
+                else if (letter.size() == 1 && std::string("abcdf").find(letter[0]) != std::string::npos) {
+                    predicate.value = static_cast<float>(std::toupper(static_cast<unsigned char>(letter[0])));
+                }
+                else {
+                    error = "expected a letter grade A-F or none, found '" + value + "'";
+                    return std::nullopt;
+                }
+            }
+            else {
+                try {
+                    size_t used = 0;
+                    predicate.value = static_cast<float>(std::stod(value, &used));
+                    if (used != value.size() || !std::isfinite(predicate.value)) throw std::invalid_argument(value);
+                }
+                catch (const std::exception&) {
+                    error = "expected a number after '" + tokens[i] + " " + tokens[i + 1] + "', found '" + value + "'";
+                    return std::nullopt;
+                }
+                if (isIntegralField(predicate.field)
+                    && (predicate.value < 0.0f || predicate.value > static_cast<float>(maximumIntegralValue))) {
+                    error = "'" + tokens[i] + "' must be between 0 and " + std::to_string(maximumIntegralValue) + ", found '" + value + "'";
+                    return std::nullopt;
+                }
+            }
+            query.predicates.push_back(predicate);
+            i += 3;
+
+            if (i < tokens.size()) {
+                if (lowered(tokens[i]) != "and") {
+                    error = "expected 'and', found '" + tokens[i] + "'";
+                    return std::nullopt;
+                }
+                ++i;
+                if (i == tokens.size()) {
+                    error = "expected a condition after 'and'";
+                    return std::nullopt;
+                }
+            }
+        }
+
+        if (query.predicates.empty()) {
+            error = "the query is empty";
+            return std::nullopt;
+        }
+        return query;
+    }
+
+    /**
+     * @brief Chooses an index seek and orders the residual predicates.
+     *
+     * Equality on a student ID finds at most one student, so it beats any
+     * other seek. Otherwise equality on grade level or letter grade is
+     * answered exactly by the student index and dropped from the residual
+     * filters. Age predicates narrow the seek's age band and are still
+     * re-checked afterwards, since the band only has to contain every match.
+     *
+     * @param query The parsed query.
+     * @return The plan.
+     */
+    QueryPlan planQuery(const StudentQuery& query) {
+        QueryPlan plan;
+        std::vector<QueryPredicate> seekPredicates;
+        for (const auto& p : query.predicates) {
+            if (isScoreField(p.field)) {
+                plan.scoreFilters.push_back(p);
+                continue;
+            }
+
+            bool integral = p.value == std::floor(p.value);
+            if (p.field == QueryField::ID && p.op == CompareOp::Equal && integral && !plan.studentID) {
+                plan.studentID = static_cast<unsigned>(p.value);
+                continue;
+            }
+            if (p.field == QueryField::GradeLevel && p.op == CompareOp::Equal && integral
+                && p.value >= 1.0f && plan.indexFilter.gradeLevel == 0) {
+                plan.indexFilter.gradeLevel = static_cast<unsigned>(p.value);
+                plan.useIndex = true;
+                seekPredicates.push_back(p);
+                continue;
+            }
+            if (p.field == QueryField::LetterGrade && p.op == CompareOp::Equal && !plan.indexFilter.letterGrade) {
+                plan.indexFilter.letterGrade = static_cast<char>(static_cast<int>(p.value));
+                plan.useIndex = true;
+                seekPredicates.push_back(p);
+                continue;
+            }
+            if (p.field == QueryField::Age && p.op != CompareOp::NotEqual) {
+                narrowAgeBand(p, plan.indexFilter);
+                plan.useIndex = true;
+            }
+            plan.studentFilters.push_back(p);
+        }
+
+        if (plan.studentID && plan.useIndex) {
+            // The ID finds the student; what the index would have answered is checked on it instead.
+            plan.studentFilters.insert(plan.studentFilters.end(), seekPredicates.begin(), seekPredicates.end());
+            plan.useIndex = false;
+            plan.indexFilter = StudentFilter();
+        }
+
+        auto bySelectivity = [](const QueryPredicate& a, const QueryPredicate& b) {
+            return selectivityRank(a.op) < selectivityRank(b.op);
+        };
+        std::stable_sort(plan.studentFilters.begin(), plan.studentFilters.end(), bySelectivity);
+        std::stable_sort(plan.scoreFilters.begin(), plan.scoreFilters.end(), bySelectivity);
+        return plan;
+    }
+
+    /**
+     * @brief Describes a plan in a few human-readable lines.
+     * @param plan The plan.
+     * @return The description.
+     */
+    std::string explainPlan(const QueryPlan& plan) {
+        auto describe = [](const std::vector<QueryPredicate>& predicates) {
+            std::ostringstream out;
+            for (size_t i = 0; i < predicates.size(); ++i) {
+                const QueryPredicate& p = predicates[i];
+                out << (i ? " and " : "") << fieldNames[static_cast<int>(p.field)] << " " << opNames[static_cast<int>(p.op)] << " ";
+                if (p.field == QueryField::LetterGrade) {
+                    out << (p.value == 0.0f ? std::string("none") : std::string(1, static_cast<char>(p.value)));
+                }
+                else {
+                    out << p.value;
+                }
+            }
+            return out.str();
+        };
+
+        std::ostringstream out;
+        if (plan.studentID) {
+            out << "ID seek: student " << *plan.studentID << "\n";
+        }
+        else if (plan.useIndex) {
+            const StudentFilter& f = plan.indexFilter;
+            out << "Index seek:";
+            if (f.gradeLevel) out << " grade " << f.gradeLevel << ";";
+            if (f.letterGrade) out << " letter " << (*f.letterGrade ? std::string(1, *f.letterGrade) : std::string("none")) << ";";
+            if (f.minAge > f.maxAge) out << " no ages;";
+            else if (f.minAge > 0 || f.maxAge != std::numeric_limits<unsigned>::max()) {
+                out << " ages " << f.minAge << "-";
+                if (f.maxAge != std::numeric_limits<unsigned>::max()) out << f.maxAge;
+                out << ";";
+            }
+            out << "\n";
+        }
+        else {
+            out << "Full scan of every student\n";
+        }
+        if (!plan.studentFilters.empty()) {
+            out << "Filter students: " << describe(plan.studentFilters) << "\n";
+        }
+        if (!plan.scoreFilters.empty()) {
+            out << "Any score with: " << describe(plan.scoreFilters) << "\n";
+        }
+        return out.str();
+    }
+
+    /**
+     * @brief Runs a plan and streams every matching row to a sink.
+     *
+     * Candidates come from the ID seek, the index seek or, failing those,
+     * every student.
+     * They are processed in batches: each batch is copied into columns, the
+     * residual predicates shrink a selection vector one column at a time,
+     * and the surviving students' scores are laid out and filtered the same
+     * way before rows are written.
+     *
+     * @param gradebook Gradebook to query.
+     * @param plan The plan to run.
+     * @param sink Destination of the rows.
+     * @return Number of rows written.
+     */
+    size_t runQuery(const Gradebook& gradebook, const QueryPlan& plan, ReportSink& sink) {
+        std::vector<ReportColumn> columns = {
+            { "First Name", false, 14 }, { "Last Name", false, 14 }, { "ID", true, 9 },
+            { "Grade Level", true, 12 }, { "Age", true, 5 }, { "Grade %", true, 9 }, { "Letter Grade", false, 13 }
+        };
+        if (!plan.scoreFilters.empty()) {
+            columns.insert(columns.end(), {
+                { "Teacher", false, 20 }, { "Assignment", false, 22 },
+                { "Points", true, 8 }, { "Score", true, 8 }, { "Score %", true, 9 } });
+        }
+        sink.begin(columns);
+
+        std::vector<Student*> candidates;
+        const StudentRecord* records = nullptr;
+        if (plan.studentID) {
+            if (Student* s = gradebook.findStudentByID(*plan.studentID)) {
+                candidates.push_back(s);
+            }
+        }
+        else if (plan.useIndex) {
+            candidates = gradebook.findStudents(plan.indexFilter);
+        }
+        else {
+            candidates.reserve(gradebook.getStudents().size());
+            for (const auto& s : gradebook.getStudents()) {
+                candidates.push_back(s.get());
+            }
+            records = gradebook.getStudentRecords().data();
+        }
+
+        size_t written = 0;
+        StudentColumns batch;
+        ScoreColumns scores;
+        std::vector<unsigned> selection;
+        std::vector<unsigned> scoreSelection;
+
+        for (size_t first = 0; first < candidates.size(); first += queryBatchSize) {
+            size_t last = std::min(first + queryBatchSize, candidates.size());
+            batch.fill(candidates, records, first, last);
+
+            selection.resize(last - first);
+            std::iota(selection.begin(), selection.end(), 0u);
+            for (const auto& p : plan.studentFilters) {
+                refine(batch.column(p.field), p, selection);
+            }
+
+            if (plan.scoreFilters.empty()) {
+                for (unsigned row : selection) {
+                    sink.row(studentCells(*batch.students[row]));
+                    ++written;
+                }
+                continue;
+            }
+
+            scores.fill(gradebook, batch, selection);
+            scoreSelection.resize(scores.score.size());
+            std::iota(scoreSelection.begin(), scoreSelection.end(), 0u);
+            for (const auto& p : plan.scoreFilters) {
+                refine(scores.column(p.field), p, scoreSelection);
+            }
+
+            for (unsigned r : scoreSelection) {
+                std::vector<std::string> cells = studentCells(*batch.students[scores.studentRow[r]]);
+                const Teacher* teacher = gradebook.findClassroom(scores.classroomID[r]);
+                const Assignment* assignment = gradebook.findAssignment(scores.assignmentID[r]);
+                cells.push_back(teacher ? teacher->getTitle() + " " + teacher->getLastName() : std::string());
+                cells.push_back(assignment ? assignment->getAssignmentName() : std::string());
+                cells.push_back(fixed2(scores.points[r]));
+                cells.push_back(fixed2(scores.score[r]));
+                cells.push_back(fixed2(scores.percent[r]));
+                sink.row(cells);
+                ++written;
+            }
+        }
+
+        sink.end();
+        return written;
+    }
+
+    /**
+     * @brief Searches notes and assignment descriptions and streams the ranked hits to a sink.
+     *
+     * Each row shows the start of the matching text so the hit can be
+     * recognized without opening the record.
+     *
+     * @param gradebook Gradebook to search.
+     * @param text Search text; see Gradebook::searchText.
+     * @param limit Most results to write.
+     * @param sink Destination of the rows.
+     * @return Number of rows written.
+     */
+    size_t runTextSearch(const Gradebook& gradebook, const std::string& text, size_t limit, ReportSink& sink) {
+        constexpr size_t excerptLength = 60;
+
+        sink.begin({
+            { "Rank", true, 6 }, { "Found In", false, 13 }, { "Name", false, 26 }, { "ID", true, 9 },
+            { "Teacher", false, 18 }, { "Relevance", true, 11 }, { "Text", false, 0 } });
+
+        size_t rank = 0;
+        for (const TextHit& hit : gradebook.searchText(text, limit)) {
+            std::vector<std::string> cells{ std::to_string(++rank) };
+            std::string_view body;
+            if (hit.source == TextSource::StudentNotes) {
+                cells.push_back("Student notes");
+                cells.push_back(hit.student->getFirstName() + " " + hit.student->getLastName());
+                cells.push_back(std::to_string(hit.student->getID()));
+                cells.push_back("");
+                body = hit.student->getNotesView();
+            }
+            else {
+                const Assignment* assignment = gradebook.findAssignment(hit.assignmentID);
+                const Teacher* owner = gradebook.findAssignmentOwner(hit.assignmentID);
+                cells.push_back("Assignment");
+                cells.push_back(assignment ? assignment->getAssignmentName() : std::string());
+                cells.push_back(std::to_string(hit.assignmentID));
+                cells.push_back(owner ? owner->getTitle() + " " + owner->getLastName() : std::string());
+                body = assignment ? assignment->getAssignmentDescriptionView() : std::string_view();
+            }
+            cells.push_back(fixed2(static_cast<float>(hit.score)));
+            cells.push_back(body.size() > excerptLength ? std::string(body.substr(0, excerptLength)) + "..." : std::string(body));
+            sink.row(cells);
+        }
+
+        sink.end();
+        return rank;
+    }
+}
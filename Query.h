@@ -0,0 +1,126 @@
+#pragma once
+#include "StudentIndex.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    class Gradebook;
+    class ReportSink;
+
+    /**
+     * @brief A value a query can test.
+     *
+     * Student fields hold one value per student. Assignment fields hold one
+     * value per graded score, and a student matches when any of their scores
+     * passes every assignment predicate at once.
+     */
+    enum class QueryField {
+        ID,                  /**< Student ID */
+        GradeLevel,          /**< Student's grade level */
+        Age,                 /**< Student's age */
+        GradePercent,        /**< Overall grade % */
+        LetterGrade,         /**< Overall letter grade; 0 if not graded yet */
+        AssignmentPoints,    /**< Points the assignment is worth */
+        AssignmentScore,     /**< Points earned */
+        AssignmentPercent    /**< Points earned as a % of points possible */
+    };
+
+    /**
+     * @brief How a field is compared with a constant.
+     */
+    enum class CompareOp {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual
+    };
+
+    /**
+     * @brief One "field op constant" test.
+     *
+     * Letter grades are compared by character code.
+     */
+    struct QueryPredicate {
+        QueryField field = QueryField::ID;    /**< Value tested */
+        CompareOp op = CompareOp::Equal;      /**< Comparison */
+        float value = 0.0f;                   /**< Constant compared against */
+    };
+
+    /**
+     * @brief A parsed query: every predicate must hold.
+     */
+    struct StudentQuery {
+        std::vector<QueryPredicate> predicates;   /**< Predicates joined by "and" */
+    };
+
+    /**
+     * @brief How a query will be evaluated.
+     *
+     * Equality on an ID becomes a lookup of that one student. Otherwise
+     * predicates the student index answers exactly become an index seek;
+     * the rest are evaluated column by column over the students the seek
+     * (or a full scan) produces, then over those students' scores.
+     */
+    struct QueryPlan {
+        std::optional<unsigned> studentID;            /**< Seed the single student with this ID */
+        bool useIndex = false;                        /**< Seed candidates from the student index */
+        StudentFilter indexFilter;                    /**< Seek used when useIndex is set */
+        std::vector<QueryPredicate> studentFilters;   /**< Residual student predicates */
+        std::vector<QueryPredicate> scoreFilters;     /**< Predicates one score must pass together */
+    };
+
+    /**
+     * @brief Parses a query such as "grade = 5 and assignment.percent < 70 and assignment.points > 50".
+     *
+     * Fields: id, grade, age, percent, letter, assignment.points,
+     * assignment.score, assignment.percent. Operators: = != < <= > >=.
+     * Letters are A-F, or "none" for students not graded yet.
+     *
+     * @param text The query text.
+     * @param error Receives a description of the problem if parsing fails.
+     * @return The query, or nothing if the text is not a valid query.
+     */
+    std::optional<StudentQuery> parseQuery(const std::string& text, std::string& error);
+
+    /**
+     * @brief Chooses an index seek and orders the residual predicates.
+     * @param query The parsed query.
+     * @return The plan.
+     */
+    QueryPlan planQuery(const StudentQuery& query);
+
+    /**
+     * @brief Describes a plan in a few human-readable lines.
+     * @param plan The plan.
+     * @return The description.
+     */
+    std::string explainPlan(const QueryPlan& plan);
+
+    /**
+     * @brief Runs a plan and streams every matching row to a sink.
+     *
+     * Without assignment predicates each matching student is one row. With
+     * them, each matching score is one row, alongside its student, class and
+     * assignment.
+     *
+     * @param gradebook Gradebook to query.
+     * @param plan The plan to run.
+     * @param sink Destination of the rows.
+     * @return Number of rows written.
+     */
+    size_t runQuery(const Gradebook& gradebook, const QueryPlan& plan, ReportSink& sink);
+
+    /**
+     * @brief Searches notes and assignment descriptions and streams the ranked hits to a sink.
+     * @param gradebook Gradebook to search.
+     * @param text Search text; see Gradebook::searchText.
+     * @param limit Most results to write.
+     * @param sink Destination of the rows.
+     * @return Number of rows written.
+     */
+    size_t runTextSearch(const Gradebook& gradebook, const std::string& text, size_t limit, ReportSink& sink);
+}
@@ -0,0 +1,283 @@
+#include "Ranking.h"
+#include "Compression.h"
+#include "Gradebook.h"
+#include "Student.h"
+#include "Teacher.h"
+#include <algorithm>
+#include <execution>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <unordered_set>
+
+namespace gradebook {
+
+    namespace {
+        /**
+         * @brief Orders entries best-first for the requested direction, breaking ties by ID.
+         */
+        struct BetterEntry {
+            bool highestFirst;
+
+            bool operator()(const RankedEntry& a, const RankedEntry& b) const {
+                if (a.value != b.value) {
+                    return highestFirst ? a.value > b.value : a.value < b.value;
+                }
+                return a.student->getRecord().id < b.student->getRecord().id;
+            }
+        };
+
+        /**
+         * @brief Collects one candidate per matching student from every classroom.
+         *
+         * Overall grades are deduplicated so a student enrolled in several
+         * classrooms is only ranked once, and students not graded yet are
+         * left out rather than ranked at 0%; assignment scores are per classroom.
+         *
+         * @param gradebook Gradebook whose classrooms are searched.
+         * @param query Metric and grade filter.
+         * @param ignoreGradeFilter True to collect every grade level.
+         * @return Unranked candidates.
+         */
+        std::vector<RankedEntry> gatherCandidates(const Gradebook& gradebook,
+            const RankingQuery& query, bool ignoreGradeFilter)
+        {
+            std::vector<RankedEntry> candidates;
+            candidates.reserve(gradebook.getStudents().size());
+
+            bool byAssignment = !query.assignmentName.empty();
+            unsigned gradeFilter = ignoreGradeFilter ? 0 : query.gradeLevel;
+            std::unordered_set<const Student*> seen;
+            if (!byAssignment) {
+                seen.reserve(gradebook.getStudents().size());
+            }
+
+            for (const auto& teacher : gradebook.getTeachers()) {
+                float possible = 0.0f;
+                unsigned assignmentID = 0;
+                if (byAssignment) {
+                    const auto& assignments = teacher.getAssignments();
+                    auto found = std::find_if(assignments.begin(), assignments.end(),
+                        [&](const Assignment& a) { return a.getAssignmentNameView() == query.assignmentName; });
+                    if (found == assignments.end() || found->getPointsPossible() <= 0.0f) {
+                        continue;
+                    }
+                    possible = found->getPointsPossible();
+                    assignmentID = found->getAssignmentID();
+                }
+
+                for (const Student* s : teacher.getClassroomStudents()) {
+                    if (!s) continue;
+                    const StudentRecord& record = s->getRecord();
+                    if (gradeFilter != 0 && record.gradeLevel != gradeFilter) continue;
+
+                    RankedEntry entry;
+                    entry.student = s;
+                    entry.teacher = &teacher;
+
+                    if (byAssignment) {
+                        auto score = s->getAssignmentScore(teacher.getClassroomID(), assignmentID);
+                        if (!score) continue;
+                        entry.value = *score / possible * 100.0f;
+                    }
+                    else {
+                        if (record.overallGrade == '\0' || !seen.insert(s).second) continue;
+                        entry.value = record.gradePercent;
+                    }
+
+                    candidates.push_back(entry);
+                }
+            }
+
+            return candidates;
+        }
+
+        /**
+         * @brief Assigns competition ranks and percentile ranks to sorted entries.
+         *
+         * Every entry better than or tied with the last one must be present, so
+         * the number of strictly better values can be read off the position.
+         *
+         * @param entries Entries sorted best-first.
+         * @param population Size of the population the entries were drawn from.
+         * @param highestFirst Direction the entries were sorted in.
+         */
+        void assignRanks(std::vector<RankedEntry>& entries, size_t population, bool highestFirst) {
+            size_t runStart = 0;
+            while (runStart < entries.size()) {
+                size_t runEnd = runStart;
+                while (runEnd < entries.size() && entries[runEnd].value == entries[runStart].value) {
+                    ++runEnd;
+                }
+
+                size_t better = runStart;
+                size_t tied = runEnd - runStart;
+                size_t below = highestFirst ? population - better - tied : better;
+                double percentile = population == 0 ? 0.0
+                    : (static_cast<double>(below) + 0.5 * static_cast<double>(tied))
+                    / static_cast<double>(population) * 100.0;
+
+                for (size_t i = runStart; i < runEnd; ++i) {
+                    entries[i].rank = better + 1;
+                    entries[i].percentile = percentile;
+                }
+                runStart = runEnd;
+            }
+        }
+
+        /**
+         * @brief Selects the k best candidates plus anything tied with the k-th.
+         *
+         * A bounded heap keeps the k best values seen so far, giving the cut-off
+         * in O(n log k); a second linear pass keeps everything at or above it.
+         *
+         * @param candidates Unranked candidates.
+         * @param highestFirst Ranking direction.
+         * @param k Number of results wanted.
+         * @return Ranked entries.
+         */
+        std::vector<RankedEntry> selectTop(const std::vector<RankedEntry>& candidates, bool highestFirst, size_t k) {
+            std::vector<RankedEntry> result;
+            if (k == 0 || candidates.empty()) {
+                return result;
+            }
+
+            // The heap's top is the worst of the kept values, i.e. the current cut-off.
+            auto worseOnTop = [highestFirst](float a, float b) { return highestFirst ? a > b : a < b; };
+            std::priority_queue<float, std::vector<float>, decltype(worseOnTop)> heap(worseOnTop);
+
+            for (const auto& c : candidates) {
+                if (heap.size() < k) {
+                    heap.push(c.value);
+                }
+                else if (worseOnTop(c.value, heap.top())) {
+                    heap.pop();
+                    heap.push(c.value);
+                }
+            }
+
+            float cutoff = heap.top();
+            for (const auto& c : candidates) {
+                bool atOrAbove = highestFirst ? c.value >= cutoff : c.value <= cutoff;
+                if (atOrAbove) {
+                    result.push_back(c);
+                }
+            }
+
+            std::sort(result.begin(), result.end(), BetterEntry{ highestFirst });
+            assignRanks(result, candidates.size(), highestFirst);
+            return result;
+        }
+    }
+
+    /**
+     * @brief Finds the k best (or worst) students across every classroom.
+     * @param gradebook Gradebook whose classrooms are searched.
+     * @param query Metric, direction and grade filter.
+     * @param k Number of results wanted.
+     * @return Ranked entries, including ties at the cut-off.
+     */
+    std::vector<RankedEntry> topStudents(const Gradebook& gradebook, const RankingQuery& query, size_t k) {
+        return selectTop(gatherCandidates(gradebook, query, false), query.highestFirst, k);
+    }
+
+    /**
+     * @brief Runs a top-k selection separately for every grade level present.
+     * @param gradebook Gradebook whose classrooms are searched.
+     * @param query Metric and direction; the grade filter is ignored.
+     * @param k Number of results wanted per grade level.
+     * @return Ranked entries keyed by grade level.
+     */
+    std::map<unsigned, std::vector<RankedEntry>> topStudentsPerGradeLevel(
+        const Gradebook& gradebook, const RankingQuery& query, size_t k)
+    {
+        std::map<unsigned, std::vector<RankedEntry>> byGrade;
+        for (const auto& c : gatherCandidates(gradebook, query, true)) {
+            byGrade[c.student->getRecord().gradeLevel].push_back(c);
+        }
+
+        std::map<unsigned, std::vector<RankedEntry>> result;
+        for (const auto& [grade, candidates] : byGrade) {
+            result[grade] = selectTop(candidates, query.highestFirst, k);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Ranks every matching student with a parallel sort.
+     * @param gradebook Gradebook whose classrooms are searched.
+     * @param query Metric, direction and grade filter.
+     * @return Every matching entry, ranked.
+     */
+    std::vector<RankedEntry> rankAllStudents(const Gradebook& gradebook, const RankingQuery& query) {
+        std::vector<RankedEntry> entries = gatherCandidates(gradebook, query, false);
+        std::sort(std::execution::par, entries.begin(), entries.end(), BetterEntry{ query.highestFirst });
+        assignRanks(entries, entries.size(), query.highestFirst);
+        return entries;
+    }
+
+    /**
+     * @brief Prints ranked entries as a table.
+     * @param entries Entries to print.
+     */
+    void printRanking(const std::vector<RankedEntry>& entries) {
+        if (entries.empty()) {
+            std::cout << "No matching students found.\n";
+            return;
+        }
+
+        std::cout << std::left
+            << std::setw(7) << "Rank"
+            << std::setw(30) << "Student"
+            << std::setw(10) << "ID"
+            << std::setw(7) << "Grade"
+            << std::setw(22) << "Teacher"
+            << std::setw(10) << "Score %"
+            << std::setw(10) << "Pctile"
+            << "\n" << std::string(96, '-') << "\n";
+
+        for (const auto& e : entries) {
+            std::cout << std::left
+                << std::setw(7) << e.rank
+                << std::setw(30) << (e.student->getFirstName() + " " + e.student->getLastName())
+                << std::setw(10) << e.student->getID()
+                << std::setw(7) << e.student->getGradeLevel()
+                << std::setw(22) << (e.teacher->getTitle() + " " + e.teacher->getLastName())
+                << std::fixed << std::setprecision(2)
+                << std::setw(10) << e.value
+                << std::setw(10) << e.percentile
+                << "\n";
+        }
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Exports ranked entries to a CSV file.
+     * @param entries Entries to export.
+     * @param filename Name of the CSV file to write.
+     */
+    void exportRankingToCSV(const std::vector<RankedEntry>& entries, const std::string& filename) {
+        ExportFile file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file " << filename << " for writing." << std::endl;
+            return;
+        }
+
+        file << "Rank,First Name,Last Name,ID,Grade Level,Teacher,Score %,Percentile\n";
+        for (const auto& e : entries) {
+            file << e.rank << ","
+                << std::quoted(e.student->getFirstName()) << ","
+                << std::quoted(e.student->getLastName()) << ","
+                << e.student->getID() << ","
+                << e.student->getGradeLevel() << ","
+                << std::quoted(e.teacher->getTitle() + " " + e.teacher->getLastName()) << ","
+                << std::fixed << std::setprecision(2)
+                << e.value << ","
+                << e.percentile << "\n";
+        }
+
+        file.close();
+        std::cout << "Ranking exported successfully to " << filename << std::endl;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    class Gradebook;
+    class Student;
+    class Teacher;
+
+    /**
+     * @brief Describes what a ranking query measures and which way it orders.
+     */
+    struct RankingQuery {
+        std::string assignmentName;   /**< Assignment to rank by; empty ranks by overall grade % */
+        bool highestFirst = true;     /**< True for top performers, false for lowest */
+        unsigned gradeLevel = 0;      /**< Restrict to one grade level; 0 means every grade */
+    };
+
+    /**
+     * @brief One ranked result.
+     *
+     * Ranks use competition ordering, so tied values share a rank (1, 2, 2, 4).
+     * The percentile rank is the share of the population scoring below the
+     * value, counting ties as half.
+     */
+    struct RankedEntry {
+        const Student* student = nullptr;   /**< Ranked student */
+        const Teacher* teacher = nullptr;   /**< Classroom the value came from */
+        float value = 0.0f;                 /**< Grade % or assignment score as % of points possible */
+        size_t rank = 0;                    /**< 1-based competition rank */
+        double percentile = 0.0;            /**< Percentile rank in [0, 100] */
+    };
+
+    /**
+     * @brief Finds the k best (or worst) students across every classroom.
+     *
+     * A bounded heap of size k finds the cut-off value in one pass; entries
+     * tied with the cut-off are kept, so the result may be longer than k.
+     *
+     * @param gradebook Gradebook whose classrooms are searched.
+     * @param query Metric, direction and grade filter.
+     * @param k Number of results wanted.
+     * @return Ranked entries, best first in the requested direction.
+     */
+    std::vector<RankedEntry> topStudents(const Gradebook& gradebook, const RankingQuery& query, size_t k);
+
+    /**
+     * @brief Runs topStudents separately for every grade level present.
+     * @param gradebook Gradebook whose classrooms are searched.
+     * @param query Metric and direction; the grade filter is ignored.
+     * @param k Number of results wanted per grade level.
+     * @return Ranked entries keyed by grade level.
+     */
+    std::map<unsigned, std::vector<RankedEntry>> topStudentsPerGradeLevel(
+        const Gradebook& gradebook, const RankingQuery& query, size_t k);
+
+    /**
+     * @brief Ranks every matching student with a parallel sort.
+     * @param gradebook Gradebook whose classrooms are searched.
+     * @param query Metric, direction and grade filter.
+     * @return Every matching entry, ranked.
+     */
+    std::vector<RankedEntry> rankAllStudents(const Gradebook& gradebook, const RankingQuery& query);
+
+    /**
+     * @brief Prints ranked entries as a table.
+     * @param entries Entries to print.
+     */
+    void printRanking(const std::vector<RankedEntry>& entries);
+
+    /**
+     * @brief Exports ranked entries to a CSV file.
+     * @param entries Entries to export.
+     * @param filename Name of the CSV file to write.
+     */
+    void exportRankingToCSV(const std::vector<RankedEntry>& entries, const std::string& filename);
+}
@@ -0,0 +1,276 @@
+#include "ReportArchive.h"
+#include "Gradebook.h"
+#include "Serialization.h"
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <sstream>
+
+namespace gradebook {
+
+    namespace {
+        /**
+         * @brief First four bytes of a report card archive ("GBRA"), repeated as the last four.
+         */
+        constexpr unsigned reportArchiveMagic = 0x41524247;
+
+        /**
+         * @brief Archive format version written by writeReportCardArchive.
+         */
+        constexpr unsigned reportArchiveVersion = 1;
+
+        /** Bytes before the first card: magic and version. */
+        constexpr size_t headerSize = 2 * sizeof(unsigned);
+
+        /** Bytes per index entry: student ID, offset and length. */
+        constexpr size_t entrySize = sizeof(unsigned) + 2 * sizeof(unsigned long long);
+
+        /** Bytes after the index: index offset, entry count, version and magic. */
+        constexpr size_t trailerSize = 2 * sizeof(unsigned long long) + 2 * sizeof(unsigned);
+
+        /** Cards rendered together before they are handed to the writer. */
+        constexpr size_t cardsPerBatch = 1024;
+
+        /**
+         * @brief Writes a trivially copyable value to a stream in native byte order.
+         * @tparam T Type of the value.
+         * @param out Destination.
+         * @param value The value to write.
+         */
+        template <typename T>
+        void writeRaw(std::ostream& out, const T& value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        /**
+         * @brief Renders a range of students' cards in parallel.
+         * @param gradebook School the students belong to.
+         * @param order Students in archive order.
+         * @param first First student of the batch.
+         * @param cards Receives one card per student of the batch; its size is the batch size.
+         */
+        void renderCards(const Gradebook& gradebook, const std::vector<const Student*>& order,
+            size_t first, std::vector<std::string>& cards)
+        {
+            parallelForRanges(cards.size(), workerCountFor(cards.size(), 128),
+                [&](unsigned, size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        const Student* student = order[first + i];
+                        std::ostringstream card;
+                        student->writeStudentReportCSV(card, gradebook.getTeachersOf(student));
+                        cards[i] = std::move(card).str();
+                    }
+                });
+        }
+    }
+
+    /**
+     * @brief Streams every student's report card into one archive with a trailing index.
+     * @param gradebook School whose students to export.
+     * @param filename Archive to create or replace.
+     * @param cards Receives the number of cards written.
+     * @return True if the archive is in place.
+     */
+    bool writeReportCardArchive(const Gradebook& gradebook, const std::string& filename, size_t& cards) {
+        cards = 0;
+
+        std::vector<const Student*> order;
+        order.reserve(gradebook.getStudents().size());
+        for (const auto& student : gradebook.getStudents()) {
+            order.push_back(student.get());
+        }
+        std::sort(order.begin(), order.end(),
+            [](const Student* a, const Student* b) { return a->getID() < b->getID(); });
+
+        std::string temporary = filename + ".tmp";
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Failed to open file " << temporary << " for writing." << std::endl;
+            return false;
+        }
+
+        writeRaw(out, reportArchiveMagic);
+        writeRaw(out, reportArchiveVersion);
+
+        std::vector<ReportArchiveEntry> index;
+        index.reserve(order.size());
+        unsigned long long offset = headerSize;
+
+        // One batch renders while the one before it is written.
+        std::vector<std::string> rendering;
+        std::vector<std::string> writing;
+        std::future<void> pendingWrite;
+
+        for (size_t first = 0; first < order.size(); first += cardsPerBatch) {
+            rendering.assign(std::min(cardsPerBatch, order.size() - first), std::string());
+            renderCards(gradebook, order, first, rendering);
+
+            if (pendingWrite.valid()) {
+                pendingWrite.get();
+            }
+            std::swap(rendering, writing);
+
+            pendingWrite = std::async(std::launch::async, [&, first] {
+                for (size_t i = 0; i < writing.size(); ++i) {
+                    index.push_back({ order[first + i]->getID(), offset, writing[i].size() });
+                    out.write(writing[i].data(), static_cast<std::streamsize>(writing[i].size()));
+                    offset += writing[i].size();
+                }
+                });
+        }
+        if (pendingWrite.valid()) {
+            pendingWrite.get();
+        }
+
+        unsigned long long indexOffset = offset;
+        for (const auto& entry : index) {
+            writeRaw(out, entry.studentID);
+            writeRaw(out, entry.offset);
+            writeRaw(out, entry.length);
+        }
+        writeRaw(out, indexOffset);
+        writeRaw(out, static_cast<unsigned long long>(index.size()));
+        writeRaw(out, reportArchiveVersion);
+        writeRaw(out, reportArchiveMagic);
+
+        out.close();
+        if (out.fail()) {
+            std::cerr << "Failed to write " << temporary << "." << std::endl;
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, filename, error);
+        if (error) {
+            std::cerr << "Failed to replace " << filename << ": " << error.message() << std::endl;
+            return false;
+        }
+
+        cards = index.size();
+        return true;
+    }
+
+    /**
+     * @brief Opens an archive and reads its trailer and index.
+     * @param archive Path of the archive.
+     * @return False if the file is missing or is not a complete archive; a message has been printed.
+     */
+    bool ReportCardArchive::open(const std::string& archive) {
+        filename = archive;
+        entries.clear();
+        if (file.is_open()) {
+            file.close();
+        }
+
+        file.open(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << filename << " was not found." << std::endl;
+            return false;
+        }
+
+        try {
+            file.seekg(0, std::ios::end);
+            unsigned long long fileSize = static_cast<unsigned long long>(file.tellg());
+            if (!file || fileSize < headerSize + trailerSize) {
+                throw std::runtime_error("too short to be an archive");
+            }
+
+            char header[headerSize];
+            file.seekg(0);
+            file.read(header, headerSize);
+            char trailer[trailerSize];
+            file.seekg(static_cast<std::streamoff>(fileSize - trailerSize));
+            file.read(trailer, trailerSize);
+            if (!file) {
+                throw std::runtime_error("could not be read");
+            }
+
+            ByteReader head(header, headerSize);
+            ByteReader tail(trailer, trailerSize);
+            unsigned long long indexOffset = tail.read<unsigned long long>();
+            unsigned long long count = tail.read<unsigned long long>();
+            unsigned version = tail.read<unsigned>();
+            if (head.read<unsigned>() != reportArchiveMagic || tail.read<unsigned>() != reportArchiveMagic) {
+                throw std::runtime_error("not a report card archive");
+            }
+            if (head.read<unsigned>() != version || version > reportArchiveVersion) {
+                throw std::runtime_error("written by a newer version (format " + std::to_string(version) + ")");
+            }
+            if (indexOffset < headerSize || count > (fileSize - trailerSize - indexOffset) / entrySize
+                || indexOffset + count * entrySize + trailerSize != fileSize) {
+                throw std::runtime_error("index does not match the file size");
+            }
+
+            std::vector<char> indexBytes(static_cast<size_t>(count * entrySize));
+            file.seekg(static_cast<std::streamoff>(indexOffset));
+            file.read(indexBytes.data(), static_cast<std::streamsize>(indexBytes.size()));
+            if (!file) {
+                throw std::runtime_error("index could not be read");
+            }
+
+            ByteReader reader(indexBytes.data(), indexBytes.size());
+            entries.resize(static_cast<size_t>(count));
+            for (auto& entry : entries) {
+                entry.studentID = reader.read<unsigned>();
+                entry.offset = reader.read<unsigned long long>();
+                entry.length = reader.read<unsigned long long>();
+                if (entry.offset < headerSize || entry.length > indexOffset - entry.offset) {
+                    throw std::runtime_error("card for student " + std::to_string(entry.studentID) + " lies outside the archive");
+                }
+            }
+            if (!std::is_sorted(entries.begin(), entries.end(),
+                [](const ReportArchiveEntry& a, const ReportArchiveEntry& b) { return a.studentID < b.studentID; })) {
+                throw std::runtime_error("index is out of order");
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << filename << " is damaged and was not opened: " << e.what() << "\n";
+            entries.clear();
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Gets the number of cards in the archive.
+     * @return Card count.
+     */
+    size_t ReportCardArchive::size() const {
+        return entries.size();
+    }
+
+    /**
+     * @brief Gets the index.
+     * @return Entries sorted by student ID.
+     */
+    const std::vector<ReportArchiveEntry>& ReportCardArchive::getEntries() const {
+        return entries;
+    }
+
+    /**
+     * @brief Finds a card in the index and reads just its bytes.
+     * @param studentID Student to look up.
+     * @return The card's CSV text, or nothing if the student has no card or it could not be read.
+     */
+    std::optional<std::string> ReportCardArchive::readCard(unsigned studentID) const {
+        auto found = std::lower_bound(entries.begin(), entries.end(), studentID,
+            [](const ReportArchiveEntry& entry, unsigned id) { return entry.studentID < id; });
+        if (found == entries.end() || found->studentID != studentID) {
+            return std::nullopt;
+        }
+
+        std::string card(static_cast<size_t>(found->length), '\0');
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(found->offset));
+        file.read(card.data(), static_cast<std::streamsize>(card.size()));
+        if (!file) {
+            std::cerr << "Failed to read the card for student " << studentID << " from " << filename << ".\n";
+            return std::nullopt;
+        }
+        return card;
+    }
+}
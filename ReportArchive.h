@@ -0,0 +1,78 @@
+#pragma once
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    class Gradebook;
+
+    /**
+     * @brief Where one student's report card sits in an archive.
+     */
+    struct ReportArchiveEntry {
+        unsigned studentID = 0;            /**< Student the card belongs to */
+        unsigned long long offset = 0;     /**< Byte offset of the card from the start of the file */
+        unsigned long long length = 0;     /**< Card length in bytes */
+    };
+
+    /**
+     * @brief Writes every student's report card into one archive file.
+     *
+     * Each card holds the same CSV text as the student's own export. Cards
+     * are rendered in parallel a batch at a time and appended in student ID
+     * order while the next batch renders, so only two batches are ever in
+     * memory. An index sorted by student ID and a fixed-size trailer
+     * pointing at it follow the cards. The archive is written beside the
+     * target and renamed over it once complete.
+     *
+     * @param gradebook School whose students to export.
+     * @param filename Archive to create or replace.
+     * @param cards Receives the number of cards written.
+     * @return True if the archive is in place.
+     */
+    bool writeReportCardArchive(const Gradebook& gradebook, const std::string& filename, size_t& cards);
+
+    /**
+     * @class ReportCardArchive
+     * @brief Reads individual report cards out of an archive without reading the rest.
+     *
+     * Opening reads only the trailer and the index; each card is then one
+     * seek and one read. A ReportCardArchive must not be shared between
+     * threads.
+     */
+    class ReportCardArchive {
+    private:
+        std::string filename;                       /**< Archive being read */
+        mutable std::ifstream file;                 /**< Open archive; moved by every read */
+        std::vector<ReportArchiveEntry> entries;    /**< Index, sorted by student ID */
+
+    public:
+        /**
+         * @brief Opens an archive and reads its index.
+         * @param archive Path of the archive.
+         * @return False if the file is missing or is not a complete archive; a message has been printed.
+         */
+        bool open(const std::string& archive);
+
+        /**
+         * @brief Gets the number of cards in the archive.
+         * @return Card count.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Gets the index.
+         * @return Entries sorted by student ID.
+         */
+        const std::vector<ReportArchiveEntry>& getEntries() const;
+
+        /**
+         * @brief Reads one student's card.
+         * @param studentID Student to look up.
+         * @return The card's CSV text, or nothing if the student has no card or it could not be read.
+         */
+        std::optional<std::string> readCard(unsigned studentID) const;
+    };
+}
@@ -0,0 +1,254 @@
+#include "ReportBatch.h"
+#include "Compression.h"
+#include "Gradebook.h"
+#include "ReportSink.h"
+#include "Serialization.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <semaphore>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace gradebook {
+
+    namespace {
+        /** Student reports written by one task. */
+        constexpr size_t studentsPerTask = 64;
+
+        /**
+         * @brief Holds one of the limited open-file slots for as long as it lives.
+         */
+        class OpenFileSlot {
+        private:
+            std::counting_semaphore<>& slots;   /**< Semaphore the slot was taken from */
+
+        public:
+            explicit OpenFileSlot(std::counting_semaphore<>& semaphore)
+                : slots(semaphore) {
+                slots.acquire();
+            }
+
+            ~OpenFileSlot() {
+                slots.release();
+            }
+
+            OpenFileSlot(const OpenFileSlot&) = delete;
+            OpenFileSlot& operator=(const OpenFileSlot&) = delete;
+        };
+
+        /**
+         * @brief Gives a report a file name no other report in the batch uses.
+         *
+         * Characters no file name may hold become underscores. Names are
+         * compared without case, since two names differing only in case are
+         * the same file on Windows. A clash gets the ID appended.
+         *
+         * @param used Names already given out, lower-cased.
+         * @param name Name the single export would use; ends in ".csv".
+         * @param id Classroom or student ID.
+         * @return The name to write.
+         */
+        std::string uniqueFileName(std::unordered_set<std::string>& used, std::string name, unsigned id) {
+            for (char& ch : name) {
+                unsigned char c = static_cast<unsigned char>(ch);
+                if (c < 32 || std::string_view("<>:\"/\\|?*").find(ch) != std::string_view::npos) {
+                    ch = '_';
+                }
+            }
+
+            auto claim = [&used](const std::string& candidate) {
+                std::string key = candidate;
+                std::transform(key.begin(), key.end(), key.begin(),
+                    [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                return used.insert(std::move(key)).second;
+            };
+
+            if (claim(name)) {
+                return name;
+            }
+
+            std::string stem = name.substr(0, name.size() - 4) + "_" + std::to_string(id);
+            std::string candidate = stem + ".csv";
+            for (unsigned n = 2; !claim(candidate); ++n) {
+                candidate = stem + "_" + std::to_string(n) + ".csv";
+            }
+            return candidate;
+        }
+
+        /**
+         * @brief Writes one report file while holding an open-file slot.
+         * @tparam Write Callable taking std::ostream& and returning the rows written.
+         * @param directory Output directory.
+         * @param slots Open-file limit.
+         * @param output Report to write; its rows, bytes and status are filled in.
+         * @param write Produces the contents.
+         */
+        template <typename Write>
+        void writeReport(const std::filesystem::path& directory, std::counting_semaphore<>& slots,
+            ReportOutput& output, Write write)
+        {
+            OpenFileSlot slot(slots);
+
+            std::filesystem::path path = directory / output.file;
+            ExportFile file(path.string());
+            if (!file.is_open()) {
+                output.status = "Failed";
+                return;
+            }
+
+            output.rows = write(file);
+            file.close();
+            output.status = file.fail() ? "Failed" : "Written";
+
+            std::error_code error;
+            auto size = std::filesystem::file_size(path, error);
+            output.bytes = error ? 0 : static_cast<unsigned long long>(size);
+        }
+    }
+
+    /**
+     * @brief Writes every classroom, assignment score and student report CSV in parallel, then a manifest.
+     * @param gradebook School to report on.
+     * @param directory Directory to write into; created if missing.
+     * @param maxOpenFiles Most report files open at the same time.
+     * @return What was written.
+     */
+    ReportBatchResult generateAllReports(const Gradebook& gradebook, const std::string& directory, unsigned maxOpenFiles) {
+        ReportBatchResult result;
+        auto started = std::chrono::steady_clock::now();
+
+        std::filesystem::path outputDirectory(directory);
+        std::error_code error;
+        std::filesystem::create_directories(outputDirectory, error);
+        if (error) {
+            std::cerr << "Failed to create directory " << directory << ": " << error.message() << std::endl;
+            return result;
+        }
+
+        const auto& teachers = gradebook.getTeachers();
+        const auto& students = gradebook.getStudents();
+
+        // Plan every output up front so tasks only ever touch their own entries.
+        auto& outputs = result.outputs;
+        outputs.resize(teachers.size() * 2 + students.size());
+        std::unordered_set<std::string> usedNames;
+        usedNames.reserve(outputs.size());
+
+        for (size_t t = 0; t < teachers.size(); ++t) {
+            const Teacher& teacher = teachers[t];
+            std::string owner = teacher.getTitle() + " " + teacher.getLastName();
+            outputs[t * 2] = { "Classroom", owner, teacher.getClassroomID(),
+                exportFileName(uniqueFileName(usedNames, teacher.classroomReportFileName(), teacher.getClassroomID())), 0, 0, "" };
+            outputs[t * 2 + 1] = { "Assignment Scores", owner, teacher.getClassroomID(),
+                exportFileName(uniqueFileName(usedNames, teacher.assignmentScoresFileName(), teacher.getClassroomID())), 0, 0, "" };
+        }
+
+        // Each student is written by the task of their first class; students in none get their own tasks.
+        std::unordered_map<unsigned, size_t> teacherByClassroom;
+        teacherByClassroom.reserve(teachers.size());
+        for (size_t t = 0; t < teachers.size(); ++t) {
+            teacherByClassroom.emplace(teachers[t].getClassroomID(), t);
+        }
+
+        std::vector<std::vector<size_t>> studentsByHome(teachers.size());
+        std::vector<size_t> unenrolled;
+        size_t firstStudentOutput = teachers.size() * 2;
+        for (size_t s = 0; s < students.size(); ++s) {
+            const Student& student = *students[s];
+            outputs[firstStudentOutput + s] = { "Student", student.getFirstName() + " " + student.getLastName(),
+                student.getID(), exportFileName(uniqueFileName(usedNames, student.reportFileName(), student.getID())), 0, 0, "" };
+
+            const auto& enrollments = student.getEnrollments();
+            auto home = enrollments.empty() ? teacherByClassroom.end() : teacherByClassroom.find(enrollments.front().classroomID);
+            if (home == teacherByClassroom.end()) {
+                unenrolled.push_back(s);
+            }
+            else {
+                studentsByHome[home->second].push_back(s);
+            }
+        }
+
+        std::counting_semaphore<> openFiles(std::max(1u, maxOpenFiles));
+
+        auto writeStudents = [&](const std::vector<size_t>& group, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const Student& student = *students[group[i]];
+                std::vector<const Teacher*> classrooms = gradebook.getTeachersOf(&student);
+                writeReport(outputDirectory, openFiles, outputs[firstStudentOutput + group[i]],
+                    [&](std::ostream& out) { return student.writeStudentReportCSV(out, classrooms); });
+            }
+            };
+
+        {
+            result.workers = workerCountFor(teachers.size() + students.size() / studentsPerTask, 1);
+            WorkStealingPool pool(result.workers);
+
+            for (size_t t = 0; t < teachers.size(); ++t) {
+                pool.submit([&, t] {
+                    const Teacher& teacher = teachers[t];
+                    ReportOutput& classroom = outputs[t * 2];
+                    ReportOutput& scores = outputs[t * 2 + 1];
+
+                    if (teacher.getClassroomStudents().empty()) {
+                        classroom.status = "Skipped";
+                        classroom.file.clear();
+                    }
+                    else {
+                        writeReport(outputDirectory, openFiles, classroom,
+                            [&](std::ostream& out) { return teacher.writeClassroomReportCSV(out); });
+                    }
+
+                    if (teacher.getClassroomStudents().empty() || teacher.getAssignments().empty()) {
+                        scores.status = "Skipped";
+                        scores.file.clear();
+                    }
+                    else {
+                        writeReport(outputDirectory, openFiles, scores,
+                            [&](std::ostream& out) { return teacher.writeAssignmentScoresCSV(out); });
+                    }
+
+                    // Queued on this worker; idle workers steal them from the front.
+                    const auto& home = studentsByHome[t];
+                    for (size_t first = 0; first < home.size(); first += studentsPerTask) {
+                        size_t last = std::min(home.size(), first + studentsPerTask);
+                        pool.submit([&home, first, last, &writeStudents] { writeStudents(home, first, last); });
+                    }
+                    });
+            }
+
+            for (size_t first = 0; first < unenrolled.size(); first += studentsPerTask) {
+                size_t last = std::min(unenrolled.size(), first + studentsPerTask);
+                pool.submit([&unenrolled, first, last, &writeStudents] { writeStudents(unenrolled, first, last); });
+            }
+
+            pool.wait();
+        }
+
+        for (const auto& output : outputs) {
+            if (output.status == "Written") ++result.written;
+            else if (output.status == "Failed") ++result.failed;
+        }
+
+        std::string manifestPath = (outputDirectory / exportFileName("manifest.csv")).string();
+        CsvSink manifest(manifestPath);
+        if (manifest.isOpen()) {
+            manifest.begin({
+                { "Kind" }, { "Name" }, { "ID", true }, { "File" },
+                { "Rows", true }, { "Bytes", true }, { "Status" } });
+            for (const auto& output : outputs) {
+                manifest.row({ output.kind, output.owner, std::to_string(output.id), output.file,
+                    std::to_string(output.rows), std::to_string(output.bytes), output.status });
+            }
+            manifest.end();
+            result.manifest = manifestPath;
+        }
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        return result;
+    }
+}
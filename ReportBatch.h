@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    class Gradebook;
+
+    /**
+     * @brief One file a report batch set out to write.
+     */
+    struct ReportOutput {
+        std::string kind;          /**< "Classroom", "Assignment Scores" or "Student" */
+        std::string owner;         /**< Teacher or student the report is about */
+        unsigned id = 0;           /**< Classroom ID or student ID */
+        std::string file;          /**< File name inside the output directory */
+        size_t rows = 0;           /**< Data rows written */
+        unsigned long long bytes = 0; /**< Size of the file written */
+        std::string status;        /**< "Written", "Skipped" (nothing to report) or "Failed" */
+    };
+
+    /**
+     * @brief Outcome of generateAllReports.
+     */
+    struct ReportBatchResult {
+        std::vector<ReportOutput> outputs;  /**< Every report, classrooms first, in school order */
+        std::string manifest;               /**< Path of the manifest CSV; empty if it could not be written */
+        size_t written = 0;                 /**< Reports written */
+        size_t failed = 0;                  /**< Reports whose file could not be written */
+        unsigned workers = 0;               /**< Threads used */
+        double seconds = 0.0;               /**< Wall-clock time for the whole batch */
+    };
+
+    /**
+     * @brief Writes every teacher's classroom and assignment score CSVs and every student's report CSV.
+     *
+     * Each classroom is one task on a work-stealing pool. A classroom task
+     * writes the teacher's two files, then queues report tasks for the
+     * students whose first class it is, so every student is written once
+     * and large classrooms spread across idle workers. A counting semaphore
+     * caps how many files are open at once. The files use the same contents
+     * and names as the single exports in the teacher and student menus; a
+     * name already taken in this batch gets the classroom or student ID
+     * appended. A manifest.csv listing every output is written last.
+     *
+     * Grades are reported as stored; nothing in the gradebook is changed.
+     *
+     * @param gradebook School to report on.
+     * @param directory Directory to write into; created if missing.
+     * @param maxOpenFiles Most report files open at the same time.
+     * @return What was written.
+     */
+    ReportBatchResult generateAllReports(const Gradebook& gradebook, const std::string& directory, unsigned maxOpenFiles = 32);
+}
@@ -0,0 +1,122 @@
+#include "ReportSink.h"
+#include "utilities.h"
+#include <iomanip>
+#include <utility>
+
+namespace gradebook {
+
+    // === ConsoleSink ===
+
+    /**
+     * @brief Creates a sink printing to a stream.
+     * @param stream Destination; std::cout unless given.
+     */
+    ConsoleSink::ConsoleSink(std::ostream& stream)
+        : out(stream) {
+    }
+
+    /**
+     * @brief Prints the heading row and a rule under it.
+     * @param reportColumns Columns every later row provides, in order.
+     */
+    void ConsoleSink::begin(const std::vector<ReportColumn>& reportColumns) {
+        columns = reportColumns;
+        rows = 0;
+
+        size_t totalWidth = 0;
+        for (const auto& column : columns) {
+            out << std::left << std::setw(column.width) << column.name;
+            totalWidth += static_cast<size_t>(column.width);
+        }
+        out << "\n" << std::string(totalWidth, '-') << "\n";
+    }
+
+    /**
+     * @brief Prints one row.
+     * @param cells One formatted cell per column.
+     */
+    void ConsoleSink::row(const std::vector<std::string>& cells) {
+        for (size_t c = 0; c < cells.size() && c < columns.size(); ++c) {
+            out << std::left << std::setw(columns[c].width) << cells[c];
+        }
+        out << "\n";
+        ++rows;
+    }
+
+    /**
+     * @brief Prints the row count.
+     */
+    void ConsoleSink::end() {
+        if (rows == 0) {
+            out << "No matching results found." << std::endl;
+            return;
+        }
+        out << rows << " row(s)." << std::endl;
+    }
+
+    // === CsvSink ===
+
+    /**
+     * @brief Creates a sink writing to a CSV file.
+     * @param name Name of the CSV file to create.
+     */
+    CsvSink::CsvSink(std::string name)
+        : filename(std::move(name)), file(filename) {
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file " << filename << " for writing." << std::endl;
+        }
+    }
+
+    /**
+     * @brief Checks whether the file could be created.
+     * @return True if rows will be written.
+     */
+    bool CsvSink::isOpen() const {
+        return file.is_open();
+    }
+
+    /**
+     * @brief Writes the header line.
+     * @param reportColumns Columns every later row provides, in order.
+     */
+    void CsvSink::begin(const std::vector<ReportColumn>& reportColumns) {
+        columns = reportColumns;
+        rows = 0;
+        if (!file.is_open()) return;
+
+        for (size_t c = 0; c < columns.size(); ++c) {
+            file << (c ? "," : "") << columns[c].name;
+        }
+        file << "\n";
+    }
+
+    /**
+     * @brief Writes one line, quoting text cells.
+     * @param cells One formatted cell per column.
+     */
+    void CsvSink::row(const std::vector<std::string>& cells) {
+        if (!file.is_open()) return;
+
+        for (size_t c = 0; c < cells.size() && c < columns.size(); ++c) {
+            if (c) file << ",";
+            if (columns[c].numeric) {
+                file << cells[c];
+            }
+            else {
+                writeQuoted(file, cells[c]);
+            }
+        }
+        file << "\n";
+        ++rows;
+    }
+
+    /**
+     * @brief Closes the file and reports how many rows were written.
+     */
+    void CsvSink::end() {
+        if (!file.is_open()) return;
+
+        file.close();
+        std::cout << rows << " row(s) exported successfully to " << filename << "." << std::endl;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "Compression.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace gradebook {
+
+    /**
+     * @brief One column of a streamed report.
+     */
+    struct ReportColumn {
+        std::string name;          /**< Column heading */
+        bool numeric = false;      /**< True if the cells are numbers; written to CSV unquoted */
+        int width = 14;            /**< Console column width */
+    };
+
+    /**
+     * @class ReportSink
+     * @brief Destination for report rows produced one at a time.
+     *
+     * Producers call begin() once with the columns, row() once per result as
+     * soon as it is known, and end() once at the end, so no report has to be
+     * held in memory before it is written.
+     */
+    class ReportSink {
+    public:
+        virtual ~ReportSink() = default;
+
+        /**
+         * @brief Starts the report.
+         * @param columns Columns every later row provides, in order.
+         */
+        virtual void begin(const std::vector<ReportColumn>& columns) = 0;
+
+        /**
+         * @brief Writes one row.
+         * @param cells One formatted cell per column.
+         */
+        virtual void row(const std::vector<std::string>& cells) = 0;
+
+        /**
+         * @brief Finishes the report.
+         */
+        virtual void end() = 0;
+    };
+
+    /**
+     * @class ConsoleSink
+     * @brief Prints report rows as a fixed-width table.
+     */
+    class ConsoleSink : public ReportSink {
+    private:
+        std::ostream& out;                  /**< Stream the table is printed to */
+        std::vector<ReportColumn> columns;  /**< Columns given to begin() */
+        size_t rows = 0;                    /**< Rows printed so far */
+
+    public:
+        /**
+         * @brief Creates a sink printing to a stream.
+         * @param stream Destination; std::cout unless given.
+         */
+        explicit ConsoleSink(std::ostream& stream = std::cout);
+
+        void begin(const std::vector<ReportColumn>& columns) override;
+        void row(const std::vector<std::string>& cells) override;
+        void end() override;
+    };
+
+    /**
+     * @class CsvSink
+     * @brief Writes report rows to a CSV file as they arrive.
+     *
+     * Text cells are quoted the same way as every other CSV export; numeric
+     * cells are written as they are.
+     */
+    class CsvSink : public ReportSink {
+    private:
+        std::string filename;               /**< File being written */
+        ExportFile file;                    /**< Open file, gzipped if named "*.gz"; closed by end() */
+        std::vector<ReportColumn> columns;  /**< Columns given to begin() */
+        size_t rows = 0;                    /**< Rows written so far */
+
+    public:
+        /**
+         * @brief Creates a sink writing to a CSV file.
+         * @param filename Name of the CSV file to create.
+         */
+        explicit CsvSink(std::string filename);
+
+        /**
+         * @brief Checks whether the file could be created.
+         * @return True if rows will be written.
+         */
+        bool isOpen() const;
+
+        void begin(const std::vector<ReportColumn>& columns) override;
+        void row(const std::vector<std::string>& cells) override;
+        void end() override;
+    };
+}
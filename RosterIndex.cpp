@@ -0,0 +1,307 @@
+#include "RosterIndex.h"
+#include "Student.h"
+#include <algorithm>
+#include <cctype>
+
+namespace gradebook {
+
+    namespace {
+        /**
+         * @brief Orders roster entries by collation key, then by student ID.
+         */
+        bool entryLess(const RosterEntry& a, const RosterEntry& b) {
+            if (a.collationKey != b.collationKey) {
+                return a.collationKey < b.collationKey;
+            }
+            return a.id < b.id;
+        }
+
+        /**
+         * @brief Builds the roster entry for a student.
+         * @param student The student to index.
+         * @return The entry with its precomputed key.
+         */
+        RosterEntry makeEntry(Student* student) {
+            RosterEntry entry;
+            entry.collationKey = RosterIndex::collationKey(student->getLastNameView(), student->getFirstNameView());
+            entry.id = student->getID();
+            entry.student = student;
+            return entry;
+        }
+
+        /**
+         * @brief Builds the "first name, last name" entry used for first-name searches.
+         * @param student The student to index.
+         * @return The entry with its precomputed key.
+         */
+        RosterEntry makeFirstNameEntry(Student* student) {
+            RosterEntry entry;
+            entry.collationKey = RosterIndex::collationKey(student->getFirstNameView(), student->getLastNameView());
+            entry.id = student->getID();
+            entry.student = student;
+            return entry;
+        }
+
+        /**
+         * @brief Builds the entry used for ID prefix searches.
+         * @param student The student to index.
+         * @return The entry keyed by the decimal ID string.
+         */
+        RosterEntry makeIDEntry(Student* student) {
+            RosterEntry entry;
+            entry.collationKey = std::to_string(student->getID());
+            entry.id = student->getID();
+            entry.student = student;
+            return entry;
+        }
+
+        /**
+         * @brief Inserts an entry at its sorted position.
+         * @param list Sorted entry list.
+         * @param entry Entry to insert.
+         */
+        void insertSorted(std::vector<RosterEntry>& list, RosterEntry entry) {
+            auto position = std::upper_bound(list.begin(), list.end(), entry, entryLess);
+            list.insert(position, std::move(entry));
+        }
+
+        /**
+         * @brief Removes one entry from a sorted list by binary search on its key and ID.
+         * @param list Sorted entry list.
+         * @param probe Entry built from the student being removed.
+         * @return True if the student's entry was found.
+         */
+        bool eraseSorted(std::vector<RosterEntry>& list, const RosterEntry& probe) {
+            auto [first, last] = std::equal_range(list.begin(), list.end(), probe, entryLess);
+            for (auto it = first; it != last; ++it) {
+                if (it->student == probe.student) {
+                    list.erase(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Finds the range of entries whose key starts with a prefix.
+         * @param list Sorted entry list.
+         * @param prefix Folded prefix to look for.
+         * @return Iterator pair delimiting the matching entries.
+         */
+        std::pair<std::vector<RosterEntry>::const_iterator, std::vector<RosterEntry>::const_iterator>
+            prefixRange(const std::vector<RosterEntry>& list, const std::string& prefix)
+        {
+            auto first = std::lower_bound(list.begin(), list.end(), prefix,
+                [](const RosterEntry& e, const std::string& p) { return e.collationKey < p; });
+            auto last = first;
+            while (last != list.end() && last->collationKey.compare(0, prefix.size(), prefix) == 0) {
+                ++last;
+            }
+            return { first, last };
+        }
+
+        /**
+         * @brief Folds a typed query into collation-key form.
+         *
+         * Letters are lower-cased, commas dropped, and runs of whitespace
+         * become the key separator so "Smith, Jo" matches "smith\x01jo...".
+         *
+         * @param query The raw query.
+         * @return The folded prefix.
+         */
+        std::string foldQuery(const std::string& query) {
+            std::string folded;
+            bool pendingSeparator = false;
+            for (char ch : query) {
+                unsigned char uch = static_cast<unsigned char>(ch);
+                if (std::isspace(uch) || ch == ',') {
+                    pendingSeparator = !folded.empty();
+                    continue;
+                }
+                if (pendingSeparator) {
+                    folded.push_back('\x01');
+                    pendingSeparator = false;
+                }
+                folded.push_back(static_cast<char>(std::tolower(uch)));
+            }
+            return folded;
+        }
+    }
+
+    /**
+     * @brief Builds the case-folded collation key for a name.
+     *
+     * The separator sorts below every printable character, so "Li, Zoe"
+     * still comes before "Lim, Ann".
+     *
+     * @param lastName Student's last name.
+     * @param firstName Student's first name.
+     * @return The collation key.
+     */
+    std::string RosterIndex::collationKey(std::string_view lastName, std::string_view firstName) {
+        std::string key;
+        key.reserve(lastName.size() + firstName.size() + 1);
+        for (char ch : lastName) {
+            key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+        }
+        key.push_back('\x01');
+        for (char ch : firstName) {
+            key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+        }
+        return key;
+    }
+
+    /**
+     * @brief Inserts one student at its sorted position.
+     * @param student Pointer to the student to index.
+     */
+    void RosterIndex::insert(Student* student) {
+        if (!student) return;
+
+        insertSorted(entries, makeEntry(student));
+        insertSorted(byFirstName, makeFirstNameEntry(student));
+        insertSorted(byID, makeIDEntry(student));
+    }
+
+    /**
+     * @brief Adds many students at once and sorts a single time.
+     * @param batch Students to index.
+     */
+    void RosterIndex::insertBatch(const std::vector<Student*>& batch) {
+        entries.reserve(entries.size() + batch.size());
+        byFirstName.reserve(byFirstName.size() + batch.size());
+        byID.reserve(byID.size() + batch.size());
+        for (Student* student : batch) {
+            if (student) {
+                entries.push_back(makeEntry(student));
+                byFirstName.push_back(makeFirstNameEntry(student));
+                byID.push_back(makeIDEntry(student));
+            }
+        }
+        std::sort(entries.begin(), entries.end(), entryLess);
+        std::sort(byFirstName.begin(), byFirstName.end(), entryLess);
+        std::sort(byID.begin(), byID.end(), entryLess);
+    }
+
+    /**
+     * @brief Removes one student from every key list.
+     *
+     * Keys are rebuilt from the student's current name and ID, so a student
+     * must be erased before either is changed.
+     *
+     * @param student Pointer to the student to remove.
+     * @return True if the student was indexed.
+     */
+    bool RosterIndex::erase(Student* student) {
+        if (!student) return false;
+
+        bool found = eraseSorted(entries, makeEntry(student));
+        eraseSorted(byFirstName, makeFirstNameEntry(student));
+        eraseSorted(byID, makeIDEntry(student));
+        return found;
+    }
+
+    /**
+     * @brief Removes many students with a single compaction of each key list.
+     * @param batch Students to remove.
+     */
+    void RosterIndex::eraseBatch(const std::unordered_set<const Student*>& batch) {
+        if (batch.empty()) return;
+
+        auto inBatch = [&](const RosterEntry& entry) { return batch.count(entry.student) != 0; };
+        for (auto* list : { &entries, &byFirstName, &byID }) {
+            list->erase(std::remove_if(list->begin(), list->end(), inBatch), list->end());
+        }
+    }
+
+    /**
+     * @brief Finds students whose last name, first name or ID starts with a query.
+     *
+     * Each lookup is a binary search plus a walk over the matches, so the cost
+     * depends on the number of results rather than the roster size.
+     *
+     * @param query The prefix typed by the user.
+     * @return Matching students, last-name matches first.
+     */
+    std::vector<Student*> RosterIndex::search(const std::string& query) const {
+        std::vector<Student*> matches;
+        std::string folded = foldQuery(query);
+
+        if (folded.empty()) {
+            matches.reserve(entries.size());
+            for (const auto& entry : entries) {
+                matches.push_back(entry.student);
+            }
+            return matches;
+        }
+
+        bool numeric = std::all_of(folded.begin(), folded.end(),
+            [](char ch) { return std::isdigit(static_cast<unsigned char>(ch)); });
+        if (numeric) {
+            auto [first, last] = prefixRange(byID, folded);
+            for (auto it = first; it != last; ++it) {
+                matches.push_back(it->student);
+            }
+            return matches;
+        }
+
+        auto [lastFirst, lastEnd] = prefixRange(entries, folded);
+        for (auto it = lastFirst; it != lastEnd; ++it) {
+            matches.push_back(it->student);
+        }
+
+        // Students whose last name already matched would show up twice.
+        size_t lastNameMatches = matches.size();
+        auto [firstFirst, firstEnd] = prefixRange(byFirstName, folded);
+        for (auto it = firstFirst; it != firstEnd; ++it) {
+            std::string lastKey = collationKey(it->student->getLastNameView(), it->student->getFirstNameView());
+            if (lastNameMatches > 0 && lastKey.compare(0, folded.size(), folded) == 0) {
+                continue;
+            }
+            matches.push_back(it->student);
+        }
+        return matches;
+    }
+
+    /**
+     * @brief Removes every entry.
+     */
+    void RosterIndex::clear() {
+        entries.clear();
+        byFirstName.clear();
+        byID.clear();
+    }
+
+    /**
+     * @brief Gets the number of indexed students.
+     * @return Entry count.
+     */
+    size_t RosterIndex::size() const {
+        return entries.size();
+    }
+
+    /**
+     * @brief Checks whether the index is empty.
+     * @return True if no students are indexed.
+     */
+    bool RosterIndex::empty() const {
+        return entries.empty();
+    }
+
+    /**
+     * @brief Gets the student at a sorted position.
+     * @param position Zero-based position in name order.
+     * @return Pointer to the student.
+     */
+    Student* RosterIndex::at(size_t position) const {
+        return entries.at(position).student;
+    }
+
+    /**
+     * @brief Gets the sorted entries.
+     * @return Const reference to the entries in name order.
+     */
+    const std::vector<RosterEntry>& RosterIndex::getEntries() const {
+        return entries;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace gradebook {
+
+    class Student;
+
+    /**
+     * @brief One student's position in a name-ordered roster.
+     */
+    struct RosterEntry {
+        std::string collationKey;   ///< Case-folded "last name, first name" sort key
+        unsigned id = 0;            ///< Student ID, used to order students with identical names
+        Student* student = nullptr; ///< The indexed student
+    };
+
+    /**
+     * @class RosterIndex
+     * @brief Keeps a classroom roster ordered by last name, then first name.
+     *
+     * Collation keys are computed once when a student is inserted, so listing
+     * the roster in order never re-reads or compares names again. Two more
+     * sorted key lists (first name first, and decimal ID) let the student
+     * picker answer prefix searches with a binary search.
+     */
+    class RosterIndex {
+    private:
+        std::vector<RosterEntry> entries;      ///< Entries kept sorted by key, then ID
+        std::vector<RosterEntry> byFirstName;  ///< Same students keyed "first name, last name"
+        std::vector<RosterEntry> byID;         ///< Same students keyed by decimal ID string
+
+    public:
+        /**
+         * @brief Builds the case-folded collation key for a name.
+         * @param lastName Student's last name.
+         * @param firstName Student's first name.
+         * @return A key that sorts by last name, then first name, ignoring case.
+         */
+        static std::string collationKey(std::string_view lastName, std::string_view firstName);
+
+        /**
+         * @brief Inserts one student at its sorted position.
+         * @param student Pointer to the student to index.
+         */
+        void insert(Student* student);
+
+        /**
+         * @brief Adds many students at once and sorts a single time.
+         * @param batch Students to index.
+         */
+        void insertBatch(const std::vector<Student*>& batch);
+
+        /**
+         * @brief Finds students whose last name, first name or ID starts with a query.
+         *
+         * Digits search IDs; anything else is matched case-insensitively against
+         * "last first" and "first last", so "smi", "smith jo" and "jo" all work.
+         * An empty query returns the whole roster in name order.
+         *
+         * @param query The prefix typed by the user.
+         * @return Matching students, last-name matches first.
+         */
+        std::vector<Student*> search(const std::string& query) const;
+
+        /**
+         * @brief Removes one student from every key list.
+         * @param student Pointer to the student to remove.
+         * @return True if the student was indexed.
+         */
+        bool erase(Student* student);
+
+        /**
+         * @brief Removes many students with a single compaction of each key list.
+         * @param batch Students to remove.
+         */
+        void eraseBatch(const std::unordered_set<const Student*>& batch);
+
+        /** @brief Removes every entry. */
+        void clear();
+
+        /** @brief Gets the number of indexed students. */
+        size_t size() const;
+
+        /** @brief Checks whether the index is empty. */
+        bool empty() const;
+
+        /**
+         * @brief Gets the student at a sorted position.
+         * @param position Zero-based position in name order.
+         * @return Pointer to the student.
+         */
+        Student* at(size_t position) const;
+
+        /** @brief Gets the sorted entries. */
+        const std::vector<RosterEntry>& getEntries() const;
+    };
+}
@@ -0,0 +1,352 @@
+#include "Serialization.h"
+#include "Compression.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace gradebook {
+
+    /**
+     * @brief Reads an entire file into memory with a single read.
+     * @param filename Path of the file to read.
+     * @param contents Receives the file's bytes.
+     * @return True on success, false if the file could not be opened or read.
+     */
+    bool readWholeFile(const std::string& filename, std::vector<char>& contents) {
+        std::ifstream inFile(filename, std::ios::binary | std::ios::ate);
+        if (!inFile) {
+            return false;
+        }
+
+        std::streamsize length = inFile.tellg();
+        if (length < 0) {
+            return false;
+        }
+        inFile.seekg(0, std::ios::beg);
+
+        contents.resize(static_cast<size_t>(length));
+        return length == 0 || static_cast<bool>(inFile.read(contents.data(), length));
+    }
+
+    namespace {
+        /**
+         * @brief Writes a buffer to a new file with the OS's own calls, optionally syncing it.
+         * @param path File to create or truncate.
+         * @param bytes Start of the buffer.
+         * @param length Buffer length in bytes.
+         * @param sync If true, fsync (_commit on Windows) before closing.
+         * @return True if every byte was written (and synced).
+         */
+        bool writeAndSync(const std::string& path, const char* bytes, size_t length, bool sync) {
+            // Cap each call so the length fits the platform's count type.
+            constexpr size_t maxChunk = size_t{ 1 } << 30;
+#ifdef _WIN32
+            int fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+            if (fd < 0) {
+                return false;
+            }
+            while (length > 0) {
+                int written = _write(fd, bytes, static_cast<unsigned>(std::min(length, maxChunk)));
+                if (written <= 0) {
+                    _close(fd);
+                    return false;
+                }
+                bytes += written;
+                length -= static_cast<size_t>(written);
+            }
+            bool ok = !sync || _commit(fd) == 0;
+            return (_close(fd) == 0) && ok;
+#else
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                return false;
+            }
+            while (length > 0) {
+                ssize_t written = ::write(fd, bytes, std::min(length, maxChunk));
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    ::close(fd);
+                    return false;
+                }
+                bytes += written;
+                length -= static_cast<size_t>(written);
+            }
+            bool ok = !sync || ::fsync(fd) == 0;
+            return (::close(fd) == 0) && ok;
+#endif
+        }
+
+        /**
+         * @brief Makes a rename inside a directory durable.
+         *
+         * POSIX only persists a rename once the directory itself is synced.
+         * Windows has no equivalent call, and NTFS journals the rename itself.
+         *
+         * @param filename File whose parent directory is synced.
+         */
+        void syncParentDirectory(const std::string& filename) {
+#ifndef _WIN32
+            std::filesystem::path parent = std::filesystem::path(filename).parent_path();
+            std::string directory = parent.empty() ? std::string(".") : parent.string();
+            int fd = ::open(directory.c_str(), O_RDONLY);
+            if (fd >= 0) {
+                ::fsync(fd);
+                ::close(fd);
+            }
+#else
+            (void)filename;
+#endif
+        }
+    }
+
+    /**
+     * @brief Replaces a file's contents without ever leaving it half written.
+     * @param filename Path of the file to replace.
+     * @param bytes Start of the buffer.
+     * @param length Buffer length in bytes.
+     * @param sync If true, flush the data and directory entry to stable storage before returning.
+     * @return True if the new contents are in place.
+     */
+    bool writeFileAtomically(const std::string& filename, const char* bytes, size_t length, bool sync) {
+        std::string temporary = filename + ".tmp";
+        if (!writeAndSync(temporary, bytes, length, sync)) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, filename, error);
+        if (error) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        if (sync) {
+            syncParentDirectory(filename);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Gets the display name of a section.
+     * @param tag Section to name.
+     * @return "administrators", "students", "teachers" or "change log".
+     */
+    const char* sectionName(SectionTag tag) {
+        switch (tag) {
+        case SectionTag::Administrators: return "administrators";
+        case SectionTag::Students: return "students";
+        case SectionTag::Teachers: return "teachers";
+        case SectionTag::ChangeLog: return "change log";
+        }
+        return "unknown";
+    }
+
+    /**
+     * @brief Encodes a section header, followed by a CRC-32 of its fields.
+     * @param out Destination; sectionHeaderBytes are written.
+     * @param header Header to encode.
+     */
+    void writeSectionHeader(char* out, const SectionHeader& header) {
+        ByteWriter writer(out, sectionHeaderBytes);
+        writer.write(static_cast<unsigned>(header.tag));
+        writer.write(header.count);
+        writer.write(header.bytes);
+        writer.write(header.crc);
+        writer.write(crc32(out, writer.position()));
+    }
+
+    /**
+     * @brief Decodes a section header and checks its CRC-32.
+     * @param data Start of the header; sectionHeaderBytes must be readable.
+     * @param header Receives the fields.
+     * @return False if the header's CRC does not match its fields.
+     */
+    bool readSectionHeader(const char* data, SectionHeader& header) {
+        ByteReader reader(data, sectionHeaderBytes);
+        header.tag = static_cast<SectionTag>(reader.read<unsigned>());
+        header.count = reader.read<unsigned>();
+        header.bytes = reader.read<unsigned long long>();
+        header.crc = reader.read<unsigned>();
+        return crc32(data, reader.position()) == reader.read<unsigned>();
+    }
+
+    /**
+     * @brief Gets the display name of a durability mode.
+     * @param mode The mode to name.
+     * @return "Fast", "Grouped" or "Strict".
+     */
+    const char* durabilityModeName(DurabilityMode mode) {
+        switch (mode) {
+        case DurabilityMode::Fast:
+            return "Fast";
+        case DurabilityMode::Grouped:
+            return "Grouped";
+        case DurabilityMode::Strict:
+            return "Strict";
+        }
+        return "Unknown";
+    }
+
+    // === GroupCommitter ===
+
+    /**
+     * @brief Starts the commit thread for a file.
+     * @param target Path of the file the snapshots replace.
+     * @param commit Writes each batch; empty to replace the file atomically.
+     */
+    GroupCommitter::GroupCommitter(std::string target, CommitFunction commit)
+        : filename(std::move(target)), commitBatch(std::move(commit)) {
+        worker = std::thread(&GroupCommitter::run, this);
+    }
+
+    /**
+     * @brief Commits anything still pending and stops the thread.
+     */
+    GroupCommitter::~GroupCommitter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+
+    /**
+     * @brief Changes the batching policy.
+     * @param batchWindow Longest a change may wait before it is committed.
+     * @param batchChanges Number of changes that closes a batch early.
+     */
+    void GroupCommitter::setPolicy(std::chrono::milliseconds batchWindow, unsigned batchChanges) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            window = batchWindow;
+            maxChanges = std::max(1u, batchChanges);
+        }
+        wake.notify_all();
+    }
+
+    /**
+     * @brief Queues a snapshot, replacing any older one still waiting.
+     * @param snapshot Complete encoded contents of the file.
+     */
+    void GroupCommitter::submit(ByteBuffer snapshot) {
+        ByteBuffer superseded;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!hasPending) {
+                firstPendingAt = std::chrono::steady_clock::now();
+            }
+            superseded = std::exchange(pending, std::move(snapshot));
+            hasPending = true;
+            ++pendingChanges;
+            ++changes;
+        }
+        wake.notify_all();
+    }
+
+    /**
+     * @brief Commits whatever is pending now and waits until it is durable.
+     */
+    void GroupCommitter::flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!hasPending && !committing) {
+            return;
+        }
+        flushRequested = true;
+        wake.notify_all();
+        drained.wait(lock, [&] { return !hasPending && !committing; });
+        flushRequested = false;
+    }
+
+    /**
+     * @brief Gets the number of batches committed so far.
+     * @return Commit count.
+     */
+    unsigned long long GroupCommitter::getCommitCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return commits;
+    }
+
+    /**
+     * @brief Gets the number of snapshots submitted so far.
+     * @return Change count.
+     */
+    unsigned long long GroupCommitter::getChangeCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return changes;
+    }
+
+    /**
+     * @brief Worker loop: waits for a batch to close, then writes and fsyncs it.
+     */
+    void GroupCommitter::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return stopping || hasPending; });
+            if (!hasPending) {
+                return;
+            }
+
+            // The batch stays open until the window closes, it fills up, or someone needs it now.
+            wake.wait_until(lock, firstPendingAt + window, [&] {
+                return stopping || flushRequested || pendingChanges >= maxChanges;
+                });
+
+            ByteBuffer batch = std::move(pending);
+            hasPending = false;
+            pendingChanges = 0;
+            committing = true;
+            lock.unlock();
+
+            bool ok;
+            if (commitBatch) {
+                ok = commitBatch(batch);
+            }
+            else {
+                // Only the last snapshot of a batch is ever compressed, and never on the caller's thread.
+                if (hasGzipExtension(filename)) {
+                    batch = gzipCompress(batch.data.get(), batch.size);
+                }
+                ok = writeFileAtomically(filename, batch.data.get(), batch.size, true);
+                if (!ok) {
+                    std::cerr << "Failed to write " << filename << ".\n";
+                }
+            }
+            batch = ByteBuffer();
+
+            lock.lock();
+            committing = false;
+            ++commits;
+            drained.notify_all();
+        }
+    }
+
+    /**
+     * @brief Picks how many worker threads to use for a batch of records.
+     * @param recordCount Number of records to process.
+     * @param minimumPerThread Smallest batch worth handing to a thread.
+     * @return Number of threads, at least 1.
+     */
+    unsigned workerCountFor(size_t recordCount, size_t minimumPerThread) {
+        unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        size_t useful = std::max<size_t>(1, recordCount / std::max<size_t>(1, minimumPerThread));
+        return static_cast<unsigned>(std::min<size_t>(hardware, useful));
+    }
+}
@@ -0,0 +1,497 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gradebook {
+
+    /**
+     * @class ByteReader
+     * @brief Bounds-checked cursor over an in-memory copy of a binary file.
+     *
+     * Every read checks the remaining length first and throws
+     * std::out_of_range instead of running past the buffer, so a truncated
+     * file can never make the loader read garbage lengths into memory.
+     * Several readers may share one buffer, which is how the loader decodes
+     * separate ranges of records on separate threads.
+     */
+    class ByteReader {
+    private:
+        const char* data;   ///< Start of the buffer
+        size_t size;        ///< Buffer length in bytes
+        size_t pos;         ///< Current read offset
+
+        /**
+         * @brief Throws if fewer than count bytes remain.
+         * @param count Number of bytes about to be read.
+         */
+        void require(size_t count) const {
+            if (count > size - pos) {
+                throw std::out_of_range("Unexpected end of data at offset " + std::to_string(pos));
+            }
+        }
+
+    public:
+        /**
+         * @brief Creates a reader over a buffer.
+         * @param bytes Start of the buffer.
+         * @param length Buffer length in bytes.
+         * @param offset Offset to start reading at.
+         */
+        ByteReader(const char* bytes, size_t length, size_t offset = 0)
+            : data(bytes), size(length), pos(offset) {
+        }
+
+        /**
+         * @brief Reads a trivially copyable value in native byte order.
+         * @tparam T Type to read.
+         * @return The decoded value.
+         */
+        template <typename T>
+        T read() {
+            static_assert(std::is_trivially_copyable_v<T>, "ByteReader::read needs a trivially copyable type");
+            require(sizeof(T));
+            T value;
+            std::memcpy(&value, data + pos, sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+
+        /**
+         * @brief Reads a size_t length prefix followed by that many characters.
+         * @return The decoded string.
+         */
+        std::string readString() {
+            size_t length = read<size_t>();
+            require(length);
+            std::string value(data + pos, length);
+            pos += length;
+            return value;
+        }
+
+        /**
+         * @brief Skips over a length-prefixed string without copying it.
+         */
+        void skipString() {
+            skip(read<size_t>());
+        }
+
+        /**
+         * @brief Skips a fixed number of bytes.
+         * @param count Number of bytes to skip.
+         */
+        void skip(size_t count) {
+            require(count);
+            pos += count;
+        }
+
+        /** @brief Gets the current read offset. */
+        size_t position() const { return pos; }
+
+        /** @brief Gets the number of bytes left to read. */
+        size_t remaining() const { return size - pos; }
+    };
+
+    /**
+     * @class ByteSizer
+     * @brief Counts the bytes a record would take without writing anything.
+     *
+     * Has the same write interface as ByteWriter, so one templated encode
+     * function both measures a record and writes it, and the two passes can
+     * never disagree about the layout.
+     */
+    class ByteSizer {
+    private:
+        size_t total = 0;   ///< Bytes counted so far
+
+    public:
+        /**
+         * @brief Counts a trivially copyable value.
+         * @tparam T Type of the value.
+         */
+        template <typename T>
+        void write(const T&) {
+            total += sizeof(T);
+        }
+
+        /**
+         * @brief Counts a size_t length prefix and the string's characters.
+         * @param value The string to count.
+         */
+        void writeString(std::string_view value) {
+            total += sizeof(size_t) + value.size();
+        }
+
+        /** @brief Gets the number of bytes counted. */
+        size_t size() const { return total; }
+    };
+
+    /**
+     * @class ByteWriter
+     * @brief Writes values into a region of a preallocated buffer.
+     *
+     * The region is sized beforehand with ByteSizer, so writes are plain
+     * copies with no growth; each write still checks the region's capacity,
+     * so an encoder that disagrees with its sizer throws instead of writing
+     * past the buffer. The caller compares position() with the measured size
+     * once the region is filled.
+     */
+    class ByteWriter {
+    private:
+        char* data;         ///< Start of the region
+        size_t capacity;    ///< Size of the region in bytes
+        size_t pos = 0;     ///< Current write offset within the region
+
+        /**
+         * @brief Checks that another count bytes fit in the region.
+         * @param count Number of bytes about to be written.
+         * @throws std::logic_error if they would run past the region.
+         */
+        void ensureRoom(size_t count) const {
+            if (count > capacity - pos) {
+                throw std::logic_error("Record is larger than the space measured for it");
+            }
+        }
+
+    public:
+        /**
+         * @brief Creates a writer over a region of a buffer.
+         * @param region Start of the region to fill.
+         * @param regionSize Size of the region in bytes.
+         */
+        ByteWriter(char* region, size_t regionSize) : data(region), capacity(regionSize) {
+        }
+
+        /**
+         * @brief Writes a trivially copyable value in native byte order.
+         * @tparam T Type of the value.
+         * @param value The value to write.
+         */
+        template <typename T>
+        void write(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>, "ByteWriter::write needs a trivially copyable type");
+            ensureRoom(sizeof(T));
+            std::memcpy(data + pos, &value, sizeof(T));
+            pos += sizeof(T);
+        }
+
+        /**
+         * @brief Writes a size_t length prefix followed by the string's characters.
+         * @param value The string to write.
+         */
+        void writeString(std::string_view value) {
+            write(value.size());
+            ensureRoom(value.size());
+            std::memcpy(data + pos, value.data(), value.size());
+            pos += value.size();
+        }
+
+        /** @brief Gets the number of bytes written. */
+        size_t position() const { return pos; }
+
+        /** @brief Gets where the next byte will be written, so a field written earlier can be filled in later. */
+        char* cursor() const { return data + pos; }
+    };
+
+    /**
+     * @brief Reads an entire file into memory with a single read.
+     * @param filename Path of the file to read.
+     * @param contents Receives the file's bytes.
+     * @return True on success, false if the file could not be opened or read.
+     */
+    bool readWholeFile(const std::string& filename, std::vector<char>& contents);
+
+    /**
+     * @brief Picks how many worker threads to use for a batch of records.
+     * @param recordCount Number of records to process.
+     * @param minimumPerThread Smallest batch worth handing to a thread.
+     * @return Number of threads, at least 1.
+     */
+    unsigned workerCountFor(size_t recordCount, size_t minimumPerThread);
+
+    /**
+     * @brief Replaces a file's contents without ever leaving it half written.
+     *
+     * The bytes go to "<filename>.tmp" in a single write, which is then
+     * renamed over the target. A crash at any point leaves either the old
+     * file or the new one, never a truncated mix.
+     *
+     * @param filename Path of the file to replace.
+     * @param bytes Start of the buffer.
+     * @param length Buffer length in bytes.
+     * @param sync If true, flush the data (and on POSIX the directory entry) to stable storage before returning.
+     * @return True if the new contents are in place.
+     */
+    bool writeFileAtomically(const std::string& filename, const char* bytes, size_t length, bool sync);
+
+    /**
+     * @brief An owned, uninitialized byte buffer holding one encoded snapshot of a file.
+     */
+    struct ByteBuffer {
+        std::unique_ptr<char[]> data;   ///< Encoded bytes
+        size_t size = 0;                ///< Number of bytes in data
+    };
+
+    /**
+     * @brief First four bytes of every versioned data file ("GBDK").
+     *
+     * Legacy files start with the administrator count instead, which is
+     * never anywhere near this value.
+     */
+    inline constexpr unsigned gradebookFileMagic = 0x4B444247;
+
+    /**
+     * @brief Format version written by serializeAndSave.
+     *
+     * Version 0 is the original unversioned layout with scores keyed by
+     * assignment name. Version 1 adds stable assignment IDs. Version 2
+     * stores each student's enrollments with their scores, and teachers
+     * carry a classroom ID instead of a roster. Version 3 saves assignment
+     * descriptions, which earlier versions dropped. Version 4 adds change
+     * versions to students and scores, and ends with the change log's
+     * tombstones and export watermarks. Version 5 checksums the header,
+     * puts each part of the file in its own section with a SectionHeader,
+     * and frames every record with its length and CRC-32.
+     */
+    inline constexpr unsigned gradebookFormatVersion = 5;
+
+    /** @brief First format version with checksums, sections and record frames. */
+    inline constexpr unsigned firstChecksummedVersion = 5;
+
+    /** @brief Length of a checksummed file's header: magic, version, next assignment ID, next classroom ID and their CRC-32. */
+    inline constexpr size_t fileHeaderBytes = 5 * sizeof(unsigned);
+
+    /** @brief Length of the frame before each record of a checksummed section: the record's length and CRC-32. */
+    inline constexpr size_t recordFrameBytes = 2 * sizeof(unsigned);
+
+    /**
+     * @brief Sections of a checksummed data file, in file order; each value spells its tag in ASCII.
+     */
+    enum class SectionTag : unsigned {
+        Administrators = 0x4E4D4441,    ///< "ADMN"
+        Students = 0x44555453,          ///< "STUD"
+        Teachers = 0x52484354,          ///< "TCHR"
+        ChangeLog = 0x474F4C43          ///< "CLOG"
+    };
+
+    /** @brief Every section of a checksummed data file, in file order. */
+    inline constexpr SectionTag dataFileSections[] = {
+        SectionTag::Administrators, SectionTag::Students, SectionTag::Teachers, SectionTag::ChangeLog };
+
+    /**
+     * @brief Gets the display name of a section.
+     * @param tag Section to name.
+     * @return "administrators", "students", "teachers" or "change log".
+     */
+    const char* sectionName(SectionTag tag);
+
+    /**
+     * @brief Start of one section of a checksummed data file.
+     *
+     * The administrator, student and teacher sections hold count records,
+     * each behind a record frame; the change log section is one unframed
+     * block, empty if there is no change log.
+     */
+    struct SectionHeader {
+        SectionTag tag = SectionTag::Administrators;    ///< Which section this is
+        unsigned count = 0;                             ///< Records in the body
+        unsigned long long bytes = 0;                   ///< Length of the body
+        unsigned crc = 0;                               ///< CRC-32 of the body
+    };
+
+    /** @brief Length of an encoded section header: tag, count, body length, body CRC-32 and a CRC-32 of those. */
+    inline constexpr size_t sectionHeaderBytes = 4 * sizeof(unsigned) + sizeof(unsigned long long);
+
+    /**
+     * @brief Encodes a section header, followed by a CRC-32 of its fields.
+     * @param out Destination; sectionHeaderBytes are written.
+     * @param header Header to encode.
+     */
+    void writeSectionHeader(char* out, const SectionHeader& header);
+
+    /**
+     * @brief Decodes a section header and checks its CRC-32.
+     * @param data Start of the header; sectionHeaderBytes must be readable.
+     * @param header Receives the fields.
+     * @return False if the header's CRC does not match its fields.
+     */
+    bool readSectionHeader(const char* data, SectionHeader& header);
+
+    /**
+     * @brief How hard autosave works to get each change onto stable storage.
+     */
+    enum class DurabilityMode {
+        Fast,       ///< Atomic replace without fsync; survives a crash of the program, not of the machine
+        Grouped,    ///< Changes within a window share one fsync on a background thread
+        Strict      ///< Every change is fsynced before the menu continues
+    };
+
+    /**
+     * @brief Gets the display name of a durability mode.
+     * @param mode The mode to name.
+     * @return "Fast", "Grouped" or "Strict".
+     */
+    const char* durabilityModeName(DurabilityMode mode);
+
+    /**
+     * @class GroupCommitter
+     * @brief Batches snapshots of a file and makes each batch durable with one fsync.
+     *
+     * Callers hand over fully encoded snapshots. Only the newest snapshot is
+     * kept; it is committed once the window since the first uncommitted
+     * change has elapsed or once enough changes have piled up, whichever
+     * comes first. Commits run on a background thread, so a caller only pays
+     * for encoding; a file named "*.gz" is also gzipped there.
+     */
+    class GroupCommitter {
+    public:
+        /**
+         * @brief Writes and fsyncs one batch in place of the default atomic replace.
+         *
+         * Runs on the commit thread and may replace the snapshot it is given.
+         * Returns false if the batch could not be written, having printed why.
+         */
+        using CommitFunction = std::function<bool(ByteBuffer& snapshot)>;
+
+    private:
+        std::string filename;                               ///< File the snapshots replace
+        CommitFunction commitBatch;                         ///< Writes a batch; empty for the default atomic replace
+        std::chrono::milliseconds window{ 250 };            ///< Longest a change waits for its commit
+        unsigned maxChanges = 8;                            ///< Changes that force a commit before the window ends
+
+        std::mutex mutex;                                   ///< Guards every field below
+        std::condition_variable wake;                       ///< Signals the worker about new work or a flush
+        std::condition_variable drained;                    ///< Signals flush() that nothing is left to commit
+        ByteBuffer pending;                                 ///< Newest snapshot not yet committed
+        bool hasPending = false;                            ///< True while pending holds a snapshot
+        unsigned pendingChanges = 0;                        ///< Changes folded into pending
+        std::chrono::steady_clock::time_point firstPendingAt; ///< When the oldest uncommitted change arrived
+        bool committing = false;                            ///< True while the worker is writing a batch
+        bool flushRequested = false;                        ///< True while a caller waits in flush()
+        bool stopping = false;                              ///< Set by the destructor
+        unsigned long long commits = 0;                     ///< Number of fsynced batches
+        unsigned long long changes = 0;                     ///< Number of snapshots submitted
+        std::thread worker;                                 ///< Background commit thread
+
+        /**
+         * @brief Worker loop: waits for a batch to close, then writes and fsyncs it.
+         */
+        void run();
+
+    public:
+        /**
+         * @brief Starts the commit thread for a file.
+         * @param target Path of the file the snapshots replace.
+         * @param commit Writes each batch; empty to replace the file atomically.
+         */
+        explicit GroupCommitter(std::string target, CommitFunction commit = nullptr);
+
+        /**
+         * @brief Commits anything still pending and stops the thread.
+         */
+        ~GroupCommitter();
+
+        GroupCommitter(const GroupCommitter&) = delete;
+        GroupCommitter& operator=(const GroupCommitter&) = delete;
+
+        /**
+         * @brief Changes the batching policy.
+         * @param batchWindow Longest a change may wait before it is committed.
+         * @param batchChanges Number of changes that closes a batch early.
+         */
+        void setPolicy(std::chrono::milliseconds batchWindow, unsigned batchChanges);
+
+        /**
+         * @brief Queues a snapshot, replacing any older one still waiting.
+         * @param snapshot Complete encoded contents of the file.
+         */
+        void submit(ByteBuffer snapshot);
+
+        /**
+         * @brief Commits whatever is pending now and waits until it is durable.
+         */
+        void flush();
+
+        /**
+         * @brief Gets the number of batches committed so far.
+         * @return Commit count.
+         */
+        unsigned long long getCommitCount();
+
+        /**
+         * @brief Gets the number of snapshots submitted so far.
+         * @return Change count.
+         */
+        unsigned long long getChangeCount();
+    };
+
+    /**
+     * @brief Gets the number of items in each range when count items are split across workers.
+     * @param count Number of items.
+     * @param workers Number of ranges.
+     * @return Items per range; the last range may be shorter.
+     */
+    inline size_t rangeStride(size_t count, unsigned workers) {
+        return workers <= 1 ? count : (count + workers - 1) / workers;
+    }
+
+    /**
+     * @brief Splits [0, count) into one contiguous range per worker and runs them on threads.
+     *
+     * The calling thread takes the first range itself. If any range throws,
+     * the first exception is rethrown after every worker has been joined.
+     *
+     * @tparam Fn Callable taking (worker index, first index, end index).
+     * @param count Number of items to process.
+     * @param workers Number of ranges to split into.
+     * @param fn Work to run on each range.
+     */
+    template <typename Fn>
+    void parallelForRanges(size_t count, unsigned workers, Fn fn) {
+        if (workers <= 1 || count <= 1) {
+            fn(0u, size_t{ 0 }, count);
+            return;
+        }
+
+        size_t stride = rangeStride(count, workers);
+        std::vector<std::exception_ptr> errors(workers);
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+
+        auto runRange = [&](unsigned w) {
+            size_t first = std::min(count, w * stride);
+            size_t last = std::min(count, first + stride);
+            try {
+                fn(w, first, last);
+            }
+            catch (...) {
+                errors[w] = std::current_exception();
+            }
+            };
+
+        for (unsigned w = 1; w < workers; ++w) {
+            threads.emplace_back(runRange, w);
+        }
+        runRange(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+}
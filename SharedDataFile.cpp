@@ -0,0 +1,430 @@
+#include "SharedDataFile.h"
+#include "Compression.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace gradebook {
+
+    namespace {
+        /** How long a watcher waits between checks of its stop flag or the file's stamp. */
+        constexpr std::chrono::milliseconds watchInterval{ 250 };
+
+        /** How often a file is polled when the OS cannot report changes. */
+        constexpr std::chrono::milliseconds pollInterval{ 1000 };
+
+        /**
+         * @brief Gets the directory a file lives in.
+         * @param filename File path.
+         * @return Its parent directory, or "." for a bare file name.
+         */
+        std::string parentDirectory(const std::string& filename) {
+            std::filesystem::path parent = std::filesystem::path(filename).parent_path();
+            return parent.empty() ? std::string(".") : parent.string();
+        }
+    }
+
+    /**
+     * @brief Reads a file's stamp.
+     * @param filename File to look at.
+     * @return Its stamp; exists is false if there is no such file.
+     */
+    FileStamp readFileStamp(const std::string& filename) {
+        FileStamp stamp;
+        std::error_code error;
+        auto modified = std::filesystem::last_write_time(filename, error);
+        if (error) {
+            return stamp;
+        }
+        stamp.exists = true;
+        stamp.modified = static_cast<long long>(modified.time_since_epoch().count());
+        stamp.size = std::filesystem::file_size(filename, error);
+#ifndef _WIN32
+        struct stat info;
+        if (::stat(filename.c_str(), &info) == 0) {
+            stamp.file = static_cast<unsigned long long>(info.st_ino);
+        }
+#endif
+        return stamp;
+    }
+
+    /**
+     * @brief Reads a data file, decompressing it if it holds gzip data.
+     * @param filename Data file to read.
+     * @param contents Receives the uncompressed contents.
+     * @param error Receives what was wrong if the file could not be read.
+     * @return True if the contents were read.
+     */
+    bool readDataFile(const std::string& filename, std::vector<char>& contents, std::string& error) {
+        if (!readWholeFile(filename, contents)) {
+            error = "the file could not be read";
+            return false;
+        }
+        // Compressed snapshots are recognised by content, whatever the file is called.
+        if (isGzipData(contents.data(), contents.size())) {
+            std::vector<char> decompressed;
+            if (!gzipDecompress(contents.data(), contents.size(), decompressed, error)) {
+                return false;
+            }
+            contents = std::move(decompressed);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Replaces a data file with a snapshot, gzipping it first if the file is named "*.gz".
+     * @param filename Data file.
+     * @param snapshot Encoded snapshot.
+     * @param sync If true, make the new file durable before returning.
+     * @return True if the new contents are in place.
+     */
+    bool writeDataFile(const std::string& filename, const ByteBuffer& snapshot, bool sync) {
+        if (hasGzipExtension(filename)) {
+            ByteBuffer compressed = gzipCompress(snapshot.data.get(), snapshot.size);
+            return writeFileAtomically(filename, compressed.data.get(), compressed.size, sync);
+        }
+        return writeFileAtomically(filename, snapshot.data.get(), snapshot.size, sync);
+    }
+
+    // === FileLock ===
+
+    /**
+     * @brief Waits for and takes the lock of a data file.
+     * @param filename Data file to lock.
+     */
+    FileLock::FileLock(const std::string& filename) {
+        std::string lockFile = filename + ".lock";
+#ifdef _WIN32
+        HANDLE file = CreateFileA(lockFile.c_str(), GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        handle = file;
+        OVERLAPPED whole = {};
+        locked = LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &whole) != 0;
+#else
+        fd = ::open(lockFile.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return;
+        }
+        int status;
+        do {
+            status = ::flock(fd, LOCK_EX);
+        } while (status != 0 && errno == EINTR);
+        locked = status == 0;
+#endif
+    }
+
+    /**
+     * @brief Releases the lock.
+     *
+     * The lock file itself stays: removing it would let a waiting writer
+     * lock a file that a newcomer no longer sees.
+     */
+    FileLock::~FileLock() {
+#ifdef _WIN32
+        if (handle) {
+            if (locked) {
+                OVERLAPPED whole = {};
+                UnlockFileEx(handle, 0, 1, 0, &whole);
+            }
+            CloseHandle(handle);
+        }
+#else
+        if (fd >= 0) {
+            if (locked) {
+                ::flock(fd, LOCK_UN);
+            }
+            ::close(fd);
+        }
+#endif
+    }
+
+    /**
+     * @brief Checks whether the lock was taken.
+     * @return False if the lock file could not be opened or locked.
+     */
+    bool FileLock::isLocked() const {
+        return locked;
+    }
+
+    // === DataFileWatcher ===
+
+    /**
+     * @brief Starts watching a file.
+     * @param target File to watch.
+     */
+    DataFileWatcher::DataFileWatcher(std::string target)
+        : filename(std::move(target)) {
+        worker = std::thread(&DataFileWatcher::run, this);
+    }
+
+    /**
+     * @brief Stops the watching thread.
+     */
+    DataFileWatcher::~DataFileWatcher() {
+        stopping = true;
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Checks for and clears the changed flag.
+     * @return True if the file may have been replaced since the last call.
+     */
+    bool DataFileWatcher::takeChange() {
+        return changed.exchange(false);
+    }
+
+    /**
+     * @brief Thread body: waits for OS notifications, or polls if there are none.
+     */
+    void DataFileWatcher::run() {
+        if (!watchNotifications()) {
+            pollStamps();
+        }
+    }
+
+    /**
+     * @brief Waits for OS notifications about the file's directory.
+     *
+     * The directory is watched rather than the file, since every save
+     * renames a new file into place. inotify names the file each event is
+     * about; a Windows notification covers the whole directory, so the
+     * file's stamp is compared to pick out its changes.
+     *
+     * @return False if notifications could not be set up or stopped working.
+     */
+    bool DataFileWatcher::watchNotifications() {
+        std::string directory = parentDirectory(filename);
+#if defined(__linux__)
+        int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        if (::inotify_add_watch(fd, directory.c_str(), IN_MOVED_TO | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE) < 0) {
+            ::close(fd);
+            return false;
+        }
+
+        std::string name = std::filesystem::path(filename).filename().string();
+        alignas(inotify_event) char events[4096];
+        while (!stopping) {
+            pollfd ready = { fd, POLLIN, 0 };
+            if (::poll(&ready, 1, static_cast<int>(watchInterval.count())) <= 0) {
+                continue;
+            }
+            ssize_t length;
+            while ((length = ::read(fd, events, sizeof(events))) > 0) {
+                for (char* at = events; at < events + length; ) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(at);
+                    if (event->len > 0 && name == event->name) {
+                        changed = true;
+                    }
+                    at += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+        ::close(fd);
+        return true;
+#elif defined(_WIN32)
+        HANDLE change = FindFirstChangeNotificationA(directory.c_str(), FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE);
+        if (change == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        FileStamp last = readFileStamp(filename);
+        while (!stopping) {
+            if (WaitForSingleObject(change, static_cast<DWORD>(watchInterval.count())) != WAIT_OBJECT_0) {
+                continue;
+            }
+            FileStamp now = readFileStamp(filename);
+            if (now != last) {
+                last = now;
+                changed = true;
+            }
+            if (!FindNextChangeNotification(change)) {
+                break;
+            }
+        }
+        FindCloseChangeNotification(change);
+        // Notifications that stopped working hand over to polling.
+        return stopping;
+#else
+        (void)directory;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Compares the file's stamp once a second until stopped.
+     */
+    void DataFileWatcher::pollStamps() {
+        FileStamp last = readFileStamp(filename);
+        auto nextCheck = std::chrono::steady_clock::now() + pollInterval;
+        while (!stopping) {
+            std::this_thread::sleep_for(watchInterval);
+            if (std::chrono::steady_clock::now() < nextCheck) {
+                continue;
+            }
+            nextCheck += pollInterval;
+
+            FileStamp now = readFileStamp(filename);
+            if (now != last) {
+                last = now;
+                changed = true;
+            }
+        }
+    }
+
+    // === SharedDataFile ===
+
+    /**
+     * @brief Starts sharing a data file.
+     * @param target Data file.
+     * @param watch True to watch the file for other sessions' commits.
+     */
+    SharedDataFile::SharedDataFile(std::string target, bool watch)
+        : filename(std::move(target)) {
+        if (watch) {
+            watcher = std::make_unique<DataFileWatcher>(filename);
+        }
+    }
+
+    /**
+     * @brief Writes a snapshot under the file lock, first merging in anything another session committed.
+     *
+     * A merged snapshot holds changes the session has not taken in, so the
+     * base stays as it was and the session is marked behind until it takes
+     * the file in; an unmerged snapshot becomes the new base.
+     *
+     * @param snapshot Encoded session; replaced by the merged snapshot if a merge was needed.
+     * @param sync If true, make the new file durable before returning.
+     * @param merge Merges another session's file into the snapshot.
+     * @return False if the file could not be locked, merged or written; a message has been printed.
+     */
+    bool SharedDataFile::commit(ByteBuffer& snapshot, bool sync, const MergeFunction& merge) {
+        std::lock_guard<std::mutex> guard(mutex);
+        FileLock lock(filename);
+        if (!lock.isLocked()) {
+            std::cerr << "Failed to lock " << filename << " for writing.\n";
+            return false;
+        }
+
+        bool merged = false;
+        FileStamp now = readFileStamp(filename);
+        // Without a base this session never read the file, and saving replaces it as before.
+        if (now.exists && !base.empty() && (behind || now != seen)) {
+            std::vector<char> current;
+            std::string error;
+            if (!readDataFile(filename, current, error)) {
+                std::cerr << "Failed to read " << filename << " before saving: " << error << ".\n";
+                return false;
+            }
+            if (current != base) {
+                if (!merge(snapshot, current, base)) {
+                    return false;
+                }
+                merged = true;
+            }
+        }
+
+        if (!writeDataFile(filename, snapshot, sync)) {
+            std::cerr << "Failed to write " << filename << ".\n";
+            return false;
+        }
+
+        seen = readFileStamp(filename);
+        if (merged) {
+            behind = true;
+        }
+        else {
+            base.assign(snapshot.data.get(), snapshot.data.get() + snapshot.size);
+            behind = false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads the file under the lock and has the session take it in.
+     * @param apply Takes the contents in.
+     * @param onlyIfChanged True to skip the read when no other session has committed.
+     * @return True if the contents were taken in; the base then becomes those contents.
+     */
+    bool SharedDataFile::take(const TakeFunction& apply, bool onlyIfChanged) {
+        std::lock_guard<std::mutex> guard(mutex);
+        // Holding the lock keeps the stamp and the contents from different commits.
+        FileLock lock(filename);
+        if (!lock.isLocked()) {
+            std::cerr << "Failed to lock " << filename << " for reading.\n";
+            return false;
+        }
+
+        FileStamp now = readFileStamp(filename);
+        if (onlyIfChanged && (!now.exists || (!behind && now == seen))) {
+            return false;
+        }
+
+        std::vector<char> current;
+        std::string error;
+        if (!readDataFile(filename, current, error)) {
+            std::cerr << "Failed to load " << filename << ": " << error << ".\n";
+            return false;
+        }
+        if (onlyIfChanged && current == base) {
+            seen = now;
+            behind = false;
+            return false;
+        }
+        if (!apply(current, base)) {
+            return false;
+        }
+
+        base = std::move(current);
+        seen = now;
+        behind = false;
+        return true;
+    }
+
+    /**
+     * @brief Checks cheaply whether another session may have committed.
+     * @return True if take() may find changes.
+     */
+    bool SharedDataFile::hasNewerCommit() {
+        bool watched = watcher && watcher->takeChange();
+        std::lock_guard<std::mutex> guard(mutex);
+        if (behind || watched) {
+            return true;
+        }
+        return !watcher && readFileStamp(filename) != seen;
+    }
+
+    /**
+     * @brief Checks whether other sessions' commits are being watched for.
+     * @return True if a watcher is running.
+     */
+    bool SharedDataFile::isWatching() const {
+        return watcher != nullptr;
+    }
+}
@@ -0,0 +1,228 @@
+#pragma once
+#include "Serialization.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gradebook {
+
+    /**
+     * @brief Identifies one version of a file without reading it.
+     *
+     * Every save replaces the file by renaming a new one over it, so on
+     * POSIX the inode changes with each commit; on Windows the size and
+     * modification time tell versions apart.
+     */
+    struct FileStamp {
+        bool exists = false;            /**< False if there was no file */
+        unsigned long long file = 0;    /**< Inode number; 0 on Windows */
+        unsigned long long size = 0;    /**< Length in bytes */
+        long long modified = 0;         /**< Last write time in file clock ticks */
+
+        bool operator==(const FileStamp& other) const = default;
+    };
+
+    /**
+     * @brief Reads a file's stamp.
+     * @param filename File to look at.
+     * @return Its stamp; exists is false if there is no such file.
+     */
+    FileStamp readFileStamp(const std::string& filename);
+
+    /**
+     * @brief Reads a data file, decompressing it if it holds gzip data.
+     * @param filename Data file to read.
+     * @param contents Receives the uncompressed contents.
+     * @param error Receives what was wrong if the file could not be read.
+     * @return True if the contents were read.
+     */
+    bool readDataFile(const std::string& filename, std::vector<char>& contents, std::string& error);
+
+    /**
+     * @brief Replaces a data file with a snapshot, gzipping it first if the file is named "*.gz".
+     * @param filename Data file.
+     * @param snapshot Encoded snapshot.
+     * @param sync If true, make the new file durable before returning.
+     * @return True if the new contents are in place.
+     */
+    bool writeDataFile(const std::string& filename, const ByteBuffer& snapshot, bool sync);
+
+    /**
+     * @class FileLock
+     * @brief Holds an exclusive advisory lock on a data file while it is rewritten.
+     *
+     * The lock is taken on "<file>.lock" rather than the data file itself,
+     * because saving renames a new file over the data file. It is held with
+     * flock on POSIX and LockFileEx on Windows, so every writer using it,
+     * in this process or another, waits its turn. Readers need no lock:
+     * the data file is always replaced whole.
+     */
+    class FileLock {
+    private:
+#ifdef _WIN32
+        void* handle = nullptr;     /**< Lock file handle */
+#else
+        int fd = -1;                /**< Lock file descriptor */
+#endif
+        bool locked = false;        /**< True once the lock is held */
+
+    public:
+        /**
+         * @brief Waits for and takes the lock of a data file.
+         * @param filename Data file to lock.
+         */
+        explicit FileLock(const std::string& filename);
+
+        /**
+         * @brief Releases the lock.
+         */
+        ~FileLock();
+
+        FileLock(const FileLock&) = delete;
+        FileLock& operator=(const FileLock&) = delete;
+
+        /**
+         * @brief Checks whether the lock was taken.
+         * @return False if the lock file could not be opened or locked.
+         */
+        bool isLocked() const;
+    };
+
+    /**
+     * @class DataFileWatcher
+     * @brief Notices on a background thread when a data file is replaced.
+     *
+     * Watches the file's directory with inotify on Linux and a change
+     * notification on Windows; elsewhere, or if those cannot be set up,
+     * the file's stamp is polled once a second. The watcher only raises a
+     * flag; whoever owns the session decides when to act on it.
+     */
+    class DataFileWatcher {
+    private:
+        std::string filename;                   /**< File being watched */
+        std::atomic<bool> changed{ false };     /**< Set when the file may have been replaced */
+        std::atomic<bool> stopping{ false };    /**< Set by the destructor */
+        std::thread worker;                     /**< Watching thread */
+
+        /**
+         * @brief Thread body: waits for OS notifications, or polls if there are none.
+         */
+        void run();
+
+        /**
+         * @brief Waits for OS notifications about the file's directory.
+         * @return False if notifications could not be set up or stopped working.
+         */
+        bool watchNotifications();
+
+        /**
+         * @brief Compares the file's stamp once a second until stopped.
+         */
+        void pollStamps();
+
+    public:
+        /**
+         * @brief Starts watching a file.
+         * @param target File to watch.
+         */
+        explicit DataFileWatcher(std::string target);
+
+        /**
+         * @brief Stops the watching thread.
+         */
+        ~DataFileWatcher();
+
+        DataFileWatcher(const DataFileWatcher&) = delete;
+        DataFileWatcher& operator=(const DataFileWatcher&) = delete;
+
+        /**
+         * @brief Checks for and clears the changed flag.
+         * @return True if the file may have been replaced since the last call.
+         */
+        bool takeChange();
+    };
+
+    /**
+     * @class SharedDataFile
+     * @brief Lets several sessions, in one process or many, save to one data file without losing each other's work.
+     *
+     * Remembers the contents this session last took in from the file (its
+     * base) and the stamp the file had when this session last read or
+     * wrote it. A commit takes the file lock and, if the stamp shows that
+     * another session committed in between, merges that session's file
+     * into the snapshot against the base before writing, so neither
+     * session's changes are lost. The session itself takes in the other
+     * session's changes later, at a point of its own choosing, with take().
+     */
+    class SharedDataFile {
+    public:
+        /**
+         * @brief Merges the file another session committed into a snapshot about to be written.
+         *
+         * Called with the snapshot, the file's current contents and the
+         * base. Replaces the snapshot; returns false if the merge failed.
+         */
+        using MergeFunction = std::function<bool(ByteBuffer& snapshot, const std::vector<char>& current, const std::vector<char>& base)>;
+
+        /**
+         * @brief Takes the file's current contents into the session.
+         *
+         * Called with the current contents and the base, which is empty if
+         * the session has not read the file before. Returns false if the
+         * contents could not be taken in.
+         */
+        using TakeFunction = std::function<bool(const std::vector<char>& current, const std::vector<char>& base)>;
+
+    private:
+        std::string filename;                       /**< Data file */
+        std::mutex mutex;                           /**< Serialises this process's commits and takes */
+        std::vector<char> base;                     /**< Contents the session last took in or wrote unmerged */
+        FileStamp seen;                             /**< File's stamp after this session last read or wrote it */
+        bool behind = false;                        /**< True if the file holds merged changes the session has not taken in */
+        std::unique_ptr<DataFileWatcher> watcher;   /**< Notices other sessions' commits, if watching */
+
+    public:
+        /**
+         * @brief Starts sharing a data file.
+         * @param target Data file.
+         * @param watch True to watch the file for other sessions' commits.
+         */
+        SharedDataFile(std::string target, bool watch);
+
+        /**
+         * @brief Writes a snapshot under the file lock, first merging in anything another session committed.
+         * @param snapshot Encoded session; replaced by the merged snapshot if a merge was needed.
+         * @param sync If true, make the new file durable before returning.
+         * @param merge Merges another session's file into the snapshot.
+         * @return False if the file could not be locked, merged or written; a message has been printed.
+         */
+        bool commit(ByteBuffer& snapshot, bool sync, const MergeFunction& merge);
+
+        /**
+         * @brief Reads the file under the lock and has the session take it in.
+         * @param apply Takes the contents in.
+         * @param onlyIfChanged True to skip the read when no other session has committed.
+         * @return True if the contents were taken in; the base then becomes those contents.
+         */
+        bool take(const TakeFunction& apply, bool onlyIfChanged);
+
+        /**
+         * @brief Checks cheaply whether another session may have committed.
+         *
+         * Without a watcher the file's stamp is compared directly.
+         *
+         * @return True if take() may find changes.
+         */
+        bool hasNewerCommit();
+
+        /**
+         * @brief Checks whether other sessions' commits are being watched for.
+         * @return True if a watcher is running.
+         */
+        bool isWatching() const;
+    };
+}
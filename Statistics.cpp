@@ -0,0 +1,435 @@
+#include "Statistics.h"
+#include "Compression.h"
+#include "Gradebook.h"
+#include "Student.h"
+#include "Teacher.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+namespace gradebook {
+
+    // === RunningStats ===
+
+    /**
+     * @brief Folds a new value into the accumulator using Welford's update.
+     * @param value The value to add.
+     */
+    void RunningStats::add(double value) {
+        ++count;
+        if (count == 1) {
+            min = max = value;
+        }
+        else {
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+    }
+
+    /**
+     * @brief Folds another accumulator into this one with Chan's pairwise update.
+     * @param other Accumulator built from a disjoint set of values.
+     */
+    void RunningStats::merge(const RunningStats& other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+
+        size_t combined = count + other.count;
+        double delta = other.mean - mean;
+        double otherWeight = static_cast<double>(other.count) / static_cast<double>(combined);
+        mean += delta * otherWeight;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * otherWeight;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        count = combined;
+    }
+
+    /**
+     * @brief Gets the population variance of the values seen so far.
+     * @return Variance, or 0 when fewer than two values were added.
+     */
+    double RunningStats::variance() const {
+        return count > 1 ? m2 / static_cast<double>(count) : 0.0;
+    }
+
+    /**
+     * @brief Gets the population standard deviation.
+     * @return Standard deviation, or 0 when fewer than two values were added.
+     */
+    double RunningStats::stddev() const {
+        return std::sqrt(variance());
+    }
+
+    // === Histogram ===
+
+    /**
+     * @brief Adds a percentage to its 10% bucket; 100% lands in the top bucket.
+     * @param percent The percentage to add.
+     */
+    void Histogram::add(double percent) {
+        double clamped = std::clamp(percent, 0.0, 100.0);
+        size_t bucket = std::min(static_cast<size_t>(clamped / 10.0), bucketCount - 1);
+        ++buckets[bucket];
+    }
+
+    /**
+     * @brief Adds another histogram's counts to this one.
+     * @param other The histogram to add.
+     */
+    void Histogram::merge(const Histogram& other) {
+        for (size_t b = 0; b < bucketCount; ++b) {
+            buckets[b] += other.buckets[b];
+        }
+    }
+
+    /**
+     * @brief Gets the display label of a bucket.
+     * @param bucket Index of the bucket.
+     * @return The label string (e.g., "0-9" or "90-100").
+     */
+    std::string Histogram::label(size_t bucket) {
+        unsigned low = static_cast<unsigned>(bucket * 10);
+        unsigned high = (bucket + 1 == bucketCount) ? 100 : low + 9;
+        return std::to_string(low) + "-" + std::to_string(high);
+    }
+
+    // === Distribution ===
+
+    /**
+     * @brief Adds a percentage to the running stats, the histogram and the sample buffer.
+     * @param percent The percentage to add.
+     */
+    void Distribution::add(float percent) {
+        stats.add(percent);
+        histogram.add(percent);
+        samples.push_back(percent);
+    }
+
+    /**
+     * @brief Folds another unfinalized distribution into this one.
+     * @param other Distribution built from a disjoint set of values.
+     */
+    void Distribution::merge(const Distribution& other) {
+        stats.merge(other.stats);
+        histogram.merge(other.histogram);
+        samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+    }
+
+    namespace {
+        /**
+         * @brief Selects an interpolated quantile in linear time with nth_element.
+         * @param values Samples to select from; reordered in place.
+         * @param q Quantile in [0, 1].
+         * @return The quantile value.
+         */
+        double selectQuantile(std::vector<float>& values, double q) {
+            double position = q * static_cast<double>(values.size() - 1);
+            size_t lowIndex = static_cast<size_t>(position);
+            double fraction = position - static_cast<double>(lowIndex);
+
+            std::nth_element(values.begin(), values.begin() + lowIndex, values.end());
+            double low = values[lowIndex];
+            if (fraction == 0.0 || lowIndex + 1 >= values.size()) {
+                return low;
+            }
+
+            // Everything after lowIndex is >= low, so the next order statistic is its minimum.
+            double high = *std::min_element(values.begin() + lowIndex + 1, values.end());
+            return low + fraction * (high - low);
+        }
+    }
+
+    /**
+     * @brief Computes quartiles with nth_element and releases the samples.
+     */
+    void Distribution::finalize() {
+        if (!samples.empty()) {
+            median = selectQuantile(samples, 0.50);
+            q1 = selectQuantile(samples, 0.25);
+            q3 = selectQuantile(samples, 0.75);
+        }
+        samples.clear();
+        samples.shrink_to_fit();
+    }
+
+    // === Computation ===
+
+    namespace {
+        /**
+         * @brief Adds every graded student's overall grade once, by grade level.
+         *
+         * Reads the gradebook's contiguous record array; students with no
+         * graded classroom yet are left out rather than counted as 0%.
+         *
+         * @param gradebook Gradebook whose students are measured.
+         * @param gradeLevels Grade-level distributions to feed, keyed by grade.
+         * @param school Optional school-wide distribution to feed as well.
+         */
+        void accumulateGradeLevels(const Gradebook& gradebook,
+            std::map<unsigned, Distribution>& gradeLevels, Distribution* school)
+        {
+            for (const StudentRecord& record : gradebook.getStudentRecords()) {
+                if (record.overallGrade == '\0') continue;
+
+                if (school) {
+                    school->add(record.gradePercent);
+                }
+                gradeLevels[record.gradeLevel].add(record.gradePercent);
+            }
+        }
+
+        /**
+         * @brief Adds one classroom to a report in a single pass over its roster.
+         *
+         * Students not yet graded in the classroom are left out of its
+         * distribution rather than counted as 0%.
+         *
+         * @param teacher Teacher whose classroom is measured.
+         * @param report Report receiving the classroom and assignment distributions.
+         */
+        void accumulateClassroom(const Teacher& teacher, StatisticsReport& report) {
+            const auto& assignments = teacher.getAssignments();
+            std::string teacherLabel = teacher.getTitle() + " " + teacher.getLastName();
+
+            Distribution classroom;
+            classroom.scope = "Classroom";
+            classroom.label = teacherLabel + " (Grade " + std::to_string(teacher.getGradeLevel()) + ")";
+
+            size_t firstAssignment = report.assignments.size();
+            for (const auto& a : assignments) {
+                Distribution d;
+                d.scope = "Assignment";
+                d.label = teacherLabel + ": " + a.getAssignmentName();
+                report.assignments.push_back(std::move(d));
+            }
+
+            for (const Student* s : teacher.getClassroomStudents()) {
+                if (!s) continue;
+
+                if (s->getClassroomGrade(teacher.getClassroomID()) != '\0') {
+                    classroom.add(s->getClassroomGradePercent(teacher.getClassroomID()));
+                }
+
+                for (size_t i = 0; i < assignments.size(); ++i) {
+                    float possible = assignments[i].getPointsPossible();
+                    auto score = s->getAssignmentScore(teacher.getClassroomID(), assignments[i].getAssignmentID());
+                    if (score && possible > 0.0f) {
+                        report.assignments[firstAssignment + i].add(*score / possible * 100.0f);
+                    }
+                }
+            }
+
+            report.classrooms.push_back(std::move(classroom));
+        }
+
+        /**
+         * @brief Finalizes every distribution in a report.
+         * @param report The report to finalize.
+         */
+        void finalizeReport(StatisticsReport& report) {
+            for (auto* group : { &report.assignments, &report.classrooms, &report.gradeLevels }) {
+                for (auto& d : *group) {
+                    d.finalize();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Computes per-assignment and overall distributions for one classroom.
+     * @param teacher The teacher whose classroom is measured.
+     * @return The finalized report.
+     */
+    StatisticsReport computeClassroomStatistics(const Teacher& teacher) {
+        StatisticsReport report;
+        accumulateClassroom(teacher, report);
+        finalizeReport(report);
+        return report;
+    }
+
+    /**
+     * @brief Computes school-wide distributions in one pass over every classroom and one over the student records.
+     * @param gradebook The gradebook to measure.
+     * @return The finalized report.
+     */
+    StatisticsReport computeSchoolStatistics(const Gradebook& gradebook) {
+        StatisticsReport report;
+        std::map<unsigned, Distribution> gradeLevels;
+
+        for (const auto& teacher : gradebook.getTeachers()) {
+            accumulateClassroom(teacher, report);
+        }
+        accumulateGradeLevels(gradebook, gradeLevels, nullptr);
+
+        for (auto& [grade, d] : gradeLevels) {
+            d.scope = "Grade Level";
+            d.label = "Grade " + std::to_string(grade);
+            report.gradeLevels.push_back(std::move(d));
+        }
+
+        finalizeReport(report);
+        return report;
+    }
+
+    namespace {
+        /**
+         * @brief One school's share of a district report, built on its own thread.
+         */
+        struct SchoolPartial {
+            Distribution school;                        /**< Finalized overall-grade distribution */
+            std::map<unsigned, Distribution> gradeLevels; /**< Unfinalized, so they can still be merged */
+        };
+
+        /**
+         * @brief Measures one school for a district report.
+         * @param name Display name of the school.
+         * @param gradebook The school's gradebook; only this thread touches it.
+         * @return The school's partial report.
+         */
+        SchoolPartial measureSchool(const std::string& name, const Gradebook& gradebook) {
+            SchoolPartial partial;
+            partial.school.scope = "School";
+            partial.school.label = name;
+
+            accumulateGradeLevels(gradebook, partial.gradeLevels, &partial.school);
+            partial.school.finalize();
+            return partial;
+        }
+    }
+
+    /**
+     * @brief Computes overall-grade distributions per school and per grade level across a district.
+     * @param schools Each school's display name and gradebook.
+     * @return The finalized report.
+     */
+    StatisticsReport computeDistrictStatistics(const std::vector<std::pair<std::string, const Gradebook*>>& schools) {
+        std::vector<std::future<SchoolPartial>> pending;
+        pending.reserve(schools.size());
+        for (const auto& [name, gradebook] : schools) {
+            pending.push_back(std::async(std::launch::async, measureSchool, std::cref(name), std::cref(*gradebook)));
+        }
+
+        StatisticsReport report;
+        std::map<unsigned, Distribution> gradeLevels;
+        for (auto& future : pending) {
+            SchoolPartial partial = future.get();
+            report.schools.push_back(std::move(partial.school));
+            for (auto& [grade, d] : partial.gradeLevels) {
+                gradeLevels[grade].merge(d);
+            }
+        }
+
+        for (auto& [grade, d] : gradeLevels) {
+            d.scope = "Grade Level";
+            d.label = "Grade " + std::to_string(grade);
+            d.finalize();
+            report.gradeLevels.push_back(std::move(d));
+        }
+        return report;
+    }
+
+    // === Output ===
+
+    /**
+     * @brief Prints every distribution in a report as a table with histograms.
+     * @param report The report to print.
+     */
+    void printStatistics(const StatisticsReport& report) {
+        auto printGroup = [](const std::string& heading, const std::vector<Distribution>& group) {
+            if (group.empty()) return;
+
+            std::cout << "\n=== " << heading << " ===\n";
+            std::cout << std::left << std::setw(32) << "Label" << std::right
+                << std::setw(7) << "Count"
+                << std::setw(9) << "Mean"
+                << std::setw(9) << "StdDev"
+                << std::setw(9) << "Min"
+                << std::setw(9) << "Q1"
+                << std::setw(9) << "Median"
+                << std::setw(9) << "Q3"
+                << std::setw(9) << "Max" << "\n";
+            std::cout << std::string(102, '-') << "\n";
+
+            for (const auto& d : group) {
+                std::cout << std::left << std::setw(32) << d.label << std::right
+                    << std::setw(7) << d.stats.count;
+                if (d.stats.count == 0) {
+                    std::cout << "   No scores recorded.\n";
+                    continue;
+                }
+                std::cout << std::fixed << std::setprecision(2)
+                    << std::setw(9) << d.stats.mean
+                    << std::setw(9) << d.stats.stddev()
+                    << std::setw(9) << d.stats.min
+                    << std::setw(9) << d.q1
+                    << std::setw(9) << d.median
+                    << std::setw(9) << d.q3
+                    << std::setw(9) << d.stats.max << "\n";
+
+                std::cout << "    Histogram:";
+                for (size_t b = 0; b < Histogram::bucketCount; ++b) {
+                    std::cout << " " << Histogram::label(b) << "%:" << d.histogram.buckets[b];
+                }
+                std::cout << "\n";
+            }
+            std::cout << std::left;
+            };
+
+        printGroup("Assignments (% of points possible)", report.assignments);
+        printGroup("Classrooms (grade %)", report.classrooms);
+        printGroup("Grade Levels (grade %)", report.gradeLevels);
+        printGroup("Schools (overall grade %)", report.schools);
+        std::cout << std::endl;
+    }
+
+    /**
+     * @brief Exports every distribution in a report to a CSV file.
+     * @param report The report to export.
+     * @param filename Name of the CSV file to write.
+     */
+    void exportStatisticsToCSV(const StatisticsReport& report, const std::string& filename) {
+        ExportFile file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file " << filename << " for writing." << std::endl;
+            return;
+        }
+
+        file << "Scope,Label,Count,Mean,StdDev,Min,Q1,Median,Q3,Max";
+        for (size_t b = 0; b < Histogram::bucketCount; ++b) {
+            file << "," << Histogram::label(b);
+        }
+        file << "\n";
+
+        for (auto* group : { &report.assignments, &report.classrooms, &report.gradeLevels, &report.schools }) {
+            for (const auto& d : *group) {
+                file << d.scope << "," << std::quoted(d.label) << "," << d.stats.count
+                    << std::fixed << std::setprecision(2)
+                    << "," << d.stats.mean
+                    << "," << d.stats.stddev()
+                    << "," << d.stats.min
+                    << "," << d.q1
+                    << "," << d.median
+                    << "," << d.q3
+                    << "," << d.stats.max;
+                for (size_t count : d.histogram.buckets) {
+                    file << "," << count;
+                }
+                file << "\n";
+            }
+        }
+
+        file.close();
+        std::cout << "Statistics exported successfully to " << filename << std::endl;
+    }
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gradebook {
+
+    class Gradebook;
+    class Teacher;
+
+    /**
+     * @brief Streaming mean/variance accumulator using Welford's algorithm.
+     *
+     * Values are folded in one at a time without storing them, and the result
+     * stays numerically stable even for large classes.
+     */
+    struct RunningStats {
+        size_t count = 0;      /**< Number of values seen */
+        double mean = 0.0;     /**< Running mean */
+        double m2 = 0.0;       /**< Sum of squared distances from the mean */
+        double min = 0.0;      /**< Smallest value seen */
+        double max = 0.0;      /**< Largest value seen */
+
+        /**
+         * @brief Folds a new value into the accumulator.
+         * @param value The value to add.
+         */
+        void add(double value);
+
+        /**
+         * @brief Folds another accumulator's values into this one.
+         * @param other Accumulator built from a disjoint set of values.
+         */
+        void merge(const RunningStats& other);
+
+        /**
+         * @brief Gets the population variance of the values seen so far.
+         * @return Variance, or 0 when fewer than two values were added.
+         */
+        double variance() const;
+
+        /**
+         * @brief Gets the population standard deviation.
+         * @return Standard deviation, or 0 when fewer than two values were added.
+         */
+        double stddev() const;
+    };
+
+    /**
+     * @brief Fixed ten-bucket histogram over percentages (0-9, 10-19, ..., 90-100).
+     */
+    struct Histogram {
+        static constexpr size_t bucketCount = 10;     /**< Number of 10% buckets */
+        std::array<size_t, bucketCount> buckets{};    /**< Count per bucket */
+
+        /**
+         * @brief Adds a percentage to its bucket. Values outside [0, 100] are clamped.
+         * @param percent The percentage to add.
+         */
+        void add(double percent);
+
+        /**
+         * @brief Adds another histogram's counts to this one.
+         * @param other The histogram to add.
+         */
+        void merge(const Histogram& other);
+
+        /**
+         * @brief Gets the display label of a bucket (e.g., "90-100").
+         * @param bucket Index of the bucket.
+         * @return The label string.
+         */
+        static std::string label(size_t bucket);
+    };
+
+    /**
+     * @brief Distribution of percentages for one assignment, classroom or grade level.
+     */
+    struct Distribution {
+        std::string scope;             /**< "Assignment", "Classroom", "Grade Level" or "School" */
+        std::string label;             /**< Human-readable name of what was measured */
+        RunningStats stats;            /**< Streaming mean, deviation and range */
+        Histogram histogram;           /**< Fixed-bucket histogram */
+        std::vector<float> samples;    /**< Raw values kept for quantile selection */
+        double q1 = 0.0;               /**< First quartile */
+        double median = 0.0;           /**< Median */
+        double q3 = 0.0;               /**< Third quartile */
+
+        /**
+         * @brief Adds a percentage to every accumulator in the distribution.
+         * @param percent The percentage to add.
+         */
+        void add(float percent);
+
+        /**
+         * @brief Folds another distribution into this one. Both must not be finalized yet.
+         * @param other Distribution built from a disjoint set of values.
+         */
+        void merge(const Distribution& other);
+
+        /**
+         * @brief Computes quartiles with nth_element and releases the samples.
+         */
+        void finalize();
+    };
+
+    /**
+     * @brief Full set of distributions computed for a classroom, a school or a district.
+     */
+    struct StatisticsReport {
+        std::vector<Distribution> assignments;   /**< One per assignment */
+        std::vector<Distribution> classrooms;    /**< One per classroom */
+        std::vector<Distribution> gradeLevels;   /**< One per grade level present */
+        std::vector<Distribution> schools;       /**< One per school; district reports only */
+    };
+
+    /**
+     * @brief Computes per-assignment and overall distributions for one classroom.
+     * @param teacher The teacher whose classroom is measured.
+     * @return The finalized report.
+     */
+    StatisticsReport computeClassroomStatistics(const Teacher& teacher);
+
+    /**
+     * @brief Computes per-assignment, per-classroom and per-grade-level distributions
+     * for the whole school: one pass over every classroom, and grade levels from one
+     * pass over the student records, counting each graded student once.
+     * @param gradebook The gradebook to measure.
+     * @return The finalized report.
+     */
+    StatisticsReport computeSchoolStatistics(const Gradebook& gradebook);
+
+    /**
+     * @brief Computes overall-grade distributions per school and per grade level across a district.
+     *
+     * Every school is measured on its own thread with std::async; the
+     * per-school grade-level partials are then merged on the calling thread.
+     * Each student counts once, by overall grade, and students who have not
+     * been graded yet are left out.
+     *
+     * @param schools Each school's display name and gradebook.
+     * @return The finalized report.
+     */
+    StatisticsReport computeDistrictStatistics(const std::vector<std::pair<std::string, const Gradebook*>>& schools);
+
+    /**
+     * @brief Prints every distribution in a report as a table with histograms.
+     * @param report The report to print.
+     */
+    void printStatistics(const StatisticsReport& report);
+
+    /**
+     * @brief Exports every distribution in a report to a CSV file.
+     * @param report The report to export.
+     * @param filename Name of the CSV file to write.
+     */
+    void exportStatisticsToCSV(const StatisticsReport& report, const std::string& filename);
+}
@@ -1,4 +1,9 @@
 #include "Student.h"
+#include "Compression.h"
+#include "Gradebook.h"
+#include "StudentIndex.h"
+#include "TextIndex.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -18,7 +23,9 @@ namespace gradebook {
      * @param entry Pronouns string.
      */
     void Student::setPronouns(const std::string& entry) {
-        pronouns = entry;
+        if (entry.empty() && !profile) return;
+        mutableProfile().pronouns = entry;
+        markChanged();
     }
 
     /**
@@ -26,7 +33,9 @@ namespace gradebook {
      * @param entry Age value.
      */
     void Student::setAge(const unsigned& entry) {
-        age = entry;
+        record->age = entry;
+        reindex();
+        markChanged();
     }
 
     /**
@@ -34,7 +43,9 @@ namespace gradebook {
      * @param entry Grade level.
      */
     void Student::setGradeLevel(const unsigned& entry) {
-        gradelevel = entry;
+        record->gradeLevel = entry;
+        reindex();
+        markChanged();
     }
 
     /**
@@ -42,7 +53,7 @@ namespace gradebook {
      * @param entry ID number.
      */
     void Student::setID(const unsigned& entry) {
-        id = entry;
+        record->id = entry;
     }
 
     /**
@@ -50,7 +61,9 @@ namespace gradebook {
      * @param entry Seat description.
      */
     void Student::setSeat(const std::string& entry) {
-        seat = entry;
+        if (entry.empty() && !profile) return;
+        mutableProfile().seat = entry;
+        markChanged();
     }
 
     /**
@@ -58,7 +71,12 @@ namespace gradebook {
      * @param entry Notes string.
      */
     void Student::setNotes(const std::string& entry) {
-        notes = entry;
+        if (entry.empty() && !profile) return;
+        mutableProfile().notes = entry;
+        if (textIndex) {
+            textIndex->setStudentNotes(this, getNotesView());
+        }
+        markChanged();
     }
 
     /**
@@ -66,7 +84,9 @@ namespace gradebook {
      * @param entry Letter grade.
      */
     void Student::setOverallGrade(const char& entry) {
-        overallGrade = entry;
+        record->overallGrade = entry;
+        reindex();
+        markChanged();
     }
 
     /**
@@ -74,16 +94,236 @@ namespace gradebook {
      * @param entry Grade percentage.
      */
     void Student::setGradePercent(const float& entry) {
-        gradePercent = entry;
+        record->gradePercent = entry;
+        markChanged();
+    }
+
+    namespace {
+        /**
+         * @brief Orders a score against an assignment ID for binary searches.
+         */
+        bool scoreBefore(const AssignmentScore& entry, unsigned assignmentID) {
+            return entry.assignmentID < assignmentID;
+        }
+
+        /**
+         * @brief Orders an enrollment against a classroom ID for binary searches.
+         */
+        bool enrollmentBefore(const Enrollment& entry, unsigned classroomID) {
+            return entry.classroomID < classroomID;
+        }
+    }
+
+    /**
+     * @brief Enrolls the student in a classroom; does nothing if already enrolled.
+     * @param classroomID Classroom to join.
+     */
+    void Student::enroll(unsigned classroomID) {
+        auto it = std::lower_bound(enrollments.begin(), enrollments.end(), classroomID, enrollmentBefore);
+        if (it == enrollments.end() || it->classroomID != classroomID) {
+            Enrollment enrollment;
+            enrollment.classroomID = classroomID;
+            enrollments.insert(it, std::move(enrollment));
+            markChanged();
+        }
+    }
+
+    /**
+     * @brief Withdraws the student from a classroom, dropping the scores earned there.
+     * @param classroomID Classroom to leave.
+     * @return True if the student was enrolled.
+     */
+    bool Student::withdraw(unsigned classroomID) {
+        auto it = std::lower_bound(enrollments.begin(), enrollments.end(), classroomID, enrollmentBefore);
+        if (it == enrollments.end() || it->classroomID != classroomID) {
+            return false;
+        }
+        enrollments.erase(it);
+        if (changeLog) {
+            changeLog->addTombstone(TombstoneKind::Withdrawn, record->id, classroomID);
+        }
+        refreshOverallGrade();
+        markChanged();
+        return true;
+    }
+
+    /**
+     * @brief Sets or updates the student's score for an assignment in one of their classrooms.
+     * @param classroomID Classroom the assignment belongs to.
+     * @param assignmentID Stable ID of the assignment.
+     * @param score Score achieved.
+     * @return False if the student is not enrolled in the classroom.
+     */
+    bool Student::setAssignmentScore(unsigned classroomID, unsigned assignmentID, float score) {
+        if (!isEnrolledIn(classroomID)) {
+            return false;
+        }
+        markChanged();
+        return setAssignmentScore(classroomID, assignmentID, score, changeVersion);
     }
 
     /**
-     * @brief Sets or updates the student's score for a specific assignment.
-     * @param assignmentName Name of the assignment.
+     * @brief Sets a score recorded at a known change version, as when loading; not counted as a change.
+     * @param classroomID Classroom the assignment belongs to.
+     * @param assignmentID Stable ID of the assignment.
      * @param score Score achieved.
+     * @param version Change version the score was set at.
+     * @return False if the student is not enrolled in the classroom.
+     */
+    bool Student::setAssignmentScore(unsigned classroomID, unsigned assignmentID, float score, ChangeVersion version) {
+        Enrollment* enrollment = findEnrollment(classroomID);
+        if (!enrollment) {
+            return false;
+        }
+
+        auto& scores = enrollment->scores;
+        auto it = std::lower_bound(scores.begin(), scores.end(), assignmentID, scoreBefore);
+        if (it != scores.end() && it->assignmentID == assignmentID) {
+            it->score = score;
+            it->version = version;
+        }
+        else {
+            scores.insert(it, AssignmentScore{ assignmentID, score, version });
+        }
+        return true;
+    }
+
+    /**
+     * @brief Gives an existing score the student's next change version, leaving its value alone.
+     * @param classroomID Classroom the assignment belongs to.
+     * @param assignmentID Stable ID of the assignment.
+     * @return True if the student has a score for it.
+     */
+    bool Student::touchAssignmentScore(unsigned classroomID, unsigned assignmentID) {
+        Enrollment* enrollment = findEnrollment(classroomID);
+        if (!enrollment) {
+            return false;
+        }
+
+        auto& scores = enrollment->scores;
+        auto it = std::lower_bound(scores.begin(), scores.end(), assignmentID, scoreBefore);
+        if (it == scores.end() || it->assignmentID != assignmentID) {
+            return false;
+        }
+        markChanged();
+        it->version = changeVersion;
+        return true;
+    }
+
+    /**
+     * @brief Removes the student's score for an assignment, if any.
+     * @param classroomID Classroom the assignment belongs to.
+     * @param assignmentID Stable ID of the assignment.
+     * @return True if a score was removed.
+     */
+    bool Student::eraseAssignmentScore(unsigned classroomID, unsigned assignmentID) {
+        Enrollment* enrollment = findEnrollment(classroomID);
+        if (!enrollment) {
+            return false;
+        }
+
+        auto& scores = enrollment->scores;
+        auto it = std::lower_bound(scores.begin(), scores.end(), assignmentID, scoreBefore);
+        if (it == scores.end() || it->assignmentID != assignmentID) {
+            return false;
+        }
+        scores.erase(it);
+        if (changeLog) {
+            changeLog->addTombstone(TombstoneKind::ScoreErased, record->id, classroomID, assignmentID);
+        }
+        markChanged();
+        return true;
+    }
+
+    /**
+     * @brief Sets the stored grade for one classroom without recalculating it.
+     * @param classroomID Classroom whose grade is set.
+     * @param letter Letter grade, or '\0' if not yet graded.
+     * @param percent Grade percentage.
+     */
+    void Student::setClassroomGrade(unsigned classroomID, char letter, float percent) {
+        if (Enrollment* enrollment = findEnrollment(classroomID)) {
+            enrollment->letterGrade = letter;
+            enrollment->gradePercent = percent;
+            markChanged();
+        }
+    }
+
+    /**
+     * @brief Sets the secondary index to notify on grade level, age and grade changes.
+     * @param entry The index, or nullptr to stop notifying.
+     */
+    void Student::setIndex(StudentIndex* entry) {
+        index = entry;
+    }
+
+    /**
+     * @brief Sets the full-text index to notify when the notes change.
+     * @param entry The index, or nullptr to stop notifying.
+     */
+    void Student::setTextIndex(TextIndex* entry) {
+        textIndex = entry;
+    }
+
+    /**
+     * @brief Sets the log that issues this student's change versions.
+     * @param entry The log, or nullptr to stop tracking.
+     */
+    void Student::setChangeLog(ChangeLog* entry) {
+        changeLog = entry;
+    }
+
+    /**
+     * @brief Sets the change version read from a file; not counted as a change.
+     * @param version The version.
+     */
+    void Student::setChangeVersion(ChangeVersion version) {
+        changeVersion = version;
+    }
+
+    /**
+     * @brief Keeps the hot record in a gradebook's record array from now on.
+     * @param storage The student's slot in the array, already holding the record.
      */
-    void Student::setAssignmentScore(const std::string& assignmentName, float score) {
-        assignmentScores[assignmentName] = score;
+    void Student::attachRecord(StudentRecord* storage) {
+        record.attach(storage);
+    }
+
+    /**
+     * @brief Takes the hot record back out of the gradebook's array.
+     */
+    void Student::detachRecord() {
+        record.detach();
+    }
+
+    /**
+     * @brief Records that the student changed, giving them the next change version.
+     */
+    void Student::markChanged() {
+        if (changeLog) {
+            changeVersion = changeLog->recordStudentChange(this, changeVersion);
+        }
+    }
+
+    /**
+     * @brief Finds an enrollment for editing.
+     * @param classroomID Classroom to look up.
+     * @return Pointer to the enrollment, or nullptr if the student is not enrolled there.
+     */
+    Enrollment* Student::findEnrollment(unsigned classroomID) {
+        auto it = std::lower_bound(enrollments.begin(), enrollments.end(), classroomID, enrollmentBefore);
+        return (it == enrollments.end() || it->classroomID != classroomID) ? nullptr : &*it;
+    }
+
+    /**
+     * @brief Gets the cold profile, allocating it the first time profile text is written.
+     * @return Reference to the profile.
+     */
+    StudentProfile& Student::mutableProfile() {
+        if (!profile) {
+            profile = std::make_unique<StudentProfile>();
+        }
+        return *profile;
     }
 
     // === Accessors ===
@@ -109,7 +349,7 @@ namespace gradebook {
      * @return Pronouns string.
      */
     std::string Student::getPronouns() const {
-        return pronouns;
+        return std::string(getPronounsView());
     }
 
     /**
@@ -117,7 +357,7 @@ namespace gradebook {
      * @return Age as unsigned.
      */
     unsigned Student::getAge() const {
-        return age;
+        return record->age;
     }
 
     /**
@@ -125,7 +365,7 @@ namespace gradebook {
      * @return Grade level as unsigned.
      */
     unsigned Student::getGradeLevel() const {
-        return gradelevel;
+        return record->gradeLevel;
     }
 
     /**
@@ -133,7 +373,7 @@ namespace gradebook {
      * @return ID number.
      */
     unsigned Student::getID() const {
-        return id;
+        return record->id;
     }
 
     /**
@@ -141,7 +381,7 @@ namespace gradebook {
      * @return Seat string.
      */
     std::string Student::getSeat() const {
-        return seat;
+        return std::string(getSeatView());
     }
 
     /**
@@ -149,7 +389,7 @@ namespace gradebook {
      * @return Notes string.
      */
     std::string Student::getNotes() const {
-        return notes;
+        return std::string(getNotesView());
     }
 
     /**
@@ -165,7 +405,7 @@ namespace gradebook {
      * @return Letter grade character.
      */
     char Student::getOverallGrade() const {
-        return overallGrade;
+        return record->overallGrade;
     }
 
     /**
@@ -173,48 +413,171 @@ namespace gradebook {
      * @return Grade percentage as float.
      */
     float Student::getGradePercent() const {
-        return gradePercent;
+        return record->gradePercent;
+    }
+
+    /**
+     * @brief Gets the student's enrollments.
+     * @return Const reference to the enrollments, sorted by classroom ID.
+     */
+    const std::vector<Enrollment>& Student::getEnrollments() const {
+        return enrollments;
+    }
+
+    /**
+     * @brief Gets the version of the student's latest change.
+     * @return The version; 0 if never tracked.
+     */
+    ChangeVersion Student::getChangeVersion() const {
+        return changeVersion;
+    }
+
+    /**
+     * @brief Finds the student's enrollment in a classroom.
+     * @param classroomID Classroom to look up.
+     * @return Pointer to the enrollment, or nullptr if the student is not enrolled there.
+     */
+    const Enrollment* Student::findEnrollment(unsigned classroomID) const {
+        auto it = std::lower_bound(enrollments.begin(), enrollments.end(), classroomID, enrollmentBefore);
+        return (it == enrollments.end() || it->classroomID != classroomID) ? nullptr : &*it;
+    }
+
+    /**
+     * @brief Checks whether the student is enrolled in a classroom.
+     * @param classroomID Classroom to look up.
+     * @return True if enrolled.
+     */
+    bool Student::isEnrolledIn(unsigned classroomID) const {
+        return findEnrollment(classroomID) != nullptr;
+    }
+
+    /**
+     * @brief Looks up the student's score for one assignment.
+     * @param classroomID Classroom the assignment belongs to.
+     * @param assignmentID Stable ID of the assignment.
+     * @return The score, or nothing if the assignment has not been graded.
+     */
+    std::optional<float> Student::getAssignmentScore(unsigned classroomID, unsigned assignmentID) const {
+        const Enrollment* enrollment = findEnrollment(classroomID);
+        if (!enrollment) {
+            return std::nullopt;
+        }
+
+        const auto& scores = enrollment->scores;
+        auto it = std::lower_bound(scores.begin(), scores.end(), assignmentID, scoreBefore);
+        if (it == scores.end() || it->assignmentID != assignmentID) {
+            return std::nullopt;
+        }
+        return it->score;
     }
 
     /**
-     * @brief Gets the map of assignment scores.
-     * @return Const reference to assignment name-score map.
+     * @brief Gets the student's grade percentage in one classroom.
+     * @param classroomID Classroom to look up.
+     * @return Grade percentage, or 0 if the student is not enrolled there.
      */
-    const std::map<std::string, float>& Student::getAssignmentScores() const {
-        return assignmentScores;
+    float Student::getClassroomGradePercent(unsigned classroomID) const {
+        const Enrollment* enrollment = findEnrollment(classroomID);
+        return enrollment ? enrollment->gradePercent : 0.0f;
+    }
+
+    /**
+     * @brief Gets the student's letter grade in one classroom.
+     * @param classroomID Classroom to look up.
+     * @return Letter grade character, or '\0' if not graded there yet.
+     */
+    char Student::getClassroomGrade(unsigned classroomID) const {
+        const Enrollment* enrollment = findEnrollment(classroomID);
+        return enrollment ? enrollment->letterGrade : '\0';
     }
 
     // === Grade Calculation ===
 
     /**
-     * @brief Calculates and updates the student's overall grade and percentage
-     * based on the provided vector of assignments and their scores.
+     * @brief Gets the letter grade for a percentage.
+     * @param percent Grade percentage.
+     * @return 'A' through 'D', or 'F'.
+     */
+    char Student::letterGradeFor(float percent) {
+        return (percent >= 90.0f) ? 'A'
+            : (percent >= 80.0f) ? 'B'
+            : (percent >= 70.0f) ? 'C'
+            : (percent >= 60.0f) ? 'D'
+            : 'F';
+    }
+
+    /**
+     * @brief Calculates the student's grade in one classroom from that classroom's
+     * assignments and their scores, then updates the overall grade and percentage.
+     * @param classroomID Classroom being graded.
      * @param assignments Vector of Assignment objects to consider.
      */
-    void Student::calculateGrade(const std::vector<Assignment>& assignments) {
+    void Student::calculateGrade(unsigned classroomID, const std::vector<Assignment>& assignments) {
+        Enrollment* enrollment = findEnrollment(classroomID);
+        if (!enrollment) {
+            return;
+        }
+
         float totalPointsPossible = 0.0f;
         float totalPointsScored = 0.0f;
 
+        const auto& scores = enrollment->scores;
         for (const auto& a : assignments) {
             totalPointsPossible += a.getPointsPossible();
-            auto it = assignmentScores.find(a.getAssignmentName());
-            if (it != assignmentScores.end()) {
-                totalPointsScored += it->second;
+            auto it = std::lower_bound(scores.begin(), scores.end(), a.getAssignmentID(), scoreBefore);
+            if (it != scores.end() && it->assignmentID == a.getAssignmentID()) {
+                totalPointsScored += it->score;
             }
         }
 
+        float percent = 0.0f;
         if (totalPointsPossible > 0.0f) {
-            gradePercent = (totalPointsScored / totalPointsPossible) * 100.0f;
+            percent = (totalPointsScored / totalPointsPossible) * 100.0f;
         }
-        else {
-            gradePercent = 0.0f;
+
+        // Regrading an unchanged class is routine; only a different grade counts as a change.
+        char letter = letterGradeFor(percent);
+        if (enrollment->gradePercent != percent || enrollment->letterGrade != letter) {
+            enrollment->gradePercent = percent;
+            enrollment->letterGrade = letter;
+            markChanged();
         }
+        refreshOverallGrade();
+    }
 
-        overallGrade = (gradePercent >= 90.0f) ? 'A'
-            : (gradePercent >= 80.0f) ? 'B'
-            : (gradePercent >= 70.0f) ? 'C'
-            : (gradePercent >= 60.0f) ? 'D'
-            : 'F';
+    /**
+     * @brief Recomputes the overall grade as the mean of the graded classrooms.
+     *
+     * Every graded class counts equally, so a student in a single class
+     * keeps exactly that class's grade. Classes not graded yet are left out;
+     * a student with none keeps no letter grade.
+     */
+    void Student::refreshOverallGrade() {
+        float total = 0.0f;
+        unsigned graded = 0;
+        for (const auto& enrollment : enrollments) {
+            if (enrollment.letterGrade == '\0') continue;
+            total += enrollment.gradePercent;
+            ++graded;
+        }
+
+        float percent = graded == 0 ? 0.0f : total / static_cast<float>(graded);
+        char letter = graded == 0 ? '\0' : letterGradeFor(percent);
+        if (record->gradePercent != percent || record->overallGrade != letter) {
+            record->gradePercent = percent;
+            record->overallGrade = letter;
+            markChanged();
+        }
+        reindex();
+    }
+
+    /**
+     * @brief Tells the secondary index, if any, that an indexed field changed.
+     */
+    void Student::reindex() {
+        if (index) {
+            index->update(this);
+        }
     }
 
     // === Print Functions ===
@@ -227,86 +590,140 @@ namespace gradebook {
         std::cout << "------------------------\n";
         std::cout << "First Name      : " << firstName << std::endl;
         std::cout << "Last Name       : " << lastName << std::endl;
-        std::cout << "Pronouns        : " << pronouns << std::endl;
-        std::cout << "Age             : " << age << std::endl;
-        std::cout << "Student ID      : " << id << std::endl;
-        std::cout << "Seat Location   : " << seat << std::endl;
-        std::cout << "Notes           : " << notes << std::endl;
+        std::cout << "Pronouns        : " << getPronounsView() << std::endl;
+        std::cout << "Age             : " << record->age << std::endl;
+        std::cout << "Student ID      : " << record->id << std::endl;
+        std::cout << "Seat Location   : " << getSeatView() << std::endl;
+        std::cout << "Notes           : " << getNotesView() << std::endl;
         std::cout << "------------------------\n" << std::endl;
     }
 
     /**
      * @brief Prints a detailed report of the student including assignment scores and overall grade.
+     *
+     * Each class gets its own section with its own grade. Scores are looked
+     * up in that class's enrollment only, so the cost grows with the
+     * student's classes and their assignments, not with the school.
+     *
+     * @param classrooms Teachers whose classes to list; ones the student is not enrolled in are skipped.
      */
-    void Student::printStudentReport() const {
+    void Student::printStudentReport(const std::vector<const Teacher*>& classrooms) const {
         // printStudent() shows name, ID, seat, notes, etc.
         printStudent();
 
-        std::cout << std::endl
-            << "=== Assignment Scores ===" << std::endl;
+        bool anyClass = false;
+        for (const Teacher* teacher : classrooms) {
+            const Enrollment* enrollment = teacher ? findEnrollment(teacher->getClassroomID()) : nullptr;
+            if (!enrollment) continue;
 
-        if (assignmentScores.empty()) {
-            std::cout << "No assignments have been graded yet.\n";
-        }
-        else {
-            for (const auto& [name, score] : assignmentScores) {
-                std::cout << std::left << std::setw(20) << name
+            anyClass = true;
+            std::cout << std::endl
+                << "=== " << teacher->getTitleView() << " " << teacher->getLastNameView()
+                << " (Grade " << teacher->getGradeLevel() << ") ===" << std::endl;
+
+            bool anyGraded = false;
+            for (const auto& a : teacher->getAssignments()) {
+                auto score = getAssignmentScore(enrollment->classroomID, a.getAssignmentID());
+                if (!score) continue;
+
+                anyGraded = true;
+                std::cout << std::left << std::setw(20) << a.getAssignmentNameView()
                     << "Score: " << std::fixed << std::setprecision(2)
-                    << score << " pts\n";
+                    << *score << " pts\n";
             }
+            if (!anyGraded) {
+                std::cout << "No assignments have been graded yet.\n";
+            }
+            std::cout << "Class Grade: " << enrollment->letterGrade
+                << " (" << std::fixed << std::setprecision(2)
+                << enrollment->gradePercent << "%)\n";
+        }
+        if (!anyClass) {
+            std::cout << std::endl << "Not enrolled in any classes.\n";
         }
 
         std::cout << std::endl
-            << "Overall Grade: " << overallGrade
+            << "Overall Grade: " << record->overallGrade
             << " (" << std::fixed << std::setprecision(2)
-            << gradePercent << "%)\n";
+            << record->gradePercent << "%)\n";
 
         if (userCheck(
             "Would you like to export this student report to CSV? [Y/N] ",
             "Exporting student report to CSV...",
             "Skipping export.")) {
-            exportStudentReportToCSV();
+            exportStudentReportToCSV(classrooms);
         }
     }
 
     // === Export ===
 
     /**
-     * @brief Exports the student's detailed report to a CSV file named with their last and first name.
+     * @brief Gets the name of the student's report CSV.
+     * @return "<LastName>_<FirstName>_Report.csv".
      */
-    void Student::exportStudentReportToCSV() const {
-        // Use a file name that includes the student's full name or ID to keep it unique
-        std::string filename = lastName + "_" + firstName + "_Report.csv";
-
-        std::ofstream file(filename);
-        if (!file) {
-            std::cerr << "Failed to open file for writing: " << filename << std::endl;
-            return;
-        }
+    std::string Student::reportFileName() const {
+        return lastName + "_" + firstName + "_Report.csv";
+    }
 
+    /**
+     * @brief Writes the student's profile, then every graded score and class grade, as CSV.
+     * @param out Destination of the CSV text.
+     * @param classrooms Teachers whose classes to list; ones the student is not enrolled in are skipped.
+     * @return Number of score rows written.
+     */
+    size_t Student::writeStudentReportCSV(std::ostream& out, const std::vector<const Teacher*>& classrooms) const {
         // Write biographical info
-        file << "First Name," << firstName << "\n";
-        file << "Last Name," << lastName << "\n";
-        file << "Pronouns," << pronouns << "\n";
-        file << "Age," << age << "\n";
-        file << "Student ID," << id << "\n";
-        file << "Seat Location," << seat << "\n";
-        file << "Notes," << notes << "\n\n";
+        out << "First Name," << firstName << "\n";
+        out << "Last Name," << lastName << "\n";
+        out << "Pronouns," << getPronounsView() << "\n";
+        out << "Age," << record->age << "\n";
+        out << "Student ID," << record->id << "\n";
+        out << "Seat Location," << getSeatView() << "\n";
+        out << "Notes," << getNotesView() << "\n\n";
 
         // Write assignment scores header
-        file << "Assignment,Score\n";
+        out << "Class,Assignment,Score\n";
 
-        if (assignmentScores.empty()) {
-            file << "No assignments graded yet,\n";
-        }
-        else {
-            for (const auto& pair : assignmentScores) {
-                file << pair.first << "," << std::fixed << std::setprecision(2) << pair.second << "\n";
+        size_t rows = 0;
+        for (const Teacher* teacher : classrooms) {
+            const Enrollment* enrollment = teacher ? findEnrollment(teacher->getClassroomID()) : nullptr;
+            if (!enrollment) continue;
+
+            std::string className = teacher->getTitle() + " " + teacher->getLastName();
+            for (const auto& a : teacher->getAssignments()) {
+                auto score = getAssignmentScore(enrollment->classroomID, a.getAssignmentID());
+                if (!score) continue;
+
+                ++rows;
+                out << className << "," << a.getAssignmentNameView() << ","
+                    << std::fixed << std::setprecision(2) << *score << "\n";
             }
+            out << className << ",Class Grade," << std::fixed << std::setprecision(2)
+                << enrollment->gradePercent << "\n";
+        }
+        if (rows == 0) {
+            out << "No assignments graded yet,\n";
+        }
+
+        out << "\nOverall Grade," << record->overallGrade << "\n";
+        out << "Grade Percent," << std::fixed << std::setprecision(2) << record->gradePercent << "\n";
+        return rows;
+    }
+
+    /**
+     * @brief Exports the student's detailed report to a CSV file named with their last and first name.
+     * @param classrooms Teachers whose classes to list; ones the student is not enrolled in are skipped.
+     */
+    void Student::exportStudentReportToCSV(const std::vector<const Teacher*>& classrooms) const {
+        std::string filename = exportFileName(reportFileName());
+
+        ExportFile file(filename);
+        if (!file) {
+            std::cerr << "Failed to open file for writing: " << filename << std::endl;
+            return;
         }
 
-        file << "\nOverall Grade," << overallGrade << "\n";
-        file << "Grade Percent," << std::fixed << std::setprecision(2) << gradePercent << "\n";
+        writeStudentReportCSV(file, classrooms);
 
         file.close();
 
@@ -333,10 +750,9 @@ namespace gradebook {
                 printStudent();
                 break;
             case 2:
-                printStudentReport();
+                printStudentReport(gradebook.getTeachersOf(this));
                 break;
             case 3:
-                welcomeMenu(gradebook);
                 return;
             default:
                 std::cout << "Invalid selection. Please try again.\n";
@@ -4,32 +4,163 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
+#include <optional>
 #include "Assignment.h"
+#include "ChangeLog.h"
 #include "User.h"
 
 namespace gradebook {
 
+    class Teacher;
+    class StudentIndex;
+    class TextIndex;
+
+    /**
+     * @brief Compact record of the fields read by every grading and ranking scan.
+     *
+     * Free of heap pointers, so a gradebook keeps the records of all its
+     * students side by side in one array that whole-school scans walk
+     * without touching any Student object.
+     */
+    struct StudentRecord {
+        unsigned id = 0;               /**< Unique student ID */
+        unsigned gradeLevel = 0;       /**< Student's grade level */
+        unsigned age = 0;              /**< Student's age */
+        float gradePercent = 0.0f;     /**< Grade percentage */
+        char overallGrade = '\0';      /**< Letter grade */
+    };
+
+    /**
+     * @brief Where a student's hot record lives.
+     *
+     * A student outside any gradebook keeps its record inline. A gradebook
+     * moves the record into its own record array and attaches the handle to
+     * that slot. Moving a student copies the record's current value into the
+     * new handle's inline storage, so a moved student is never left pointing
+     * at another student's slot.
+     */
+    class StudentRecordHandle {
+    private:
+        StudentRecord inlineRecord;                 /**< Record used while detached */
+        StudentRecord* current = &inlineRecord;     /**< Record in use: inlineRecord or a gradebook slot */
+
+    public:
+        StudentRecordHandle() = default;
+
+        StudentRecordHandle(StudentRecordHandle&& other) noexcept : inlineRecord(*other.current) {
+        }
+
+        StudentRecordHandle& operator=(StudentRecordHandle&& other) noexcept {
+            inlineRecord = *other.current;
+            current = &inlineRecord;
+            return *this;
+        }
+
+        StudentRecord* operator->() { return current; }
+        const StudentRecord* operator->() const { return current; }
+
+        /** @brief Gets the record in use. */
+        const StudentRecord& get() const { return *current; }
+
+        /**
+         * @brief Starts using a gradebook slot; the caller has already copied the record into it.
+         * @param storage The slot.
+         */
+        void attach(StudentRecord* storage) { current = storage; }
+
+        /**
+         * @brief Copies the record back inline and stops using the gradebook slot.
+         */
+        void detach() {
+            inlineRecord = *current;
+            current = &inlineRecord;
+        }
+    };
+
+    /**
+     * @brief One graded assignment, keyed by the assignment's stable ID.
+     */
+    struct AssignmentScore {
+        unsigned assignmentID = 0;     /**< ID of the graded assignment */
+        float score = 0.0f;            /**< Points earned */
+        ChangeVersion version = 0;     /**< Change version the score was last set at; 0 if never tracked */
+    };
+
+    /**
+     * @brief One classroom a student is enrolled in, with the scores earned there.
+     *
+     * A student's enrollments double as the reverse index from student to
+     * classroom: everything about one class is found without touching any
+     * other class or any other student.
+     */
+    struct Enrollment {
+        unsigned classroomID = 0;               /**< ID of the teacher's classroom */
+        float gradePercent = 0.0f;              /**< Grade percentage in this classroom */
+        char letterGrade = '\0';                /**< Letter grade in this classroom; '\0' until first graded */
+        std::vector<AssignmentScore> scores;    /**< Scores sorted by assignment ID */
+    };
+
+    /**
+     * @brief Free-form profile text that only printing and exports read.
+     */
+    struct StudentProfile {
+        std::string pronouns;          /**< Student's pronouns */
+        std::string seat;              /**< Seating location */
+        std::string notes;             /**< Additional notes */
+    };
+
     /**
      * @class Student
      * @brief Represents a student in the gradebook system, inheriting from User.
      * Contains biographical data, grade info, assignment scores, and related functionality.
+     *
+     * Hot grading fields live in a StudentRecord kept in the owning
+     * gradebook's record array (inline until the student is stored); cold
+     * profile text lives out of line in a StudentProfile that is only
+     * allocated once some profile text is actually set.
      */
     class Student : public User {
     private:
-        // Biographical Variables
-        std::string pronouns;               /**< Student's pronouns */
-        unsigned age;                      /**< Student's age */
-        unsigned gradelevel;               /**< Student's grade level */
-        unsigned id;                      /**< Unique student ID */
-        std::string seat;                 /**< Seating location */
-        std::string notes;                /**< Additional notes */
+        // Hot grading data
+        StudentRecordHandle record;        /**< ID, grade level, age and grade */
+
+        // Classrooms and their scores
+        std::vector<Enrollment> enrollments;   /**< Enrollments sorted by classroom ID */
+
+        // Cold profile data
+        std::unique_ptr<StudentProfile> profile;   /**< Pronouns, seat and notes; null until first set */
+
+        // Secondary index
+        StudentIndex* index = nullptr;     /**< Index told about grade level, age and grade changes; null if unindexed */
+        TextIndex* textIndex = nullptr;    /**< Full-text index told about note edits; null if unindexed */
+
+        // Change tracking
+        ChangeLog* changeLog = nullptr;    /**< Log that issues change versions; null if untracked */
+        ChangeVersion changeVersion = 0;   /**< Version of the latest change; 0 if never tracked */
+
+        /**
+         * @brief Gets the cold profile, allocating it on first write.
+         * @return Reference to the profile.
+         */
+        StudentProfile& mutableProfile();
+
+        /**
+         * @brief Finds an enrollment for editing.
+         * @param classroomID Classroom to look up.
+         * @return Pointer to the enrollment, or nullptr if the student is not enrolled there.
+         */
+        Enrollment* findEnrollment(unsigned classroomID);
 
-        // Grade Variables
-        char overallGrade;                /**< Letter grade */
-        float gradePercent;               /**< Grade percentage */
+        /**
+         * @brief Recomputes the overall grade as the mean of the graded classrooms.
+         */
+        void refreshOverallGrade();
 
-        // Individual Student Assignment Container
-        std::map<std::string, float> assignmentScores;  /**< Map of assignment names to scores */
+        /**
+         * @brief Tells the secondary index, if any, that an indexed field changed.
+         */
+        void reindex();
 
     public:
         // === Mutators ===
@@ -83,11 +214,112 @@ namespace gradebook {
         void setGradePercent(const float& entry);
 
         /**
-         * @brief Sets or updates the student's score for a specific assignment.
-         * @param assignmentName Name of the assignment.
+         * @brief Enrolls the student in a classroom; does nothing if already enrolled.
+         * @param classroomID Classroom to join.
+         */
+        void enroll(unsigned classroomID);
+
+        /**
+         * @brief Withdraws the student from a classroom, dropping the scores earned there.
+         * @param classroomID Classroom to leave.
+         * @return True if the student was enrolled.
+         */
+        bool withdraw(unsigned classroomID);
+
+        /**
+         * @brief Sets or updates the student's score for an assignment in one of their classrooms.
+         * @param classroomID Classroom the assignment belongs to.
+         * @param assignmentID Stable ID of the assignment.
+         * @param score Score achieved.
+         * @return False if the student is not enrolled in the classroom.
+         */
+        bool setAssignmentScore(unsigned classroomID, unsigned assignmentID, float score);
+
+        /**
+         * @brief Sets a score recorded at a known change version, as when loading; not counted as a change.
+         * @param classroomID Classroom the assignment belongs to.
+         * @param assignmentID Stable ID of the assignment.
          * @param score Score achieved.
+         * @param version Change version the score was set at.
+         * @return False if the student is not enrolled in the classroom.
+         */
+        bool setAssignmentScore(unsigned classroomID, unsigned assignmentID, float score, ChangeVersion version);
+
+        /**
+         * @brief Marks an existing score changed without altering it, as when its assignment is renamed.
+         * @param classroomID Classroom the assignment belongs to.
+         * @param assignmentID Stable ID of the assignment.
+         * @return True if the student has a score for it.
+         */
+        bool touchAssignmentScore(unsigned classroomID, unsigned assignmentID);
+
+        /**
+         * @brief Removes the student's score for an assignment, if any.
+         * @param classroomID Classroom the assignment belongs to.
+         * @param assignmentID Stable ID of the assignment.
+         * @return True if a score was removed.
          */
-        void setAssignmentScore(const std::string& assignmentName, float score);
+        bool eraseAssignmentScore(unsigned classroomID, unsigned assignmentID);
+
+        /**
+         * @brief Sets the stored grade for one classroom without recalculating it.
+         * @param classroomID Classroom whose grade is set.
+         * @param letter Letter grade, or '\0' if not yet graded.
+         * @param percent Grade percentage.
+         */
+        void setClassroomGrade(unsigned classroomID, char letter, float percent);
+
+        /**
+         * @brief Sets the secondary index to notify on grade level, age and grade changes.
+         *
+         * Called by StudentIndex itself when the student is inserted or removed.
+         *
+         * @param entry The index, or nullptr to stop notifying.
+         */
+        void setIndex(StudentIndex* entry);
+
+        /**
+         * @brief Sets the full-text index to notify when the notes change.
+         *
+         * Called by TextIndex itself when the student is indexed or removed.
+         *
+         * @param entry The index, or nullptr to stop notifying.
+         */
+        void setTextIndex(TextIndex* entry);
+
+        /**
+         * @brief Sets the log that issues this student's change versions.
+         * @param entry The log, or nullptr to stop tracking.
+         */
+        void setChangeLog(ChangeLog* entry);
+
+        /**
+         * @brief Sets the change version read from a file; not counted as a change.
+         * @param version The version.
+         */
+        void setChangeVersion(ChangeVersion version);
+
+        /**
+         * @brief Records that the student changed, giving them the next change version.
+         *
+         * Every mutator calls this; does nothing while the student is untracked.
+         */
+        void markChanged();
+
+        /**
+         * @brief Keeps the hot record in a gradebook's record array from now on.
+         *
+         * Called by Gradebook, which copies getRecord() into the slot first and
+         * attaches again whenever the array moves.
+         *
+         * @param storage The student's slot in the array.
+         */
+        void attachRecord(StudentRecord* storage);
+
+        /**
+         * @brief Takes the hot record back out of the gradebook's array.
+         */
+        void detachRecord();
 
         // === Accessors ===
 
@@ -158,19 +390,95 @@ namespace gradebook {
         float getGradePercent() const;
 
         /**
-         * @brief Gets the map of assignment scores.
-         * @return Const reference to assignment name-score map.
+         * @brief Gets the student's enrollments.
+         * @return Const reference to the enrollments, sorted by classroom ID.
+         */
+        const std::vector<Enrollment>& getEnrollments() const;
+
+        /**
+         * @brief Gets the version of the student's latest change.
+         * @return The version; 0 if never tracked.
+         */
+        ChangeVersion getChangeVersion() const;
+
+        /**
+         * @brief Finds the student's enrollment in a classroom.
+         * @param classroomID Classroom to look up.
+         * @return Pointer to the enrollment, or nullptr if the student is not enrolled there.
+         */
+        const Enrollment* findEnrollment(unsigned classroomID) const;
+
+        /**
+         * @brief Checks whether the student is enrolled in a classroom.
+         * @param classroomID Classroom to look up.
+         * @return True if enrolled.
+         */
+        bool isEnrolledIn(unsigned classroomID) const;
+
+        /**
+         * @brief Looks up the student's score for one assignment.
+         * @param classroomID Classroom the assignment belongs to.
+         * @param assignmentID Stable ID of the assignment.
+         * @return The score, or nothing if the assignment has not been graded.
+         */
+        std::optional<float> getAssignmentScore(unsigned classroomID, unsigned assignmentID) const;
+
+        /**
+         * @brief Gets the student's grade percentage in one classroom.
+         * @param classroomID Classroom to look up.
+         * @return Grade percentage, or 0 if the student is not enrolled there.
+         */
+        float getClassroomGradePercent(unsigned classroomID) const;
+
+        /**
+         * @brief Gets the student's letter grade in one classroom.
+         * @param classroomID Classroom to look up.
+         * @return Letter grade character, or '\0' if not graded there yet.
+         */
+        char getClassroomGrade(unsigned classroomID) const;
+
+        // === Zero-Copy Accessors ===
+
+        /**
+         * @brief Views the student's pronouns without copying them.
+         * @return View of the stored pronouns.
+         */
+        std::string_view getPronounsView() const { return profile ? std::string_view(profile->pronouns) : std::string_view(); }
+
+        /**
+         * @brief Views the student's seat location without copying it.
+         * @return View of the stored seat string.
+         */
+        std::string_view getSeatView() const { return profile ? std::string_view(profile->seat) : std::string_view(); }
+
+        /**
+         * @brief Views the notes about the student without copying them.
+         * @return View of the stored notes.
          */
-        const std::map<std::string, float>& getAssignmentScores() const;
+        std::string_view getNotesView() const { return profile ? std::string_view(profile->notes) : std::string_view(); }
+
+        /**
+         * @brief Gets the compact hot record read by grading and ranking scans.
+         * @return Const reference to the record.
+         */
+        const StudentRecord& getRecord() const { return record.get(); }
 
         // === Grade Calculation ===
 
         /**
-         * @brief Calculates and updates the student's overall grade and percentage
-         * based on the provided vector of assignments and their respective scores.
+         * @brief Gets the letter grade for a percentage.
+         * @param percent Grade percentage.
+         * @return 'A' through 'D', or 'F'.
+         */
+        static char letterGradeFor(float percent);
+
+        /**
+         * @brief Calculates the student's grade in one classroom from that classroom's
+         * assignments, then updates the overall grade and percentage.
+         * @param classroomID Classroom being graded.
          * @param assignments Vector of Assignment objects to consider.
          */
-        void calculateGrade(const std::vector<Assignment>& assignments);
+        void calculateGrade(unsigned classroomID, const std::vector<Assignment>& assignments);
 
         // === Print Functions ===
 
@@ -180,16 +488,32 @@ namespace gradebook {
         void printStudent() const;
 
         /**
-         * @brief Prints a detailed student report including assignment scores.
+         * @brief Prints a detailed student report including assignment scores, grouped by class.
+         * @param classrooms Teachers whose classes to list; ones the student is not enrolled in are skipped.
          */
-        void printStudentReport() const;
+        void printStudentReport(const std::vector<const Teacher*>& classrooms) const;
 
         // === Export Functions ===
 
         /**
-         * @brief Exports the student's report to a CSV file.
+         * @brief Exports the student's report to a CSV file, grouped by class.
+         * @param classrooms Teachers whose classes to list; ones the student is not enrolled in are skipped.
+         */
+        void exportStudentReportToCSV(const std::vector<const Teacher*>& classrooms) const;
+
+        /**
+         * @brief Gets the name of the file exportStudentReportToCSV writes.
+         * @return "<LastName>_<FirstName>_Report.csv".
+         */
+        std::string reportFileName() const;
+
+        /**
+         * @brief Writes the student's report CSV to a stream.
+         * @param out Destination of the CSV text.
+         * @param classrooms Teachers whose classes to list; ones the student is not enrolled in are skipped.
+         * @return Number of score rows written.
          */
-        void exportStudentReportToCSV() const;
+        size_t writeStudentReportCSV(std::ostream& out, const std::vector<const Teacher*>& classrooms) const;
 
         // === Menu ===
 
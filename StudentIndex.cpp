@@ -0,0 +1,222 @@
+#include "StudentIndex.h"
+#include "Student.h"
+
+namespace gradebook {
+
+    /**
+     * @brief Builds the key a student currently belongs under.
+     * @param student The student.
+     * @return The student's key.
+     */
+    StudentIndexKey StudentIndex::keyOf(const Student* student) {
+        const StudentRecord& record = student->getRecord();
+        return { record.gradeLevel, record.overallGrade, record.age };
+    }
+
+    /**
+     * @brief Appends a student to the cell for a key.
+     * @param student The student.
+     * @param key Cell to join.
+     * @return The student's new location.
+     */
+    StudentIndex::Location StudentIndex::place(Student* student, const StudentIndexKey& key) {
+        Location location;
+        location.cell = cells.try_emplace(key).first;
+        location.position = location.cell->second.size();
+        location.cell->second.push_back(student);
+        return location;
+    }
+
+    /**
+     * @brief Takes a student out of its cell by swapping the cell's last student into its place.
+     *
+     * Empty cells are dropped so queries never visit them.
+     *
+     * @param location The student's current location.
+     */
+    void StudentIndex::unplace(const Location& location) {
+        std::vector<Student*>& members = location.cell->second;
+        if (location.position + 1 != members.size()) {
+            members[location.position] = members.back();
+            locations[members[location.position]].position = location.position;
+        }
+        members.pop_back();
+        if (members.empty()) {
+            cells.erase(location.cell);
+        }
+    }
+
+    /**
+     * @brief Adds a student and starts listening for its changes.
+     * @param student The student to index.
+     */
+    void StudentIndex::insert(Student* student) {
+        if (!student || locations.count(student)) return;
+
+        locations[student] = place(student, keyOf(student));
+        student->setIndex(this);
+    }
+
+    /**
+     * @brief Removes a student and stops listening for its changes.
+     * @param student The student to remove.
+     * @return True if the student was indexed.
+     */
+    bool StudentIndex::erase(Student* student) {
+        auto found = locations.find(student);
+        if (found == locations.end()) {
+            return false;
+        }
+
+        Location location = found->second;
+        locations.erase(found);
+        unplace(location);
+        student->setIndex(nullptr);
+        return true;
+    }
+
+    /**
+     * @brief Moves a student to the cell matching its current grade level, age and grade.
+     *
+     * Called by the student itself after any of those change; a student whose
+     * key did not actually change stays where it is.
+     *
+     * @param student The student that changed; ignored if it is not indexed.
+     */
+    void StudentIndex::update(Student* student) {
+        auto found = locations.find(student);
+        if (found == locations.end()) {
+            return;
+        }
+
+        StudentIndexKey key = keyOf(student);
+        if (found->second.cell->first == key) {
+            return;
+        }
+
+        Location old = found->second;
+        found->second = place(student, key);
+        unplace(old);
+    }
+
+    /**
+     * @brief Replaces the index contents with every student in a list.
+     * @param students The school's students.
+     */
+    void StudentIndex::rebuild(const std::vector<std::unique_ptr<Student>>& students) {
+        clear();
+        locations.reserve(students.size());
+        for (const auto& student : students) {
+            insert(student.get());
+        }
+    }
+
+    /**
+     * @brief Removes every student, detaching them from the index.
+     */
+    void StudentIndex::clear() {
+        for (auto& [key, members] : cells) {
+            for (Student* student : members) {
+                student->setIndex(nullptr);
+            }
+        }
+        cells.clear();
+        locations.clear();
+    }
+
+    /**
+     * @brief Finds the first cell that could match a filter.
+     *
+     * Cells are ordered by grade level, then letter grade, then age, so a
+     * fixed grade level (and letter grade) lets the walk start at the first
+     * matching cell instead of the first cell.
+     *
+     * @param filter The filter.
+     * @return Iterator to the first candidate cell.
+     */
+    StudentIndex::CellMap::const_iterator StudentIndex::firstCandidate(const StudentFilter& filter) const {
+        if (filter.gradeLevel == 0) {
+            return cells.begin();
+        }
+
+        StudentIndexKey start{ filter.gradeLevel, std::numeric_limits<char>::min(), 0 };
+        if (filter.letterGrade) {
+            start.letterGrade = *filter.letterGrade;
+            start.age = filter.minAge;
+        }
+        return cells.lower_bound(start);
+    }
+
+    /**
+     * @brief Checks whether a cell lies past every cell a filter can match.
+     * @param key The cell's key.
+     * @param filter The filter.
+     * @return True if the walk can stop.
+     */
+    bool StudentIndex::pastCandidates(const StudentIndexKey& key, const StudentFilter& filter) {
+        if (filter.gradeLevel == 0) {
+            return false;
+        }
+        if (key.gradeLevel != filter.gradeLevel) {
+            return true;
+        }
+        return filter.letterGrade
+            && (key.letterGrade != *filter.letterGrade || key.age > filter.maxAge);
+    }
+
+    /**
+     * @brief Checks whether every student in a cell matches a filter.
+     * @param key The cell's key.
+     * @param filter The filter.
+     * @return True on a match.
+     */
+    bool StudentIndex::cellMatches(const StudentIndexKey& key, const StudentFilter& filter) {
+        return (filter.gradeLevel == 0 || key.gradeLevel == filter.gradeLevel)
+            && (!filter.letterGrade || key.letterGrade == *filter.letterGrade)
+            && key.age >= filter.minAge
+            && key.age <= filter.maxAge;
+    }
+
+    /**
+     * @brief Finds the students matching a filter.
+     *
+     * Only whole cells are matched, so no student record is read; the cost
+     * is the number of candidate cells plus the number of results.
+     *
+     * @param filter Grade level, letter grade and age band to match.
+     * @return Matching students, grouped by grade level, then letter grade, then age.
+     */
+    std::vector<Student*> StudentIndex::find(const StudentFilter& filter) const {
+        std::vector<Student*> matches;
+        matches.reserve(count(filter));
+        for (auto it = firstCandidate(filter); it != cells.end() && !pastCandidates(it->first, filter); ++it) {
+            if (cellMatches(it->first, filter)) {
+                matches.insert(matches.end(), it->second.begin(), it->second.end());
+            }
+        }
+        return matches;
+    }
+
+    /**
+     * @brief Counts the students matching a filter without listing them.
+     * @param filter Grade level, letter grade and age band to match.
+     * @return Number of matching students.
+     */
+    size_t StudentIndex::count(const StudentFilter& filter) const {
+        size_t total = 0;
+        for (auto it = firstCandidate(filter); it != cells.end() && !pastCandidates(it->first, filter); ++it) {
+            if (cellMatches(it->first, filter)) {
+                total += it->second.size();
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Gets the number of indexed students.
+     * @return Student count.
+     */
+    size_t StudentIndex::size() const {
+        return locations.size();
+    }
+}
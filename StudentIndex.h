@@ -0,0 +1,156 @@
+#pragma once
+#include <compare>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace gradebook {
+
+    class Student;
+
+    /**
+     * @brief The indexed attributes of one student.
+     */
+    struct StudentIndexKey {
+        unsigned gradeLevel = 0;       /**< Student's grade level */
+        char letterGrade = '\0';       /**< Overall letter grade; '\0' if not graded yet */
+        unsigned age = 0;              /**< Student's age */
+
+        auto operator<=>(const StudentIndexKey&) const = default;
+    };
+
+    /**
+     * @brief Describes which students a filtered query should return.
+     */
+    struct StudentFilter {
+        unsigned gradeLevel = 0;                             /**< Restrict to one grade level; 0 means every grade */
+        std::optional<char> letterGrade;                     /**< Restrict to one letter grade; '\0' finds ungraded students */
+        unsigned minAge = 0;                                 /**< Youngest age in the band, inclusive */
+        unsigned maxAge = std::numeric_limits<unsigned>::max(); /**< Oldest age in the band, inclusive */
+    };
+
+    /**
+     * @class StudentIndex
+     * @brief Groups a school's students by grade level, overall letter grade and age.
+     *
+     * Every distinct (grade level, letter grade, age) combination gets one
+     * cell holding the students that share it. There are only a few hundred
+     * such cells in any school, so a filtered query visits the matching
+     * cells and copies out their students: its cost follows the size of
+     * the answer, not the size of the school.
+     *
+     * Students report their own changes: an indexed student calls update()
+     * whenever its grade level, age or overall grade changes, and the student
+     * moves cells in constant time.
+     */
+    class StudentIndex {
+    private:
+        using CellMap = std::map<StudentIndexKey, std::vector<Student*>>;
+
+        /**
+         * @brief Where one indexed student currently sits.
+         */
+        struct Location {
+            CellMap::iterator cell;    /**< Cell holding the student */
+            size_t position = 0;       /**< Position inside that cell */
+        };
+
+        CellMap cells;                                       /**< Non-empty cells in key order */
+        std::unordered_map<const Student*, Location> locations; /**< Cell and position of every indexed student */
+
+        /**
+         * @brief Builds the key a student currently belongs under.
+         * @param student The student.
+         * @return The student's key.
+         */
+        static StudentIndexKey keyOf(const Student* student);
+
+        /**
+         * @brief Appends a student to the cell for a key.
+         * @param student The student.
+         * @param key Cell to join.
+         * @return The student's new location.
+         */
+        Location place(Student* student, const StudentIndexKey& key);
+
+        /**
+         * @brief Takes a student out of its cell by swapping the cell's last student into its place.
+         * @param location The student's current location.
+         */
+        void unplace(const Location& location);
+
+        /**
+         * @brief Finds the first cell that could match a filter.
+         * @param filter The filter.
+         * @return Iterator to the first candidate cell.
+         */
+        CellMap::const_iterator firstCandidate(const StudentFilter& filter) const;
+
+        /**
+         * @brief Checks whether a cell lies past every cell a filter can match.
+         * @param key The cell's key.
+         * @param filter The filter.
+         * @return True if the walk can stop.
+         */
+        static bool pastCandidates(const StudentIndexKey& key, const StudentFilter& filter);
+
+        /**
+         * @brief Checks whether every student in a cell matches a filter.
+         * @param key The cell's key.
+         * @param filter The filter.
+         * @return True on a match.
+         */
+        static bool cellMatches(const StudentIndexKey& key, const StudentFilter& filter);
+
+    public:
+        /**
+         * @brief Adds a student and starts listening for its changes.
+         * @param student The student to index.
+         */
+        void insert(Student* student);
+
+        /**
+         * @brief Removes a student and stops listening for its changes.
+         * @param student The student to remove.
+         * @return True if the student was indexed.
+         */
+        bool erase(Student* student);
+
+        /**
+         * @brief Moves a student to the cell matching its current grade level, age and grade.
+         * @param student The student that changed; ignored if it is not indexed.
+         */
+        void update(Student* student);
+
+        /**
+         * @brief Replaces the index contents with every student in a list.
+         * @param students The school's students.
+         */
+        void rebuild(const std::vector<std::unique_ptr<Student>>& students);
+
+        /**
+         * @brief Removes every student, detaching them from the index.
+         */
+        void clear();
+
+        /**
+         * @brief Finds the students matching a filter.
+         * @param filter Grade level, letter grade and age band to match.
+         * @return Matching students, grouped by grade level, then letter grade, then age.
+         */
+        std::vector<Student*> find(const StudentFilter& filter) const;
+
+        /**
+         * @brief Counts the students matching a filter without listing them.
+         * @param filter Grade level, letter grade and age band to match.
+         * @return Number of matching students.
+         */
+        size_t count(const StudentFilter& filter) const;
+
+        /** @brief Gets the number of indexed students. */
+        size_t size() const;
+    };
+}
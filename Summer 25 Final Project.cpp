@@ -1,3 +1,6 @@
+#include "CommandLine.h"
+#include "Compression.h"
+#include "District.h"
 #include "Gradebook.h"
 #include "utilities.h"
 #include <iostream>
@@ -7,15 +10,38 @@ using namespace gradebook;
 /**
  * @brief Entry point of the Gradebook application.
  *
- * Creates a Gradebook instance and launches the welcome menu
+ * With --query, runs the query headless and exits without showing any
+ * menu. Runs in district mode, serving several schools from their own
+ * data files, when district.dat exists or --district is passed.
+ * Otherwise creates a single Gradebook and launches the welcome menu,
  * which handles loading, login, and the main program flow.
  *
+ * @param argc Number of command-line arguments.
+ * @param argv Command-line arguments.
  * @return int Returns 0 upon successful program termination.
  */
-int main()
+int main(int argc, char* argv[])
 {
+    CommandLineOptions options;
+    if (!parseCommandLine(argc, argv, options)) {
+        return 1;
+    }
+    setExportCompression(options.compress);
+
+    if (isHeadless(options)) {
+        return runHeadless(options);
+    }
+
+    if (options.district || fileExists("district.dat")) {
+        District district;
+        district.loadManifest();
+        district.menu();
+        return 0;
+    }
+
     Gradebook gradebook;
+    gradebook.setDataFile(options.dataFile);
     welcomeMenu(gradebook);
 
     return 0;
-}
\ No newline at end of file
+}
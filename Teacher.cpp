@@ -7,10 +7,15 @@
 #include "Student.h"
 #include "User.h"
 #include "Gradebook.h"
+#include "Statistics.h"
+#include "ChangeExport.h"
+#include "Compression.h"
 #include "utilities.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 namespace gradebook {
 
@@ -20,6 +25,7 @@ namespace gradebook {
 	 */
 	void Teacher::setTitle(const std::string& entry) {
 		title = entry;
+		touch();
 	}
 
 	/**
@@ -28,6 +34,17 @@ namespace gradebook {
 	 */
 	void Teacher::setGradeLevel(const unsigned& entry) {
 		gradeLevel = entry;
+		touch();
+	}
+
+	/**
+	 * @brief Stamps this classroom with a fresh revision.
+	 *
+	 * Called by every operation that changes the roster, the assignments or
+	 * the scores, so that the gradebook's report cache knows to re-render it.
+	 */
+	void Teacher::touch() const {
+		revision = Gradebook::nextRevision();
 	}
 
 	/**
@@ -62,6 +79,30 @@ namespace gradebook {
 		return gradeLevel;
 	}
 
+	/**
+	 * @brief Sets the classroom ID issued by the gradebook.
+	 * @param entry The classroom ID.
+	 */
+	void Teacher::setClassroomID(unsigned entry) {
+		classroomID = entry;
+	}
+
+	/**
+	 * @brief Retrieves the stable ID of this teacher's classroom.
+	 * @return The classroom ID.
+	 */
+	unsigned Teacher::getClassroomID() const {
+		return classroomID;
+	}
+
+	/**
+	 * @brief Retrieves the revision of this classroom's roster and scores.
+	 * @return The revision stamped by the most recent change.
+	 */
+	unsigned long long Teacher::getRevision() const {
+		return revision;
+	}
+
 	/**
 	 * @brief Retrieves the teacher's password (for login verification).
 	 * @return The stored password string.
@@ -107,7 +148,111 @@ namespace gradebook {
 	 * @param student Pointer to the Student to add.
 	 */
 	void Teacher::addStudentToClassroom(Student* student) {
+		student->enroll(classroomID);
+		rosterPositions[student] = students.size();
 		students.push_back(student);
+		rosterIndex.insert(student);
+		touch();
+	}
+
+	/**
+	 * @brief Adds a batch of students to the roster, sorting the index only once.
+	 * @param batch Pointers to the Students to add.
+	 */
+	void Teacher::addStudentsToClassroom(const std::vector<Student*>& batch) {
+		rosterPositions.reserve(students.size() + batch.size());
+		for (Student* student : batch) {
+			student->enroll(classroomID);
+			rosterPositions[student] = students.size();
+			students.push_back(student);
+		}
+		rosterIndex.insertBatch(batch);
+		touch();
+	}
+
+	/**
+	 * @brief Checks whether a student is on this roster.
+	 * @param student Student to look for.
+	 * @return True if the student is on the roster.
+	 */
+	bool Teacher::hasStudent(const Student* student) const {
+		return rosterPositions.count(student) != 0;
+	}
+
+	/**
+	 * @brief Removes one student from the roster by swapping the last student into its place.
+	 * @param student Student to remove.
+	 * @return True if the student was on the roster.
+	 */
+	bool Teacher::removeStudentFromClassroom(Student* student) {
+		auto found = rosterPositions.find(student);
+		if (found == rosterPositions.end()) {
+			return false;
+		}
+
+		size_t position = found->second;
+		rosterPositions.erase(found);
+		if (position + 1 != students.size()) {
+			students[position] = students.back();
+			rosterPositions[students[position]] = position;
+		}
+		students.pop_back();
+
+		student->withdraw(classroomID);
+		rosterIndex.erase(student);
+		touch();
+		return true;
+	}
+
+	/**
+	 * @brief Removes many students with a single compaction of the roster and its index.
+	 * @param batch Students to remove; ones not on the roster are ignored.
+	 * @return Number of students removed.
+	 */
+	size_t Teacher::removeStudentsFromClassroom(const std::unordered_set<const Student*>& batch) {
+		size_t before = students.size();
+		students.erase(std::remove_if(students.begin(), students.end(),
+			[&](Student* s) {
+				if (batch.count(s) == 0) return false;
+				s->withdraw(classroomID);
+				return true;
+			}), students.end());
+		size_t removed = before - students.size();
+		if (removed == 0) {
+			return 0;
+		}
+
+		rosterPositions.clear();
+		rosterPositions.reserve(students.size());
+		for (size_t i = 0; i < students.size(); ++i) {
+			rosterPositions[students[i]] = i;
+		}
+		rosterIndex.eraseBatch(batch);
+		touch();
+		return removed;
+	}
+
+	/**
+	 * @brief Moves a renamed student to their new place in the name index.
+	 * @param student Student on this roster whose name has already changed.
+	 *
+	 * The old keys can no longer be rebuilt from the student, so the entry
+	 * is found by pointer instead.
+	 */
+	void Teacher::reindexStudentName(Student* student) {
+		if (!hasStudent(student)) return;
+
+		rosterIndex.eraseBatch({ student });
+		rosterIndex.insert(student);
+		touch();
+	}
+
+	/**
+	 * @brief Provides read-only access to the name-ordered roster index.
+	 * @return A const reference to the RosterIndex.
+	 */
+	const RosterIndex& Teacher::getRosterIndex() const {
+		return rosterIndex;
 	}
 
 	/**
@@ -129,15 +274,11 @@ namespace gradebook {
 
 		// 1) pick a student
 		std::cout << "Select a student to enter grades for:\n";
-		for (size_t i = 0; i < students.size(); ++i) {
-			std::cout << i + 1 << ". "
-				<< students[i]->getFirstName() << " "
-				<< students[i]->getLastName() << "\n";
+		Student* selected = pickStudent(rosterIndex);
+		if (!selected) {
+			std::cout << "No student selected.\n";
+			return;
 		}
-		unsigned idx = numericValidator<unsigned>(
-			"Enter the number of the student: ",
-			1, students.size());
-		Student* selected = students[idx - 1];
 
 		// 2) choose bulk or single
 		std::cout << "Would you like to:\n"
@@ -154,7 +295,7 @@ namespace gradebook {
 					"\" (" + std::to_string(a.getPointsPossible()) + " pts): ";
 				float score = numericValidator<float>(
 					prompt, 0.0f, a.getPointsPossible());
-				selected->setAssignmentScore(a.getAssignmentName(), score);
+				selected->setAssignmentScore(classroomID, a.getAssignmentID(), score);
 			}
 		}
 		else {
@@ -176,18 +317,17 @@ namespace gradebook {
 				"\" (" + std::to_string(a.getPointsPossible()) + " pts): ";
 			float score = numericValidator<float>(
 				prompt, 0.0f, a.getPointsPossible());
-			selected->setAssignmentScore(a.getAssignmentName(), score);
+			selected->setAssignmentScore(classroomID, a.getAssignmentID(), score);
 		}
 
 		// 3) recalc & autosave
-		selected->calculateGrade(assignments);
+		selected->calculateGrade(classroomID, assignments);
+		touch();
 		std::cout << "Grades recorded for "
 			<< selected->getFirstName() << " "
 			<< selected->getLastName() << ".\n";
 
-		if (gradebook.isAutosaveEnabled()) {
-			gradebook.serializeAndSave();
-		}
+		gradebook.autosave();
 	}
 
 	/**
@@ -197,9 +337,10 @@ namespace gradebook {
 	void Teacher::scoreAllStudents(const std::vector<Assignment>& assignments) {
 		for (auto* student : students) {
 			if (student) {
-				student->calculateGrade(assignments);
+				student->calculateGrade(classroomID, assignments);
 			}
 		}
+		touch();
 	}
 
 	/**
@@ -216,11 +357,12 @@ namespace gradebook {
 			assignment.setPointsPossible(numericValidator("Please enter the number of points it is possible to receive on this assignment: ", 1, 500));
 		} while (!userCheck("Does this look right to you? [Y / N] ", "Great! Let's continue", "That's okay. Let's try again."));
 
+		assignment.setAssignmentID(gradebook.registerAssignment(*this));
 		assignments.push_back(assignment);
+		gradebook.indexAssignmentDescription(assignments.back());
+		touch();
 
-		if (gradebook.isAutosaveEnabled()) {
-			gradebook.serializeAndSave();
-		}
+		gradebook.autosave();
 
 
 		if (userCheck("Would you like to add another assignment? ",
@@ -229,13 +371,163 @@ namespace gradebook {
 			addAssignment(assignments, gradebook);
 		}
 		else {
-			if (gradebook.isAutosaveEnabled()) {
-				gradebook.serializeAndSave();
-			}
+			gradebook.autosave();
 			menu(gradebook);
 		}
 	}
 
+	/**
+	 * @brief Finds one of this teacher's assignments by its stable ID.
+	 * @param assignmentID ID to look up.
+	 * @return Pointer to the assignment, or nullptr if this teacher has none with that ID.
+	 */
+	const Assignment* Teacher::findAssignment(unsigned assignmentID) const {
+		for (const auto& a : assignments) {
+			if (a.getAssignmentID() == assignmentID) {
+				return &a;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * @brief Finds one of this teacher's assignments by its stable ID for editing.
+	 * @param assignmentID ID to look up.
+	 * @return Pointer to the assignment, or nullptr if this teacher has none with that ID.
+	 */
+	Assignment* Teacher::findAssignment(unsigned assignmentID) {
+		for (auto& a : assignments) {
+			if (a.getAssignmentID() == assignmentID) {
+				return &a;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * @brief Marks every score for an assignment changed, so delta exports resend the rows showing its name or points.
+	 * @param assignmentID ID of the assignment.
+	 */
+	void Teacher::touchScores(unsigned assignmentID) {
+		for (auto* student : students) {
+			if (student) {
+				student->touchAssignmentScore(classroomID, assignmentID);
+			}
+		}
+	}
+
+	/**
+	 * @brief Renames an assignment. Scores refer to it by ID, so they are only marked changed.
+	 * @param assignmentID ID of the assignment to rename.
+	 * @param name The new name.
+	 * @return True if the assignment exists.
+	 */
+	bool Teacher::renameAssignment(unsigned assignmentID, const std::string& name) {
+		Assignment* a = findAssignment(assignmentID);
+		if (!a) {
+			return false;
+		}
+		a->setAssignmentName(name);
+		touchScores(assignmentID);
+		touch();
+		return true;
+	}
+
+	/**
+	 * @brief Changes an assignment's points possible and regrades this classroom.
+	 * @param assignmentID ID of the assignment to change.
+	 * @param points The new points possible.
+	 * @return True if the assignment exists.
+	 */
+	bool Teacher::setAssignmentPoints(unsigned assignmentID, float points) {
+		Assignment* a = findAssignment(assignmentID);
+		if (!a) {
+			return false;
+		}
+		a->setPointsPossible(points);
+		touchScores(assignmentID);
+		scoreAllStudents(assignments);
+		return true;
+	}
+
+	/**
+	 * @brief Deletes an assignment, drops its scores from this roster and regrades it.
+	 * @param assignmentID ID of the assignment to delete.
+	 * @param gradebook Gradebook that issued the ID.
+	 * @return True if the assignment existed.
+	 */
+	bool Teacher::deleteAssignment(unsigned assignmentID, Gradebook& gradebook) {
+		auto it = std::find_if(assignments.begin(), assignments.end(),
+			[&](const Assignment& a) { return a.getAssignmentID() == assignmentID; });
+		if (it == assignments.end()) {
+			return false;
+		}
+
+		assignments.erase(it);
+		gradebook.unregisterAssignment(assignmentID);
+		for (auto* student : students) {
+			if (student) {
+				student->eraseAssignmentScore(classroomID, assignmentID);
+			}
+		}
+		scoreAllStudents(assignments);
+		return true;
+	}
+
+	/**
+	 * @brief Lets the teacher rename, re-point or delete one of their assignments.
+	 * @param gradebook Reference to trigger autosave.
+	 */
+	void Teacher::manageAssignments(Gradebook& gradebook) {
+		if (assignments.empty()) {
+			std::cout << "There are no assignments in the system.\n";
+			return;
+		}
+
+		std::vector<std::string> labels;
+		labels.reserve(assignments.size());
+		for (const auto& a : assignments) {
+			std::ostringstream label;
+			label << a.getAssignmentNameView() << " (" << a.getPointsPossible() << " pts)";
+			labels.push_back(label.str());
+		}
+
+		std::cout << "Select an assignment:\n";
+		size_t picked = pickFromList(labels);
+		if (picked == labels.size()) {
+			std::cout << "No assignment selected.\n";
+			return;
+		}
+		unsigned assignmentID = assignments[picked].getAssignmentID();
+
+		std::cout << "1. Rename it\n"
+			<< "2. Change its points possible\n"
+			<< "3. Delete it\n";
+		unsigned choice = numericValidator<unsigned>("Choose an option [1-3]: ", 1, 3);
+
+		if (choice == 1) {
+			renameAssignment(assignmentID, stringValidator("Please enter the new name of this assignment: "));
+			std::cout << "Assignment renamed.\n";
+		}
+		else if (choice == 2) {
+			float points = numericValidator<float>(
+				"Please enter the new number of points possible: ", 1.0f, 500.0f);
+			setAssignmentPoints(assignmentID, points);
+			std::cout << "Points updated and grades recalculated.\n";
+		}
+		else {
+			if (!userCheck("This also deletes every score recorded for it. Are you sure? [Y/N] ",
+				"Deleting assignment.",
+				"Keeping assignment.")) {
+				return;
+			}
+			deleteAssignment(assignmentID, gradebook);
+			std::cout << "Assignment deleted and grades recalculated.\n";
+		}
+
+		gradebook.autosave();
+	}
+
     /**
  * @brief Prints a detailed report of the entire classroom roster, including student info and grades.
  */
@@ -264,10 +556,13 @@ namespace gradebook {
             << "\n"
             << std::string(110, '-') << "\n";
 
+        bool gradesChanged = false;
         for (auto* s : students) {
             if (!s) continue;
 
-            s->calculateGrade(assignments);
+            float previousPercent = s->getClassroomGradePercent(classroomID);
+            s->calculateGrade(classroomID, assignments);
+            gradesChanged = gradesChanged || s->getClassroomGradePercent(classroomID) != previousPercent;
 
             std::cout << std::left
                 << std::setw(15) << s->getFirstName()
@@ -278,10 +573,13 @@ namespace gradebook {
                 << std::setw(10) << s->getSeat()
                 << std::setw(20) << s->getNotes()
                 << std::setw(10) << std::fixed << std::setprecision(2)
-                << s->getGradePercent()
-                << std::setw(8) << s->getOverallGrade()
+                << s->getClassroomGradePercent(classroomID)
+                << std::setw(8) << s->getClassroomGrade(classroomID)
                 << "\n";
         }
+        if (gradesChanged) {
+            touch();
+        }
 
         std::cout << std::endl;
         if (userCheck(
@@ -306,29 +604,12 @@ namespace gradebook {
             return;
         }
 
-        std::vector<Student*> sortedStudents = students;
-
-        for (size_t i = 0; i < sortedStudents.size(); ++i) {
-            for (size_t j = 0; j < sortedStudents.size() - 1 - i; ++j) {
-                Student* studentA = sortedStudents[j];
-                Student* studentB = sortedStudents[j + 1];
-                if (!studentA || !studentB) continue;
-
-                if (studentA->getLastName() > studentB->getLastName() ||
-                    (studentA->getLastName() == studentB->getLastName() &&
-                        studentA->getFirstName() > studentB->getFirstName()))
-                {
-                    std::swap(sortedStudents[j], sortedStudents[j + 1]);
-                }
-            }
-        }
-
+        // The roster index is kept in name order on insert, so listing is a single pass.
         std::cout << "List of students:" << std::endl;
         int count = 1;
-        for (const Student* s : sortedStudents) {
-            if (!s) continue;
-            std::cout << std::setw(2) << count++ << ". " << s->getFirstName()
-                << " " << s->getLastName() << std::endl;
+        for (const RosterEntry& entry : rosterIndex.getEntries()) {
+            std::cout << std::setw(2) << count++ << ". " << entry.student->getFirstName()
+                << " " << entry.student->getLastName() << std::endl;
         }
     }
 
@@ -356,20 +637,21 @@ namespace gradebook {
                 << std::right << std::setw(10) << "Score\n";
             std::cout << "----------------------------------------\n";
 
+            // One buffer is reused for every row instead of building a new name string each time.
+            std::string studentName;
             for (const auto* student : students) {
                 if (!student) continue;
 
-                auto scores = student->getAssignmentScores();
-                auto it = scores.find(assignment.getAssignmentName());
+                auto score = student->getAssignmentScore(classroomID, assignment.getAssignmentID());
 
-                std::string studentName = student->getFirstName()
-                    + " " + student->getLastName();
+                studentName.assign(student->getFirstNameView())
+                    .append(" ").append(student->getLastNameView());
 
-                if (it != scores.end()) {
+                if (score) {
                     std::cout << std::left << std::setw(25) << studentName
                         << std::right << std::setw(10)
                         << std::fixed << std::setprecision(2)
-                        << it->second << '\n';
+                        << *score << '\n';
                 }
                 else {
                     std::cout << std::left << std::setw(25) << studentName
@@ -387,41 +669,151 @@ namespace gradebook {
     }
 
     /**
-     * @brief Exports the classroom report data to a CSV file named "<Title>_<LastName>_Grade<Level>.csv".
+     * @brief Prints mean, deviation, quartiles and histograms for the class and each assignment.
      */
-    void Teacher::exportClassroomReportToCSV() const {
+    void Teacher::printClassStatistics() const {
         if (students.empty()) {
-            std::cout << "No students in your classroom to export." << std::endl;
+            std::cout << "No students in your class.\n";
             return;
         }
 
-        std::string filename = getTitle() + "_" + getLastName()
+        StatisticsReport report = computeClassroomStatistics(*this);
+        std::cout << "=== Class Statistics for " << getTitle() << " " << getLastName() << " ===\n";
+        printStatistics(report);
+
+        if (userCheck("Would you like to export these statistics to CSV? [Y/N] ",
+            "Exporting statistics to CSV...",
+            "Skipping export."))
+        {
+            std::string filename = getTitle() + "_" + getLastName()
+                + "_Grade" + std::to_string(getGradeLevel())
+                + "_Statistics.csv";
+            for (char& ch : filename) {
+                if (ch == ' ') ch = '_';
+            }
+            exportStatisticsToCSV(report, exportFileName(filename));
+        }
+    }
+
+    /**
+     * @brief Gets the name of the classroom report CSV: "<Title>_<LastName>_Grade<Level>.csv".
+     * @return The file name.
+     */
+    std::string Teacher::classroomReportFileName() const {
+        return getTitle() + "_" + getLastName()
             + "_Grade" + std::to_string(getGradeLevel())
             + ".csv";
+    }
 
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open file " << filename
-                << " for writing." << std::endl;
-            return;
+    /**
+     * @brief Gets the name of the assignment scores CSV: "<Title>_<LastName>_Grade<Level>_AssignmentScores.csv".
+     * @return The file name, with spaces replaced by underscores.
+     */
+    std::string Teacher::assignmentScoresFileName() const {
+        std::string filename = getTitle() + "_" + getLastName()
+            + "_Grade" + std::to_string(getGradeLevel())
+            + "_AssignmentScores.csv";
+        for (char& ch : filename) {
+            if (ch == ' ') ch = '_';
         }
+        return filename;
+    }
 
-        file << "First Name,Last Name,Pronouns,Age,ID,Seat,Notes,Grade %,Letter Grade\n";
+    /**
+     * @brief Writes the classroom report CSV: one row per student with their grade in this class.
+     * @param out Destination of the CSV text.
+     * @return Number of student rows written.
+     */
+    size_t Teacher::writeClassroomReportCSV(std::ostream& out) const {
+        out << "First Name,Last Name,Pronouns,Age,ID,Seat,Notes,Grade %,Letter Grade\n";
 
+        size_t rows = 0;
         for (const auto* s : students) {
             if (!s) continue;
 
-            file << std::quoted(s->getFirstName()) << ','
-                << std::quoted(s->getLastName()) << ','
-                << std::quoted(s->getPronouns()) << ','
-                << s->getAge() << ','
-                << s->getID() << ','
-                << std::quoted(s->getSeat()) << ','
-                << std::quoted(s->getNotes()) << ','
-                << std::fixed << std::setprecision(2)
-                << s->getGradePercent() << ','
-                << s->getOverallGrade() << '\n';
+            writeClassroomReportRow(out, *s);
+            out << '\n';
+            ++rows;
+        }
+        return rows;
+    }
+
+    /**
+     * @brief Writes the cells of one classroom report CSV row, without the line end.
+     * @param out Destination of the CSV text.
+     * @param s Student the row is about.
+     */
+    void Teacher::writeClassroomReportRow(std::ostream& out, const Student& s) const {
+        writeQuoted(out, s.getFirstNameView());
+        out << ',';
+        writeQuoted(out, s.getLastNameView());
+        out << ',';
+        writeQuoted(out, s.getPronounsView());
+        out << ',' << s.getAge()
+            << ',' << s.getID() << ',';
+        writeQuoted(out, s.getSeatView());
+        out << ',';
+        writeQuoted(out, s.getNotesView());
+        out << ','
+            << std::fixed << std::setprecision(2)
+            << s.getClassroomGradePercent(classroomID) << ','
+            << s.getClassroomGrade(classroomID);
+    }
+
+    /**
+     * @brief Writes one block per assignment listing every student's score, or N/A if ungraded.
+     * @param out Destination of the CSV text.
+     * @return Number of score rows written.
+     */
+    size_t Teacher::writeAssignmentScoresCSV(std::ostream& out) const {
+        size_t rows = 0;
+        for (const auto& assignment : assignments) {
+            out << "Assignment:," << assignment.getAssignmentNameView() << ","
+                << assignment.getPointsPossible() << " pts\n";
+            out << "Student Name,Score\n";
+
+            for (const auto* student : students) {
+                if (!student) continue;
+
+                std::string_view firstName = student->getFirstNameView();
+                std::string_view lastName = student->getLastNameView();
+                auto score = student->getAssignmentScore(classroomID, assignment.getAssignmentID());
+
+                if (score) {
+                    out << "\"" << firstName << " " << lastName << "\","
+                        << std::fixed << std::setprecision(2)
+                        << *score << "\n";
+                }
+                else {
+                    out << "\"" << firstName << " " << lastName << "\",N/A\n";
+                }
+                ++rows;
+            }
+
+            out << "\n";
         }
+        return rows;
+    }
+
+    /**
+     * @brief Exports the classroom report data to a CSV file named "<Title>_<LastName>_Grade<Level>.csv".
+     */
+    void Teacher::exportClassroomReportToCSV() const {
+        if (students.empty()) {
+            std::cout << "No students in your classroom to export." << std::endl;
+            return;
+        }
+
+        std::string filename = exportFileName(classroomReportFileName());
+
+        ExportFile file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file " << filename
+                << " for writing." << std::endl;
+            return;
+        }
+
+        writeClassroomReportCSV(file);
 
         file.close();
         std::cout << "Classroom report exported successfully to "
@@ -438,56 +830,55 @@ namespace gradebook {
             return;
         }
 
-        std::string filename = getTitle() + "_" + getLastName()
-            + "_Grade" + std::to_string(getGradeLevel())
-            + "_AssignmentScores.csv";
-        for (char& ch : filename) {
-            if (ch == ' ') ch = '_';
-        }
+        std::string filename = exportFileName(assignmentScoresFileName());
 
-        std::ofstream outFile(filename);
+        ExportFile outFile(filename);
         if (!outFile.is_open()) {
             std::cerr << "Error opening file for writing.\n";
             return;
         }
 
-        for (const auto& assignment : assignments) {
-            outFile << "Assignment:," << assignment.getAssignmentName() << ","
-                << assignment.getPointsPossible() << " pts\n";
-            outFile << "Student Name,Score\n";
-
-            for (const auto* student : students) {
-                if (!student) continue;
-
-                std::string studentName = student->getFirstName()
-                    + " " + student->getLastName();
-                auto scores = student->getAssignmentScores();
-                auto it = scores.find(assignment.getAssignmentName());
-
-                if (it != scores.end()) {
-                    outFile << "\"" << studentName << "\","
-                        << std::fixed << std::setprecision(2)
-                        << it->second << "\n";
-                }
-                else {
-                    outFile << "\"" << studentName << "\",N/A\n";
-                }
-            }
-
-            outFile << "\n";
-        }
+        writeAssignmentScoresCSV(outFile);
 
         outFile.close();
         std::cout << "Assignment scores exported to \"" << filename
             << "\" successfully.\n";
     }
 
+    /**
+     * @brief Exports the classroom report rows and assignment scores changed since the last change export.
+     * @param gradebook Gradebook whose change log records the exports.
+     *
+     * The first export of each file holds every row; later ones hold only
+     * upserts and deletes, so a spreadsheet or script can apply them.
+     */
+    void Teacher::exportChangesToCSV(Gradebook& gradebook) const {
+        ChangeExportResult classroom;
+        ChangeExportResult scores;
+        bool written = exportClassroomReportChanges(gradebook, *this, classroom);
+        written = exportAssignmentScoreChanges(gradebook, *this, scores) && written;
+
+        for (const auto* result : { &classroom, &scores }) {
+            if (!result->filename.empty()) {
+                std::cout << result->upserts << " changed row(s) and " << result->deletes
+                    << " deleted row(s) exported to " << result->filename << ".\n";
+            }
+        }
+        if (written && classroom.filename.empty() && scores.filename.empty()) {
+            std::cout << "Nothing has changed since your last change export.\n";
+            return;
+        }
+        gradebook.autosave();
+    }
+
     /**
      * @brief Displays the teacher's interactive menu for classroom management.
      * @param gradebook Reference to the Gradebook for navigation and data access.
      */
     void Teacher::menu(Gradebook& gradebook) {
         while (true) {
+            gradebook.reloadExternalChanges();
+
             std::cout << "\n\n===== Teacher Menu =====\n";
             std::cout << "Welcome to the main menu.\n";
             std::cout << "From here you can enter student information and grades.\n\n";
@@ -496,13 +887,16 @@ namespace gradebook {
             std::cout << "3. Generate a report for your entire class.\n";
             std::cout << "4. View all assignments.\n";
             std::cout << "5. Create new assignments.\n";
-            std::cout << "6. Enter grades for an existing assignment.\n";
-            std::cout << "7. Save your work.\n";
-            std::cout << "8. Toggle autosave.\n";
-            std::cout << "9. Log out.\n\n";
+            std::cout << "6. Rename, re-point or delete an assignment.\n";
+            std::cout << "7. Enter grades for an existing assignment.\n";
+            std::cout << "8. View class statistics.\n";
+            std::cout << "9. Export changes since your last change export.\n";
+            std::cout << "10. Save your work.\n";
+            std::cout << "11. Toggle autosave.\n";
+            std::cout << "12. Log out.\n\n";
 
             unsigned choice = numericValidator<unsigned>(
-                "Please enter the number of your selection [1-9]: ", 1, 9);
+                "Please enter the number of your selection [1-12]: ", 1, 12);
 
             switch (choice) {
             case 1:
@@ -519,13 +913,9 @@ namespace gradebook {
                     break;
                 }
                 std::cout << "Select a student to view their report:\n";
-                printAllStudents();
-                unsigned index = numericValidator<unsigned>(
-                    "Enter the number of the student: ", 1, students.size());
-
-                Student* selected = students[index - 1];
+                Student* selected = pickStudent(rosterIndex);
                 if (selected) {
-                    selected->printStudentReport();
+                    selected->printStudentReport({ this });
                 }
                 break;
             }
@@ -549,6 +939,9 @@ namespace gradebook {
                 addAssignment(getAssignments(), gradebook);
                 break;
             case 6:
+                manageAssignments(gradebook);
+                break;
+            case 7:
                 if (students.empty()) {
                     std::cout << "There are no students in your class.\n";
                 }
@@ -559,14 +952,24 @@ namespace gradebook {
                     enterGrades(getAssignments(), gradebook);
                 }
                 break;
-            case 7:
+            case 8:
+                if (students.empty()) {
+                    std::cout << "There are no students in your class.\n";
+                }
+                else {
+                    printClassStatistics();
+                }
+                break;
+            case 9:
+                exportChangesToCSV(gradebook);
+                break;
+            case 10:
                 gradebook.serializeAndSave();
                 break;
-            case 8:
+            case 11:
                 gradebook.autosaveToggle();
                 break;
-            case 9:
-                welcomeMenu(gradebook);
+            case 12:
                 return;
             default:
                 std::cout << "Invalid option. Please try again.\n";
@@ -1,7 +1,11 @@
 #pragma once
 #include "User.h"
 #include "Assignment.h"
+#include "RosterIndex.h"
+#include <iosfwd>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace gradebook {
@@ -19,8 +23,15 @@ namespace gradebook {
 	private:
 		std::string title;            ///< Professional title (e.g., Mr., Ms., Dr.)
 		unsigned gradeLevel;         ///< Grade level taught by the teacher
+		unsigned classroomID = 0;    ///< Stable ID of the teacher's classroom, issued by the gradebook
 		std::vector<Student*> students;      ///< Pointers to students in the teacher's class
+		RosterIndex rosterIndex;             ///< Students ordered by last name, then first name
+		std::unordered_map<const Student*, size_t> rosterPositions; ///< Position of each student in students
 		std::vector<Assignment> assignments; ///< Assignments created by the teacher
+		mutable unsigned long long revision = 0; ///< Bumped whenever the roster or scores change
+
+		/** @brief Stamps the classroom with a fresh revision so cached reports are rebuilt. */
+		void touch() const;
 
 	public:
 		/** @brief Sets the teacher's title. */
@@ -32,6 +43,9 @@ namespace gradebook {
 		/** @brief Gets the teacher's title. */
 		std::string getTitle() const;
 
+		/** @brief Views the teacher's title without copying it. */
+		std::string_view getTitleView() const { return title; }
+
 		/** @brief Gets the teacher's first name (inherited override). */
 		std::string getFirstName() const override;
 
@@ -41,6 +55,15 @@ namespace gradebook {
 		/** @brief Gets the teacher's grade level. */
 		unsigned getGradeLevel() const;
 
+		/** @brief Sets the classroom ID; only the gradebook issues these. */
+		void setClassroomID(unsigned entry);
+
+		/** @brief Gets the stable ID of the teacher's classroom. */
+		unsigned getClassroomID() const;
+
+		/** @brief Gets the revision of this classroom's roster and scores. */
+		unsigned long long getRevision() const;
+
 		/** @brief Gets the teacher's password (inherited override). */
 		std::string getPassword() const override;
 
@@ -57,11 +80,48 @@ namespace gradebook {
 		const std::vector<Student*>& getClassroomStudents() const;
 
 		/**
-		 * @brief Adds a student to the teachers classroom.
+		 * @brief Adds a student to the teachers classroom and enrolls them in it.
 		 * @param student Pointer to the student to add.
 		 */
 		void addStudentToClassroom(Student* student);
 
+		/**
+		 * @brief Adds many students to the classroom, sorting the roster index once.
+		 * @param batch Pointers to the students to add.
+		 */
+		void addStudentsToClassroom(const std::vector<Student*>& batch);
+
+		/**
+		 * @brief Checks whether a student is on this roster.
+		 * @param student Student to look for.
+		 * @return True if the student is on the roster.
+		 */
+		bool hasStudent(const Student* student) const;
+
+		/**
+		 * @brief Removes one student from the roster by swapping the last student into its place,
+		 * withdrawing them from the classroom.
+		 * @param student Student to remove.
+		 * @return True if the student was on the roster.
+		 */
+		bool removeStudentFromClassroom(Student* student);
+
+		/**
+		 * @brief Removes many students with a single compaction of the roster and its index.
+		 * @param batch Students to remove; ones not on the roster are ignored.
+		 * @return Number of students removed.
+		 */
+		size_t removeStudentsFromClassroom(const std::unordered_set<const Student*>& batch);
+
+		/**
+		 * @brief Moves a renamed student to their new place in the name index.
+		 * @param student Student on this roster whose name has already changed.
+		 */
+		void reindexStudentName(Student* student);
+
+		/** @brief Gets the name-ordered roster index. */
+		const RosterIndex& getRosterIndex() const;
+
 		/**
 		 * @brief Enters grades for students in the classroom.
 		 * @param assignments Vector of assignments to grade.
@@ -75,6 +135,12 @@ namespace gradebook {
 		 */
 		void scoreAllStudents(const std::vector<Assignment>& assignments);
 
+		/**
+		 * @brief Marks every score for an assignment changed without altering it.
+		 * @param assignmentID ID of the assignment.
+		 */
+		void touchScores(unsigned assignmentID);
+
 		/**
 		 * @brief Adds a new assignment to the classroom.
 		 * @param assignments Reference to a shared vector of assignments.
@@ -82,6 +148,46 @@ namespace gradebook {
 		 */
 		void addAssignment(std::vector<Assignment>& assignments, Gradebook& gradebook);
 
+		/**
+		 * @brief Finds one of this teacher's assignments by its stable ID.
+		 * @param assignmentID ID to look up.
+		 * @return Pointer to the assignment, or nullptr if this teacher has none with that ID.
+		 */
+		const Assignment* findAssignment(unsigned assignmentID) const;
+
+		/** @brief Finds one of this teacher's assignments by its stable ID for editing. */
+		Assignment* findAssignment(unsigned assignmentID);
+
+		/**
+		 * @brief Renames an assignment without touching any student.
+		 * @param assignmentID ID of the assignment to rename.
+		 * @param name The new name.
+		 * @return True if the assignment exists.
+		 */
+		bool renameAssignment(unsigned assignmentID, const std::string& name);
+
+		/**
+		 * @brief Changes an assignment's points possible and regrades this classroom.
+		 * @param assignmentID ID of the assignment to change.
+		 * @param points The new points possible.
+		 * @return True if the assignment exists.
+		 */
+		bool setAssignmentPoints(unsigned assignmentID, float points);
+
+		/**
+		 * @brief Deletes an assignment, drops its scores from this roster and regrades it.
+		 * @param assignmentID ID of the assignment to delete.
+		 * @param gradebook Gradebook that issued the ID.
+		 * @return True if the assignment existed.
+		 */
+		bool deleteAssignment(unsigned assignmentID, Gradebook& gradebook);
+
+		/**
+		 * @brief Interactive rename, re-point or delete of one assignment.
+		 * @param gradebook Reference to the central Gradebook object.
+		 */
+		void manageAssignments(Gradebook& gradebook);
+
 		/** @brief Prints a summary report of the entire classroom. */
 		void printClassroomReport() const;
 
@@ -91,12 +197,48 @@ namespace gradebook {
 		/** @brief Prints details of all assignments created by the teacher. */
 		void printAllAssignments() const;
 
+		/** @brief Prints score distributions for the class and each assignment. */
+		void printClassStatistics() const;
+
 		/** @brief Exports a full classroom report to a CSV file. */
 		void exportClassroomReportToCSV() const;
 
 		/** @brief Exports assignment scores for all students to a CSV file. */
 		void exportAssignmentScoresToCSV() const;
 
+		/**
+		 * @brief Exports the classroom report rows and assignment scores changed since the last change export.
+		 * @param gradebook Gradebook whose change log records the exports.
+		 */
+		void exportChangesToCSV(Gradebook& gradebook) const;
+
+		/** @brief Gets the name of the file exportClassroomReportToCSV writes. */
+		std::string classroomReportFileName() const;
+
+		/** @brief Gets the name of the file exportAssignmentScoresToCSV writes. */
+		std::string assignmentScoresFileName() const;
+
+		/**
+		 * @brief Writes the classroom report CSV to a stream.
+		 * @param out Destination of the CSV text.
+		 * @return Number of student rows written.
+		 */
+		size_t writeClassroomReportCSV(std::ostream& out) const;
+
+		/**
+		 * @brief Writes the cells of one classroom report CSV row, without the line end.
+		 * @param out Destination of the CSV text.
+		 * @param s Student the row is about.
+		 */
+		void writeClassroomReportRow(std::ostream& out, const Student& s) const;
+
+		/**
+		 * @brief Writes every assignment's scores as CSV to a stream.
+		 * @param out Destination of the CSV text.
+		 * @return Number of score rows written.
+		 */
+		size_t writeAssignmentScoresCSV(std::ostream& out) const;
+
 		/**
 		 * @brief Displays the teacher's interactive menu.
 		 * @param gradebook Reference to the central Gradebook object.
@@ -0,0 +1,532 @@
+#include "TextIndex.h"
+#include "Serialization.h"
+#include "Student.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+namespace gradebook {
+
+    namespace {
+        /**
+         * @brief Marks a listening student whose notes currently have no words.
+         */
+        constexpr uint32_t noDocument = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * @brief Fewest retired documents worth a compaction.
+         */
+        constexpr size_t minimumRetiredToCompact = 1024;
+
+        /**
+         * @brief Fewest documents worth tokenizing on a separate thread.
+         */
+        constexpr size_t minimumDocumentsPerWorker = 4096;
+
+        /**
+         * @brief BM25 term-frequency saturation.
+         */
+        constexpr double bm25K1 = 1.2;
+
+        /**
+         * @brief BM25 document-length normalization.
+         */
+        constexpr double bm25B = 0.75;
+
+        /**
+         * @brief Checks whether a byte belongs inside a word.
+         */
+        bool isWordByte(char ch) {
+            unsigned char uch = static_cast<unsigned char>(ch);
+            return uch >= 0x80 || std::isalnum(uch);
+        }
+
+        /**
+         * @brief Intersects two sorted document lists.
+         */
+        std::vector<uint32_t> intersect(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+            std::vector<uint32_t> out;
+            out.reserve(std::min(a.size(), b.size()));
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+            return out;
+        }
+    }
+
+    /**
+     * @brief Splits text into lower-cased words.
+     * @param text Text to split.
+     * @return The words in order.
+     */
+    std::vector<std::string> TextIndex::tokenize(std::string_view text) {
+        std::vector<std::string> words;
+        size_t i = 0;
+        while (i < text.size()) {
+            while (i < text.size() && !isWordByte(text[i])) ++i;
+            size_t start = i;
+            while (i < text.size() && isWordByte(text[i])) ++i;
+            if (i > start) {
+                std::string word(text.substr(start, i - start));
+                for (char& ch : word) {
+                    ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+                }
+                words.push_back(std::move(word));
+            }
+        }
+        return words;
+    }
+
+    /**
+     * @brief Appends a document and its postings.
+     *
+     * Document IDs only grow, so appending keeps every postings list sorted.
+     *
+     * @param document Who the text belongs to.
+     * @param words The text's words in order.
+     * @return The new document ID.
+     */
+    uint32_t TextIndex::addDocument(Document document, const std::vector<std::string>& words) {
+        uint32_t doc = static_cast<uint32_t>(documents.size());
+
+        // (word ID, position) pairs, grouped by word once sorted.
+        std::vector<std::pair<uint32_t, uint32_t>> occurrences;
+        occurrences.reserve(words.size());
+        for (uint32_t position = 0; position < words.size(); ++position) {
+            auto found = vocabulary.find(words[position]);
+            if (found == vocabulary.end()) {
+                found = vocabulary.emplace(words[position], static_cast<uint32_t>(postings.size())).first;
+                postings.emplace_back();
+            }
+            occurrences.emplace_back(found->second, position);
+        }
+        std::sort(occurrences.begin(), occurrences.end());
+
+        for (size_t i = 0; i < occurrences.size();) {
+            uint32_t term = occurrences[i].first;
+            Postings& list = postings[term];
+            list.docs.push_back(doc);
+            for (; i < occurrences.size() && occurrences[i].first == term; ++i) {
+                list.positions.push_back(occurrences[i].second);
+            }
+            list.offsets.push_back(static_cast<uint32_t>(list.positions.size()));
+            ++list.liveDocs;
+            document.terms.push_back(term);
+        }
+
+        document.length = static_cast<uint32_t>(words.size());
+        document.live = true;
+        liveWords += document.length;
+        ++liveDocuments;
+        documents.push_back(std::move(document));
+        return doc;
+    }
+
+    /**
+     * @brief Retires a document so searches skip it.
+     * @param doc Document ID.
+     */
+    void TextIndex::retireDocument(uint32_t doc) {
+        Document& document = documents[doc];
+        if (!document.live) return;
+
+        document.live = false;
+        --liveDocuments;
+        liveWords -= document.length;
+        for (uint32_t term : document.terms) {
+            --postings[term].liveDocs;
+        }
+        document.terms = {};
+    }
+
+    /**
+     * @brief Purges retired documents once they make up half the index.
+     *
+     * Current documents are renumbered in their existing order, so every
+     * postings list stays sorted without re-sorting.
+     */
+    void TextIndex::compactIfSparse() {
+        size_t retired = documents.size() - liveDocuments;
+        if (retired < minimumRetiredToCompact || retired < liveDocuments) {
+            return;
+        }
+
+        std::vector<uint32_t> renumbered(documents.size(), noDocument);
+        std::vector<Document> kept;
+        kept.reserve(liveDocuments);
+        for (uint32_t doc = 0; doc < documents.size(); ++doc) {
+            if (documents[doc].live) {
+                renumbered[doc] = static_cast<uint32_t>(kept.size());
+                kept.push_back(std::move(documents[doc]));
+            }
+        }
+        documents = std::move(kept);
+
+        for (Postings& list : postings) {
+            Postings compacted;
+            compacted.liveDocs = list.liveDocs;
+            for (size_t e = 0; e < list.docs.size(); ++e) {
+                uint32_t doc = renumbered[list.docs[e]];
+                if (doc == noDocument) continue;
+
+                compacted.docs.push_back(doc);
+                compacted.positions.insert(compacted.positions.end(),
+                    list.positions.begin() + list.offsets[e], list.positions.begin() + list.offsets[e + 1]);
+                compacted.offsets.push_back(static_cast<uint32_t>(compacted.positions.size()));
+            }
+            list = std::move(compacted);
+        }
+
+        for (auto& [student, doc] : studentDocs) {
+            if (doc != noDocument) doc = renumbered[doc];
+        }
+        for (auto& [assignmentID, doc] : assignmentDocs) {
+            doc = renumbered[doc];
+        }
+    }
+
+    /**
+     * @brief Indexes a student's notes, replacing any earlier version, and listens for edits.
+     * @param student The student.
+     * @param notes The student's current notes.
+     */
+    void TextIndex::setStudentNotes(Student* student, std::string_view notes) {
+        if (!student) return;
+
+        uint32_t& doc = studentDocs.try_emplace(student, noDocument).first->second;
+        if (doc != noDocument) {
+            retireDocument(doc);
+            doc = noDocument;
+        }
+        student->setTextIndex(this);
+
+        std::vector<std::string> words = tokenize(notes);
+        if (!words.empty()) {
+            Document document;
+            document.source = TextSource::StudentNotes;
+            document.student = student;
+            doc = addDocument(std::move(document), words);
+        }
+        compactIfSparse();
+    }
+
+    /**
+     * @brief Drops a student's notes and stops listening for edits.
+     * @param student The student.
+     */
+    void TextIndex::removeStudent(Student* student) {
+        auto found = studentDocs.find(student);
+        if (found == studentDocs.end()) return;
+
+        if (found->second != noDocument) {
+            retireDocument(found->second);
+        }
+        studentDocs.erase(found);
+        student->setTextIndex(nullptr);
+        compactIfSparse();
+    }
+
+    /**
+     * @brief Indexes an assignment's description, replacing any earlier version.
+     * @param assignmentID Stable assignment ID.
+     * @param description The current description.
+     */
+    void TextIndex::setAssignmentDescription(unsigned assignmentID, std::string_view description) {
+        removeAssignment(assignmentID);
+
+        std::vector<std::string> words = tokenize(description);
+        if (!words.empty()) {
+            Document document;
+            document.source = TextSource::AssignmentDescription;
+            document.assignmentID = assignmentID;
+            assignmentDocs[assignmentID] = addDocument(std::move(document), words);
+        }
+    }
+
+    /**
+     * @brief Drops an assignment's description.
+     * @param assignmentID Stable assignment ID.
+     */
+    void TextIndex::removeAssignment(unsigned assignmentID) {
+        auto found = assignmentDocs.find(assignmentID);
+        if (found == assignmentDocs.end()) return;
+
+        retireDocument(found->second);
+        assignmentDocs.erase(found);
+        compactIfSparse();
+    }
+
+    /**
+     * @brief Replaces the whole index, tokenizing on several threads.
+     *
+     * Tokenizing is the expensive part and touches nothing shared, so it
+     * runs in parallel; the postings are then appended in a single pass.
+     *
+     * @param students Every student, with their notes.
+     * @param assignments Every assignment ID with its description.
+     */
+    void TextIndex::rebuild(const std::vector<Student*>& students,
+        const std::vector<std::pair<unsigned, std::string_view>>& assignments)
+    {
+        clear();
+
+        std::vector<std::vector<std::string>> studentWords(students.size());
+        unsigned workers = workerCountFor(students.size(), minimumDocumentsPerWorker);
+        parallelForRanges(students.size(), workers, [&](unsigned, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                studentWords[i] = tokenize(students[i]->getNotesView());
+            }
+            });
+
+        studentDocs.reserve(students.size());
+        documents.reserve(students.size() + assignments.size());
+        for (size_t i = 0; i < students.size(); ++i) {
+            uint32_t doc = noDocument;
+            if (!studentWords[i].empty()) {
+                Document document;
+                document.source = TextSource::StudentNotes;
+                document.student = students[i];
+                doc = addDocument(std::move(document), studentWords[i]);
+            }
+            studentDocs[students[i]] = doc;
+            students[i]->setTextIndex(this);
+        }
+
+        for (const auto& [assignmentID, description] : assignments) {
+            setAssignmentDescription(assignmentID, description);
+        }
+    }
+
+    /**
+     * @brief Removes everything and detaches every student.
+     */
+    void TextIndex::clear() {
+        for (auto& [student, doc] : studentDocs) {
+            student->setTextIndex(nullptr);
+        }
+        vocabulary.clear();
+        postings.clear();
+        documents.clear();
+        studentDocs.clear();
+        assignmentDocs.clear();
+        liveDocuments = 0;
+        liveWords = 0;
+    }
+
+    /**
+     * @brief Splits a search into clauses.
+     *
+     * Quoted text is a phrase. A word ending in * is a prefix. A word the
+     * tokenizer splits in two, like "o'neil", becomes a phrase as well.
+     *
+     * @param query Search text.
+     * @return The clauses.
+     */
+    std::vector<TextIndex::Clause> TextIndex::parseClauses(const std::string& query) {
+        std::vector<Clause> clauses;
+        size_t i = 0;
+        while (i < query.size()) {
+            if (std::isspace(static_cast<unsigned char>(query[i]))) {
+                ++i;
+                continue;
+            }
+
+            Clause clause;
+            if (query[i] == '"') {
+                size_t close = query.find('"', i + 1);
+                if (close == std::string::npos) close = query.size();
+                clause.words = tokenize(std::string_view(query).substr(i + 1, close - i - 1));
+                i = close + 1;
+            }
+            else {
+                size_t start = i;
+                while (i < query.size() && !std::isspace(static_cast<unsigned char>(query[i])) && query[i] != '"') ++i;
+                std::string_view word = std::string_view(query).substr(start, i - start);
+                clause.prefix = word.size() > 1 && word.back() == '*';
+                if (clause.prefix) word.remove_suffix(1);
+                clause.words = tokenize(word);
+                clause.prefix = clause.prefix && clause.words.size() == 1;
+            }
+
+            if (!clause.words.empty()) {
+                clauses.push_back(std::move(clause));
+            }
+        }
+        return clauses;
+    }
+
+    /**
+     * @brief Finds the word IDs a clause can match.
+     * @param clause The clause.
+     * @return Word IDs; empty if some word is not indexed.
+     */
+    std::vector<uint32_t> TextIndex::clauseTerms(const Clause& clause) const {
+        std::vector<uint32_t> terms;
+        if (clause.prefix) {
+            const std::string& prefix = clause.words.front();
+            for (auto it = vocabulary.lower_bound(prefix);
+                it != vocabulary.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+                terms.push_back(it->second);
+            }
+            return terms;
+        }
+
+        for (const auto& word : clause.words) {
+            auto found = vocabulary.find(word);
+            if (found == vocabulary.end()) {
+                return {};
+            }
+            terms.push_back(found->second);
+        }
+        return terms;
+    }
+
+    /**
+     * @brief Finds a document's entry in a word's postings.
+     * @param list The word's postings.
+     * @param doc Document ID.
+     * @return Entry position, or list.docs.size() if the word is not in the document.
+     */
+    size_t TextIndex::findEntry(const Postings& list, uint32_t doc) {
+        auto it = std::lower_bound(list.docs.begin(), list.docs.end(), doc);
+        return (it != list.docs.end() && *it == doc) ? static_cast<size_t>(it - list.docs.begin()) : list.docs.size();
+    }
+
+    /**
+     * @brief Checks whether a phrase's words appear consecutively in a document.
+     * @param terms Phrase word IDs in order.
+     * @param doc Document ID.
+     * @return True on a match.
+     */
+    bool TextIndex::phraseOccurs(const std::vector<uint32_t>& terms, uint32_t doc) const {
+        std::vector<std::pair<const uint32_t*, const uint32_t*>> ranges;
+        ranges.reserve(terms.size());
+        for (uint32_t term : terms) {
+            const Postings& list = postings[term];
+            size_t e = findEntry(list, doc);
+            if (e == list.docs.size()) return false;
+            ranges.emplace_back(list.positions.data() + list.offsets[e], list.positions.data() + list.offsets[e + 1]);
+        }
+
+        for (const uint32_t* start = ranges[0].first; start != ranges[0].second; ++start) {
+            bool whole = true;
+            for (size_t k = 1; k < ranges.size() && whole; ++k) {
+                whole = std::binary_search(ranges[k].first, ranges[k].second, *start + static_cast<uint32_t>(k));
+            }
+            if (whole) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Lists the current documents matching a clause.
+     *
+     * A phrase walks the postings of its rarest word and checks the other
+     * words' positions only in those documents.
+     *
+     * @param clause The clause.
+     * @param terms The clause's word IDs.
+     * @return Sorted document IDs.
+     */
+    std::vector<uint32_t> TextIndex::clauseDocuments(const Clause& clause, const std::vector<uint32_t>& terms) const {
+        std::vector<uint32_t> docs;
+        if (clause.prefix) {
+            for (uint32_t term : terms) {
+                for (uint32_t doc : postings[term].docs) {
+                    if (documents[doc].live) docs.push_back(doc);
+                }
+            }
+            std::sort(docs.begin(), docs.end());
+            docs.erase(std::unique(docs.begin(), docs.end()), docs.end());
+            return docs;
+        }
+
+        uint32_t rarest = *std::min_element(terms.begin(), terms.end(),
+            [&](uint32_t a, uint32_t b) { return postings[a].docs.size() < postings[b].docs.size(); });
+        for (uint32_t doc : postings[rarest].docs) {
+            if (documents[doc].live && (terms.size() == 1 || phraseOccurs(terms, doc))) {
+                docs.push_back(doc);
+            }
+        }
+        return docs;
+    }
+
+    /**
+     * @brief Finds the best matches for a search.
+     *
+     * Every clause narrows the candidate documents; the survivors are then
+     * scored with BM25 over every word the clauses matched.
+     *
+     * @param query Search text.
+     * @param limit Most results to return.
+     * @return Hits, most relevant first.
+     */
+    std::vector<TextHit> TextIndex::search(const std::string& query, size_t limit) const {
+        std::vector<Clause> clauses = parseClauses(query);
+        if (clauses.empty() || liveDocuments == 0) {
+            return {};
+        }
+
+        std::vector<uint32_t> matches;
+        std::vector<uint32_t> scoringTerms;
+        for (size_t c = 0; c < clauses.size(); ++c) {
+            std::vector<uint32_t> terms = clauseTerms(clauses[c]);
+            if (terms.empty()) return {};
+
+            std::vector<uint32_t> docs = clauseDocuments(clauses[c], terms);
+            matches = (c == 0) ? std::move(docs) : intersect(matches, docs);
+            if (matches.empty()) return {};
+            scoringTerms.insert(scoringTerms.end(), terms.begin(), terms.end());
+        }
+        std::sort(scoringTerms.begin(), scoringTerms.end());
+        scoringTerms.erase(std::unique(scoringTerms.begin(), scoringTerms.end()), scoringTerms.end());
+
+        double documentCount = static_cast<double>(liveDocuments);
+        double averageLength = static_cast<double>(liveWords) / documentCount;
+        std::vector<double> idf(scoringTerms.size());
+        for (size_t t = 0; t < scoringTerms.size(); ++t) {
+            double df = postings[scoringTerms[t]].liveDocs;
+            idf[t] = std::log(1.0 + (documentCount - df + 0.5) / (df + 0.5));
+        }
+
+        std::vector<TextHit> hits;
+        hits.reserve(matches.size());
+        for (uint32_t doc : matches) {
+            const Document& document = documents[doc];
+            double lengthNorm = 1.0 - bm25B + bm25B * document.length / averageLength;
+
+            double score = 0.0;
+            for (size_t t = 0; t < scoringTerms.size(); ++t) {
+                const Postings& list = postings[scoringTerms[t]];
+                size_t e = findEntry(list, doc);
+                if (e == list.docs.size()) continue;
+                double tf = list.offsets[e + 1] - list.offsets[e];
+                score += idf[t] * tf * (bm25K1 + 1.0) / (tf + bm25K1 * lengthNorm);
+            }
+
+            TextHit hit;
+            hit.source = document.source;
+            hit.student = document.student;
+            hit.assignmentID = document.assignmentID;
+            hit.score = score;
+            hits.push_back(hit);
+        }
+
+        auto better = [](const TextHit& a, const TextHit& b) { return a.score > b.score; };
+        if (hits.size() > limit) {
+            std::partial_sort(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(limit), hits.end(), better);
+            hits.resize(limit);
+        }
+        else {
+            std::sort(hits.begin(), hits.end(), better);
+        }
+        return hits;
+    }
+
+    /**
+     * @brief Gets the number of current documents.
+     * @return Document count.
+     */
+    size_t TextIndex::documentCount() const {
+        return liveDocuments;
+    }
+}
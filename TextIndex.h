@@ -0,0 +1,217 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gradebook {
+
+    class Student;
+
+    /**
+     * @brief Which free-text field a search hit came from.
+     */
+    enum class TextSource {
+        StudentNotes,           /**< Student::notes */
+        AssignmentDescription   /**< Assignment::assignmentDescription */
+    };
+
+    /**
+     * @brief One ranked search result.
+     */
+    struct TextHit {
+        TextSource source = TextSource::StudentNotes;  /**< Field that matched */
+        const Student* student = nullptr;              /**< Student whose notes matched, for StudentNotes */
+        unsigned assignmentID = 0;                     /**< Assignment whose description matched, for AssignmentDescription */
+        double score = 0.0;                            /**< BM25 relevance; higher is better */
+    };
+
+    /**
+     * @class TextIndex
+     * @brief Inverted index over student notes and assignment descriptions.
+     *
+     * Text is split into case-folded words. Every word maps to the documents
+     * containing it and the word positions inside each, stored as flat
+     * arrays that only ever grow at the end. Searches support single words,
+     * "quoted phrases" and prefix* words, all of which must match, and rank
+     * the matches with BM25.
+     *
+     * Editing a document retires its old version and appends a new one;
+     * retired versions are skipped by searches and purged once they make up
+     * half the index. Students report their own note edits, like they
+     * report grade changes to the StudentIndex.
+     */
+    class TextIndex {
+    private:
+        /**
+         * @brief Every occurrence of one word.
+         *
+         * Entry i says document docs[i] holds the word at
+         * positions[offsets[i]] up to positions[offsets[i + 1]].
+         */
+        struct Postings {
+            std::vector<uint32_t> docs;                /**< Documents in increasing order */
+            std::vector<uint32_t> offsets{ 0 };        /**< Start of each document's positions; one extra at the end */
+            std::vector<uint32_t> positions;           /**< Word positions, grouped by document */
+            uint32_t liveDocs = 0;                     /**< Documents still current; BM25's document frequency */
+        };
+
+        /**
+         * @brief One indexed version of a note or description.
+         */
+        struct Document {
+            TextSource source = TextSource::StudentNotes;
+            const Student* student = nullptr;
+            unsigned assignmentID = 0;
+            uint32_t length = 0;                       /**< Number of words */
+            bool live = true;                          /**< False once replaced or removed */
+            std::vector<uint32_t> terms;               /**< Distinct word IDs, to update frequencies on removal */
+        };
+
+        /**
+         * @brief One search clause: a word, a phrase or a prefix.
+         */
+        struct Clause {
+            std::vector<std::string> words;            /**< Words in order; several for a phrase */
+            bool prefix = false;                       /**< Match any word starting with words[0] */
+        };
+
+        std::map<std::string, uint32_t, std::less<>> vocabulary;   /**< Word to word ID, sorted for prefix search */
+        std::vector<Postings> postings;                /**< Postings by word ID */
+        std::vector<Document> documents;               /**< Documents by document ID */
+        std::unordered_map<Student*, uint32_t> studentDocs;        /**< Listening students and their current document, if any */
+        std::unordered_map<unsigned, uint32_t> assignmentDocs;     /**< Assignment ID to current document */
+        size_t liveDocuments = 0;                      /**< Documents still current */
+        uint64_t liveWords = 0;                        /**< Total length of current documents */
+
+        /**
+         * @brief Appends a document and its postings.
+         * @param document Who the text belongs to.
+         * @param words The text's words in order.
+         * @return The new document ID.
+         */
+        uint32_t addDocument(Document document, const std::vector<std::string>& words);
+
+        /**
+         * @brief Retires a document so searches skip it.
+         * @param doc Document ID.
+         */
+        void retireDocument(uint32_t doc);
+
+        /**
+         * @brief Purges retired documents once they make up half the index.
+         */
+        void compactIfSparse();
+
+        /**
+         * @brief Splits a search into clauses.
+         * @param query Search text.
+         * @return The clauses.
+         */
+        static std::vector<Clause> parseClauses(const std::string& query);
+
+        /**
+         * @brief Finds the word IDs a clause can match.
+         * @param clause The clause.
+         * @return Word IDs; empty if some word is not indexed.
+         */
+        std::vector<uint32_t> clauseTerms(const Clause& clause) const;
+
+        /**
+         * @brief Lists the current documents matching a clause.
+         * @param clause The clause.
+         * @param terms The clause's word IDs.
+         * @return Sorted document IDs.
+         */
+        std::vector<uint32_t> clauseDocuments(const Clause& clause, const std::vector<uint32_t>& terms) const;
+
+        /**
+         * @brief Finds a document's entry in a word's postings.
+         * @param list The word's postings.
+         * @param doc Document ID.
+         * @return Entry position, or list.docs.size() if the word is not in the document.
+         */
+        static size_t findEntry(const Postings& list, uint32_t doc);
+
+        /**
+         * @brief Checks whether a phrase's words appear consecutively in a document.
+         * @param terms Phrase word IDs in order.
+         * @param doc Document ID.
+         * @return True on a match.
+         */
+        bool phraseOccurs(const std::vector<uint32_t>& terms, uint32_t doc) const;
+
+    public:
+        /**
+         * @brief Splits text into lower-cased words.
+         *
+         * Letters and digits form words; everything else separates them.
+         * Bytes outside ASCII are kept inside words so UTF-8 text stays whole.
+         *
+         * @param text Text to split.
+         * @return The words in order.
+         */
+        static std::vector<std::string> tokenize(std::string_view text);
+
+        /**
+         * @brief Indexes a student's notes, replacing any earlier version, and listens for edits.
+         * @param student The student.
+         * @param notes The student's current notes.
+         */
+        void setStudentNotes(Student* student, std::string_view notes);
+
+        /**
+         * @brief Drops a student's notes and stops listening for edits.
+         * @param student The student.
+         */
+        void removeStudent(Student* student);
+
+        /**
+         * @brief Indexes an assignment's description, replacing any earlier version.
+         * @param assignmentID Stable assignment ID.
+         * @param description The current description.
+         */
+        void setAssignmentDescription(unsigned assignmentID, std::string_view description);
+
+        /**
+         * @brief Drops an assignment's description.
+         * @param assignmentID Stable assignment ID.
+         */
+        void removeAssignment(unsigned assignmentID);
+
+        /**
+         * @brief Replaces the whole index, tokenizing on several threads.
+         * @param students Every student, with their notes.
+         * @param assignments Every assignment ID with its description.
+         */
+        void rebuild(const std::vector<Student*>& students,
+            const std::vector<std::pair<unsigned, std::string_view>>& assignments);
+
+        /**
+         * @brief Removes everything and detaches every student.
+         */
+        void clear();
+
+        /**
+         * @brief Finds the best matches for a search.
+         *
+         * Plain words must all appear, "quoted phrases" must appear word for
+         * word, and a word ending in * matches any word starting with it.
+         *
+         * @param query Search text.
+         * @param limit Most results to return.
+         * @return Hits, most relevant first.
+         */
+        std::vector<TextHit> search(const std::string& query, size_t limit) const;
+
+        /**
+         * @brief Gets the number of current documents.
+         * @return Document count.
+         */
+        size_t documentCount() const;
+    };
+}
@@ -0,0 +1,170 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace gradebook {
+
+    namespace {
+        /** Pool the current thread works for, or nullptr outside any worker. */
+        thread_local const WorkStealingPool* currentPool = nullptr;
+
+        /** Index of the current thread within currentPool. */
+        thread_local size_t currentWorker = 0;
+    }
+
+    /**
+     * @brief Starts the workers.
+     * @param workers Number of threads; at least one is started.
+     */
+    WorkStealingPool::WorkStealingPool(unsigned workers) {
+        workers = std::max(1u, workers);
+        queues.reserve(workers);
+        for (unsigned w = 0; w < workers; ++w) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        threads.reserve(workers);
+        for (unsigned w = 0; w < workers; ++w) {
+            threads.emplace_back(&WorkStealingPool::run, this, static_cast<size_t>(w));
+        }
+    }
+
+    /**
+     * @brief Finishes every queued task, then stops and joins the workers.
+     */
+    WorkStealingPool::~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    /**
+     * @brief Queues a task on the calling worker's queue, or round robin from outside the pool.
+     * @param task Work to run on some worker.
+     */
+    void WorkStealingPool::submit(Task task) {
+        size_t target;
+        if (currentPool == this) {
+            target = currentWorker;
+        }
+        else {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            target = nextQueue;
+            nextQueue = (nextQueue + 1) % queues.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mutex);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+
+        // Counted only once it is in a queue, so every claim has a task to find.
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            ++queued;
+            ++unfinished;
+        }
+        wake.notify_one();
+    }
+
+    /**
+     * @brief Blocks until every submitted task has finished, rethrowing the first error.
+     */
+    void WorkStealingPool::wait() {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        idle.wait(lock, [this] { return unfinished == 0; });
+
+        if (firstError) {
+            std::exception_ptr error = firstError;
+            firstError = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return Worker count.
+     */
+    unsigned WorkStealingPool::size() const {
+        return static_cast<unsigned>(threads.size());
+    }
+
+    /**
+     * @brief Takes a task from the back of the worker's own queue, else steals from the front of another.
+     * @param self Index of the worker.
+     * @param task Receives the task.
+     * @return True if a task was found.
+     */
+    bool WorkStealingPool::take(size_t self, Task& task) {
+        {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t step = 1; step < queues.size(); ++step) {
+            Queue& victim = *queues[(self + step) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Worker loop: claims, takes and runs tasks until the pool stops.
+     *
+     * A worker first claims one of the queued tasks under the state lock and
+     * only then goes looking for it, so idle workers sleep instead of
+     * spinning over empty queues.
+     *
+     * @param self Index of the worker.
+     */
+    void WorkStealingPool::run(size_t self) {
+        currentPool = this;
+        currentWorker = self;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(stateMutex);
+                wake.wait(lock, [this] { return queued > 0 || stopping; });
+                if (queued == 0) {
+                    return;
+                }
+                --queued;
+            }
+
+            // The claimed task is in some queue; another worker may move ahead of us, but never past it.
+            Task task;
+            while (!take(self, task)) {
+                std::this_thread::yield();
+            }
+
+            std::exception_ptr error;
+            try {
+                task();
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (error && !firstError) {
+                firstError = error;
+            }
+            if (--unfinished == 0) {
+                idle.notify_all();
+            }
+        }
+    }
+}
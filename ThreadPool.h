@@ -0,0 +1,97 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gradebook {
+
+    /**
+     * @class WorkStealingPool
+     * @brief Fixed set of worker threads, each with its own task queue.
+     *
+     * A worker runs tasks from the back of its own queue and, once that is
+     * empty, steals from the front of the others. Tasks submitted from inside
+     * a task land on the submitting worker's queue, so a task that splits its
+     * work keeps it local until another worker runs dry and takes some.
+     * Tasks submitted from outside are spread round robin.
+     */
+    class WorkStealingPool {
+    public:
+        using Task = std::function<void()>;
+
+    private:
+        /**
+         * @brief One worker's queue.
+         */
+        struct Queue {
+            std::mutex mutex;           /**< Guards tasks */
+            std::deque<Task> tasks;     /**< Owner pops the back; thieves take the front */
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;    /**< One queue per worker */
+        std::vector<std::thread> threads;              /**< Worker threads */
+
+        std::mutex stateMutex;                         /**< Guards every field below */
+        std::condition_variable wake;                  /**< Signals workers that a task was queued or the pool is stopping */
+        std::condition_variable idle;                  /**< Signals wait() that every task has finished */
+        size_t queued = 0;                             /**< Tasks sitting in a queue, not yet claimed by a worker */
+        size_t unfinished = 0;                         /**< Tasks submitted and not yet finished */
+        size_t nextQueue = 0;                          /**< Queue the next outside submission goes to */
+        bool stopping = false;                         /**< Set by the destructor */
+        std::exception_ptr firstError;                 /**< First exception thrown by a task since the last wait() */
+
+        /**
+         * @brief Takes a task, preferring the back of the worker's own queue.
+         * @param self Index of the worker.
+         * @param task Receives the task.
+         * @return True if a task was found.
+         */
+        bool take(size_t self, Task& task);
+
+        /**
+         * @brief Worker loop: claims, takes and runs tasks until the pool stops.
+         * @param self Index of the worker.
+         */
+        void run(size_t self);
+
+    public:
+        /**
+         * @brief Starts the workers.
+         * @param workers Number of threads; at least one is started.
+         */
+        explicit WorkStealingPool(unsigned workers);
+
+        /**
+         * @brief Finishes every queued task, then stops and joins the workers.
+         */
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        /**
+         * @brief Queues a task. Safe to call from inside a running task.
+         * @param task Work to run on some worker.
+         */
+        void submit(Task task);
+
+        /**
+         * @brief Blocks until every submitted task, including ones they submitted, has finished.
+         *
+         * If a task threw, the first exception is rethrown here; the other
+         * tasks still ran.
+         */
+        void wait();
+
+        /**
+         * @brief Gets the number of worker threads.
+         * @return Worker count.
+         */
+        unsigned size() const;
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <iostream>
 
 namespace gradebook {
@@ -79,5 +80,25 @@ namespace gradebook {
          * @return The user's password.
          */
         virtual std::string getPassword() const = 0;
+
+        // === Zero-Copy Accessors ===
+
+        /**
+         * @brief Views the user's first name without copying it.
+         * @return View of the stored first name, valid until it is next modified.
+         */
+        std::string_view getFirstNameView() const { return firstName; }
+
+        /**
+         * @brief Views the user's last name without copying it.
+         * @return View of the stored last name, valid until it is next modified.
+         */
+        std::string_view getLastNameView() const { return lastName; }
+
+        /**
+         * @brief Views the user's password without copying it.
+         * @return View of the stored password, valid until it is next modified.
+         */
+        std::string_view getPasswordView() const { return password; }
     };
 }
\ No newline at end of file
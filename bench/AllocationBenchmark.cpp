@@ -0,0 +1,168 @@
+/**
+ * @file AllocationBenchmark.cpp
+ * @brief Counts heap allocations on the paths moved onto the string_view accessors.
+ *
+ * Replaces the global operator new with a counting one, builds a synthetic
+ * school and reports how many allocations each path makes. The copying
+ * getters are measured next to the views they were replaced with, so the
+ * per-field allocation the views avoid is visible in the same run.
+ *
+ * Build from the repository root, linking every source except the
+ * program's own main (libstdc++ needs TBB for the parallel algorithms):
+ *
+ *     g++ -std=c++20 -O2 -pthread bench/AllocationBenchmark.cpp \
+ *         $(ls *.cpp | grep -v "Summer 25") -ltbb -o allocation-benchmark
+ *
+ * In Visual Studio, add this file and every project source except
+ * "Summer 25 Final Project.cpp" to a new C++20 console project.
+ *
+ * Usage: allocation-benchmark [students]   (default 10000)
+ */
+#include "BenchmarkSchool.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <ostream>
+#include <streambuf>
+
+namespace {
+    std::atomic<unsigned long long> allocationCount{ 0 };
+
+    /**
+     * @brief Stream buffer that discards everything, so exporters run without buffering their output.
+     */
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    /**
+     * @brief Runs one path and prints the allocations it made.
+     * @param label Name of the path.
+     * @param students Number of students, for the per-student column.
+     * @param run The path to measure.
+     */
+    void measure(const char* label, unsigned students, const std::function<void()>& run) {
+        unsigned long long before = allocationCount.load();
+        run();
+        unsigned long long made = allocationCount.load() - before;
+        std::printf("%-40s %12llu %14.3f\n", label, made, static_cast<double>(made) / students);
+    }
+}
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char* argv[]) {
+    using namespace gradebook;
+
+    unsigned studentCount = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) : 10000;
+    if (studentCount == 0) {
+        std::fprintf(stderr, "Usage: %s [students]\n", argv[0]);
+        return 1;
+    }
+
+    Gradebook gradebook;
+    gradebook.setDataFile("allocation-benchmark.dat");
+    bench::buildSchool(gradebook, studentCount, 40, 10);
+
+    NullBuffer nullBuffer;
+    std::ostream discard(&nullBuffer);
+    const auto& students = gradebook.getStudents();
+    const auto& teachers = gradebook.getTeachers();
+    size_t sink = 0;
+
+    std::printf("%u students, %zu classrooms\n\n", studentCount, teachers.size());
+    std::printf("%-40s %12s %14s\n", "Path", "Allocations", "Per student");
+
+    measure("Name and notes, copying getters", studentCount, [&] {
+        for (const auto& s : students) {
+            sink += s->getFirstName().size() + s->getLastName().size() + s->getNotes().size();
+        }
+        });
+    measure("Name and notes, string_view getters", studentCount, [&] {
+        for (const auto& s : students) {
+            sink += s->getFirstNameView().size() + s->getLastNameView().size() + s->getNotesView().size();
+        }
+        });
+    measure("Teacher login lookup, copying getters", studentCount, [&] {
+        const std::string first = teachers.back().getFirstName();
+        const std::string last = teachers.back().getLastName();
+        for (unsigned repeat = 0; repeat < 100; ++repeat) {
+            for (const auto& t : teachers) {
+                if (t.getFirstName() == first && t.getLastName() == last) {
+                    ++sink;
+                    break;
+                }
+            }
+        }
+        });
+    measure("Teacher login lookup, string_view getters", studentCount, [&] {
+        const std::string first = teachers.back().getFirstName();
+        const std::string last = teachers.back().getLastName();
+        for (unsigned repeat = 0; repeat < 100; ++repeat) {
+            for (const auto& t : teachers) {
+                if (t.getFirstNameView() == first && t.getLastNameView() == last) {
+                    ++sink;
+                    break;
+                }
+            }
+        }
+        });
+    measure("calculateGrade, every student", studentCount, [&] {
+        for (const auto& t : teachers) {
+            for (Student* s : t.getClassroomStudents()) {
+                s->calculateGrade(t.getClassroomID(), t.getAssignments());
+            }
+        }
+        });
+    measure("School report rows, rendered cold", studentCount, [&] {
+        gradebook.invalidateReportCache();
+        sink += gradebook.getSchoolReportRows().size();
+        });
+    measure("Classroom report CSV, every classroom", studentCount, [&] {
+        for (const auto& t : teachers) {
+            sink += t.writeClassroomReportCSV(discard);
+        }
+        });
+    measure("Assignment scores CSV, every classroom", studentCount, [&] {
+        for (const auto& t : teachers) {
+            sink += t.writeAssignmentScoresCSV(discard);
+        }
+        });
+    measure("Save to the data file", studentCount, [&] {
+        gradebook.serializeAndSave();
+        });
+
+    std::remove("allocation-benchmark.dat");
+    std::remove("allocation-benchmark.dat.lock");
+    return sink == 0 ? 1 : 0;
+}
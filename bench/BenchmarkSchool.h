@@ -0,0 +1,80 @@
+#pragma once
+#include "../Gradebook.h"
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace gradebook::bench {
+
+    /**
+     * @brief Fills a gradebook with a synthetic school for the benchmark drivers.
+     *
+     * Names, notes and assignment names are longer than the small-string
+     * buffer of every common standard library, so a copying getter always
+     * allocates and the benchmarks see it.
+     *
+     * @param gradebook Empty gradebook to fill.
+     * @param studentCount Number of students.
+     * @param teacherCount Number of classrooms; students are dealt round robin.
+     * @param assignmentsPerTeacher Graded assignments in each classroom.
+     */
+    inline void buildSchool(Gradebook& gradebook, unsigned studentCount, unsigned teacherCount, unsigned assignmentsPerTeacher) {
+        Administrator admin;
+        admin.setAdminTitle("Principal");
+        admin.setFirstName("Benchmark");
+        admin.setLastName("Administrator");
+        admin.setSchoolName("Benchmark Elementary School");
+        admin.setPassword("Benchmark#Password1");
+        gradebook.getSchool().push_back(admin);
+
+        for (unsigned t = 0; t < teacherCount; ++t) {
+            Teacher teacher;
+            teacher.setTitle("Mx.");
+            teacher.setFirstName("TeacherFirstName" + std::to_string(t));
+            teacher.setLastName("TeacherLastName" + std::to_string(t));
+            teacher.setPassword("Benchmark#Password1");
+            teacher.setGradeLevel(1 + t % 8);
+            Teacher& stored = gradebook.addTeacher(std::move(teacher));
+
+            for (unsigned a = 0; a < assignmentsPerTeacher; ++a) {
+                Assignment assignment;
+                assignment.setAssignmentName("Assignment number " + std::to_string(a));
+                assignment.setAssignmentDescription("Synthetic assignment used by the benchmark drivers");
+                assignment.setPointsPossible(100.0f);
+                assignment.setAssignmentID(gradebook.registerAssignment(stored));
+                stored.getAssignments().push_back(assignment);
+                gradebook.indexAssignmentDescription(stored.getAssignments().back());
+            }
+        }
+
+        for (unsigned i = 0; i < studentCount; ++i) {
+            auto student = std::make_unique<Student>();
+            student->setFirstName("StudentFirstName" + std::to_string(i));
+            student->setLastName("StudentLastName" + std::to_string(i));
+            student->setPassword("Benchmark#Password1");
+            student->setPronouns("they/them");
+            student->setAge(6 + i % 8);
+            student->setGradeLevel(1 + i % 8);
+            student->setID(100000 + i);
+            student->setSeat("Row " + std::to_string(i % 10));
+            student->setNotes("Synthetic student notes long enough to live on the heap");
+            Student* stored = gradebook.addStudent(std::move(student));
+
+            Teacher& teacher = gradebook.getTeachers()[i % teacherCount];
+            gradebook.enrollStudent(teacher, stored);
+            for (const auto& a : teacher.getAssignments()) {
+                stored->setAssignmentScore(teacher.getClassroomID(), a.getAssignmentID(), static_cast<float>(50 + (i + a.getAssignmentID()) % 50));
+            }
+            stored->calculateGrade(teacher.getClassroomID(), teacher.getAssignments());
+        }
+    }
+
+    /**
+     * @brief Gets the milliseconds elapsed since a start time.
+     * @param start When timing began.
+     * @return Elapsed milliseconds.
+     */
+    inline double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
@@ -0,0 +1,89 @@
+/**
+ * @file DurabilityBenchmark.cpp
+ * @brief Times autosave under each durability mode.
+ *
+ * Builds a synthetic school, then for each mode makes a run of grade
+ * changes, autosaving after every one as the menus do. The time until the
+ * last change returns is the latency a user sees; the time until every
+ * change is durable adds the final flush of any pending group commit.
+ *
+ * fsync cost depends entirely on the disk, so run it in a directory on the
+ * storage the program will really use; on tmpfs the modes differ only by
+ * the work of encoding and writing.
+ *
+ * Build from the repository root, linking every source except the
+ * program's own main (libstdc++ needs TBB for the parallel algorithms):
+ *
+ *     g++ -std=c++20 -O2 -pthread bench/DurabilityBenchmark.cpp \
+ *         $(ls *.cpp | grep -v "Summer 25") -ltbb -o durability-benchmark
+ *
+ * In Visual Studio, add this file and every project source except
+ * "Summer 25 Final Project.cpp" to a new C++20 console project.
+ *
+ * Usage: durability-benchmark [students] [changes] [windowMs] [maxChanges]
+ *        (defaults 10000, 100, 250, 8)
+ */
+#include "BenchmarkSchool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+int main(int argc, char* argv[]) {
+    using namespace gradebook;
+
+    auto argument = [&](int i, unsigned fallback) {
+        return argc > i ? static_cast<unsigned>(std::strtoul(argv[i], nullptr, 10)) : fallback;
+        };
+    unsigned studentCount = argument(1, 10000);
+    unsigned changes = argument(2, 100);
+    unsigned windowMs = argument(3, 250);
+    unsigned maxChanges = argument(4, 8);
+    if (studentCount == 0 || changes == 0) {
+        std::fprintf(stderr, "Usage: %s [students] [changes] [windowMs] [maxChanges]\n", argv[0]);
+        return 1;
+    }
+
+    const char* dataFile = "durability-benchmark.dat";
+    Gradebook gradebook;
+    gradebook.setDataFile(dataFile);
+    // Every classroom gets at least one student to change.
+    bench::buildSchool(gradebook, studentCount, std::min(40u, studentCount), 10);
+    gradebook.setGroupCommitPolicy(windowMs, maxChanges);
+
+    std::printf("%u students, %u changes per mode, group window %u ms or %u changes\n\n",
+        studentCount, changes, windowMs, maxChanges);
+    std::printf("%-10s %16s %16s %18s\n", "Mode", "ms per change", "total ms", "ms until durable");
+
+    // Autosave reports every save on std::cout; keep it out of the table.
+    std::ostringstream quiet;
+    std::streambuf* console = std::cout.rdbuf();
+
+    for (DurabilityMode mode : { DurabilityMode::Fast, DurabilityMode::Strict, DurabilityMode::Grouped }) {
+        std::cout.rdbuf(quiet.rdbuf());
+        gradebook.setDurabilityMode(mode);
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < changes; ++i) {
+            Teacher& teacher = gradebook.getTeachers()[i % gradebook.getTeachers().size()];
+            Student* student = teacher.getClassroomStudents()[i % teacher.getClassroomStudents().size()];
+            unsigned assignmentID = teacher.getAssignments().front().getAssignmentID();
+            student->setAssignmentScore(teacher.getClassroomID(), assignmentID, static_cast<float>(i % 100));
+            student->calculateGrade(teacher.getClassroomID(), teacher.getAssignments());
+            teacher.touchScores(assignmentID);
+            gradebook.autosave();
+        }
+        double returned = bench::millisecondsSince(start);
+        gradebook.flushPendingSaves();
+        double durable = bench::millisecondsSince(start);
+
+        std::cout.rdbuf(console);
+        quiet.str("");
+        std::printf("%-10s %16.3f %16.1f %18.1f\n", durabilityModeName(mode), returned / changes, returned, durable);
+    }
+
+    std::remove(dataFile);
+    std::remove((std::string(dataFile) + ".lock").c_str());
+    return 0;
+}
@@ -6,7 +6,10 @@
 #include <iostream>
 #include <limits>
 #include <cctype>
+#include <algorithm>
+#include <cstdint>
 #include "Gradebook.h"
+#include "RosterIndex.h"
 
 namespace gradebook {
 
@@ -106,6 +109,142 @@ namespace gradebook {
         }
     }
 
+    namespace {
+        constexpr size_t pickerPageSize = 20; ///< Choices shown per page by the pickers
+
+        /**
+         * @brief Runs the shared page/search/select loop behind both pickers.
+         *
+         * @param search Re-runs the search for a query and returns the match count.
+         * @param label Returns the display label of a match by position.
+         * @return Position of the chosen match, or SIZE_MAX if the user cancelled.
+         */
+        size_t runPicker(const std::function<size_t(const std::string&)>& search,
+            const std::function<std::string(size_t)>& label)
+        {
+            std::string query;
+            size_t matchCount = search(query);
+            size_t page = 0;
+
+            while (true) {
+                if (matchCount == 0) {
+                    std::cout << "No matches for \"" << query << "\"." << std::endl;
+                }
+                else {
+                    size_t first = page * pickerPageSize;
+                    size_t last = std::min(first + pickerPageSize, matchCount);
+                    std::cout << "Showing " << first + 1 << "-" << last << " of " << matchCount;
+                    if (!query.empty()) {
+                        std::cout << " matches for \"" << query << "\"";
+                    }
+                    std::cout << ":" << std::endl;
+                    for (size_t i = first; i < last; ++i) {
+                        std::cout << "  " << (i + 1) << ". " << label(i) << std::endl;
+                    }
+                }
+
+                std::string input = stringValidator(
+                    "Enter a number to select, /text to search, n or p to page, or q to cancel: ");
+
+                if (input == "q" || input == "Q") {
+                    return SIZE_MAX;
+                }
+                if (input == "n" || input == "N") {
+                    if ((page + 1) * pickerPageSize < matchCount) ++page;
+                    continue;
+                }
+                if (input == "p" || input == "P") {
+                    if (page > 0) --page;
+                    continue;
+                }
+                if (input[0] == '/') {
+                    query = input.substr(1);
+                    matchCount = search(query);
+                    page = 0;
+                    continue;
+                }
+                if (std::all_of(input.begin(), input.end(),
+                    [](char ch) { return std::isdigit(static_cast<unsigned char>(ch)); })
+                    && input.size() < 10) {
+                    size_t number = std::stoul(input);
+                    if (number >= 1 && number <= matchCount) {
+                        return number - 1;
+                    }
+                }
+                std::cout << "Invalid selection. Please try again." << std::endl;
+            }
+        }
+    }
+
+    /**
+     * @brief Lets the user pick a student from a roster using prefix search and paging.
+     * @param roster The roster index to pick from.
+     * @return Pointer to the chosen student, or nullptr if the user cancelled.
+     */
+    Student* pickStudent(const RosterIndex& roster) {
+        std::vector<Student*> matches;
+        size_t choice = runPicker(
+            [&](const std::string& query) {
+                matches = roster.search(query);
+                return matches.size();
+            },
+            [&](size_t i) {
+                return matches[i]->getLastName() + ", " + matches[i]->getFirstName()
+                    + " (ID " + std::to_string(matches[i]->getID()) + ")";
+            });
+
+        return choice == SIZE_MAX ? nullptr : matches[choice];
+    }
+
+    /**
+     * @brief Lets the user pick one entry from a list of labels, a page at a time.
+     * @param labels Display labels for each choice.
+     * @return Zero-based index of the chosen label, or labels.size() if cancelled.
+     */
+    size_t pickFromList(const std::vector<std::string>& labels) {
+        std::vector<size_t> matches;
+        auto fold = [](std::string text) {
+            for (char& ch : text) {
+                ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+            }
+            return text;
+            };
+
+        size_t choice = runPicker(
+            [&](const std::string& query) {
+                std::string needle = fold(query);
+                matches.clear();
+                for (size_t i = 0; i < labels.size(); ++i) {
+                    if (needle.empty() || fold(labels[i]).find(needle) != std::string::npos) {
+                        matches.push_back(i);
+                    }
+                }
+                return matches.size();
+            },
+            [&](size_t i) { return labels[matches[i]]; });
+
+        return choice == SIZE_MAX ? labels.size() : matches[choice];
+    }
+
+    /**
+     * @brief Writes a double-quoted, backslash-escaped field to a stream.
+     * @param out Stream to write to.
+     * @param text Text to quote.
+     */
+    void writeQuoted(std::ostream& out, std::string_view text) {
+        out.put('"');
+        size_t runStart = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '"' || text[i] == '\\') {
+                out.write(text.data() + runStart, static_cast<std::streamsize>(i - runStart));
+                out.put('\\');
+                runStart = i;
+            }
+        }
+        out.write(text.data() + runStart, static_cast<std::streamsize>(text.size() - runStart));
+        out.put('"');
+    }
+
     /**
      * @brief Checks if a file exists on disk.
      *
@@ -120,16 +259,21 @@ namespace gradebook {
     /**
      * @brief Displays the initial welcome menu and handles login/setup flow.
      *
-     * If a saved `gradebook.dat` file is found, it loads school data.
+     * If the gradebook's data file (`gradebook.dat` unless changed) is found, it loads school data.
      * If no file is found, it initiates school setup.
-     * Then repeatedly prompts user to log in as an Administrator, Teacher, or Student.
+     * Then repeatedly prompts user to log in as an Administrator, Teacher, or Student,
+     * and offers to save once the user exits.
+     * The data file is shared, so changes other sessions save to it are
+     * loaded between logins and between menu actions.
      *
      * @param gradebook Reference to the Gradebook instance.
      */
     void welcomeMenu(Gradebook& gradebook) {
         std::cout << "Welcome to Gradebook!" << std::endl << std::endl;
 
-        const std::string filename = "gradebook.dat";
+        const std::string& filename = gradebook.getDataFile();
+        // Other sessions may have the same file open; saves merge their work instead of overwriting it.
+        gradebook.shareDataFile(true);
 
         if (fileExists(filename)) {
             std::cout << "Loading saved data..." << std::endl;
@@ -141,14 +285,30 @@ namespace gradebook {
             gradebook.serializeAndSave();
         }
 
+        loginMenu(gradebook, "Exit");
+        closeMenu(gradebook);
+    }
+
+    /**
+     * @brief Repeatedly prompts the user to log in as an Administrator, Teacher, or Student.
+     *
+     * Each login runs that user's menu; logging out comes back here. Changes
+     * other sessions saved to a shared data file are loaded before each prompt.
+     *
+     * @param gradebook Reference to the Gradebook instance.
+     * @param leaveLabel Menu text of the option that returns to the caller.
+     */
+    void loginMenu(Gradebook& gradebook, const std::string& leaveLabel) {
         std::unique_ptr<User, std::function<void(User*)>> user = nullptr;
 
         while (true) {
+            gradebook.reloadExternalChanges();
+
             std::cout << std::endl << "Please select a login type:" << std::endl;
             std::cout << "  1. Administrator" << std::endl;
             std::cout << "  2. Teacher" << std::endl;
             std::cout << "  3. Student" << std::endl;
-            std::cout << "  4. Exit" << std::endl;
+            std::cout << "  4. " << leaveLabel << std::endl;
 
             int choice = numericValidator("Choose an option [1-4]: ", 1, 4);
 
@@ -163,7 +323,6 @@ namespace gradebook {
                 user = attemptLogin<Student>(gradebook.getStudents(), gradebook);
                 break;
             case 4:
-                closeMenu(gradebook);
                 return;
             default:
                 user = nullptr;
@@ -200,6 +359,8 @@ namespace gradebook {
             std::exit(0);
         }
         else {
+            // Changes already autosaved stay saved, even if their group commit is still pending.
+            gradebook.flushPendingSaves();
             gradebook.clearCachedData();
             std::exit(0);
         }
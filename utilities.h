@@ -106,7 +106,7 @@ namespace gradebook {
             std::string last = stringValidator("Enter your last name: ");
             for (auto& uPtr : users) {
                 if constexpr (std::is_same_v<T, Teacher> || std::is_same_v<T, Administrator>) {
-                    if (uPtr->getFirstName() == first && uPtr->getLastName() == last) {
+                    if (uPtr->getFirstNameView() == first && uPtr->getLastNameView() == last) {
                         userPtr = uPtr.get();
                         break;
                     }
@@ -121,20 +121,18 @@ namespace gradebook {
 
         auto doPasswordFlow = [&](User& u) {
             std::string entered;
-            if (u.getPassword().empty()) {
+            if (u.getPasswordView().empty()) {
                 std::cout << "No password set for your account. Please create one now.\n";
                 do {
                     entered = stringValidator("Enter new password: ");
                 } while (!isStrongPassword(entered));
                 u.setPassword(entered);
                 std::cout << "Password set successfully.\n";
-                if (gradebook.isAutosaveEnabled()) {
-                    gradebook.serializeAndSave();
-                }
+                gradebook.autosave();
             }
             else {
                 entered = stringValidator("Enter your password: ");
-                if (entered != u.getPassword()) {
+                if (entered != u.getPasswordView()) {
                     std::cout << "Incorrect password.\n";
                     return false;
                 }
@@ -189,7 +187,7 @@ namespace gradebook {
             std::string last = stringValidator("Enter your last name: ");
             for (auto& u : users) {
                 if constexpr (std::is_same_v<T, Teacher> || std::is_same_v<T, Administrator>) {
-                    if (u.getFirstName() == first && u.getLastName() == last) {
+                    if (u.getFirstNameView() == first && u.getLastNameView() == last) {
                         userPtr = &u;
                         break;
                     }
@@ -204,20 +202,18 @@ namespace gradebook {
 
         auto doPasswordFlow = [&](User& u) {
             std::string entered;
-            if (u.getPassword().empty()) {
+            if (u.getPasswordView().empty()) {
                 std::cout << "No password set for your account. Please create one now.\n";
                 do {
                     entered = stringValidator("Enter new password: ");
                 } while (!isStrongPassword(entered));
                 u.setPassword(entered);
                 std::cout << "Password set successfully.\n";
-                if (gradebook.isAutosaveEnabled()) {
-                    gradebook.serializeAndSave();
-                }
+                gradebook.autosave();
             }
             else {
                 entered = stringValidator("Enter your password: ");
-                if (entered != u.getPassword()) {
+                if (entered != u.getPasswordView()) {
                     std::cout << "Incorrect password.\n";
                     return false;
                 }
@@ -248,6 +244,40 @@ namespace gradebook {
      */
     bool userCheck(const std::string& prompt, const std::string& yesPrompt, const std::string& noPrompt);
 
+    /**
+     * @brief Lets the user pick a student from a roster using prefix search and paging.
+     *
+     * At most one page of students is printed at a time. Typing "/" followed by
+     * text searches by last name, first name or ID prefix through the roster's
+     * sorted key index.
+     *
+     * @param roster The roster index to pick from.
+     * @return Pointer to the chosen student, or nullptr if the user cancelled.
+     */
+    Student* pickStudent(const RosterIndex& roster);
+
+    /**
+     * @brief Lets the user pick one entry from a list of labels, a page at a time.
+     *
+     * Typing "/" followed by text filters the labels case-insensitively.
+     *
+     * @param labels Display labels for each choice.
+     * @return Zero-based index of the chosen label, or labels.size() if cancelled.
+     */
+    size_t pickFromList(const std::vector<std::string>& labels);
+
+    /**
+     * @brief Writes a double-quoted field exactly like std::quoted, without temporaries.
+     *
+     * Quotes and backslashes inside the text are escaped with a backslash.
+     * Unlike std::quoted this writes straight to the stream, so exporters
+     * don't allocate per field.
+     *
+     * @param out Stream to write to.
+     * @param text Text to quote.
+     */
+    void writeQuoted(std::ostream& out, std::string_view text);
+
     /**
      * @brief Checks whether a file exists on disk.
      *
@@ -263,6 +293,14 @@ namespace gradebook {
      */
     void welcomeMenu(Gradebook& gradebook);
 
+    /**
+     * @brief Repeatedly prompts for an Administrator, Teacher or Student login until the user leaves.
+     *
+     * @param gradebook Reference to the Gradebook object for access to all data.
+     * @param leaveLabel Menu text of the option that returns to the caller.
+     */
+    void loginMenu(Gradebook& gradebook, const std::string& leaveLabel);
+
     /**
      * @brief Displays the closing message and handles autosave or shutdown tasks.
      *